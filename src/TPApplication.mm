@@ -1,6 +1,10 @@
 #import "TPApplication.h"
 #import "TPConfig.h"
 #import "TPEventViewController.h"
+#import "TPLogger.h"
+#include "application/services/TelemetryTap.h"
+#include "application/services/TraceRecorder.h"
+#include "domain/models/HIDUsage.h"
 
 #ifdef DEBUG
 #define DebugLog(format, ...) NSLog(@"%s: " format, __FUNCTION__, ##__VA_ARGS__)
@@ -34,6 +38,7 @@
         // Process command line arguments
         NSArray<NSString *> *arguments = [[NSProcessInfo processInfo] arguments];
         [[TPConfig sharedConfig] applyCommandLineArguments:arguments];
+        TPMiddle::Application::TraceRecorder::SetThreadName("main");
         
         // Initialize components
         self.hidManager = [TPHIDManager sharedManager];
@@ -83,6 +88,11 @@
     }
 }
 
+- (void)applicationDidActivate:(NSNotification *)notification {
+    NSRunningApplication *application = notification.userInfo[NSWorkspaceApplicationKey];
+    [self.buttonManager setFrontmostApplication:application.bundleIdentifier];
+}
+
 - (void)showEventViewer {
     [self.eventViewController startMonitoring];
     [self.eventWindow makeKeyAndOrderFront:nil];
@@ -98,20 +108,32 @@
 #pragma mark - Public Methods
 
 - (void)start {
-    // Configure HID device matching
-    [self.hidManager addDeviceMatching:kUsagePageGenericDesktop usage:kUsageMouse];
-    [self.hidManager addDeviceMatching:kUsagePageGenericDesktop usage:kUsagePointer];
-    [self.hidManager addVendorMatching:kVendorIDLenovo];
+    // Configure HID device matching: Lenovo pointer interfaces only, so
+    // keyboard and consumer-control interfaces never call back
+    [self.hidManager addDeviceMatching:kUsagePageGenericDesktop usage:kUsageMouse vendor:kVendorIDLenovo];
+    [self.hidManager addDeviceMatching:kUsagePageGenericDesktop usage:kUsagePointer vendor:kVendorIDLenovo];
     
-    // Start HID monitoring
+    // Start HID monitoring, capturing a replayable trace if requested
+    self.hidManager.traceCapturePath = [TPConfig sharedConfig].traceCapturePath;
+    self.hidManager.pipelineTracePath = [TPConfig sharedConfig].pipelineTracePath;
     if (![self.hidManager start]) {
         DebugLog(@"Failed to start HID manager");
         [NSApp terminate:nil];
         return;
     }
+    [[TPConfig sharedConfig] startWatchingConfigFile];
+    
+    // Scroll profiles follow the frontmost application
+    NSWorkspace *workspace = [NSWorkspace sharedWorkspace];
+    [self.buttonManager setFrontmostApplication:workspace.frontmostApplication.bundleIdentifier];
+    [workspace.notificationCenter addObserver:self
+                                     selector:@selector(applicationDidActivate:)
+                                         name:NSWorkspaceDidActivateApplicationNotification
+                                       object:nil];
     
-    // Show event viewer in debug mode
+    // Show event viewer and record events in debug mode
     if ([TPConfig sharedConfig].debugMode) {
+        [[TPLogger sharedLogger] startLogging];
         [self showEventViewer];
     }
     
@@ -120,6 +142,22 @@
 
 #pragma mark - TPHIDManagerDelegate
 
+- (void)willProcessInputBatch {
+    [self.buttonManager beginInputBatch];
+}
+
+- (void)didAttachDeviceHandle:(uint64_t)handle identity:(NSString *)identity name:(NSString *)name {
+    [self.buttonManager deviceAttached:handle identity:identity name:name];
+}
+
+- (void)didDetachDeviceHandle:(uint64_t)handle {
+    [self.buttonManager deviceDetached:handle];
+}
+
+- (void)didSwitchActiveDeviceHandle:(uint64_t)handle {
+    [self.buttonManager setActiveDevice:handle];
+}
+
 - (void)didDetectDeviceAttached:(NSString *)deviceInfo {
     DebugLog(@"Device attached:\n%@", deviceInfo);
 }
@@ -129,32 +167,25 @@
     [self.buttonManager reset];
 }
 
-- (void)didReceiveButtonPress:(BOOL)leftButton right:(BOOL)rightButton middle:(BOOL)middleButton {
-    // Post notification for EventViewController
-    [[NSNotificationCenter defaultCenter] postNotificationName:@"TPButtonNotification"
-                                                      object:nil
-                                                    userInfo:@{
-        @"left": @(leftButton),
-        @"right": @(rightButton),
-        @"middle": @(middleButton)
-    }];
+- (void)didReceiveButtonPress:(BOOL)leftButton right:(BOOL)rightButton middle:(BOOL)middleButton
+                    timestamp:(uint64_t)timestampNs {
+    // The event viewer pulls aggregated state at display rate; free while it is closed
+    TPMiddle::Application::TelemetryTap::Shared().RecordButtons(
+        (leftButton ? TPMiddle::Domain::kButtonMaskLeft : 0) |
+        (rightButton ? TPMiddle::Domain::kButtonMaskRight : 0) |
+        (middleButton ? TPMiddle::Domain::kButtonMaskMiddle : 0));
     
     // Forward to button manager
-    [self.buttonManager updateButtonStates:leftButton right:rightButton middle:middleButton];
-}
-
-- (void)didReceiveMovement:(int)deltaX deltaY:(int)deltaY withButtonState:(uint8_t)buttons {
-    // Post notification for EventViewController
-    [[NSNotificationCenter defaultCenter] postNotificationName:@"TPMovementNotification"
-                                                      object:nil
-                                                    userInfo:@{
-        @"deltaX": @(deltaX),
-        @"deltaY": @(deltaY),
-        @"buttons": @(buttons)
-    }];
+    [self.buttonManager updateButtonStates:leftButton right:rightButton middle:middleButton timestamp:timestampNs];
+}
+
+- (void)didReceiveMovement:(int)deltaX deltaY:(int)deltaY withButtonState:(uint8_t)buttons
+                 timestamp:(uint64_t)timestampNs {
+    TP_TRACE_SPAN("didReceiveMovement:");
+    TPMiddle::Application::TelemetryTap::Shared().RecordMovement(deltaX, deltaY);
     
     // Forward movement data to button manager for scroll processing
-    [self.buttonManager handleMovement:deltaX deltaY:deltaY withButtonState:buttons];
+    [self.buttonManager handleMovement:deltaX deltaY:deltaY withButtonState:buttons timestamp:timestampNs];
     
     if ([TPConfig sharedConfig].debugMode) {
         DebugLog(@"Movement - X: %d, Y: %d, Buttons: %02X", deltaX, deltaY, buttons);
@@ -173,10 +204,30 @@
 
 - (void)statusBarControllerWillQuit {
     // Clean up before quitting
+    [[TPConfig sharedConfig] stopWatchingConfigFile];
+    [[NSWorkspace sharedWorkspace].notificationCenter removeObserver:self];
     [self.hidManager stop];
     [self.buttonManager reset];
 }
 
+- (NSString *)statusBarControllerStatisticsReport {
+    return [self.hidManager statisticsReport];
+}
+
+- (void)statusBarControllerDidRequestStatisticsDump {
+    NSDateFormatter *formatter = [[NSDateFormatter alloc] init];
+    [formatter setDateFormat:@"yyyy-MM-dd-HHmmss"];
+    NSString *fileName = [NSString stringWithFormat:@"tpmiddle-stats-%@.txt", [formatter stringFromDate:[NSDate date]]];
+    NSString *path = [[[TPLogger sharedLogger] logDirectory] stringByAppendingPathComponent:fileName];
+    
+    NSError *error = nil;
+    if ([[self.hidManager statisticsReport] writeToFile:path atomically:YES encoding:NSUTF8StringEncoding error:&error]) {
+        DebugLog(@"Statistics written to %@", path);
+    } else {
+        DebugLog(@"Failed to write statistics to %@: %@", path, error);
+    }
+}
+
 - (void)statusBarControllerDidToggleEventViewer:(BOOL)show {
     if (show) {
         [self showEventViewer];
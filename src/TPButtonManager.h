@@ -13,11 +13,22 @@
 
 + (instancetype)sharedManager;
 
-// Button state management
-- (void)updateButtonStates:(BOOL)leftDown right:(BOOL)rightDown middle:(BOOL)middleDown;
-
-// Movement handling
-- (void)handleMovement:(int)deltaX deltaY:(int)deltaY withButtonState:(uint8_t)buttons;
+// Picks up configuration changes; call on the input thread before each event batch
+- (void)beginInputBatch;
+
+// Scroll profiles: the frontmost application is set on the main thread,
+// device changes arrive on the input thread
+- (void)setFrontmostApplication:(NSString *)bundleIdentifier;
+- (void)deviceAttached:(uint64_t)handle identity:(NSString *)identity name:(NSString *)name;
+- (void)deviceDetached:(uint64_t)handle;
+- (void)setActiveDevice:(uint64_t)handle;
+
+// Input carries the device's sample time in MonotonicClock nanoseconds;
+// chord windows, scroll velocity and momentum are measured on it
+- (void)updateButtonStates:(BOOL)leftDown right:(BOOL)rightDown middle:(BOOL)middleDown
+                 timestamp:(uint64_t)timestampNs;
+- (void)handleMovement:(int)deltaX deltaY:(int)deltaY withButtonState:(uint8_t)buttons
+             timestamp:(uint64_t)timestampNs;
 
 // Reset state
 - (void)reset;
@@ -2,6 +2,21 @@
 #import "TPConfig.h"
 #import "TPLogger.h"
 #import <AppKit/AppKit.h>
+#include "application/services/InputConfig.h"
+#include "application/services/LatencyMonitor.h"
+#include "application/services/TelemetryTap.h"
+#include "application/services/TraceRecorder.h"
+#include "domain/services/MiddleButtonEmulator.h"
+#include "domain/services/MomentumIntegrator.h"
+#include "domain/services/ScrollEngine.h"
+#include "domain/services/ScrollSynthesizer.h"
+#include "infrastructure/metrics/LiveCounters.h"
+#include "utils/MonotonicClock.h"
+#include <algorithm>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
 
 #ifdef DEBUG
 #define DebugLog(format, ...) NSLog(@"%s: " format, __FUNCTION__, ##__VA_ARGS__)
@@ -9,22 +24,99 @@
 #define DebugLog(format, ...)
 #endif
 
-// Scroll configuration
-const CGFloat kMinMovementThreshold = 1.0;   // Minimum movement to trigger scroll
-const CGFloat kMaxScrollSpeed = 50.0;        // Maximum scroll speed cap
+using TPMiddle::Application::InputConfig;
+using TPMiddle::Application::InputConfigCell;
+using TPMiddle::Application::LatencyMonitor;
+using TPMiddle::Application::ProfileDevice;
+using TPMiddle::Application::ProfileResolver;
+using TPMiddle::Application::ProfileStore;
+using TPMiddle::Application::ScrollProfile;
+using TPMiddle::Application::TelemetryTap;
+using TPMiddle::Application::TraceRecorder;
+using TPMiddle::Domain::AccelerationCurve;
+using TPMiddle::Domain::MiddleButtonActions;
+using TPMiddle::Domain::MiddleButtonEmulator;
+using TPMiddle::Domain::MomentumIntegrator;
+using TPMiddle::Domain::ScrollEngine;
+using TPMiddle::Domain::ScrollFrame;
+using TPMiddle::Domain::ScrollOutput;
+using TPMiddle::Domain::ScrollSettings;
+using TPMiddle::Domain::ScrollSynthesizer;
+using TPMiddle::Infrastructure::LiveCounter;
+using TPMiddle::Infrastructure::LiveCounters;
+using TPMiddle::Utils::MonotonicClock;
+
+static const uint64_t kFrameTimerLeewayNs = 250 * NSEC_PER_USEC;
+
+static void *kInputConfigContext = &kInputConfigContext;
+
+static NSArray<NSString *> *InputConfigKeyPaths(void) {
+    return @[@"middleButtonDelay", @"scrollProfiles", @"scrollSpeedMultiplier", @"scrollAcceleration", @"naturalScrolling",
+             @"accelerationCurve", @"maxScrollSpeed", @"minMovementThreshold",
+             @"invertScrollX", @"invertScrollY", @"scrollFrameRate",
+             @"momentumScrolling", @"momentumFriction", @"reloading"];
+}
+
+static std::string TPStdString(NSString *string) {
+    return string.length ? std::string(string.UTF8String) : std::string();
+}
+
+static ScrollProfile TPScrollProfileFromDictionary(NSDictionary<NSString *, id> *entry) {
+    ScrollProfile profile;
+    profile.application = TPStdString(entry[kScrollProfileKeyApplication]);
+    profile.device = TPStdString(entry[kScrollProfileKeyDevice]);
+    if (entry[kScrollProfileKeySpeedMultiplier]) {
+        profile.overrides.speedMultiplier = [entry[kScrollProfileKeySpeedMultiplier] doubleValue];
+    }
+    if (entry[kScrollProfileKeyAcceleration]) {
+        profile.overrides.acceleration = [entry[kScrollProfileKeyAcceleration] doubleValue];
+    }
+    if (entry[kScrollProfileKeyNaturalScrolling]) {
+        profile.overrides.naturalScrolling = [entry[kScrollProfileKeyNaturalScrolling] boolValue];
+    }
+    if (entry[kScrollProfileKeyInvertX]) {
+        profile.overrides.invertX = [entry[kScrollProfileKeyInvertX] boolValue];
+    }
+    if (entry[kScrollProfileKeyInvertY]) {
+        profile.overrides.invertY = [entry[kScrollProfileKeyInvertY] boolValue];
+    }
+    return profile;
+}
 
 @interface TPButtonManager () {
-    BOOL _leftDown;
-    BOOL _rightDown;
-    BOOL _middleEmulated;
-    BOOL _middlePressed;
-    NSDate *_leftDownTime;
-    NSDate *_rightDownTime;
+    // PassThrough: the HID manager does not seize the device, so the system
+    // has already seen every left and right press by the time we do
+    MiddleButtonEmulator _middleEmulator;
     
     // Scroll state
-    CGFloat _accumulatedDeltaX;
-    CGFloat _accumulatedDeltaY;
-    NSTimeInterval _lastScrollTime;
+    ScrollEngine _scrollEngine;
+    
+    // Configuration compiled on every TPConfig change; the input thread picks
+    // up a new snapshot at the start of an event batch
+    InputConfigCell _config;
+    std::unique_ptr<InputConfigCell::Reader> _configReader;   // Input thread only
+    uint64_t _appliedConfigVersion;                           // Input thread only
+    
+    // Profile and curve inputs, main thread only
+    NSString *_frontmostApplication;
+    NSString *_compiledCurveSource;
+    std::shared_ptr<const AccelerationCurve> _compiledCurve;
+    NSArray *_compiledProfileSource;
+    std::shared_ptr<const ProfileStore> _compiledProfiles;
+    
+    // Resolved profile per device; the engine is reconfigured only when the
+    // resolution or the device producing input changes
+    ProfileResolver _profiles;                                // Input thread only
+    std::shared_ptr<const ProfileStore> _activeProfiles;      // Input thread only, keeps _profiles' store alive
+    uint64_t _activeDevice;                                   // Input thread only
+    uint64_t _appliedProfileGeneration;                       // Input thread only
+    
+    // Frame-paced scroll output, shared by the input worker and the frame timer
+    std::mutex _scrollLock;
+    ScrollSynthesizer _scrollSynthesizer;   // Guarded by _scrollLock
+    MomentumIntegrator _momentum;           // Guarded by _scrollLock
+    BOOL _frameTimerArmed;                  // Guarded by _scrollLock
+    dispatch_source_t _frameTimer;
 }
 @end
 
@@ -41,147 +133,284 @@ const CGFloat kMaxScrollSpeed = 50.0;        // Maximum scroll speed cap
 
 - (instancetype)init {
     if (self = [super init]) {
+        [self setupFrameTimer];
+        _configReader.reset(new InputConfigCell::Reader(_config));
+        _appliedConfigVersion = 0;
+        _activeDevice = 0;
+        _appliedProfileGeneration = 0;
+        [self publishInputConfig];
+        [self beginInputBatch];
+        for (NSString *keyPath in InputConfigKeyPaths()) {
+            [[TPConfig sharedConfig] addObserver:self
+                                      forKeyPath:keyPath
+                                         options:0
+                                         context:kInputConfigContext];
+        }
         [self reset];
     }
     return self;
 }
 
+- (void)dealloc {
+    for (NSString *keyPath in InputConfigKeyPaths()) {
+        [[TPConfig sharedConfig] removeObserver:self forKeyPath:keyPath context:kInputConfigContext];
+    }
+    dispatch_source_cancel(_frameTimer);
+}
+
+- (void)setupFrameTimer {
+    dispatch_queue_attr_t attributes = dispatch_queue_attr_make_with_qos_class(DISPATCH_QUEUE_SERIAL,
+                                                                               QOS_CLASS_USER_INTERACTIVE, 0);
+    dispatch_queue_t queue = dispatch_queue_create("com.tpmiddle.scrollframes", attributes);
+    _frameTimer = dispatch_source_create(DISPATCH_SOURCE_TYPE_TIMER, 0, DISPATCH_TIMER_STRICT, queue);
+    
+    __weak TPButtonManager *weakSelf = self;
+    dispatch_source_set_event_handler(_frameTimer, ^{
+        // The queue runs on whichever pool thread is free
+        TraceRecorder::SetThreadPooled();
+        [weakSelf emitDueScrollFrame];
+    });
+    dispatch_source_set_timer(_frameTimer, DISPATCH_TIME_FOREVER, DISPATCH_TIME_FOREVER, 0);
+    dispatch_resume(_frameTimer);
+}
+
 #pragma mark - Public Methods
 
-- (void)updateButtonStates:(BOOL)leftDown right:(BOOL)rightDown middle:(BOOL)middleDown {
+- (void)beginInputBatch {
+    // One pointer load while nothing changed
+    const InputConfig &config = _configReader->Get();
+    if (_configReader->GetVersion() == _appliedConfigVersion) return;
+    _appliedConfigVersion = _configReader->GetVersion();
+    
+    _activeProfiles = config.profiles;
+    _profiles.Configure(config.scroll, _activeProfiles.get(), config.application);
+    [self applyResolvedProfile];
+    _middleEmulator.SetChordWindow(config.chordWindowNs);
+    
+    std::lock_guard<std::mutex> lock(_scrollLock);
+    _scrollSynthesizer.SetFrameRate(config.scroll.frameRate);
+    _momentum.Configure(config.scroll.momentumFriction, (size_t)config.scroll.momentumSamples);
+}
+
+- (void)setFrontmostApplication:(NSString *)bundleIdentifier {
+    if ([bundleIdentifier isEqualToString:_frontmostApplication]) return;
+    _frontmostApplication = [bundleIdentifier copy];
+    [self publishInputConfig];
+}
+
+- (void)deviceAttached:(uint64_t)handle identity:(NSString *)identity name:(NSString *)name {
+    ProfileDevice device;
+    device.key = TPStdString(identity);
+    device.name = TPStdString(name);
+    _profiles.AttachDevice(handle, device);
+    [self applyResolvedProfile];
+}
+
+- (void)deviceDetached:(uint64_t)handle {
+    _profiles.DetachDevice(handle);
+    [self applyResolvedProfile];
+}
+
+- (void)setActiveDevice:(uint64_t)handle {
+    if (handle == _activeDevice) return;
+    _activeDevice = handle;
+    _scrollEngine.Configure(_profiles.ForDevice(handle));
+}
+
+- (void)updateButtonStates:(BOOL)leftDown right:(BOOL)rightDown middle:(BOOL)middleDown
+                 timestamp:(uint64_t)timestampNs {
+    [self cancelMomentum];
+    
     // Log button state
     [[TPLogger sharedLogger] logButtonEvent:leftDown right:rightDown middle:middleDown];
     
-    // Real middle button press takes precedence
-    if (middleDown != _middlePressed) {
-        _middlePressed = middleDown;
-        if (!_middlePressed) {
-            // Reset scroll state when middle button is released
-            _accumulatedDeltaX = 0;
-            _accumulatedDeltaY = 0;
-        }
-    }
+    // The chord window is measured between device samples, so a late wakeup
+    // of this thread cannot split or merge a chord
+    MiddleButtonActions actions = _middleEmulator.Update(timestampNs, leftDown, rightDown, middleDown);
+    [self applyMiddleButtonActions:actions at:timestampNs];
+}
+
+- (void)handleMovement:(int)deltaX deltaY:(int)deltaY withButtonState:(uint8_t)buttons
+             timestamp:(uint64_t)timestampNs {
+    TP_TRACE_SPAN("handleMovement:");
+    [self cancelMomentum];
+    if (!_middleEmulator.IsScrollActive()) return;
     
-    if (middleDown) {
-        if (!_middleEmulated) {
-            [self postMiddleButtonEvent:YES];
-            _middleEmulated = YES;
-        }
-        return;
-    }
+    // Velocity comes from the device's sample spacing; frame pacing follows
+    // the time the output is actually produced
+    ScrollOutput output = _scrollEngine.ProcessMovement(timestampNs, deltaX, deltaY);
+    if (!output.emit) return;
     
-    // Handle left button state change
-    if (leftDown != _leftDown) {
-        _leftDown = leftDown;
-        if (leftDown) {
-            _leftDownTime = [NSDate date];
-        }
+    // Fractions carry over; whole pixels go out at most once per frame
+    uint64_t now = MonotonicClock::SystemNanoseconds();
+    ScrollFrame frame;
+    {
+        std::lock_guard<std::mutex> lock(_scrollLock);
+        _momentum.AddSample(timestampNs, output.deltaX, output.deltaY);
+        frame = _scrollSynthesizer.Add(now, output.deltaX, output.deltaY, timestampNs);
+        [self armFrameTimerLocked:now];
     }
+    [self postScrollFrame:frame];
+}
+
+- (void)reset {
+    uint64_t now = MonotonicClock::SystemNanoseconds();
+    [self applyMiddleButtonActions:_middleEmulator.Reset() at:now];
     
-    // Handle right button state change
-    if (rightDown != _rightDown) {
-        _rightDown = rightDown;
-        if (rightDown) {
-            _rightDownTime = [NSDate date];
+    // Reset scroll state
+    _scrollEngine.Reset(now);
+    std::lock_guard<std::mutex> lock(_scrollLock);
+    _scrollSynthesizer.Reset();
+    _momentum.Reset();
+}
+
+- (BOOL)isMiddleButtonEmulated {
+    return _middleEmulator.IsMiddleEmulated();
+}
+
+- (BOOL)isMiddleButtonPressed {
+    return _middleEmulator.IsMiddlePressed();
+}
+
+#pragma mark - Private Methods
+
+- (void)applyMiddleButtonActions:(const MiddleButtonActions &)actions at:(uint64_t)timestampNs {
+    // Deliver scroll still waiting for a frame before the middle button goes up,
+    // then let the frame timer carry the drag on as momentum
+    if (actions.clearScroll) {
+        ScrollFrame frame;
+        {
+            std::lock_guard<std::mutex> lock(_scrollLock);
+            uint64_t now = MonotonicClock::SystemNanoseconds();
+            frame = _scrollSynthesizer.Flush(now);
+            if (_scrollEngine.GetSettings().momentum && _momentum.Start(timestampNs)) {
+                [self armFrameTimerLocked:now];
+            }
         }
+        [self postScrollFrame:frame];
+        _scrollEngine.ClearAccumulator();
     }
-    
-    // Check for middle button emulation
-    if (leftDown && rightDown && !_middleEmulated) {
-        NSTimeInterval timeDiff = fabs([_leftDownTime timeIntervalSinceDate:_rightDownTime]);
-        if (timeDiff <= [TPConfig sharedConfig].middleButtonDelay) {
-            [self postMiddleButtonEvent:YES];
-            _middleEmulated = YES;
-            _middlePressed = YES;
+    if (actions.postMiddleDown) {
+        if (_middleEmulator.IsMiddleEmulated()) {
+            LiveCounters::Shared().Add(LiveCounter::ChordDetections);
+            TP_TRACE_INSTANT("chord", 0);
         }
+        [self postMiddleButtonEvent:YES];
     }
-    
-    // Release emulated middle button when both buttons are released
-    if (!leftDown && !rightDown && _middleEmulated) {
+    if (actions.postMiddleUp) {
         [self postMiddleButtonEvent:NO];
-        _middleEmulated = NO;
-        _middlePressed = NO;
-        
-        // Reset scroll state
-        _accumulatedDeltaX = 0;
-        _accumulatedDeltaY = 0;
     }
 }
 
-- (void)handleMovement:(int)deltaX deltaY:(int)deltaY withButtonState:(uint8_t)buttons {
-    if (!_middlePressed && !_middleEmulated) return;
-    
-    TPConfig *config = [TPConfig sharedConfig];
+// Runs on the frame timer queue
+- (void)emitDueScrollFrame {
+    TP_TRACE_SPAN("emitDueScrollFrame");
+    ScrollFrame frame;
+    {
+        std::lock_guard<std::mutex> lock(_scrollLock);
+        uint64_t now = MonotonicClock::SystemNanoseconds();
+        _frameTimerArmed = NO;
+        // Coast has no input behind it, so its frames stay out of the latency histograms
+        ScrollOutput coast = _momentum.Advance(now);
+        frame = coast.emit ? _scrollSynthesizer.Add(now, coast.deltaX, coast.deltaY)
+                           : _scrollSynthesizer.Tick(now);
+        [self armFrameTimerLocked:now];
+    }
+    [self postScrollFrame:frame];
+}
+
+// One-shot wakeup at the next frame boundary while whole pixels are pending or
+// momentum is coasting; the one timer serves both
+- (void)armFrameTimerLocked:(uint64_t)now {
+    if (_frameTimerArmed) return;
     
-    // Calculate time since last scroll for acceleration
-    NSTimeInterval currentTime = [NSDate timeIntervalSinceReferenceDate];
-    NSTimeInterval timeDelta = currentTime - _lastScrollTime;
-    if (timeDelta > 0.1) timeDelta = 0.1; // Cap the time delta
-    
-    // Apply acceleration based on movement speed
-    CGFloat speed = sqrt(deltaX * deltaX + deltaY * deltaY);
-    CGFloat accelerationFactor = 1.0 + (speed * config.scrollAcceleration * timeDelta);
-    
-    // Apply direction adjustments
-    CGFloat adjustedDeltaX = deltaX * (config.invertScrollX ? -1 : 1);
-    CGFloat adjustedDeltaY = deltaY * (config.invertScrollY ? -1 : 1);
-    
-    // Accumulate movement with acceleration and speed multiplier
-    _accumulatedDeltaX += adjustedDeltaX * config.scrollSpeedMultiplier * accelerationFactor;
-    _accumulatedDeltaY += adjustedDeltaY * config.scrollSpeedMultiplier * accelerationFactor;
-    
-    // Only scroll if accumulated movement exceeds threshold
-    if (fabs(_accumulatedDeltaX) >= kMinMovementThreshold || 
-        fabs(_accumulatedDeltaY) >= kMinMovementThreshold) {
-        
-        // Cap scroll speed
-        CGFloat scrollX = MIN(MAX(_accumulatedDeltaX, -kMaxScrollSpeed), kMaxScrollSpeed);
-        CGFloat scrollY = MIN(MAX(_accumulatedDeltaY, -kMaxScrollSpeed), kMaxScrollSpeed);
-        
-        // Apply natural scrolling if enabled
-        if (config.naturalScrolling) {
-            scrollX = -scrollX;
-            scrollY = -scrollY;
+    uint64_t deadline;
+    if (_momentum.IsActive()) {
+        deadline = std::max(_momentum.GetNextStepTime(), _scrollSynthesizer.GetNextFrameTime());
+    } else if (_scrollSynthesizer.HasPending()) {
+        deadline = _scrollSynthesizer.GetNextFrameTime();
+    } else {
+        return;
+    }
+    int64_t delay = deadline > now ? (int64_t)(deadline - now) : 0;
+    dispatch_source_set_timer(_frameTimer, dispatch_time(DISPATCH_TIME_NOW, delay),
+                              DISPATCH_TIME_FOREVER, kFrameTimerLeewayNs);
+    _frameTimerArmed = YES;
+}
+
+- (void)observeValueForKeyPath:(NSString *)keyPath
+                      ofObject:(id)object
+                        change:(NSDictionary<NSKeyValueChangeKey, id> *)change
+                       context:(void *)context {
+    if (context == kInputConfigContext) {
+        // A reload changes many keys at once; publish once when it ends
+        if (![TPConfig sharedConfig].isReloading) {
+            [self publishInputConfig];
         }
-        
-        // Create and post scroll event
-        [self postScrollEvent:scrollY deltaX:scrollX];
-        
-        // Reset accumulated deltas
-        _accumulatedDeltaX = 0;
-        _accumulatedDeltaY = 0;
-        _lastScrollTime = currentTime;
+    } else {
+        [super observeValueForKeyPath:keyPath ofObject:object change:change context:context];
     }
 }
 
-- (void)reset {
-    _leftDown = NO;
-    _rightDown = NO;
-    if (_middleEmulated) {
-        [self postMiddleButtonEvent:NO];
-        _middleEmulated = NO;
+// Runs on the main thread, where TPConfig changes and applications activate
+- (void)publishInputConfig {
+    TPConfig *config = [TPConfig sharedConfig];
+    InputConfig compiled;
+    ScrollSettings &settings = compiled.scroll;
+    settings.speedMultiplier = config.scrollSpeedMultiplier;
+    settings.acceleration = config.scrollAcceleration;
+    settings.naturalScrolling = config.naturalScrolling;
+    settings.invertX = config.invertScrollX;
+    settings.invertY = config.invertScrollY;
+    settings.minMovementThreshold = config.minMovementThreshold;
+    settings.maxScrollSpeed = config.maxScrollSpeed;
+    settings.frameRate = (double)config.scrollFrameRate;
+    settings.momentum = config.momentumScrolling;
+    settings.momentumFriction = config.momentumFriction;
+    
+    // The curve table is rebuilt only when the curve text changes
+    if (![config.accelerationCurve isEqualToString:_compiledCurveSource]) {
+        auto curve = std::make_shared<AccelerationCurve>();
+        if (!curve->Parse(TPStdString(config.accelerationCurve))) {
+            DebugLog(@"Ignoring acceleration curve: %s", curve->GetLastError().c_str());
+            curve.reset();
+        }
+        _compiledCurveSource = [config.accelerationCurve copy];
+        _compiledCurve = curve;
     }
-    _middlePressed = NO;
-    _leftDownTime = nil;
-    _rightDownTime = nil;
+    settings.accelerationCurve = _compiledCurve;
+    compiled.chordWindowNs = (uint64_t)(config.middleButtonDelay * NSEC_PER_SEC);
+    compiled.application = TPStdString(_frontmostApplication);
     
-    // Reset scroll state
-    _accumulatedDeltaX = 0;
-    _accumulatedDeltaY = 0;
-    _lastScrollTime = [NSDate timeIntervalSinceReferenceDate];
+    // Profiles are rebuilt only when TPConfig hands out a new array
+    if (config.scrollProfiles != _compiledProfileSource) {
+        std::vector<ScrollProfile> profiles;
+        for (NSDictionary *entry in config.scrollProfiles) {
+            if ([entry isKindOfClass:[NSDictionary class]]) {
+                profiles.push_back(TPScrollProfileFromDictionary(entry));
+            }
+        }
+        _compiledProfileSource = config.scrollProfiles;
+        _compiledProfiles = std::make_shared<const ProfileStore>(std::move(profiles));
+    }
+    compiled.profiles = _compiledProfiles;
+    _config.Publish(compiled);
 }
 
-- (BOOL)isMiddleButtonEmulated {
-    return _middleEmulated;
+- (void)applyResolvedProfile {
+    if (_profiles.GetGeneration() == _appliedProfileGeneration) return;
+    _appliedProfileGeneration = _profiles.GetGeneration();
+    _scrollEngine.Configure(_profiles.ForDevice(_activeDevice));
 }
 
-- (BOOL)isMiddleButtonPressed {
-    return _middlePressed;
+// Any new input ends the coast; a stale timer wakeup then finds nothing to do
+- (void)cancelMomentum {
+    std::lock_guard<std::mutex> lock(_scrollLock);
+    _momentum.Cancel();
 }
 
-#pragma mark - Private Methods
-
 - (void)postMiddleButtonEvent:(BOOL)isDown {
+    TP_TRACE_SPAN("postMiddleButtonEvent:");
     CGEventRef event = CGEventCreate(NULL);
     CGPoint pos = CGEventGetLocation(event);
     CFRelease(event);
@@ -195,10 +424,13 @@ const CGFloat kMaxScrollSpeed = 50.0;        // Maximum scroll speed cap
     );
     
     CGEventPost(kCGHIDEventTap, mouseEvent);
+    LatencyMonitor::Shared().RecordOutput(MonotonicClock::SystemNanoseconds());
+    LiveCounters::Shared().Add(LiveCounter::MiddleButtonEvents);
     CFRelease(mouseEvent);
     
     // Log middle button emulation
-    [[TPLogger sharedLogger] logMiddleButtonEmulation:isDown];
+    [[TPLogger sharedLogger] logMiddleButtonEmulation:isDown
+                                                 delay:_middleEmulator.GetChordWindow() / (double)NSEC_PER_SEC];
     
     // Notify delegate
     if ([self.delegate respondsToSelector:@selector(middleButtonStateChanged:)]) {
@@ -211,25 +443,32 @@ const CGFloat kMaxScrollSpeed = 50.0;        // Maximum scroll speed cap
     }
 }
 
-- (void)postScrollEvent:(CGFloat)deltaY deltaX:(CGFloat)deltaX {
+- (void)postScrollFrame:(const ScrollFrame &)frame {
+    if (!frame.emit) return;
+    TP_TRACE_SPAN("postScrollFrame:");
+    
     // Create scroll event (using pixel units for smoother scrolling)
     CGEventRef scrollEvent = CGEventCreateScrollWheelEvent(
         NULL,
         kCGScrollEventUnitPixel,
         2,  // number of axes
-        (int32_t)deltaY,
-        (int32_t)deltaX
+        frame.deltaY,
+        frame.deltaX
     );
     
     // Post the event
     CGEventPost(kCGHIDEventTap, scrollEvent);
+    LatencyMonitor::Shared().RecordFrameOutput(frame.sourceTimestamp, MonotonicClock::SystemNanoseconds());
+    TelemetryTap::Shared().RecordScroll(frame.deltaX, frame.deltaY);
+    // Also posted from the frame timer queue; Add() is safe from any thread
+    LiveCounters::Shared().Add(LiveCounter::ScrollEvents);
     CFRelease(scrollEvent);
     
     // Log scroll event
-    [[TPLogger sharedLogger] logScrollEvent:deltaX deltaY:deltaY];
+    [[TPLogger sharedLogger] logScrollEvent:frame.deltaX deltaY:frame.deltaY];
     
     if ([TPConfig sharedConfig].debugMode) {
-        DebugLog(@"Posted scroll event - deltaX: %.2f, deltaY: %.2f", deltaX, deltaY);
+        DebugLog(@"Posted scroll event - deltaX: %d, deltaY: %d", frame.deltaX, frame.deltaY);
     }
 }
 
@@ -12,26 +12,66 @@ typedef NS_ENUM(NSInteger, TPOperationMode) {
 @property (nonatomic) TPOperationMode operationMode;
 @property (nonatomic) BOOL debugMode;
 @property (nonatomic) NSTimeInterval middleButtonDelay;
+@property (nonatomic) BOOL binaryLogging;
+@property (nonatomic, copy) NSString *traceCapturePath;    // Not persisted; set by --record-trace=<path>
+@property (nonatomic, copy) NSString *pipelineTracePath;   // Not persisted; set by --chrome-trace=<path>
+@property (nonatomic, copy) NSString *configFilePath;      // Property list with user defaults keys; set by --config=<path>
+@property (nonatomic, readonly, getter=isReloading) BOOL reloading;  // YES while reloadSettings applies its layers
 
 // Scroll settings
 @property (nonatomic) CGFloat scrollSpeedMultiplier;
 @property (nonatomic) CGFloat scrollAcceleration;
+@property (nonatomic, copy) NSString *accelerationCurve;    // "linear", "power:<e>", "points:<s>,<v>;..." or "bezier:<x1>,<y1>;<x2>,<y2>;<x3>,<y3>"
+@property (nonatomic) CGFloat maxScrollSpeed;              // Largest scroll delta per event, 0 = uncapped
+@property (nonatomic) CGFloat minMovementThreshold;        // Accumulated movement needed before a scroll event
 @property (nonatomic) BOOL naturalScrolling;
 @property (nonatomic) BOOL invertScrollX;
 @property (nonatomic) BOOL invertScrollY;
+@property (nonatomic) NSInteger scrollFrameRate;           // Scroll events per second at most, 0 = unpaced
+@property (nonatomic) BOOL momentumScrolling;
+@property (nonatomic) CGFloat momentumFriction;            // Momentum decay per second, larger stops sooner
+
+// Per-application and per-device overrides, most specific wins. Each entry may
+// hold Application (bundle identifier), Device ("vendor:product" in hex, or the
+// product name) and any of the scroll keys below.
+@property (nonatomic, copy) NSArray<NSDictionary<NSString *, id> *> *scrollProfiles;
 
 // Singleton access
 + (instancetype)sharedConfig;
 
-// Configuration management
+// Configuration management. saveToDefaults stores only the values changed since
+// the last load, i.e. those picked in the UI.
 - (void)loadFromDefaults;
 - (void)saveToDefaults;
 - (void)applyCommandLineArguments:(NSArray<NSString *>*)arguments;
 - (void)resetToDefaults;
 
+// Settings in the config file override stored defaults; the command line overrides both.
+// File and command line values are an overlay and are never written to the defaults.
+// While watched, edits to the file are applied live and reach the input thread
+// through the TPButtonManager config snapshot.
+- (BOOL)reloadSettings;
+- (BOOL)loadFromFile:(NSString *)path;
+- (void)startWatchingConfigFile;
+- (void)stopWatchingConfigFile;
+
 @end
 
+// Scroll profile entry keys; the scroll keys match the stored settings
+extern NSString* const kScrollProfileKeyApplication;
+extern NSString* const kScrollProfileKeyDevice;
+extern NSString* const kScrollProfileKeySpeedMultiplier;
+extern NSString* const kScrollProfileKeyAcceleration;
+extern NSString* const kScrollProfileKeyNaturalScrolling;
+extern NSString* const kScrollProfileKeyInvertX;
+extern NSString* const kScrollProfileKeyInvertY;
+
 // Default values
 extern const CGFloat kDefaultScrollSpeedMultiplier;
 extern const CGFloat kDefaultScrollAcceleration;
+extern NSString* const kDefaultAccelerationCurve;
+extern const CGFloat kDefaultMaxScrollSpeed;
+extern const CGFloat kDefaultMinMovementThreshold;
+extern const NSInteger kDefaultScrollFrameRate;
+extern const CGFloat kDefaultMomentumFriction;
 extern const NSTimeInterval kDefaultMiddleButtonDelay;
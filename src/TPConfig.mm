@@ -1,4 +1,6 @@
 #import "TPConfig.h"
+#include <fcntl.h>
+#include <unistd.h>
 
 #ifdef DEBUG
 #define DebugLog(format, ...) NSLog(@"%s: " format, __FUNCTION__, ##__VA_ARGS__)
@@ -9,17 +11,49 @@
 // Default values
 const CGFloat kDefaultScrollSpeedMultiplier = 0.5;
 const CGFloat kDefaultScrollAcceleration = 1.2;
+NSString* const kDefaultAccelerationCurve = @"linear";
+const CGFloat kDefaultMaxScrollSpeed = 50.0;
+const CGFloat kDefaultMinMovementThreshold = 1.0;
+const NSInteger kDefaultScrollFrameRate = 60;
+const CGFloat kDefaultMomentumFriction = 3.0;
 const NSTimeInterval kDefaultMiddleButtonDelay = 0.02;
 
 // User defaults keys
 static NSString* const kDefaultsKeyNormalMode = @"NormalMode";
 static NSString* const kDefaultsKeyDebugMode = @"DebugMode";
 static NSString* const kDefaultsKeyMiddleButtonDelay = @"MiddleButtonDelay";
+static NSString* const kDefaultsKeyBinaryLogging = @"BinaryLogging";
 static NSString* const kDefaultsKeyScrollSpeedMultiplier = @"ScrollSpeedMultiplier";
 static NSString* const kDefaultsKeyScrollAcceleration = @"ScrollAcceleration";
+static NSString* const kDefaultsKeyAccelerationCurve = @"AccelerationCurve";
+static NSString* const kDefaultsKeyMaxScrollSpeed = @"MaxScrollSpeed";
+static NSString* const kDefaultsKeyMinMovementThreshold = @"MinMovementThreshold";
 static NSString* const kDefaultsKeyNaturalScrolling = @"NaturalScrolling";
 static NSString* const kDefaultsKeyInvertScrollX = @"InvertScrollX";
 static NSString* const kDefaultsKeyInvertScrollY = @"InvertScrollY";
+static NSString* const kDefaultsKeyScrollFrameRate = @"ScrollFrameRate";
+static NSString* const kDefaultsKeyMomentumScrolling = @"MomentumScrolling";
+static NSString* const kDefaultsKeyMomentumFriction = @"MomentumFriction";
+static NSString* const kDefaultsKeyScrollProfiles = @"ScrollProfiles";
+
+NSString* const kScrollProfileKeyApplication = @"Application";
+NSString* const kScrollProfileKeyDevice = @"Device";
+NSString* const kScrollProfileKeySpeedMultiplier = @"ScrollSpeedMultiplier";
+NSString* const kScrollProfileKeyAcceleration = @"ScrollAcceleration";
+NSString* const kScrollProfileKeyNaturalScrolling = @"NaturalScrolling";
+NSString* const kScrollProfileKeyInvertX = @"InvertScrollX";
+NSString* const kScrollProfileKeyInvertY = @"InvertScrollY";
+
+static NSString* const kConfigFileRelativePath = @"Library/Application Support/TPMiddle/Config.plist";
+static const int64_t kConfigFileRewatchDelayNs = 100 * NSEC_PER_MSEC;
+
+@interface TPConfig () {
+    dispatch_source_t _fileWatcher;
+    NSMutableDictionary<NSString *, id> *_commandLineSettings;   // Overlay, never persisted
+    NSDictionary<NSString *, id> *_loadedSettings;               // Values as last loaded, to spot UI changes
+}
+@property (nonatomic, readwrite, getter=isReloading) BOOL reloading;
+@end
 
 @implementation TPConfig
 
@@ -34,102 +68,283 @@ static NSString* const kDefaultsKeyInvertScrollY = @"InvertScrollY";
 
 - (instancetype)init {
     if (self = [super init]) {
-        [self resetToDefaults];
-        [self loadFromDefaults];
+        _configFilePath = [NSHomeDirectory() stringByAppendingPathComponent:kConfigFileRelativePath];
+        _commandLineSettings = [NSMutableDictionary dictionary];
+        [self reloadSettings];
     }
     return self;
 }
 
+- (void)dealloc {
+    [self stopWatchingConfigFile];
+}
+
 - (void)resetToDefaults {
     _operationMode = TPOperationModeDefault;
     _debugMode = NO;
     _middleButtonDelay = kDefaultMiddleButtonDelay;
+    _binaryLogging = NO;
     
     // Scroll settings
     _scrollSpeedMultiplier = kDefaultScrollSpeedMultiplier;
     _scrollAcceleration = kDefaultScrollAcceleration;
+    _accelerationCurve = kDefaultAccelerationCurve;
+    _maxScrollSpeed = kDefaultMaxScrollSpeed;
+    _minMovementThreshold = kDefaultMinMovementThreshold;
     _naturalScrolling = YES;  // Default to natural scrolling like modern macOS
     _invertScrollX = NO;
     _invertScrollY = NO;
+    _scrollFrameRate = kDefaultScrollFrameRate;
+    _momentumScrolling = NO;
+    _momentumFriction = kDefaultMomentumFriction;
+    _scrollProfiles = @[];
 }
 
 - (void)loadFromDefaults {
-    NSUserDefaults *defaults = [NSUserDefaults standardUserDefaults];
-    
+    [self applySettingsFromDictionary:[[NSUserDefaults standardUserDefaults] dictionaryRepresentation]];
+}
+
+// Keys are the user defaults keys; anything missing keeps its current value
+- (void)applySettingsFromDictionary:(NSDictionary<NSString *, id> *)settings {
     // Basic settings
-    if ([defaults objectForKey:kDefaultsKeyNormalMode]) {
-        self.operationMode = [defaults boolForKey:kDefaultsKeyNormalMode] ? 
+    if (settings[kDefaultsKeyNormalMode]) {
+        self.operationMode = [settings[kDefaultsKeyNormalMode] boolValue] ? 
             TPOperationModeNormal : TPOperationModeDefault;
     }
     
-    if ([defaults objectForKey:kDefaultsKeyDebugMode]) {
-        self.debugMode = [defaults boolForKey:kDefaultsKeyDebugMode];
+    if (settings[kDefaultsKeyDebugMode]) {
+        self.debugMode = [settings[kDefaultsKeyDebugMode] boolValue];
     }
     
-    if ([defaults objectForKey:kDefaultsKeyMiddleButtonDelay]) {
-        self.middleButtonDelay = [defaults doubleForKey:kDefaultsKeyMiddleButtonDelay];
+    if (settings[kDefaultsKeyMiddleButtonDelay]) {
+        self.middleButtonDelay = [settings[kDefaultsKeyMiddleButtonDelay] doubleValue];
+    }
+    
+    if (settings[kDefaultsKeyBinaryLogging]) {
+        self.binaryLogging = [settings[kDefaultsKeyBinaryLogging] boolValue];
     }
     
     // Scroll settings
-    if ([defaults objectForKey:kDefaultsKeyScrollSpeedMultiplier]) {
-        self.scrollSpeedMultiplier = [defaults doubleForKey:kDefaultsKeyScrollSpeedMultiplier];
+    if (settings[kDefaultsKeyScrollSpeedMultiplier]) {
+        self.scrollSpeedMultiplier = [settings[kDefaultsKeyScrollSpeedMultiplier] doubleValue];
+    }
+    
+    if (settings[kDefaultsKeyScrollAcceleration]) {
+        self.scrollAcceleration = [settings[kDefaultsKeyScrollAcceleration] doubleValue];
     }
     
-    if ([defaults objectForKey:kDefaultsKeyScrollAcceleration]) {
-        self.scrollAcceleration = [defaults doubleForKey:kDefaultsKeyScrollAcceleration];
+    if ([settings[kDefaultsKeyAccelerationCurve] isKindOfClass:[NSString class]]) {
+        self.accelerationCurve = settings[kDefaultsKeyAccelerationCurve];
     }
     
-    if ([defaults objectForKey:kDefaultsKeyNaturalScrolling]) {
-        self.naturalScrolling = [defaults boolForKey:kDefaultsKeyNaturalScrolling];
+    if (settings[kDefaultsKeyMaxScrollSpeed]) {
+        self.maxScrollSpeed = MAX(0.0, [settings[kDefaultsKeyMaxScrollSpeed] doubleValue]);
     }
     
-    if ([defaults objectForKey:kDefaultsKeyInvertScrollX]) {
-        self.invertScrollX = [defaults boolForKey:kDefaultsKeyInvertScrollX];
+    if (settings[kDefaultsKeyMinMovementThreshold]) {
+        self.minMovementThreshold = MAX(0.0, [settings[kDefaultsKeyMinMovementThreshold] doubleValue]);
     }
     
-    if ([defaults objectForKey:kDefaultsKeyInvertScrollY]) {
-        self.invertScrollY = [defaults boolForKey:kDefaultsKeyInvertScrollY];
+    if (settings[kDefaultsKeyNaturalScrolling]) {
+        self.naturalScrolling = [settings[kDefaultsKeyNaturalScrolling] boolValue];
+    }
+    
+    if (settings[kDefaultsKeyInvertScrollX]) {
+        self.invertScrollX = [settings[kDefaultsKeyInvertScrollX] boolValue];
+    }
+    
+    if (settings[kDefaultsKeyInvertScrollY]) {
+        self.invertScrollY = [settings[kDefaultsKeyInvertScrollY] boolValue];
+    }
+    
+    if (settings[kDefaultsKeyScrollFrameRate]) {
+        self.scrollFrameRate = MAX(0, [settings[kDefaultsKeyScrollFrameRate] integerValue]);
+    }
+    
+    if (settings[kDefaultsKeyMomentumScrolling]) {
+        self.momentumScrolling = [settings[kDefaultsKeyMomentumScrolling] boolValue];
+    }
+    
+    if (settings[kDefaultsKeyMomentumFriction]) {
+        self.momentumFriction = [settings[kDefaultsKeyMomentumFriction] doubleValue];
+    }
+    
+    if ([settings[kDefaultsKeyScrollProfiles] isKindOfClass:[NSArray class]]) {
+        self.scrollProfiles = settings[kDefaultsKeyScrollProfiles];
     }
 }
 
+// Stored defaults, then the config file, then the command line; a key dropped
+// from the file falls back to the layer below it. Observers can skip the
+// per-key notifications while reloading is YES and act once when it clears.
+- (BOOL)reloadSettings {
+    self.reloading = YES;
+    [self resetToDefaults];
+    [self loadFromDefaults];
+    BOOL loaded = [self loadFromFile:self.configFilePath];
+    [self applySettingsFromDictionary:_commandLineSettings];
+    _loadedSettings = [self currentSettings];
+    self.reloading = NO;
+    return loaded;
+}
+
+- (NSDictionary<NSString *, id> *)currentSettings {
+    return @{
+        kDefaultsKeyNormalMode: @(self.operationMode == TPOperationModeNormal),
+        kDefaultsKeyDebugMode: @(self.debugMode),
+        kDefaultsKeyMiddleButtonDelay: @(self.middleButtonDelay),
+        kDefaultsKeyBinaryLogging: @(self.binaryLogging),
+        kDefaultsKeyScrollSpeedMultiplier: @(self.scrollSpeedMultiplier),
+        kDefaultsKeyScrollAcceleration: @(self.scrollAcceleration),
+        kDefaultsKeyAccelerationCurve: self.accelerationCurve ?: kDefaultAccelerationCurve,
+        kDefaultsKeyMaxScrollSpeed: @(self.maxScrollSpeed),
+        kDefaultsKeyMinMovementThreshold: @(self.minMovementThreshold),
+        kDefaultsKeyNaturalScrolling: @(self.naturalScrolling),
+        kDefaultsKeyInvertScrollX: @(self.invertScrollX),
+        kDefaultsKeyInvertScrollY: @(self.invertScrollY),
+        kDefaultsKeyScrollFrameRate: @(self.scrollFrameRate),
+        kDefaultsKeyMomentumScrolling: @(self.momentumScrolling),
+        kDefaultsKeyMomentumFriction: @(self.momentumFriction),
+        kDefaultsKeyScrollProfiles: self.scrollProfiles ?: @[],
+    };
+}
+
+- (BOOL)loadFromFile:(NSString *)path {
+    NSDictionary *settings = [NSDictionary dictionaryWithContentsOfFile:path];
+    if (!settings) {
+        DebugLog(@"No readable config file at %@", path);
+        return NO;
+    }
+    [self applySettingsFromDictionary:settings];
+    return YES;
+}
+
+#pragma mark - Config File Watching
+
+- (void)startWatchingConfigFile {
+    [self stopWatchingConfigFile];
+    
+    int fd = open(self.configFilePath.fileSystemRepresentation, O_EVTONLY);
+    if (fd < 0) {
+        DebugLog(@"Config file %@ not found, not watching", self.configFilePath);
+        return;
+    }
+    
+    _fileWatcher = dispatch_source_create(DISPATCH_SOURCE_TYPE_VNODE, fd,
+                                          DISPATCH_VNODE_WRITE | DISPATCH_VNODE_EXTEND |
+                                          DISPATCH_VNODE_DELETE | DISPATCH_VNODE_RENAME,
+                                          dispatch_get_main_queue());
+    __weak TPConfig *weakSelf = self;
+    dispatch_source_set_event_handler(_fileWatcher, ^{
+        [weakSelf configFileChanged];
+    });
+    dispatch_source_set_cancel_handler(_fileWatcher, ^{
+        close(fd);
+    });
+    dispatch_resume(_fileWatcher);
+    DebugLog(@"Watching config file %@", self.configFilePath);
+}
+
+- (void)stopWatchingConfigFile {
+    if (_fileWatcher) {
+        dispatch_source_cancel(_fileWatcher);
+        _fileWatcher = nil;
+    }
+}
+
+- (void)configFileChanged {
+    unsigned long flags = dispatch_source_get_data(_fileWatcher);
+    
+    // Editors usually save by replacing the file, which ends this watch;
+    // give the new file a moment to appear and follow the path to it
+    if (flags & (DISPATCH_VNODE_DELETE | DISPATCH_VNODE_RENAME)) {
+        [self stopWatchingConfigFile];
+        __weak TPConfig *weakSelf = self;
+        dispatch_after(dispatch_time(DISPATCH_TIME_NOW, kConfigFileRewatchDelayNs), dispatch_get_main_queue(), ^{
+            [weakSelf reloadSettings];
+            [weakSelf startWatchingConfigFile];
+        });
+        return;
+    }
+    
+    if ([self reloadSettings]) {
+        DebugLog(@"Reloaded config file %@", self.configFilePath);
+    }
+}
+
+// Only values changed since the last load are written, so config file and
+// command line values stay an overlay rather than becoming stored defaults
 - (void)saveToDefaults {
     NSUserDefaults *defaults = [NSUserDefaults standardUserDefaults];
+    NSDictionary<NSString *, id> *settings = [self currentSettings];
     
-    // Basic settings
-    [defaults setBool:(self.operationMode == TPOperationModeNormal) forKey:kDefaultsKeyNormalMode];
-    [defaults setBool:self.debugMode forKey:kDefaultsKeyDebugMode];
-    [defaults setDouble:self.middleButtonDelay forKey:kDefaultsKeyMiddleButtonDelay];
-    
-    // Scroll settings
-    [defaults setDouble:self.scrollSpeedMultiplier forKey:kDefaultsKeyScrollSpeedMultiplier];
-    [defaults setDouble:self.scrollAcceleration forKey:kDefaultsKeyScrollAcceleration];
-    [defaults setBool:self.naturalScrolling forKey:kDefaultsKeyNaturalScrolling];
-    [defaults setBool:self.invertScrollX forKey:kDefaultsKeyInvertScrollX];
-    [defaults setBool:self.invertScrollY forKey:kDefaultsKeyInvertScrollY];
+    for (NSString *key in settings) {
+        if ([settings[key] isEqual:_loadedSettings[key]]) continue;
+        [defaults setObject:settings[key] forKey:key];
+        // A value picked in the UI outlives the flag that set it at launch
+        [_commandLineSettings removeObjectForKey:key];
+    }
+    _loadedSettings = settings;
     
     [defaults synchronize];
 }
 
 - (void)applyCommandLineArguments:(NSArray<NSString *>*)arguments {
+    // An explicit config file is read first so the other flags override it
+    for (NSString *arg in arguments) {
+        if ([arg hasPrefix:@"--config="]) {
+            self.configFilePath = [[arg substringFromIndex:@"--config=".length] stringByExpandingTildeInPath];
+            DebugLog(@"Config file %@ selected via command line", self.configFilePath);
+        }
+    }
+    
+    NSMutableDictionary<NSString *, id> *settings = _commandLineSettings;
     for (NSString *arg in arguments) {
         if ([arg isEqualToString:@"-n"] || [arg isEqualToString:@"--normal"]) {
-            self.operationMode = TPOperationModeNormal;
+            settings[kDefaultsKeyNormalMode] = @YES;
             DebugLog(@"Normal mode enabled via command line");
         } else if ([arg isEqualToString:@"-r"] || [arg isEqualToString:@"--reset"]) {
-            self.operationMode = TPOperationModeDefault;
+            settings[kDefaultsKeyNormalMode] = @NO;
             DebugLog(@"Reset to default mode via command line");
         } else if ([arg isEqualToString:@"-d"] || [arg isEqualToString:@"--debug"]) {
-            self.debugMode = YES;
+            settings[kDefaultsKeyDebugMode] = @YES;
             DebugLog(@"Debug mode enabled via command line");
+        } else if ([arg isEqualToString:@"--binary-log"]) {
+            settings[kDefaultsKeyBinaryLogging] = @YES;
+            DebugLog(@"Binary event logging enabled via command line");
+        } else if ([arg isEqualToString:@"--text-log"]) {
+            settings[kDefaultsKeyBinaryLogging] = @NO;
+            DebugLog(@"Text event logging enabled via command line");
+        } else if ([arg hasPrefix:@"--record-trace="]) {
+            self.traceCapturePath = [[arg substringFromIndex:@"--record-trace=".length] stringByExpandingTildeInPath];
+            DebugLog(@"Input trace capture to %@ enabled via command line", self.traceCapturePath);
+        } else if ([arg hasPrefix:@"--chrome-trace="]) {
+            self.pipelineTracePath = [[arg substringFromIndex:@"--chrome-trace=".length] stringByExpandingTildeInPath];
+            DebugLog(@"Pipeline tracing to %@ enabled via command line", self.pipelineTracePath);
         } else if ([arg isEqualToString:@"--natural-scroll"]) {
-            self.naturalScrolling = YES;
+            settings[kDefaultsKeyNaturalScrolling] = @YES;
             DebugLog(@"Natural scrolling enabled via command line");
         } else if ([arg isEqualToString:@"--reverse-scroll"]) {
-            self.naturalScrolling = NO;
+            settings[kDefaultsKeyNaturalScrolling] = @NO;
             DebugLog(@"Natural scrolling disabled via command line");
+        } else if ([arg hasPrefix:@"--acceleration-curve="]) {
+            settings[kDefaultsKeyAccelerationCurve] = [arg substringFromIndex:@"--acceleration-curve=".length];
+            DebugLog(@"Acceleration curve set to %@ via command line", settings[kDefaultsKeyAccelerationCurve]);
+        } else if ([arg hasPrefix:@"--scroll-rate="]) {
+            settings[kDefaultsKeyScrollFrameRate] = @([[arg substringFromIndex:@"--scroll-rate=".length] integerValue]);
+            DebugLog(@"Scroll frame rate set to %@ Hz via command line", settings[kDefaultsKeyScrollFrameRate]);
+        } else if ([arg isEqualToString:@"--momentum"]) {
+            settings[kDefaultsKeyMomentumScrolling] = @YES;
+            DebugLog(@"Momentum scrolling enabled via command line");
+        } else if ([arg isEqualToString:@"--no-momentum"]) {
+            settings[kDefaultsKeyMomentumScrolling] = @NO;
+            DebugLog(@"Momentum scrolling disabled via command line");
+        } else if ([arg hasPrefix:@"--momentum-friction="]) {
+            settings[kDefaultsKeyMomentumFriction] = @([[arg substringFromIndex:@"--momentum-friction=".length] doubleValue]);
+            DebugLog(@"Momentum friction set to %@ via command line", settings[kDefaultsKeyMomentumFriction]);
         }
     }
-    [self saveToDefaults];
+    [self reloadSettings];
 }
 
 @end
@@ -1,9 +1,39 @@
 #import "TPEventViewController.h"
 #import "TPConfig.h"
 #import "TPApplication.h"
+#import <QuartzCore/QuartzCore.h>
+#include "application/services/TelemetryTap.h"
+#include "application/services/TraceRecorder.h"
+#include "domain/models/HIDUsage.h"
+#include "utils/MonotonicClock.h"
+#include <atomic>
+
+using TPMiddle::Application::TelemetryFrame;
+using TPMiddle::Application::TelemetryTap;
+using TPMiddle::Domain::kButtonMaskLeft;
+using TPMiddle::Domain::kButtonMaskMiddle;
+using TPMiddle::Domain::kButtonMaskRight;
+using TPMiddle::Utils::MonotonicClock;
+
+@interface TPEventViewController ()
+- (void)scheduleRefresh;
+@end
+
+static CVReturn TPEventViewerDisplayLinkCallback(CVDisplayLinkRef displayLink,
+                                                 const CVTimeStamp *now,
+                                                 const CVTimeStamp *outputTime,
+                                                 CVOptionFlags flagsIn,
+                                                 CVOptionFlags *flagsOut,
+                                                 void *context) {
+    [(__bridge TPEventViewController *)context scheduleRefresh];
+    return kCVReturnSuccess;
+}
 
 @interface TPEventViewController () {
     NSView *_centerIndicator;
+    CAShapeLayer *_trailLayer;
+    CVDisplayLinkRef _displayLink;
+    std::atomic<bool> _refreshPending;
     NSPoint _lastPoint;
     CGFloat _accumulatedScrollX;
     CGFloat _accumulatedScrollY;
@@ -31,6 +61,13 @@
     _centerIndicator.layer.cornerRadius = 4.0;
     [self.movementView addSubview:_centerIndicator];
     
+    // Recent movement drawn behind the indicator
+    _trailLayer = [CAShapeLayer layer];
+    _trailLayer.fillColor = NULL;
+    _trailLayer.strokeColor = [[NSColor systemBlueColor] colorWithAlphaComponent:0.4].CGColor;
+    _trailLayer.lineWidth = 1.5;
+    [self.movementView.layer insertSublayer:_trailLayer atIndex:0];
+    
     // Center the indicator
     [self centerIndicator];
     
@@ -60,93 +97,120 @@
 }
 
 - (void)startMonitoring {
-    // Register for notifications instead of setting delegates directly
-    [[NSNotificationCenter defaultCenter] addObserver:self
-                                           selector:@selector(handleMovementNotification:)
-                                               name:@"TPMovementNotification"
-                                             object:nil];
-    [[NSNotificationCenter defaultCenter] addObserver:self
-                                           selector:@selector(handleButtonNotification:)
-                                               name:@"TPButtonNotification"
-                                             object:nil];
+    // The viewer pulls aggregated telemetry once per display refresh instead of
+    // receiving a notification per input event
+    TelemetryTap::Shared().Attach(MonotonicClock::SystemNanoseconds());
+    if (!_displayLink) {
+        CVDisplayLinkCreateWithActiveCGDisplays(&_displayLink);
+        CVDisplayLinkSetOutputCallback(_displayLink, TPEventViewerDisplayLinkCallback, (__bridge void *)self);
+    }
+    CVDisplayLinkStart(_displayLink);
 }
 
 - (void)stopMonitoring {
-    [[NSNotificationCenter defaultCenter] removeObserver:self];
+    if (_displayLink) {
+        CVDisplayLinkStop(_displayLink);
+    }
+    TelemetryTap::Shared().Detach();
     [self centerIndicator];
+    _trailLayer.path = NULL;
+}
+
+- (void)dealloc {
+    if (_displayLink) {
+        CVDisplayLinkStop(_displayLink);
+        CVDisplayLinkRelease(_displayLink);
+    }
 }
 
-#pragma mark - Notification Handlers
+#pragma mark - Telemetry
 
-- (void)handleMovementNotification:(NSNotification *)notification {
-    NSDictionary *info = notification.userInfo;
-    int deltaX = [info[@"deltaX"] intValue];
-    int deltaY = [info[@"deltaY"] intValue];
-    uint8_t buttons = [info[@"buttons"] unsignedCharValue];
+// Runs on the display link thread
+- (void)scheduleRefresh {
+    // Skip a refresh rather than queue them up behind a busy main thread
+    if (_refreshPending.exchange(true)) return;
+    
+    __weak TPEventViewController *weakSelf = self;
+    dispatch_async(dispatch_get_main_queue(), ^{
+        [weakSelf refreshFromTelemetry];
+    });
+}
+
+- (void)refreshFromTelemetry {
+    TP_TRACE_SPAN("refreshFromTelemetry");
+    _refreshPending.store(false);
+    TelemetryTap &tap = TelemetryTap::Shared();
+    if (!tap.IsAttached()) return;
+    
+    const TelemetryFrame &frame = tap.Pull(MonotonicClock::SystemNanoseconds());
+    
+    self.leftButton.state = (frame.buttons & kButtonMaskLeft) ? NSControlStateValueOn : NSControlStateValueOff;
+    self.rightButton.state = (frame.buttons & kButtonMaskRight) ? NSControlStateValueOn : NSControlStateValueOff;
+    self.middleButton.state = (frame.buttons & kButtonMaskMiddle) ? NSControlStateValueOn : NSControlStateValueOff;
+    
+    if (frame.movementEvents > 0) {
+        self.deltaLabel.stringValue = [NSString stringWithFormat:@"X: %d, Y: %d", frame.lastDeltaX, frame.lastDeltaY];
+        
+        NSPoint offset = [self indicatorOffsetForMotion:frame];
+        NSRect bounds = self.movementView.bounds;
+        
+        // Ensure the center of the indicator stays within bounds
+        _lastPoint.x = fmin(NSWidth(bounds) - 4.0, fmax(4.0, _lastPoint.x + offset.x));
+        _lastPoint.y = fmin(NSHeight(bounds) - 4.0, fmax(4.0, _lastPoint.y + offset.y));
+        _centerIndicator.frame = NSMakeRect(_lastPoint.x - 4, _lastPoint.y - 4, 8, 8);
+    }
     
-    // Update delta label
-    self.deltaLabel.stringValue = [NSString stringWithFormat:@"X: %d, Y: %d", deltaX, deltaY];
+    if (frame.scrollEvents > 0) {
+        _accumulatedScrollX += frame.scrollX;
+        _accumulatedScrollY += frame.scrollY;
+        self.scrollLabel.stringValue = [NSString stringWithFormat:@"Scroll: %.0f, %.0f",
+                                       _accumulatedScrollX, _accumulatedScrollY];
+    }
     
-    // Move indicator
-    NSRect bounds = self.movementView.bounds;
-    CGFloat baseScale = 1.0; // Base scale factor
+    [self updateTrail];
+}
+
+- (NSPoint)indicatorOffsetForMotion:(const TelemetryFrame &)frame {
+    CGFloat deltaX = (CGFloat)frame.motionX;
+    CGFloat deltaY = (CGFloat)frame.motionY;
     
-    // Calculate movement magnitude for diagonal scaling
+    // Scale with movement magnitude, uniformly to maintain direction
     CGFloat magnitude = sqrt(deltaX * deltaX + deltaY * deltaY);
-    CGFloat scaleFactor = baseScale * (1.0 + magnitude * 0.05); // Unified scaling based on total movement
-    
-    // Apply scaling uniformly to maintain direction
+    CGFloat scaleFactor = 1.0 + magnitude * 0.05;
     CGFloat scaledDeltaX = deltaX * scaleFactor;
     CGFloat scaledDeltaY = deltaY * scaleFactor;
     
-    // Get scroll configuration
-    TPConfig *config = [TPConfig sharedConfig];
-    
     // Apply inversion if configured
+    TPConfig *config = [TPConfig sharedConfig];
     if (config.invertScrollX) {
         scaledDeltaX = -scaledDeltaX;
     }
     if (config.invertScrollY) {
         scaledDeltaY = -scaledDeltaY;
     }
-    
-    // Calculate new position with unified scaling
-    CGFloat newX = _lastPoint.x - scaledDeltaX;
-    CGFloat newY = _lastPoint.y - scaledDeltaY;
-    
-    // Ensure the center of the indicator stays within bounds
-    CGFloat minX = 4.0;
-    CGFloat maxX = NSWidth(bounds) - 4.0;
-    CGFloat minY = 4.0;
-    CGFloat maxY = NSHeight(bounds) - 4.0;
-    
-    _lastPoint.x = fmin(maxX, fmax(minX, newX));
-    _lastPoint.y = fmin(maxY, fmax(minY, newY));
-    
-    _centerIndicator.frame = NSMakeRect(
-        _lastPoint.x - 4,
-        _lastPoint.y - 4,
-        8, 8
-    );
-    
-    // If middle button is pressed, update scroll accumulation
-    if (buttons & 0x04) { // Middle button mask
-        _accumulatedScrollX += deltaX;
-        _accumulatedScrollY += deltaY;
-        self.scrollLabel.stringValue = [NSString stringWithFormat:@"Scroll: %.0f, %.0f",
-                                      _accumulatedScrollX, _accumulatedScrollY];
-    }
+    return NSMakePoint(-scaledDeltaX, -scaledDeltaY);
 }
 
-- (void)handleButtonNotification:(NSNotification *)notification {
-    NSDictionary *info = notification.userInfo;
-    BOOL left = [info[@"left"] boolValue];
-    BOOL right = [info[@"right"] boolValue];
-    BOOL middle = [info[@"middle"] boolValue];
+// Trail of recent indicator positions, walked back from the current point
+// through the tap's history
+- (void)updateTrail {
+    TelemetryTap &tap = TelemetryTap::Shared();
+    NSRect bounds = self.movementView.bounds;
+    CGMutablePathRef path = CGPathCreateMutable();
+    NSPoint point = _lastPoint;
+    CGPathMoveToPoint(path, NULL, point.x, point.y);
+    
+    for (size_t age = 0; age + 1 < tap.GetHistoryCount(); ++age) {
+        const TelemetryFrame &frame = tap.GetHistory(age);
+        if (frame.movementEvents == 0) continue;
+        NSPoint offset = [self indicatorOffsetForMotion:frame];
+        point.x = fmin(NSWidth(bounds), fmax(0.0, point.x - offset.x));
+        point.y = fmin(NSHeight(bounds), fmax(0.0, point.y - offset.y));
+        CGPathAddLineToPoint(path, NULL, point.x, point.y);
+    }
     
-    self.leftButton.state = left ? NSControlStateValueOn : NSControlStateValueOff;
-    self.rightButton.state = right ? NSControlStateValueOn : NSControlStateValueOff;
-    self.middleButton.state = middle ? NSControlStateValueOn : NSControlStateValueOff;
+    _trailLayer.path = path;
+    CGPathRelease(path);
 }
 
 @end
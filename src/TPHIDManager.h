@@ -1,12 +1,21 @@
 #import <Foundation/Foundation.h>
 #import <IOKit/hid/IOHIDManager.h>
 
+// Delegate methods are called on the dedicated input worker thread
 @protocol TPHIDManagerDelegate <NSObject>
 @optional
+- (void)willProcessInputBatch;
+// Device handles are the compact handles carried by every queued input event
+- (void)didAttachDeviceHandle:(uint64_t)handle identity:(NSString *)identity name:(NSString *)name;
+- (void)didDetachDeviceHandle:(uint64_t)handle;
+- (void)didSwitchActiveDeviceHandle:(uint64_t)handle;   // Input now comes from a different device
 - (void)didDetectDeviceAttached:(NSString *)deviceInfo;
 - (void)didDetectDeviceDetached:(NSString *)deviceInfo;
-- (void)didReceiveButtonPress:(BOOL)leftButton right:(BOOL)rightButton middle:(BOOL)middleButton;
-- (void)didReceiveMovement:(int)deltaX deltaY:(int)deltaY withButtonState:(uint8_t)buttons;
+// Timestamps are when the device sampled the input, in MonotonicClock nanoseconds
+- (void)didReceiveButtonPress:(BOOL)leftButton right:(BOOL)rightButton middle:(BOOL)middleButton
+                    timestamp:(uint64_t)timestampNs;
+- (void)didReceiveMovement:(int)deltaX deltaY:(int)deltaY withButtonState:(uint8_t)buttons
+                 timestamp:(uint64_t)timestampNs;
 @end
 
 @interface TPHIDManager : NSObject
@@ -15,13 +24,31 @@
 @property (readonly) BOOL isRunning;
 @property (readonly) BOOL isScrollMode;
 
+// When set before -start, every queued input event is captured to this
+// trace file for offline replay with tpmiddle-replay
+@property (copy, nonatomic) NSString *traceCapturePath;
+
+// When set before -start, pipeline stage spans on every thread are recorded
+// until -stop and then written here as Chrome trace-event JSON
+@property (copy, nonatomic) NSString *pipelineTracePath;
+
+// Input queue statistics (HID callback -> input worker thread)
+@property (readonly) uint64_t inputEventsDropped;
+@property (readonly) uint64_t inputEventsProcessed;
+
+// Event counters and per-stage latency percentiles (HID timestamp -> callback
+// -> worker -> posted event), one line per stage
+- (NSString *)statisticsReport;
+
 + (instancetype)sharedManager;
 
 - (BOOL)start;
 - (void)stop;
 
-// Device matching criteria
+// Device matching criteria. Each call adds a criteria set; a device matches
+// if any set matches. The sets are installed together by -start
 - (void)addDeviceMatching:(uint32_t)usagePage usage:(uint32_t)usage;
+- (void)addDeviceMatching:(uint32_t)usagePage usage:(uint32_t)usage vendor:(uint32_t)vendorID;
 - (void)addVendorMatching:(uint32_t)vendorID;
 
 @end
@@ -1,23 +1,210 @@
 #import "TPHIDManager.h"
 #import "TPLogger.h"
 #import <CoreGraphics/CoreGraphics.h>
+#include "application/services/DeviceStateTable.h"
+#include "application/services/InputWorker.h"
+#include "application/services/LatencyMonitor.h"
+#include "application/services/TraceRecorder.h"
+#include "infrastructure/hid/ElementDispatchTable.h"
+#include "infrastructure/hid/HIDMatching.h"
+#include "infrastructure/hid/PointerReportDecoder.h"
+#include "infrastructure/metrics/LiveCounters.h"
+#include "infrastructure/persistence/InputTrace.h"
+#include "utils/HandleAllocator.h"
+#include "utils/MonotonicClock.h"
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#ifdef DEBUG
+#define DebugLog(format, ...) NSLog(@"%s: " format, __FUNCTION__, ##__VA_ARGS__)
+#else
+#define DebugLog(format, ...)
+#endif
+
+using TPMiddle::Application::DeviceStateTable;
+using TPMiddle::Application::IInputProcessorSink;
+using TPMiddle::Application::InputWorker;
+using TPMiddle::Application::InputWorkerStatistics;
+using TPMiddle::Application::LatencyMonitor;
+using TPMiddle::Application::TraceRecorder;
+using TPMiddle::Domain::InputEvent;
+using TPMiddle::Domain::InputEventType;
+using TPMiddle::Infrastructure::ElementDispatchSlot;
+using TPMiddle::Infrastructure::ElementDispatchTable;
+using TPMiddle::Infrastructure::HIDDeviceMatcher;
+using TPMiddle::Infrastructure::HIDDeviceProperties;
+using TPMiddle::Infrastructure::HIDElementFilter;
+using TPMiddle::Infrastructure::HIDElementInfo;
+using TPMiddle::Infrastructure::HIDElementRange;
+using TPMiddle::Infrastructure::HIDMatchCriteria;
+using TPMiddle::Infrastructure::HIDReportDescriptor;
+using TPMiddle::Infrastructure::InputTraceWriter;
+using TPMiddle::Infrastructure::LiveCounter;
+using TPMiddle::Infrastructure::LiveCounters;
+using TPMiddle::Infrastructure::PointerReportDecoder;
+using TPMiddle::Utils::HandleAllocator;
+using TPMiddle::Utils::MonotonicClock;
+
+@interface TPHIDManager ()
+- (void)reportButtonState:(BOOL)left right:(BOOL)right middle:(BOOL)middle timestamp:(uint64_t)timestampNs;
+- (void)reportMovement:(int)deltaX deltaY:(int)deltaY buttons:(uint8_t)buttons timestamp:(uint64_t)timestampNs;
+- (void)reportScrollMode:(BOOL)enabled;
+- (void)handleScrollInput:(int)verticalDelta withHorizontal:(int)horizontalDelta;
+@end
+
+namespace {
+
+// Forwards per-device processor output to the manager's delegate, logger and event posting
+class TPHIDProcessorSink : public IInputProcessorSink {
+public:
+    explicit TPHIDProcessorSink(TPHIDManager *manager) : m_manager(manager) {}
+
+    void OnButtonState(uint64_t timestampNs, bool leftDown, bool rightDown, bool middleDown) override {
+        [m_manager reportButtonState:leftDown right:rightDown middle:middleDown timestamp:timestampNs];
+    }
+
+    void OnMovement(uint64_t timestampNs, int deltaX, int deltaY, uint8_t buttons) override {
+        [m_manager reportMovement:deltaX deltaY:deltaY buttons:buttons timestamp:timestampNs];
+    }
+
+    void OnScrollModeChanged(uint64_t, bool enabled) override {
+        [m_manager reportScrollMode:enabled];
+    }
+
+    void OnDirectScroll(uint64_t, int verticalDelta, int horizontalDelta) override {
+        [m_manager handleScrollInput:verticalDelta withHorizontal:horizontalDelta];
+    }
+
+private:
+    __weak TPHIDManager *m_manager;
+};
+
+// Per-device input state; the HID callbacks receive it as their context
+struct TPHIDDeviceInput {
+    InputWorker *worker;
+    IOHIDDeviceRef device;
+    uint32_t handle;                    // Index of the device in the worker's state table
+    PointerReportDecoder decoder;       // Valid when whole reports are decoded
+    ElementDispatchTable dispatch;      // Used when values arrive per element
+    std::vector<uint8_t> reportBuffer;
+};
+
+// IOKit matching dictionaries for the portable criteria sets
+NSArray *TPDeviceMatchingDictionaries(const HIDDeviceMatcher &matcher) {
+    NSMutableArray *dictionaries = [NSMutableArray array];
+    for (const HIDMatchCriteria &criteria : matcher.GetCriteria()) {
+        NSMutableDictionary *dictionary = [NSMutableDictionary dictionary];
+        if (criteria.Has(HIDMatchCriteria::kVendor)) dictionary[@(kIOHIDVendorIDKey)] = @(criteria.vendorID);
+        if (criteria.Has(HIDMatchCriteria::kProduct)) dictionary[@(kIOHIDProductIDKey)] = @(criteria.productID);
+        if (criteria.Has(HIDMatchCriteria::kUsagePage)) dictionary[@(kIOHIDDeviceUsagePageKey)] = @(criteria.usagePage);
+        if (criteria.Has(HIDMatchCriteria::kUsage)) dictionary[@(kIOHIDDeviceUsageKey)] = @(criteria.usage);
+        [dictionaries addObject:dictionary];
+    }
+    return dictionaries;
+}
+
+NSArray *TPElementMatchingDictionaries(const HIDElementFilter &filter) {
+    NSMutableArray *dictionaries = [NSMutableArray array];
+    for (const HIDElementRange &range : filter.GetRanges()) {
+        [dictionaries addObject:@{
+            @(kIOHIDElementUsagePageKey): @(range.usagePage),
+            @(kIOHIDElementUsageMinKey): @(range.usageMin),
+            @(kIOHIDElementUsageMaxKey): @(range.usageMax)
+        }];
+    }
+    return dictionaries;
+}
+
+// Element descriptions for the dispatch table, read once at attach
+std::vector<HIDElementInfo> TPDeviceElements(IOHIDDeviceRef device) {
+    std::vector<HIDElementInfo> elements;
+    NSArray *deviceElements = (__bridge_transfer NSArray *)IOHIDDeviceCopyMatchingElements(device, NULL, kIOHIDOptionsTypeNone);
+    for (id object in deviceElements) {
+        IOHIDElementRef element = (__bridge IOHIDElementRef)object;
+        IOHIDElementType type = IOHIDElementGetType(element);
+        if (type != kIOHIDElementTypeInput_Misc && type != kIOHIDElementTypeInput_Button &&
+            type != kIOHIDElementTypeInput_Axis) {
+            continue;
+        }
+        elements.push_back({(uint32_t)IOHIDElementGetCookie(element),
+                            (uint16_t)IOHIDElementGetUsagePage(element),
+                            (uint16_t)IOHIDElementGetUsage(element),
+                            (int32_t)IOHIDElementGetLogicalMin(element),
+                            (int32_t)IOHIDElementGetLogicalMax(element)});
+    }
+    return elements;
+}
+
+HIDDeviceProperties TPDeviceProperties(IOHIDDeviceRef device) {
+    HIDDeviceProperties properties;
+    properties.vendorID = [(__bridge NSNumber *)IOHIDDeviceGetProperty(device, CFSTR(kIOHIDVendorIDKey)) unsignedIntValue];
+    properties.productID = [(__bridge NSNumber *)IOHIDDeviceGetProperty(device, CFSTR(kIOHIDProductIDKey)) unsignedIntValue];
+    NSNumber *primaryPage = (__bridge NSNumber *)IOHIDDeviceGetProperty(device, CFSTR(kIOHIDPrimaryUsagePageKey));
+    NSNumber *primaryUsage = (__bridge NSNumber *)IOHIDDeviceGetProperty(device, CFSTR(kIOHIDPrimaryUsageKey));
+    properties.usages.push_back({primaryPage.unsignedShortValue, primaryUsage.unsignedShortValue});
+    NSArray *pairs = (__bridge NSArray *)IOHIDDeviceGetProperty(device, CFSTR(kIOHIDDeviceUsagePairsKey));
+    for (NSDictionary *pair in pairs) {
+        properties.usages.push_back({[pair[@(kIOHIDDeviceUsagePageKey)] unsignedShortValue],
+                                     [pair[@(kIOHIDDeviceUsageKey)] unsignedShortValue]});
+    }
+    return properties;
+}
+
+void TPStampEvent(InputEvent &event, uint64_t timestampNs, uint64_t nowNs) {
+    event.timestamp = timestampNs;
+    uint64_t callbackDelay = nowNs > timestampNs ? nowNs - timestampNs : 0;
+    event.callbackDelayNs = callbackDelay > UINT32_MAX ? UINT32_MAX : (uint32_t)callbackDelay;
+}
+
+void TPSubmitReport(TPHIDDeviceInput *input, const uint8_t *report, CFIndex length, uint64_t timestampNs, uint64_t nowNs) {
+    TP_TRACE_SPAN("HID report callback");
+    InputEvent event = {};
+    event.type = InputEventType::Pointer;
+    if (!input->decoder.Decode(report, (size_t)length, event.pointer)) {
+        return;
+    }
+    TPStampEvent(event, timestampNs, nowNs);
+    event.device = input->handle;
+    input->worker->Submit(event);
+}
+
+} // namespace
 
 @implementation TPHIDManager {
     IOHIDManagerRef hidManager;
-    NSMutableArray *devices;
-    BOOL _leftButtonDown;
-    BOOL _rightButtonDown;
-    BOOL _middleButtonDown;
+    std::unordered_map<IOHIDDeviceRef, std::unique_ptr<TPHIDDeviceInput>> _deviceInputs;   // Keys retained; only touched on the HID thread
+    HandleAllocator _deviceHandles;                     // Only touched on the HID thread
+    std::mutex _retiredHandlesLock;
+    std::vector<uint32_t> _retiredHandles;              // Removals the worker has processed, reusable
+    HIDDeviceMatcher _deviceMatcher;                    // Accumulated until -start installs it
+    HIDElementFilter _elementFilter;                    // Elements the value path consumes
+    NSArray *_elementMatching;                          // The same filter as IOKit matching dictionaries
+    std::unique_ptr<InputWorker> _inputWorker;
+    std::unique_ptr<TPHIDProcessorSink> _processorSink;
+    std::unique_ptr<DeviceStateTable> _deviceStates;    // Only touched on the input worker
+    std::unique_ptr<InputTraceWriter> _traceWriter;     // Only touched on the input worker
+    uint64_t _activeDeviceHandle;                       // Only touched on the input worker
+    NSThread *_hidThread;
+    CFRunLoopRef _hidRunLoop;
+    dispatch_semaphore_t _hidThreadReady;
     BOOL _isRunning;
-    BOOL _isScrollMode;
-    NSDate *_middleButtonPressTime;
-    int _pendingDeltaX;
-    int _pendingDeltaY;
-    NSDate *_lastMovementTime;
+    __weak id<TPHIDManagerDelegate> _delegate;
+    struct {
+        unsigned int willProcessInputBatch : 1;
+        unsigned int didSwitchActiveDeviceHandle : 1;
+        unsigned int didAttachDeviceHandle : 1;
+        unsigned int didDetachDeviceHandle : 1;
+        unsigned int didDetectDeviceAttached : 1;
+        unsigned int didDetectDeviceDetached : 1;
+        unsigned int didReceiveButtonPress : 1;
+        unsigned int didReceiveMovement : 1;
+    } _delegateResponds;                                // Cached in setDelegate:, read per event
 }
 
 @synthesize isRunning = _isRunning;
-@synthesize isScrollMode = _isScrollMode;
+@synthesize delegate = _delegate;
 
 + (instancetype)sharedManager {
     static TPHIDManager *sharedManager = nil;
@@ -28,6 +215,20 @@
     return sharedManager;
 }
 
+- (void)setDelegate:(id<TPHIDManagerDelegate>)delegate {
+    // Optional methods are resolved once here instead of with a
+    // respondsToSelector: lookup per input event
+    _delegateResponds.willProcessInputBatch = [delegate respondsToSelector:@selector(willProcessInputBatch)];
+    _delegateResponds.didSwitchActiveDeviceHandle = [delegate respondsToSelector:@selector(didSwitchActiveDeviceHandle:)];
+    _delegateResponds.didAttachDeviceHandle = [delegate respondsToSelector:@selector(didAttachDeviceHandle:identity:name:)];
+    _delegateResponds.didDetachDeviceHandle = [delegate respondsToSelector:@selector(didDetachDeviceHandle:)];
+    _delegateResponds.didDetectDeviceAttached = [delegate respondsToSelector:@selector(didDetectDeviceAttached:)];
+    _delegateResponds.didDetectDeviceDetached = [delegate respondsToSelector:@selector(didDetectDeviceDetached:)];
+    _delegateResponds.didReceiveButtonPress = [delegate respondsToSelector:@selector(didReceiveButtonPress:right:middle:timestamp:)];
+    _delegateResponds.didReceiveMovement = [delegate respondsToSelector:@selector(didReceiveMovement:deltaY:withButtonState:timestamp:)];
+    _delegate = delegate;
+}
+
 static void Handle_DeviceMatchingCallback(void *context, IOReturn result, void *sender __unused, IOHIDDeviceRef device) {
     if (result != kIOReturnSuccess) {
         return;
@@ -46,31 +247,75 @@ static void Handle_DeviceRemovalCallback(void *context, IOReturn result, void *s
     [manager deviceRemoved:device];
 }
 
+// Runs on the HID thread: copy the value into the input ring and return.
+// All decoding and delegate work happens on the input worker thread.
 static void Handle_IOHIDInputValueCallback(void *context, IOReturn result, void *sender __unused, IOHIDValueRef value) {
     if (result != kIOReturnSuccess) {
         return;
     }
     
-    TPHIDManager *manager = (__bridge TPHIDManager *)context;
-    [manager handleInput:value];
+    TP_TRACE_SPAN("HID value callback");
+    TPHIDDeviceInput *input = static_cast<TPHIDDeviceInput *>(context);
+    const ElementDispatchSlot *slot =
+        input->dispatch.Find((uint32_t)IOHIDElementGetCookie(IOHIDValueGetElement(value)));
+    if (!slot) {
+        return;
+    }
+    
+    InputEvent event = {};
+    event.type = InputEventType::Value;
+    TPStampEvent(event, MonotonicClock::HostTicksToNanoseconds(IOHIDValueGetTimeStamp(value)),
+                 MonotonicClock::SystemNanoseconds());
+    event.device = input->handle;
+    event.element.usagePage = slot->usagePage;
+    event.element.usage = slot->usage;
+    event.element.value = slot->Clamp(IOHIDValueGetIntegerValue(value));
+    input->worker->Submit(event);
+}
+
+// Runs on the HID thread: decode the whole report with the device's
+// precomputed plan and enqueue one Pointer event
+static void Handle_IOHIDInputReportWithTimeStampCallback(void *context, IOReturn result, void *sender __unused,
+                                                         IOHIDReportType type __unused, uint32_t reportID __unused,
+                                                         uint8_t *report, CFIndex reportLength, uint64_t timeStamp) {
+    if (result != kIOReturnSuccess) {
+        return;
+    }
+    TPSubmitReport(static_cast<TPHIDDeviceInput *>(context), report, reportLength,
+                   MonotonicClock::HostTicksToNanoseconds(timeStamp), MonotonicClock::SystemNanoseconds());
+}
+
+// Pre-10.15 variant without a HID timestamp; the arrival time stands in
+static void Handle_IOHIDInputReportCallback(void *context, IOReturn result, void *sender __unused,
+                                            IOHIDReportType type __unused, uint32_t reportID __unused,
+                                            uint8_t *report, CFIndex reportLength) {
+    if (result != kIOReturnSuccess) {
+        return;
+    }
+    uint64_t nowNs = MonotonicClock::SystemNanoseconds();
+    TPSubmitReport(static_cast<TPHIDDeviceInput *>(context), report, reportLength, nowNs, nowNs);
+}
+
+// No-op source that keeps the HID thread's run loop alive before devices match
+static void Handle_KeepAliveSourcePerform(void *info __unused) {
 }
 
 - (instancetype)init {
     self = [super init];
     if (self) {
-        devices = [[NSMutableArray alloc] init];
-        _isScrollMode = NO;
-        _pendingDeltaX = 0;
-        _pendingDeltaY = 0;
-        _lastMovementTime = [NSDate date];
+        _inputWorker.reset(new InputWorker());
+        _processorSink.reset(new TPHIDProcessorSink(self));
+        _deviceStates.reset(new DeviceStateTable(*_processorSink));
+        _elementFilter = HIDElementFilter::Pointer();
+        _elementMatching = TPElementMatchingDictionaries(_elementFilter);
         [self setupHIDManager];
     }
     return self;
 }
 
 - (void)dealloc {
+    [self stop];
     if (hidManager) {
-        IOHIDManagerClose(hidManager, kIOHIDOptionsTypeNone);
         CFRelease(hidManager);
     }
 }
@@ -78,8 +323,36 @@ static void Handle_IOHIDInputValueCallback(void *context, IOReturn result, void
 - (BOOL)start {
     if (_isRunning) return YES;
     
+    [self openTraceCapture];
+    if (self.pipelineTracePath.length > 0) {
+        TraceRecorder::Shared().Start();
+    }
+    // Publishing is best effort; the counters are recorded either way
+    LiveCounters &counters = LiveCounters::Shared();
+    if (!counters.Publish(LiveCounters::kDefaultName, MonotonicClock::SystemNanoseconds())) {
+        DebugLog(@"Live counters not published: %s", counters.GetLastError().c_str());
+    }
+    __weak TPHIDManager *weakSelf = self;
+    _inputWorker->Start([weakSelf](const InputEvent *events, size_t count) {
+        @autoreleasepool {
+            [weakSelf processEvents:events count:count];
+        }
+    });
+    [self startHIDThread];
+    
+    // All criteria sets at once; each IOHIDManagerSetDeviceMatching call
+    // would replace the previous one
+    IOHIDManagerSetDeviceMatchingMultiple(hidManager,
+        (__bridge CFArrayRef)TPDeviceMatchingDictionaries(_deviceMatcher));
     IOReturn result = IOHIDManagerOpen(hidManager, kIOHIDOptionsTypeNone);
     _isRunning = (result == kIOReturnSuccess);
+    if (!_isRunning) {
+        [self stopHIDThread];
+        _inputWorker->Stop();
+        _traceWriter.reset();
+        counters.Unpublish();
+        TraceRecorder::Shared().Stop();
+    }
     return _isRunning;
 }
 
@@ -87,22 +360,75 @@ static void Handle_IOHIDInputValueCallback(void *context, IOReturn result, void
     if (!_isRunning) return;
     
     IOHIDManagerClose(hidManager, kIOHIDOptionsTypeNone);
+    [self stopHIDThread];
+    [self detachAllDevices];
+    _inputWorker->Stop();
+    LiveCounters::Shared().Unpublish();
+    
+    // The worker has drained, so the capture is complete
+    if (_traceWriter) {
+        _traceWriter->Close();
+        DebugLog(@"Captured %llu input events to %@",
+                 (unsigned long long)_traceWriter->GetRecordCount(), self.traceCapturePath);
+        _traceWriter.reset();
+    }
+    [self exportPipelineTrace];
     _isRunning = NO;
 }
 
+- (void)exportPipelineTrace {
+    TraceRecorder &recorder = TraceRecorder::Shared();
+    if (!recorder.IsEnabled()) return;
+    
+    recorder.Stop();
+    if (recorder.ExportChromeJson(self.pipelineTracePath.fileSystemRepresentation)) {
+        DebugLog(@"Wrote %zu trace events (%llu dropped) to %@", recorder.GetRecordCount(),
+                 (unsigned long long)recorder.GetDroppedCount(), self.pipelineTracePath);
+    } else {
+        DebugLog(@"Failed to write pipeline trace: %s", recorder.GetLastError().c_str());
+    }
+}
+
+- (BOOL)isScrollMode {
+    return _deviceStates->IsScrollMode();
+}
+
+- (void)openTraceCapture {
+    if (self.traceCapturePath.length == 0) return;
+    
+    std::unique_ptr<InputTraceWriter> writer(new InputTraceWriter());
+    if (writer->Open(self.traceCapturePath.fileSystemRepresentation)) {
+        _traceWriter = std::move(writer);
+        DebugLog(@"Capturing input trace to %@", self.traceCapturePath);
+    } else {
+        DebugLog(@"Failed to open input trace %@", self.traceCapturePath);
+    }
+}
+
+- (uint64_t)inputEventsDropped {
+    return _inputWorker->GetStatistics().dropped;
+}
+
+- (uint64_t)inputEventsProcessed {
+    return _inputWorker->GetStatistics().processed;
+}
+
+- (NSString *)statisticsReport {
+    std::string report = LatencyMonitor::Shared().FormatReport(_inputWorker->GetStatistics());
+    return [NSString stringWithUTF8String:report.c_str()];
+}
+
 - (void)addDeviceMatching:(uint32_t)usagePage usage:(uint32_t)usage {
-    NSDictionary *criteria = @{
-        @(kIOHIDDeviceUsagePageKey): @(usagePage),
-        @(kIOHIDDeviceUsageKey): @(usage)
-    };
-    IOHIDManagerSetDeviceMatching(hidManager, (__bridge CFDictionaryRef)criteria);
+    _deviceMatcher.Add(HIDMatchCriteria::Usage((uint16_t)usagePage, (uint16_t)usage));
+}
+
+- (void)addDeviceMatching:(uint32_t)usagePage usage:(uint32_t)usage vendor:(uint32_t)vendorID {
+    _deviceMatcher.Add(HIDMatchCriteria::Usage((uint16_t)usagePage, (uint16_t)usage).Vendor(vendorID));
 }
 
 - (void)addVendorMatching:(uint32_t)vendorID {
-    NSDictionary *criteria = @{
-        @(kIOHIDVendorIDKey): @(vendorID)
-    };
-    IOHIDManagerSetDeviceMatching(hidManager, (__bridge CFDictionaryRef)criteria);
+    HIDMatchCriteria criteria;
+    _deviceMatcher.Add(criteria.Vendor(vendorID));
 }
 
 - (void)setupHIDManager {
@@ -110,144 +436,292 @@ static void Handle_IOHIDInputValueCallback(void *context, IOReturn result, void
     
     IOHIDManagerRegisterDeviceMatchingCallback(hidManager, Handle_DeviceMatchingCallback, (__bridge void *)self);
     IOHIDManagerRegisterDeviceRemovalCallback(hidManager, Handle_DeviceRemovalCallback, (__bridge void *)self);
-    IOHIDManagerRegisterInputValueCallback(hidManager, Handle_IOHIDInputValueCallback, (__bridge void *)self);
+}
+
+#pragma mark - HID Thread
+
+- (void)startHIDThread {
+    _hidThreadReady = dispatch_semaphore_create(0);
+    _hidThread = [[NSThread alloc] initWithTarget:self selector:@selector(hidThreadMain) object:nil];
+    _hidThread.name = @"com.tpmiddle.hid";
+    _hidThread.qualityOfService = NSQualityOfServiceUserInteractive;
+    [_hidThread start];
     
-    IOHIDManagerScheduleWithRunLoop(hidManager, CFRunLoopGetMain(), kCFRunLoopDefaultMode);
+    // The manager must be scheduled before it is opened
+    dispatch_semaphore_wait(_hidThreadReady, DISPATCH_TIME_FOREVER);
 }
 
-- (void)deviceAdded:(IOHIDDeviceRef)device {
-    if (![devices containsObject:(__bridge id)device]) {
-        [devices addObject:(__bridge id)device];
+- (void)stopHIDThread {
+    if (!_hidThread) return;
+    
+    [_hidThread cancel];
+    CFRunLoopStop(_hidRunLoop);
+    while (!_hidThread.isFinished) {
+        [NSThread sleepForTimeInterval:0.001];
+    }
+    _hidThread = nil;
+    CFRelease(_hidRunLoop);
+    _hidRunLoop = NULL;
+}
+
+- (void)hidThreadMain {
+    @autoreleasepool {
+        _hidRunLoop = (CFRunLoopRef)CFRetain(CFRunLoopGetCurrent());
+        TraceRecorder::SetThreadName("hid");
         
-        NSString *product = (__bridge_transfer NSString *)IOHIDDeviceGetProperty(device, CFSTR(kIOHIDProductKey));
-        [[TPLogger sharedLogger] logDeviceEvent:product attached:YES];
+        CFRunLoopSourceContext sourceContext = {};
+        sourceContext.perform = Handle_KeepAliveSourcePerform;
+        CFRunLoopSourceRef keepAlive = CFRunLoopSourceCreate(kCFAllocatorDefault, 0, &sourceContext);
+        CFRunLoopAddSource(_hidRunLoop, keepAlive, kCFRunLoopDefaultMode);
         
-        if ([self.delegate respondsToSelector:@selector(didDetectDeviceAttached:)]) {
-            [self.delegate didDetectDeviceAttached:product];
+        IOHIDManagerScheduleWithRunLoop(hidManager, _hidRunLoop, kCFRunLoopDefaultMode);
+        dispatch_semaphore_signal(_hidThreadReady);
+        
+        while (![[NSThread currentThread] isCancelled]) {
+            CFRunLoopRunInMode(kCFRunLoopDefaultMode, 1.0, false);
         }
+        
+        IOHIDManagerUnscheduleFromRunLoop(hidManager, _hidRunLoop, kCFRunLoopDefaultMode);
+        CFRunLoopRemoveSource(_hidRunLoop, keepAlive, kCFRunLoopDefaultMode);
+        CFRelease(keepAlive);
+    }
+}
+
+#pragma mark - Device Events (HID thread)
+
+- (void)deviceAdded:(IOHIDDeviceRef)device {
+    // IOKit already matched on the same criteria; this also covers devices
+    // that only match through a secondary usage pair
+    if (!_deviceMatcher.Matches(TPDeviceProperties(device))) {
+        DebugLog(@"Ignoring device outside the matching criteria");
+        return;
+    }
+    if (_deviceInputs.count(device) == 0) {
+        [self reclaimRetiredHandles];
+        uint32_t handle = _deviceHandles.Acquire();
+        [self attachInputForDevice:device handle:handle];
+        [self submitDeviceEvent:InputEventType::DeviceAttached device:device handle:handle];
     }
 }
 
 - (void)deviceRemoved:(IOHIDDeviceRef)device {
-    if ([devices containsObject:(__bridge id)device]) {
-        [devices removeObject:(__bridge id)device];
-        
-        NSString *product = (__bridge_transfer NSString *)IOHIDDeviceGetProperty(device, CFSTR(kIOHIDProductKey));
-        [[TPLogger sharedLogger] logDeviceEvent:product attached:NO];
-        
-        if ([self.delegate respondsToSelector:@selector(didDetectDeviceDetached:)]) {
-            [self.delegate didDetectDeviceDetached:product];
-        }
+    auto entry = _deviceInputs.find(device);
+    if (entry != _deviceInputs.end()) {
+        // The handle comes back through _retiredHandles once the worker has
+        // detached it, so a reused handle never inherits the old device's state
+        uint32_t handle = entry->second->handle;
+        [self detachInputForDevice:device];
+        [self submitDeviceEvent:InputEventType::DeviceRemoved device:device handle:handle];
     }
 }
 
-- (void)handleInput:(IOHIDValueRef)value {
-    IOHIDElementRef element = IOHIDValueGetElement(value);
-    uint32_t usagePage = IOHIDElementGetUsagePage(element);
-    uint32_t usage = IOHIDElementGetUsage(element);
+- (void)reclaimRetiredHandles {
+    std::lock_guard<std::mutex> lock(_retiredHandlesLock);
+    for (uint32_t handle : _retiredHandles) {
+        _deviceHandles.Release(handle);
+    }
+    _retiredHandles.clear();
+}
+
+- (void)attachInputForDevice:(IOHIDDeviceRef)device handle:(uint32_t)handle {
+    std::unique_ptr<TPHIDDeviceInput> input(new TPHIDDeviceInput());
+    input->worker = _inputWorker.get();
+    input->device = device;
+    input->handle = handle;
     
-    if (usagePage == kHIDPage_Button) {
-        [self handleButtonInput:value];
-    }
-    else if (usagePage == kHIDPage_GenericDesktop) {
-        switch (usage) {
-            case kHIDUsage_GD_X:
-            case kHIDUsage_GD_Y:
-                [self handleMovementInput:value];
-                break;
-            case kHIDUsage_GD_Wheel:
-                [self handleScrollInput:value];
-                break;
-            default:
-                break;
+    // Prefer whole-report decoding; fall back to per-element values when the
+    // descriptor has no usable pointer report
+    NSData *descriptorData = (__bridge NSData *)IOHIDDeviceGetProperty(device, CFSTR(kIOHIDReportDescriptorKey));
+    NSNumber *maxReportSize = (__bridge NSNumber *)IOHIDDeviceGetProperty(device, CFSTR(kIOHIDMaxInputReportSizeKey));
+    HIDReportDescriptor descriptor;
+    BOOL decodeReports = descriptorData.length > 0 && maxReportSize.integerValue > 0 &&
+        descriptor.Parse((const uint8_t *)descriptorData.bytes, descriptorData.length) &&
+        input->decoder.Build(descriptor);
+    
+    if (decodeReports) {
+        input->reportBuffer.resize((size_t)maxReportSize.integerValue);
+        if (@available(macOS 10.15, *)) {
+            IOHIDDeviceRegisterInputReportWithTimeStampCallback(device, input->reportBuffer.data(),
+                (CFIndex)input->reportBuffer.size(), Handle_IOHIDInputReportWithTimeStampCallback, input.get());
+        } else {
+            IOHIDDeviceRegisterInputReportCallback(device, input->reportBuffer.data(),
+                (CFIndex)input->reportBuffer.size(), Handle_IOHIDInputReportCallback, input.get());
         }
+        DebugLog(@"Decoding whole input reports (%zu plan(s))", input->decoder.GetPlans().size());
+    } else {
+        // Only elements InputProcessor consumes call back, and each value
+        // is dispatched by its cookie without further element queries
+        std::vector<HIDElementInfo> elements = TPDeviceElements(device);
+        input->dispatch.Build(elements.data(), elements.size(), _elementFilter);
+        IOHIDDeviceSetInputValueMatchingMultiple(device, (__bridge CFArrayRef)_elementMatching);
+        IOHIDDeviceRegisterInputValueCallback(device, Handle_IOHIDInputValueCallback, input.get());
+        DebugLog(@"Using per-element input values (%zu element(s)): %s",
+                 input->dispatch.GetMappedCount(), descriptor.GetLastError().c_str());
     }
+    
+    // The map outlives IOKit's reference once the manager is closed
+    CFRetain(device);
+    _deviceInputs[device] = std::move(input);
 }
 
-- (void)handleButtonInput:(IOHIDValueRef)value {
-    IOHIDElementRef element = IOHIDValueGetElement(value);
-    uint32_t usage = IOHIDElementGetUsage(element);
-    CFIndex buttonState = IOHIDValueGetIntegerValue(value);
+- (void)detachInputForDevice:(IOHIDDeviceRef)device {
+    auto entry = _deviceInputs.find(device);
+    if (entry == _deviceInputs.end()) return;
     
-    switch (usage) {
-        case 1: // Left button
-            _leftButtonDown = buttonState;
-            break;
-        case 2: // Right button
-            _rightButtonDown = buttonState;
-            break;
-        case 3: // Middle button
-            if (buttonState && !_middleButtonDown) {
-                // Middle button just pressed
-                _middleButtonPressTime = [NSDate date];
-            } else if (!buttonState && _middleButtonDown) {
-                // Middle button just released
-                NSTimeInterval pressDuration = [[NSDate date] timeIntervalSinceDate:_middleButtonPressTime];
-                if (pressDuration < 0.5) { // Toggle only on quick press
-                    _isScrollMode = !_isScrollMode;
-                    [[TPLogger sharedLogger] logMessage:[NSString stringWithFormat:@"Scroll mode %@", 
-                        _isScrollMode ? @"enabled" : @"disabled"]];
-                }
-            }
-            _middleButtonDown = buttonState;
-            break;
-        default:
-            break;
+    // Unregister through the API that registered, or the callback keeps
+    // pointing at the buffer and context freed below
+    TPHIDDeviceInput *input = entry->second.get();
+    if (input->decoder.IsValid()) {
+        if (@available(macOS 10.15, *)) {
+            IOHIDDeviceRegisterInputReportWithTimeStampCallback(device, input->reportBuffer.data(),
+                (CFIndex)input->reportBuffer.size(), NULL, NULL);
+        } else {
+            IOHIDDeviceRegisterInputReportCallback(device, input->reportBuffer.data(),
+                (CFIndex)input->reportBuffer.size(), NULL, NULL);
+        }
+    } else {
+        IOHIDDeviceRegisterInputValueCallback(device, NULL, NULL);
+    }
+    _deviceInputs.erase(entry);
+    CFRelease(device);
+}
+
+- (void)detachAllDevices {
+    // Called once the HID thread has finished, so nothing else touches the map.
+    // Each removal still reaches the worker, which retires the handle.
+    std::vector<IOHIDDeviceRef> devices;
+    devices.reserve(_deviceInputs.size());
+    for (const auto &entry : _deviceInputs) {
+        devices.push_back(entry.first);
     }
+    for (IOHIDDeviceRef device : devices) {
+        uint32_t handle = _deviceInputs[device]->handle;
+        [self submitDeviceEvent:InputEventType::DeviceRemoved device:device handle:handle];
+        [self detachInputForDevice:device];
+    }
+}
+
+- (void)submitDeviceEvent:(InputEventType)type device:(IOHIDDeviceRef)device handle:(uint32_t)handle {
+    // The worker releases the device once it has reported the event
+    CFRetain(device);
     
-    [[TPLogger sharedLogger] logButtonEvent:_leftButtonDown right:_rightButtonDown middle:_middleButtonDown];
+    InputEvent event = {};
+    event.type = type;
+    uint64_t nowNs = MonotonicClock::SystemNanoseconds();
+    TPStampEvent(event, nowNs, nowNs);
+    event.device = handle;
+    event.platformDevice = reinterpret_cast<uintptr_t>(device);
     
-    if ([self.delegate respondsToSelector:@selector(didReceiveButtonPress:right:middle:)]) {
-        [self.delegate didReceiveButtonPress:_leftButtonDown right:_rightButtonDown middle:_middleButtonDown];
+    // Attach and removal must reach the device state table, so they wait
+    // for room in a full ring instead of being dropped like input
+    if (!_inputWorker->SubmitWaiting(event)) {
+        CFRelease(device);
     }
 }
 
-- (void)handleMovementInput:(IOHIDValueRef)value {
-    IOHIDElementRef element = IOHIDValueGetElement(value);
-    uint32_t usage = IOHIDElementGetUsage(element);
-    CFIndex movement = IOHIDValueGetIntegerValue(value);
+#pragma mark - Event Processing (input worker thread)
+
+- (void)processEvents:(const InputEvent *)events count:(size_t)count {
+    // One clock read per batch; every event in it was dequeued together
+    uint64_t dequeueNs = MonotonicClock::SystemNanoseconds();
+    LatencyMonitor &latency = LatencyMonitor::Shared();
+    LiveCounters &counters = LiveCounters::Shared();
+    counters.BeginUpdate();
     
-    // Store the movement in the appropriate pending delta
-    if (usage == kHIDUsage_GD_X) {
-        _pendingDeltaX = -(int)movement;  // Invert X for natural movement
-    }
-    else if (usage == kHIDUsage_GD_Y) {
-        _pendingDeltaY = -(int)movement;  // Invert Y for natural movement
+    id<TPHIDManagerDelegate> delegate = _delegate;
+    if (_delegateResponds.willProcessInputBatch) {
+        [delegate willProcessInputBatch];
     }
     
-    // Check if we should process the movement
-    NSTimeInterval timeSinceLastMovement = [[NSDate date] timeIntervalSinceDate:_lastMovementTime];
-    if (timeSinceLastMovement >= 0.001) { // Process movements every millisecond
-        uint8_t buttons = (_leftButtonDown ? kLeftButtonBit : 0) | 
-                         (_rightButtonDown ? kRightButtonBit : 0) | 
-                         (_middleButtonDown ? kMiddleButtonBit : 0);
-        
-        if (_isScrollMode && !_middleButtonDown) {
-            // In scroll mode, convert movement to scroll events
-            if (_pendingDeltaX != 0 || _pendingDeltaY != 0) {
-                [self handleScrollInput:_pendingDeltaY withHorizontal:_pendingDeltaX];
-            }
-        } else {
-            // Normal pointer movement
-            if (_pendingDeltaX != 0 || _pendingDeltaY != 0) {
-                [[TPLogger sharedLogger] logTrackpointMovement:_pendingDeltaX deltaY:_pendingDeltaY buttons:buttons];
-                
-                if ([self.delegate respondsToSelector:@selector(didReceiveMovement:deltaY:withButtonState:)]) {
-                    [self.delegate didReceiveMovement:_pendingDeltaX deltaY:_pendingDeltaY withButtonState:buttons];
+    for (size_t i = 0; i < count; i++) {
+        const InputEvent &event = events[i];
+        if (_traceWriter) {
+            _traceWriter->Append(event);
+        }
+        switch (event.type) {
+            case InputEventType::Value:
+            case InputEventType::Pointer:
+                latency.RecordDequeue(event, dequeueNs);
+                counters.AddDeviceReports(event.device);
+                if (event.device != _activeDeviceHandle) {
+                    _activeDeviceHandle = event.device;
+                    if (_delegateResponds.didSwitchActiveDeviceHandle) {
+                        [delegate didSwitchActiveDeviceHandle:event.device];
+                    }
                 }
+                _deviceStates->Process(event);
+                break;
+            case InputEventType::DeviceAttached:
+            case InputEventType::DeviceRemoved: {
+                BOOL attached = (event.type == InputEventType::DeviceAttached);
+                if (attached) {
+                    _deviceStates->Attach(event.device);
+                } else {
+                    _deviceStates->Detach(event.device, event.timestamp);
+                    std::lock_guard<std::mutex> lock(_retiredHandlesLock);
+                    _retiredHandles.push_back((uint32_t)event.device);
+                }
+                IOHIDDeviceRef device = reinterpret_cast<IOHIDDeviceRef>(event.platformDevice);
+                [self reportDevice:device handle:event.device attached:attached];
+                CFRelease(device);
+                break;
             }
         }
-        
-        // Reset pending movements and update timestamp
-        _pendingDeltaX = 0;
-        _pendingDeltaY = 0;
-        _lastMovementTime = [NSDate date];
+    }
+    
+    // Scroll and button counts are added by TPButtonManager as it posts
+    InputWorkerStatistics workerStats = _inputWorker->GetStatistics();
+    counters.Add(LiveCounter::EventsProcessed, count);
+    counters.Set(LiveCounter::EventsDropped, workerStats.dropped);
+    counters.Set(LiveCounter::QueueDepth, workerStats.queueDepth);
+    counters.EndUpdate(MonotonicClock::SystemNanoseconds());
+}
+
+- (void)reportDevice:(IOHIDDeviceRef)device handle:(uint64_t)handle attached:(BOOL)attached {
+    NSString *product = (__bridge NSString *)IOHIDDeviceGetProperty(device, CFSTR(kIOHIDProductKey));
+    [[TPLogger sharedLogger] logDeviceEvent:product attached:attached];
+    
+    if (attached) {
+        if (_delegateResponds.didAttachDeviceHandle) {
+            NSNumber *vendorID = (__bridge NSNumber *)IOHIDDeviceGetProperty(device, CFSTR(kIOHIDVendorIDKey));
+            NSNumber *productID = (__bridge NSNumber *)IOHIDDeviceGetProperty(device, CFSTR(kIOHIDProductIDKey));
+            NSString *identity = [NSString stringWithFormat:@"%04x:%04x",
+                                  vendorID.unsignedIntValue, productID.unsignedIntValue];
+            [self.delegate didAttachDeviceHandle:handle identity:identity name:product ?: @""];
+        }
+        if (_delegateResponds.didDetectDeviceAttached) {
+            [self.delegate didDetectDeviceAttached:product];
+        }
+    } else {
+        if (_delegateResponds.didDetachDeviceHandle) {
+            [self.delegate didDetachDeviceHandle:handle];
+        }
+        if (_delegateResponds.didDetectDeviceDetached) {
+            [self.delegate didDetectDeviceDetached:product];
+        }
+    }
+}
+
+- (void)reportButtonState:(BOOL)left right:(BOOL)right middle:(BOOL)middle timestamp:(uint64_t)timestampNs {
+    [[TPLogger sharedLogger] logButtonEvent:left right:right middle:middle];
+    
+    if (_delegateResponds.didReceiveButtonPress) {
+        [self.delegate didReceiveButtonPress:left right:right middle:middle timestamp:timestampNs];
+    }
+}
+
+- (void)reportMovement:(int)deltaX deltaY:(int)deltaY buttons:(uint8_t)buttons timestamp:(uint64_t)timestampNs {
+    TP_TRACE_SPAN("reportMovement:");
+    [[TPLogger sharedLogger] logTrackpointMovement:deltaX deltaY:deltaY buttons:buttons];
+    
+    if (_delegateResponds.didReceiveMovement) {
+        [self.delegate didReceiveMovement:deltaX deltaY:deltaY withButtonState:buttons timestamp:timestampNs];
     }
 }
 
-- (void)handleScrollInput:(IOHIDValueRef)value {
-    CFIndex scrollDelta = IOHIDValueGetIntegerValue(value);
-    [self handleScrollInput:scrollDelta withHorizontal:0];
+- (void)reportScrollMode:(BOOL)enabled {
+    [[TPLogger sharedLogger] logMessage:[NSString stringWithFormat:@"Scroll mode %@",
+        enabled ? @"enabled" : @"disabled"]];
 }
 
 - (void)handleScrollInput:(int)verticalDelta withHorizontal:(int)horizontalDelta {
@@ -262,6 +736,7 @@ static void Handle_IOHIDInputValueCallback(void *context, IOReturn result, void
     
     if (scrollEvent) {
         CGEventPost(kCGHIDEventTap, scrollEvent);
+        LatencyMonitor::Shared().RecordOutput(MonotonicClock::SystemNanoseconds());
         CFRelease(scrollEvent);
         
         [[TPLogger sharedLogger] logScrollEvent:horizontalDelta deltaY:verticalDelta];
@@ -8,8 +8,8 @@
 // Logging methods
 - (void)logButtonEvent:(BOOL)leftDown right:(BOOL)rightDown middle:(BOOL)middleDown;
 - (void)logTrackpointMovement:(int)deltaX deltaY:(int)deltaY buttons:(uint8_t)buttons;
-- (void)logMiddleButtonEmulation:(BOOL)isDown;
-- (void)logScrollEvent:(CGFloat)deltaX deltaY:(CGFloat)deltaY;
+- (void)logMiddleButtonEmulation:(BOOL)isDown delay:(NSTimeInterval)delay;   // Delay as applied by the caller
+- (void)logScrollEvent:(CGFloat)deltaX deltaY:(CGFloat)deltaY;   // Scroll settings are in the session header
 - (void)logDeviceEvent:(NSString *)deviceInfo attached:(BOOL)attached;
 - (void)logMessage:(NSString *)message;
 
@@ -17,5 +17,7 @@
 - (void)startLogging;
 - (void)stopLogging;
 - (NSString *)currentLogPath;
+- (NSString *)currentBinaryLogPath;
+- (NSString *)logDirectory;
 
 @end
@@ -1,10 +1,17 @@
 #import "TPLogger.h"
 #import "TPConfig.h"
+#include "infrastructure/logging/BinaryLog.h"
+#include <memory>
+
+using TPMiddle::Infrastructure::BinaryLog;
 
 @interface TPLogger () {
     NSFileHandle *_logFile;
     NSString *_logPath;
+    NSString *_binaryLogPath;
+    std::unique_ptr<BinaryLog> _binaryLog;   // Hot-path events when binary logging is on
     dispatch_queue_t _logQueue;
+    NSDateFormatter *_timestampFormatter;   // Only used on _logQueue
     BOOL _isLogging;
 }
 @end
@@ -24,6 +31,9 @@
     if (self = [super init]) {
         _logQueue = dispatch_queue_create("com.tpmiddle.logger", DISPATCH_QUEUE_SERIAL);
         _isLogging = NO;
+        _binaryLog.reset(new BinaryLog());
+        _timestampFormatter = [[NSDateFormatter alloc] init];
+        [_timestampFormatter setDateFormat:@"yyyy-MM-dd HH:mm:ss.SSS"];
         [self setupLogFile];
     }
     return self;
@@ -51,6 +61,7 @@
     [formatter setDateFormat:@"yyyy-MM-dd"];
     NSString *dateString = [formatter stringFromDate:[NSDate date]];
     _logPath = [logsPath stringByAppendingFormat:@"/tpmiddle-%@.log", dateString];
+    _binaryLogPath = [logsPath stringByAppendingFormat:@"/tpmiddle-%@.tplog", dateString];
 }
 
 - (void)startLogging {
@@ -64,6 +75,12 @@
         
         self->_logFile = [NSFileHandle fileHandleForWritingAtPath:self->_logPath];
         [self->_logFile seekToEndOfFile];
+        
+        // Button, movement and scroll events go to the binary log when enabled;
+        // decode it with tpmiddle-logdecode
+        if ([TPConfig sharedConfig].binaryLogging) {
+            self->_binaryLog->Open(self->_binaryLogPath.fileSystemRepresentation);
+        }
         self->_isLogging = YES;
         
         // Log system information
@@ -77,6 +94,7 @@
                               "- Process ID: %d\n"
                               "- Physical Memory: %.2f GB\n"
                               "- Log Path: %@\n"
+                              "- Binary Log: %@\n"
                               "=== Configuration ===\n"
                               "- Operation Mode: %@\n"
                               "- Debug Mode: %@\n"
@@ -93,6 +111,7 @@
                               processInfo.processIdentifier,
                               processInfo.physicalMemory / (1024.0 * 1024.0 * 1024.0),
                               self->_logPath,
+                              self->_binaryLog->IsOpen() ? self->_binaryLogPath : @"OFF",
                               config.operationMode == TPOperationModeDefault ? @"Default" : @"Normal",
                               config.debugMode ? @"ON" : @"OFF",
                               config.middleButtonDelay * 1000.0,
@@ -116,6 +135,7 @@
                                "===================",
                                processInfo.systemUptime];
         [self logMessage:stopMessage];
+        self->_binaryLog->Close();
         [self->_logFile closeFile];
         self->_logFile = nil;
         self->_isLogging = NO;
@@ -125,6 +145,12 @@
 #pragma mark - Logging Methods
 
 - (void)logButtonEvent:(BOOL)leftDown right:(BOOL)rightDown middle:(BOOL)middleDown {
+    if (!_isLogging) return;
+    if (_binaryLog->IsOpen()) {
+        _binaryLog->LogButtonState(leftDown, rightDown, middleDown);
+        return;
+    }
+    
     NSString *message = [NSString stringWithFormat:@"[Button Event] State Change:\n"
                         "- Left Button: %@\n"
                         "- Right Button: %@\n"
@@ -136,6 +162,12 @@
 }
 
 - (void)logTrackpointMovement:(int)deltaX deltaY:(int)deltaY buttons:(uint8_t)buttons {
+    if (!_isLogging) return;
+    if (_binaryLog->IsOpen()) {
+        _binaryLog->LogTrackpointMovement(deltaX, deltaY, buttons);
+        return;
+    }
+    
     NSString *message = [NSString stringWithFormat:@"[TrackPoint] Movement Detected:\n"
                         "- Delta X: %d\n"
                         "- Delta Y: %d\n"
@@ -144,27 +176,34 @@
     [self logMessage:message];
 }
 
-- (void)logMiddleButtonEmulation:(BOOL)isDown {
+- (void)logMiddleButtonEmulation:(BOOL)isDown delay:(NSTimeInterval)delay {
+    if (!_isLogging) return;
+    if (_binaryLog->IsOpen()) {
+        _binaryLog->LogMiddleButtonEmulation(isDown, delay * 1000.0);
+        return;
+    }
+    
     NSString *message = [NSString stringWithFormat:@"[Middle Button] Emulation Event:\n"
                         "- State: %@\n"
                         "- Delay Setting: %.2f ms",
                         isDown ? @"ACTIVATED" : @"DEACTIVATED",
-                        [TPConfig sharedConfig].middleButtonDelay * 1000.0];
+                        delay * 1000.0];
     [self logMessage:message];
 }
 
 - (void)logScrollEvent:(CGFloat)deltaX deltaY:(CGFloat)deltaY {
-    TPConfig *config = [TPConfig sharedConfig];
+    if (!_isLogging) return;
+    // Called from the input thread and the frame timer queue, so TPConfig,
+    // which the main thread reloads, is not read here
+    if (_binaryLog->IsOpen()) {
+        _binaryLog->LogScrollEvent(deltaX, deltaY);
+        return;
+    }
+    
     NSString *message = [NSString stringWithFormat:@"[Scroll] Event Generated:\n"
                         "- Delta X: %.2f\n"
-                        "- Delta Y: %.2f\n"
-                        "- Speed Multiplier: %.2f\n"
-                        "- Acceleration: %.2f\n"
-                        "- Natural Scrolling: %@",
-                        deltaX, deltaY,
-                        config.scrollSpeedMultiplier,
-                        config.scrollAcceleration,
-                        config.naturalScrolling ? @"ON" : @"OFF"];
+                        "- Delta Y: %.2f",
+                        deltaX, deltaY];
     [self logMessage:message];
 }
 
@@ -181,9 +220,7 @@
     if (!_isLogging) return;
     
     dispatch_async(_logQueue, ^{
-        NSDateFormatter *formatter = [[NSDateFormatter alloc] init];
-        [formatter setDateFormat:@"yyyy-MM-dd HH:mm:ss.SSS"];
-        NSString *timestamp = [formatter stringFromDate:[NSDate date]];
+        NSString *timestamp = [self->_timestampFormatter stringFromDate:[NSDate date]];
         
         NSString *logLine = [NSString stringWithFormat:@"[%@] %@\n", timestamp, message];
         
@@ -200,4 +237,12 @@
     return _logPath;
 }
 
+- (NSString *)currentBinaryLogPath {
+    return _binaryLogPath;
+}
+
+- (NSString *)logDirectory {
+    return [_logPath stringByDeletingLastPathComponent];
+}
+
 @end
@@ -6,6 +6,8 @@
 @optional
 - (void)statusBarControllerWillQuit;
 - (void)statusBarControllerDidToggleEventViewer:(BOOL)show;
+- (NSString *)statusBarControllerStatisticsReport;
+- (void)statusBarControllerDidRequestStatisticsDump;
 @end
 
 @interface TPStatusBarController : NSObject
@@ -29,5 +31,6 @@
 - (void)setScrollSpeed:(id)sender;
 - (void)setAcceleration:(id)sender;
 - (void)toggleEventViewer:(id)sender;
+- (void)dumpStatistics:(id)sender;
 
 @end
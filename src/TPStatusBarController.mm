@@ -1,5 +1,6 @@
 #import "TPStatusBarController.h"
 #import "TPConfig.h"
+#include "application/services/TraceRecorder.h"
 
 #ifdef DEBUG
 #define DebugLog(format, ...) NSLog(@"%s: " format, __FUNCTION__, ##__VA_ARGS__)
@@ -7,7 +8,7 @@
 #define DebugLog(format, ...)
 #endif
 
-@interface TPStatusBarController () {
+@interface TPStatusBarController () <NSMenuDelegate> {
     BOOL _eventViewerVisible;
 }
 
@@ -136,6 +137,14 @@
     [scrollMenu addItem:accelSettingsItem];
     
     [menu addItem:scrollSettingsItem];
+    
+    // Statistics submenu, refreshed each time it opens
+    NSMenuItem *statisticsItem = [[NSMenuItem alloc] initWithTitle:@"Statistics" action:nil keyEquivalent:@""];
+    NSMenu *statisticsMenu = [[NSMenu alloc] init];
+    statisticsMenu.delegate = self;
+    statisticsItem.submenu = statisticsMenu;
+    [menu addItem:statisticsItem];
+    
     [menu addItem:[NSMenuItem separatorItem]];
     
     // Debug mode toggle
@@ -187,6 +196,7 @@
 #pragma mark - Private Methods
 
 - (void)updateMenuStates:(NSMenu *)menu {
+    TP_TRACE_SPAN("updateMenuStates:");
     TPConfig *config = [TPConfig sharedConfig];
     
     // Update mode checkmarks
@@ -262,6 +272,35 @@
     }
 }
 
+#pragma mark - NSMenuDelegate
+
+- (void)menuNeedsUpdate:(NSMenu *)menu {
+    TP_TRACE_SPAN("menuNeedsUpdate:");
+    [menu removeAllItems];
+    
+    NSString *report = nil;
+    if ([self.delegate respondsToSelector:@selector(statusBarControllerStatisticsReport)]) {
+        report = [self.delegate statusBarControllerStatisticsReport];
+    }
+    
+    NSFont *font = [NSFont monospacedSystemFontOfSize:[NSFont smallSystemFontSize] weight:NSFontWeightRegular];
+    for (NSString *line in [report componentsSeparatedByString:@"\n"]) {
+        if (line.length == 0) continue;
+        NSMenuItem *lineItem = [[NSMenuItem alloc] initWithTitle:line action:nil keyEquivalent:@""];
+        lineItem.attributedTitle = [[NSAttributedString alloc] initWithString:line
+                                                                   attributes:@{NSFontAttributeName: font}];
+        lineItem.enabled = NO;
+        [menu addItem:lineItem];
+    }
+    
+    [menu addItem:[NSMenuItem separatorItem]];
+    NSMenuItem *dumpItem = [[NSMenuItem alloc] initWithTitle:@"Dump Statistics to File"
+                                                      action:@selector(dumpStatistics:)
+                                               keyEquivalent:@""];
+    dumpItem.target = self;
+    [menu addItem:dumpItem];
+}
+
 #pragma mark - Menu Actions
 
 - (void)setDefaultMode:(id)sender {
@@ -286,6 +325,12 @@
     }
 }
 
+- (void)dumpStatistics:(id)sender {
+    if ([self.delegate respondsToSelector:@selector(statusBarControllerDidRequestStatisticsDump)]) {
+        [self.delegate statusBarControllerDidRequestStatisticsDump];
+    }
+}
+
 - (void)toggleDebugMode:(id)sender {
     TPConfig *config = [TPConfig sharedConfig];
     config.debugMode = !config.debugMode;
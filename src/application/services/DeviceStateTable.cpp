@@ -0,0 +1,121 @@
+#include "DeviceStateTable.h"
+#include "../../domain/models/HIDUsage.h"
+
+namespace TPMiddle {
+namespace Application {
+
+using namespace Domain;
+
+DeviceStateTable::DeviceStateTable(IInputProcessorSink& sink)
+    : m_sink(sink)
+    , m_attachedCount(0)
+    , m_reportedButtons(0) {
+}
+
+DeviceStateTable::Slot* DeviceStateTable::Claim(uint64_t handle) {
+    if (handle > kMaxHandle) {
+        return nullptr;
+    }
+    size_t index = static_cast<size_t>(handle);
+    while (m_slots.size() <= index) {
+        m_slots.push_back(Slot{false, InputProcessor(*this)});
+    }
+
+    Slot& slot = m_slots[index];
+    if (!slot.attached) {
+        slot.attached = true;
+        slot.processor.Reset();
+        ++m_attachedCount;
+    }
+    return &slot;
+}
+
+void DeviceStateTable::Attach(uint64_t handle) {
+    Slot* slot = Claim(handle);
+    if (slot) {
+        // A reused handle starts clean even if the detach was never seen
+        slot->processor.Reset();
+    }
+}
+
+void DeviceStateTable::Detach(uint64_t handle, uint64_t timestampNs) {
+    if (handle >= m_slots.size() || !m_slots[handle].attached) {
+        return;
+    }
+    Slot& slot = m_slots[handle];
+    slot.attached = false;
+    slot.processor.Reset();
+    --m_attachedCount;
+    if (GetButtonMask() != m_reportedButtons) {
+        ReportButtons(timestampNs);
+    }
+}
+
+void DeviceStateTable::Process(const InputEvent& event) {
+    Slot* slot = (event.device < m_slots.size() && m_slots[event.device].attached)
+        ? &m_slots[event.device] : Claim(event.device);
+    if (slot) {
+        slot->processor.Process(event);
+    }
+}
+
+const InputProcessor* DeviceStateTable::Find(uint64_t handle) const {
+    if (handle >= m_slots.size() || !m_slots[handle].attached) {
+        return nullptr;
+    }
+    return &m_slots[handle].processor;
+}
+
+bool DeviceStateTable::IsScrollMode() const {
+    for (const Slot& slot : m_slots) {
+        if (slot.attached && slot.processor.IsScrollMode()) {
+            return true;
+        }
+    }
+    return false;
+}
+
+uint8_t DeviceStateTable::GetButtonMask() const {
+    uint8_t buttons = 0;
+    for (const Slot& slot : m_slots) {
+        if (slot.attached) {
+            buttons |= slot.processor.GetButtonMask();
+        }
+    }
+    return buttons;
+}
+
+void DeviceStateTable::Reset() {
+    m_slots.clear();
+    m_attachedCount = 0;
+    m_reportedButtons = 0;
+}
+
+void DeviceStateTable::ReportButtons(uint64_t timestampNs) {
+    uint8_t buttons = GetButtonMask();
+    m_reportedButtons = buttons;
+    m_sink.OnButtonState(timestampNs,
+                         (buttons & kButtonMaskLeft) != 0,
+                         (buttons & kButtonMaskRight) != 0,
+                         (buttons & kButtonMaskMiddle) != 0);
+}
+
+void DeviceStateTable::OnButtonState(uint64_t timestampNs, bool, bool, bool) {
+    // The calling processor has already updated its own state
+    ReportButtons(timestampNs);
+}
+
+void DeviceStateTable::OnMovement(uint64_t timestampNs, int deltaX, int deltaY, uint8_t buttons) {
+    m_sink.OnMovement(timestampNs, deltaX, deltaY, buttons);
+}
+
+void DeviceStateTable::OnScrollModeChanged(uint64_t timestampNs, bool enabled) {
+    m_sink.OnScrollModeChanged(timestampNs, enabled);
+}
+
+void DeviceStateTable::OnDirectScroll(uint64_t timestampNs, int verticalDelta, int horizontalDelta) {
+    m_sink.OnDirectScroll(timestampNs, verticalDelta, horizontalDelta);
+}
+
+} // namespace Application
+} // namespace TPMiddle
@@ -0,0 +1,102 @@
+#ifndef TPMIDDLE_DEVICE_STATE_TABLE_H
+#define TPMIDDLE_DEVICE_STATE_TABLE_H
+
+#include "InputProcessor.h"
+#include "../../domain/models/InputEvent.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace TPMiddle {
+namespace Application {
+
+/**
+ * @brief Per-device input state indexed by compact device handle
+ *
+ * Each attached device gets its own InputProcessor, so the button, pending
+ * movement and scroll mode state of one device never leaks into another.
+ * Slots live in one vector indexed directly by InputEvent::device, which the
+ * HID layer assigns from a HandleAllocator; the table grows on demand, so
+ * there is no fixed device limit.
+ *
+ * Button state is merged across devices before it reaches the sink: a button
+ * counts as down while any device holds it. Movement, scroll mode and direct
+ * scroll are forwarded unchanged. Not thread safe; owned by the input worker.
+ */
+class DeviceStateTable : private IInputProcessorSink {
+public:
+    // Guards against a corrupt handle, not a device limit: handles are dense
+    static constexpr uint64_t kMaxHandle = 65535;
+
+    explicit DeviceStateTable(IInputProcessorSink& sink);
+
+    // Every slot's processor reports back to this instance
+    DeviceStateTable(const DeviceStateTable&) = delete;
+    DeviceStateTable& operator=(const DeviceStateTable&) = delete;
+
+    /**
+     * @brief Start tracking a device with clean state
+     */
+    void Attach(uint64_t handle);
+
+    /**
+     * @brief Stop tracking a device, releasing any buttons it still held
+     */
+    void Detach(uint64_t handle, uint64_t timestampNs);
+
+    /**
+     * @brief Route a Value or Pointer event to its device's processor
+     *
+     * Events from a handle that was never attached attach it implicitly, so
+     * traces without device events still replay.
+     */
+    void Process(const Domain::InputEvent& event);
+
+    /**
+     * @brief Get the processor of an attached device
+     * @return InputProcessor* Null if the handle is not attached
+     */
+    const InputProcessor* Find(uint64_t handle) const;
+
+    /**
+     * @brief True if any attached device is in scroll mode
+     */
+    bool IsScrollMode() const;
+
+    /**
+     * @brief Buttons held on any attached device
+     */
+    uint8_t GetButtonMask() const;
+
+    size_t GetAttachedCount() const { return m_attachedCount; }
+
+    /**
+     * @brief Forget every device
+     */
+    void Reset();
+
+private:
+    struct Slot {
+        bool attached;
+        InputProcessor processor;
+    };
+
+    IInputProcessorSink& m_sink;
+    std::vector<Slot> m_slots;
+    size_t m_attachedCount;
+    uint8_t m_reportedButtons;
+
+    Slot* Claim(uint64_t handle);
+    void ReportButtons(uint64_t timestampNs);
+
+    // IInputProcessorSink, called by the slot being processed
+    void OnButtonState(uint64_t timestampNs, bool leftDown, bool rightDown, bool middleDown) override;
+    void OnMovement(uint64_t timestampNs, int deltaX, int deltaY, uint8_t buttons) override;
+    void OnScrollModeChanged(uint64_t timestampNs, bool enabled) override;
+    void OnDirectScroll(uint64_t timestampNs, int verticalDelta, int horizontalDelta) override;
+};
+
+} // namespace Application
+} // namespace TPMiddle
+
+#endif // TPMIDDLE_DEVICE_STATE_TABLE_H
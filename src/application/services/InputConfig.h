@@ -0,0 +1,39 @@
+#ifndef TPMIDDLE_INPUT_CONFIG_H
+#define TPMIDDLE_INPUT_CONFIG_H
+
+#include "ScrollProfiles.h"
+#include "../../domain/services/ScrollEngine.h"
+#include "../../utils/SnapshotCell.h"
+#include <cstdint>
+#include <memory>
+#include <string>
+
+namespace TPMiddle {
+namespace Application {
+
+/**
+ * @brief Everything the input thread needs from the user configuration
+ *
+ * Built from TPConfig whenever a setting changes and published as an
+ * immutable snapshot, so processing an event never reads Objective-C
+ * properties. Per-axis gains and signs are folded together once, by
+ * ScrollEngine::Configure, when the input thread picks up a new snapshot.
+ * The frontmost application travels with the snapshot, so an application
+ * switch is one more publication rather than a second channel.
+ */
+struct InputConfig {
+    Domain::ScrollSettings scroll;                  // Global settings, before profiles
+    uint64_t chordWindowNs = 20000000ULL;
+    std::string application;                        // Bundle identifier of the frontmost application
+    std::shared_ptr<const ProfileStore> profiles;   // Shared by every snapshot until profiles change
+};
+
+/**
+ * @brief Config publication point: written on configuration changes, read once per event batch
+ */
+using InputConfigCell = Utils::SnapshotCell<InputConfig>;
+
+} // namespace Application
+} // namespace TPMiddle
+
+#endif // TPMIDDLE_INPUT_CONFIG_H
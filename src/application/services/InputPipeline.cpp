@@ -0,0 +1,167 @@
+#include "InputPipeline.h"
+#include "TraceRecorder.h"
+#include "../../domain/models/HIDUsage.h"
+#include <algorithm>
+
+namespace TPMiddle {
+namespace Application {
+
+using namespace Domain;
+
+InputPipeline::InputPipeline(IPipelineOutput& output, const ScrollSettings& settings, uint64_t chordWindowNs)
+    : m_output(output)
+    , m_devices(*this)
+    , m_emulator(chordWindowNs)
+    , m_scrollEngine(settings)
+    , m_scrollSynthesizer(settings.frameRate)
+    , m_momentum(settings.momentumFriction, static_cast<size_t>(std::max(settings.momentumSamples, 0))) {
+}
+
+void InputPipeline::Process(const InputEvent* events, size_t count) {
+    TP_TRACE_SPAN("InputPipeline::Process");
+    for (size_t i = 0; i < count; ++i) {
+        const InputEvent& event = events[i];
+        RunFrameTimer(event.timestamp);
+        m_momentum.Cancel();
+        switch (event.type) {
+            case InputEventType::DeviceAttached:
+                m_devices.Attach(event.device);
+                break;
+            case InputEventType::DeviceRemoved:
+                m_devices.Detach(event.device, event.timestamp);
+                Reset(event.timestamp);
+                break;
+            default:
+                m_devices.Process(event);
+                break;
+        }
+    }
+    m_statistics.eventsProcessed += count;
+}
+
+void InputPipeline::Finish(uint64_t timestampNs) {
+    RunFrameTimer(timestampNs);
+    while (m_momentum.IsActive()) {
+        timestampNs = std::max(timestampNs, GetNextWakeup());
+        FireFrameTimer(timestampNs);
+    }
+    PostFrame(timestampNs, m_scrollSynthesizer.Flush(timestampNs));
+}
+
+void InputPipeline::Reset(uint64_t timestampNs) {
+    Apply(timestampNs, m_emulator.Reset());
+    m_scrollEngine.Reset(timestampNs);
+    m_scrollSynthesizer.Reset();
+    m_momentum.Reset();
+}
+
+void InputPipeline::RunFrameTimer(uint64_t timestampNs) {
+    for (uint64_t deadline = m_emulator.GetNextDeadline(); deadline <= timestampNs;
+         deadline = m_emulator.GetNextDeadline()) {
+        Apply(deadline, m_emulator.Advance(deadline));
+    }
+    while (m_momentum.IsActive() && GetNextWakeup() <= timestampNs) {
+        FireFrameTimer(GetNextWakeup());
+    }
+    PostFrame(timestampNs, m_scrollSynthesizer.Tick(timestampNs));
+}
+
+void InputPipeline::FireFrameTimer(uint64_t timestampNs) {
+    ScrollOutput coast = m_momentum.Advance(timestampNs);
+    PostFrame(timestampNs, coast.emit ? m_scrollSynthesizer.Add(timestampNs, coast.deltaX, coast.deltaY)
+                                      : m_scrollSynthesizer.Tick(timestampNs));
+}
+
+uint64_t InputPipeline::GetNextDeadline() {
+    uint64_t deadline = m_emulator.GetNextDeadline();
+    if (m_momentum.IsActive()) {
+        deadline = std::min(deadline, GetNextWakeup());
+    } else if (m_scrollSynthesizer.HasPending()) {
+        deadline = std::min(deadline, m_scrollSynthesizer.GetNextFrameTime());
+    }
+    return deadline;
+}
+
+// While coasting the app's timer waits for both a new step and a free frame
+uint64_t InputPipeline::GetNextWakeup() const {
+    return std::max(m_momentum.GetNextStepTime(), m_scrollSynthesizer.GetNextFrameTime());
+}
+
+void InputPipeline::Apply(uint64_t timestampNs, const MiddleButtonActions& actions) {
+    // Deliver scroll still waiting for a frame before the middle button goes up
+    if (actions.clearScroll) {
+        PostFrame(timestampNs, m_scrollSynthesizer.Flush(timestampNs));
+        m_scrollEngine.ClearAccumulator();
+        if (m_scrollEngine.GetSettings().momentum) {
+            m_momentum.Start(timestampNs);
+        }
+    }
+    if (actions.postLeftDown) {
+        PostButton(timestampNs, kButtonMaskLeft, true);
+    }
+    if (actions.postRightDown) {
+        PostButton(timestampNs, kButtonMaskRight, true);
+    }
+    if (actions.postMiddleDown) {
+        m_output.PostMiddleButton(timestampNs, true);
+        ++m_statistics.middleButtonEvents;
+        if (m_emulator.IsMiddleEmulated()) {
+            ++m_statistics.chordDetections;
+            TP_TRACE_INSTANT("chord", 0);
+        }
+    }
+    if (actions.postLeftUp) {
+        PostButton(timestampNs, kButtonMaskLeft, false);
+    }
+    if (actions.postRightUp) {
+        PostButton(timestampNs, kButtonMaskRight, false);
+    }
+    if (actions.postMiddleUp) {
+        m_output.PostMiddleButton(timestampNs, false);
+        ++m_statistics.middleButtonEvents;
+    }
+}
+
+void InputPipeline::PostButton(uint64_t timestampNs, uint8_t buttonMask, bool isDown) {
+    m_output.PostButton(timestampNs, buttonMask, isDown);
+    ++m_statistics.replayedButtonEvents;
+}
+
+void InputPipeline::PostFrame(uint64_t timestampNs, const ScrollFrame& frame) {
+    if (frame.emit) {
+        TP_TRACE_SPAN("IPipelineOutput::PostScroll");
+        m_output.PostScroll(timestampNs, frame.deltaX, frame.deltaY);
+        ++m_statistics.scrollEvents;
+    }
+}
+
+void InputPipeline::OnButtonState(uint64_t timestampNs, bool leftDown, bool rightDown, bool middleDown) {
+    ++m_statistics.buttonUpdates;
+    Apply(timestampNs, m_emulator.Update(timestampNs, leftDown, rightDown, middleDown));
+}
+
+void InputPipeline::OnMovement(uint64_t timestampNs, int deltaX, int deltaY, uint8_t) {
+    ++m_statistics.movements;
+    if (!m_emulator.IsScrollActive()) {
+        // The processor inverted both axes for scrolling
+        m_output.PostMotion(timestampNs, -deltaX, -deltaY);
+        return;
+    }
+
+    ScrollOutput output = m_scrollEngine.ProcessMovement(timestampNs, deltaX, deltaY);
+    if (output.emit) {
+        m_momentum.AddSample(timestampNs, output.deltaX, output.deltaY);
+        PostFrame(timestampNs, m_scrollSynthesizer.Add(timestampNs, output.deltaX, output.deltaY));
+    }
+}
+
+void InputPipeline::OnScrollModeChanged(uint64_t, bool) {
+}
+
+void InputPipeline::OnDirectScroll(uint64_t timestampNs, int verticalDelta, int horizontalDelta) {
+    m_output.PostScroll(timestampNs, horizontalDelta, verticalDelta);
+    ++m_statistics.scrollEvents;
+}
+
+} // namespace Application
+} // namespace TPMiddle
@@ -0,0 +1,139 @@
+#ifndef TPMIDDLE_INPUT_PIPELINE_H
+#define TPMIDDLE_INPUT_PIPELINE_H
+
+#include "DeviceStateTable.h"
+#include "../../domain/services/MiddleButtonEmulator.h"
+#include "../../domain/services/MomentumIntegrator.h"
+#include "../../domain/services/ScrollEngine.h"
+#include "../../domain/services/ScrollSynthesizer.h"
+#include <cstddef>
+#include <cstdint>
+
+namespace TPMiddle {
+namespace Application {
+
+/**
+ * @brief Synthetic output produced by the pipeline
+ */
+class IPipelineOutput {
+public:
+    virtual ~IPipelineOutput() = default;
+
+    virtual void PostMiddleButton(uint64_t timestampNs, bool isDown) = 0;
+    virtual void PostScroll(uint64_t timestampNs, double deltaX, double deltaY) = 0;
+
+    /**
+     * @brief Left or right button edge replayed under ChordClickPolicy::Hold
+     * @param buttonMask Domain::kButtonMaskLeft or Domain::kButtonMaskRight
+     */
+    virtual void PostButton(uint64_t timestampNs, uint8_t buttonMask, bool isDown) {
+        (void)timestampNs;
+        (void)buttonMask;
+        (void)isDown;
+    }
+
+    /**
+     * @brief Pointer movement that did not become scroll, in device
+     * direction; only needed where the pipeline owns the device
+     */
+    virtual void PostMotion(uint64_t timestampNs, int deltaX, int deltaY) {
+        (void)timestampNs;
+        (void)deltaX;
+        (void)deltaY;
+    }
+};
+
+/**
+ * @brief Counters for one pipeline instance
+ */
+struct InputPipelineStatistics {
+    uint64_t eventsProcessed = 0;
+    uint64_t buttonUpdates = 0;
+    uint64_t movements = 0;
+    uint64_t scrollEvents = 0;
+    uint64_t middleButtonEvents = 0;
+    uint64_t replayedButtonEvents = 0;
+    uint64_t chordDetections = 0;       // Emulated middle presses
+};
+
+/**
+ * @brief Headless composition of the input processing stages
+ *
+ * Wires DeviceStateTable -> MiddleButtonEmulator -> ScrollEngine ->
+ * ScrollSynthesizer the same way TPHIDManager -> TPApplication ->
+ * TPButtonManager do in the app, but with no platform dependencies. Used to
+ * replay recorded traces and to benchmark the processing path. Scroll
+ * frames that come due between events are emitted when the next event is
+ * processed or on Finish(), and momentum after a release is integrated at
+ * the wakeups the app's frame timer would have had before the next event.
+ * Chord window deadlines fire at their exact time in the same way.
+ */
+class InputPipeline : private IInputProcessorSink {
+public:
+    InputPipeline(IPipelineOutput& output,
+                  const Domain::ScrollSettings& settings = Domain::ScrollSettings(),
+                  uint64_t chordWindowNs = 20000000ULL);
+
+    void Process(const Domain::InputEvent* events, size_t count);
+    void Process(const Domain::InputEvent& event) { Process(&event, 1); }
+
+    /**
+     * @brief Let momentum coast to a stop and emit any scroll still waiting
+     * for a frame, e.g. at the end of a trace
+     */
+    void Finish(uint64_t timestampNs);
+
+    /**
+     * @brief Reset every stage, as the app does when a device is detached
+     */
+    void Reset(uint64_t timestampNs);
+
+    /**
+     * @brief Hold left and right presses back until they cannot start a chord
+     *
+     * The app cannot do this without seizing the device, so it keeps the
+     * default PassThrough; headless consumers may opt in.
+     */
+    void SetClickPolicy(Domain::ChordClickPolicy policy) { m_emulator.SetClickPolicy(policy); }
+
+    /**
+     * @brief Run chord deadlines, momentum and scroll frames due by timestampNs
+     * when no event arrived, for live callers that sleep until GetNextDeadline()
+     */
+    void Advance(uint64_t timestampNs) { RunFrameTimer(timestampNs); }
+
+    /**
+     * @brief When Advance() next has work to do, UINT64_MAX if nothing is pending
+     */
+    uint64_t GetNextDeadline();
+
+    const InputPipelineStatistics& GetStatistics() const { return m_statistics; }
+    const DeviceStateTable& GetDevices() const { return m_devices; }
+
+private:
+    IPipelineOutput& m_output;
+    DeviceStateTable m_devices;
+    Domain::MiddleButtonEmulator m_emulator;
+    Domain::ScrollEngine m_scrollEngine;
+    Domain::ScrollSynthesizer m_scrollSynthesizer;
+    Domain::MomentumIntegrator m_momentum;
+    InputPipelineStatistics m_statistics;
+
+    void Apply(uint64_t timestampNs, const Domain::MiddleButtonActions& actions);
+    void PostButton(uint64_t timestampNs, uint8_t buttonMask, bool isDown);
+    void PostFrame(uint64_t timestampNs, const Domain::ScrollFrame& frame);
+    void RunFrameTimer(uint64_t timestampNs);
+    void FireFrameTimer(uint64_t timestampNs);
+    uint64_t GetNextWakeup() const;
+
+    // IInputProcessorSink
+    void OnButtonState(uint64_t timestampNs, bool leftDown, bool rightDown, bool middleDown) override;
+    void OnMovement(uint64_t timestampNs, int deltaX, int deltaY, uint8_t buttons) override;
+    void OnScrollModeChanged(uint64_t timestampNs, bool enabled) override;
+    void OnDirectScroll(uint64_t timestampNs, int verticalDelta, int horizontalDelta) override;
+};
+
+} // namespace Application
+} // namespace TPMiddle
+
+#endif // TPMIDDLE_INPUT_PIPELINE_H
@@ -0,0 +1,147 @@
+#include "InputProcessor.h"
+#include "../../domain/models/HIDUsage.h"
+
+namespace TPMiddle {
+namespace Application {
+
+using namespace Domain;
+
+InputProcessor::InputProcessor(IInputProcessorSink& sink)
+    : m_sink(sink)
+    , m_toggle(new MiddleButtonEmulator()) {
+    m_toggle->SetScrollToggleWindow(kScrollTogglePressNs);
+    Reset();
+}
+
+void InputProcessor::Reset() {
+    m_leftDown = false;
+    m_rightDown = false;
+    m_middleDown = false;
+    m_toggle->Reset();
+    m_pendingDeltaX = 0;
+    m_pendingDeltaY = 0;
+    m_lastMovementTime = 0;
+}
+
+uint8_t InputProcessor::GetButtonMask() const {
+    return (m_leftDown ? kButtonMaskLeft : 0) |
+           (m_rightDown ? kButtonMaskRight : 0) |
+           (m_middleDown ? kButtonMaskMiddle : 0);
+}
+
+void InputProcessor::Process(const InputEvent& event) {
+    switch (event.type) {
+        case InputEventType::Value:
+            HandleElement(event);
+            break;
+        case InputEventType::Pointer:
+            HandlePointer(event);
+            break;
+        default:
+            break;
+    }
+}
+
+void InputProcessor::HandleElement(const InputEvent& event) {
+    if (event.element.usagePage == HIDUsage::kPageButton) {
+        HandleButton(event);
+    } else if (event.element.usagePage == HIDUsage::kPageGenericDesktop) {
+        switch (event.element.usage) {
+            case HIDUsage::kX:
+            case HIDUsage::kY:
+                HandleMovement(event);
+                break;
+            case HIDUsage::kWheel:
+                m_sink.OnDirectScroll(event.timestamp, event.element.value, 0);
+                break;
+            default:
+                break;
+        }
+    }
+}
+
+void InputProcessor::HandlePointer(const InputEvent& event) {
+    const PointerSample& sample = event.pointer;
+
+    // Buttons first, matching the order elements appear in a mouse report
+    bool leftDown = (sample.buttons & kButtonMaskLeft) != 0;
+    bool rightDown = (sample.buttons & kButtonMaskRight) != 0;
+    bool middleDown = (sample.buttons & kButtonMaskMiddle) != 0;
+    if (leftDown != m_leftDown || rightDown != m_rightDown || middleDown != m_middleDown) {
+        ApplyButton(HIDUsage::kButtonLeft, leftDown, event.timestamp);
+        ApplyButton(HIDUsage::kButtonRight, rightDown, event.timestamp);
+        ApplyButton(HIDUsage::kButtonMiddle, middleDown, event.timestamp);
+        m_sink.OnButtonState(event.timestamp, m_leftDown, m_rightDown, m_middleDown);
+    }
+
+    // X and Y come from the same report, so no coalescing window is needed
+    if (sample.deltaX != 0 || sample.deltaY != 0) {
+        int deltaX = -sample.deltaX;
+        int deltaY = -sample.deltaY;
+        if (IsScrollMode() && !m_middleDown) {
+            m_sink.OnDirectScroll(event.timestamp, deltaY, deltaX);
+        } else {
+            m_sink.OnMovement(event.timestamp, deltaX, deltaY, GetButtonMask());
+        }
+        m_lastMovementTime = event.timestamp;
+    }
+
+    if (sample.wheel != 0 || sample.pan != 0) {
+        m_sink.OnDirectScroll(event.timestamp, sample.wheel, sample.pan);
+    }
+}
+
+void InputProcessor::HandleButton(const InputEvent& event) {
+    ApplyButton(event.element.usage, event.element.value != 0, event.timestamp);
+    m_sink.OnButtonState(event.timestamp, m_leftDown, m_rightDown, m_middleDown);
+}
+
+void InputProcessor::ApplyButton(uint16_t button, bool pressed, uint64_t timestamp) {
+    switch (button) {
+        case HIDUsage::kButtonLeft:
+            m_leftDown = pressed;
+            break;
+        case HIDUsage::kButtonRight:
+            m_rightDown = pressed;
+            break;
+        case HIDUsage::kButtonMiddle: {
+            // Left and right stay out of the toggle so a chord cannot swallow the click
+            MiddleButtonActions actions = m_toggle->Update(timestamp, false, false, pressed);
+            if (actions.scrollModeChanged) {
+                m_sink.OnScrollModeChanged(timestamp, m_toggle->IsScrollMode());
+            }
+            m_middleDown = pressed;
+            break;
+        }
+        default:
+            break;
+    }
+}
+
+void InputProcessor::HandleMovement(const InputEvent& event) {
+    // Invert both axes for natural movement; sum so no delta is lost while coalescing
+    if (event.element.usage == HIDUsage::kX) {
+        m_pendingDeltaX -= event.element.value;
+    } else {
+        m_pendingDeltaY -= event.element.value;
+    }
+
+    if (event.timestamp - m_lastMovementTime < kMovementIntervalNs) {
+        return;
+    }
+
+    if (m_pendingDeltaX != 0 || m_pendingDeltaY != 0) {
+        if (IsScrollMode() && !m_middleDown) {
+            m_sink.OnDirectScroll(event.timestamp, m_pendingDeltaY, m_pendingDeltaX);
+        } else {
+            m_sink.OnMovement(event.timestamp, m_pendingDeltaX, m_pendingDeltaY, GetButtonMask());
+        }
+    }
+
+    m_pendingDeltaX = 0;
+    m_pendingDeltaY = 0;
+    m_lastMovementTime = event.timestamp;
+}
+
+} // namespace Application
+} // namespace TPMiddle
@@ -0,0 +1,94 @@
+#ifndef TPMIDDLE_INPUT_PROCESSOR_H
+#define TPMIDDLE_INPUT_PROCESSOR_H
+
+#include "../../domain/models/InputEvent.h"
+#include "../../domain/services/MiddleButtonEmulator.h"
+#include <cstdint>
+#include <memory>
+
+namespace TPMiddle {
+namespace Application {
+
+/**
+ * @brief Receives the decoded output of an InputProcessor
+ *
+ * All methods are called on the thread that calls InputProcessor::Process.
+ */
+class IInputProcessorSink {
+public:
+    virtual ~IInputProcessorSink() = default;
+
+    /**
+     * @brief Physical button state after a button element changed
+     */
+    virtual void OnButtonState(uint64_t timestampNs, bool leftDown, bool rightDown, bool middleDown) = 0;
+
+    /**
+     * @brief Pointer movement while not in scroll mode
+     */
+    virtual void OnMovement(uint64_t timestampNs, int deltaX, int deltaY, uint8_t buttons) = 0;
+
+    /**
+     * @brief Scroll mode was toggled by a quick middle button press
+     */
+    virtual void OnScrollModeChanged(uint64_t timestampNs, bool enabled) = 0;
+
+    /**
+     * @brief Scroll to post as-is (wheel input, or movement in scroll mode)
+     */
+    virtual void OnDirectScroll(uint64_t timestampNs, int verticalDelta, int horizontalDelta) = 0;
+};
+
+/**
+ * @brief Platform-neutral decoding of raw HID input
+ *
+ * Tracks button state, the quick-press scroll mode toggle and X/Y movement
+ * that TPHIDManager used to do inline. The toggle is the scroll toggle
+ * window of a MiddleButtonEmulator fed only the middle button. Pointer
+ * events (whole decoded reports) are handled as one sample; per-element
+ * Value events, used for devices without a usable report descriptor, are
+ * summed and coalesced over kMovementIntervalNs. Timing decisions use the
+ * event timestamps, so a recorded trace replays deterministically.
+ */
+class InputProcessor {
+public:
+    static constexpr uint64_t kMovementIntervalNs = 1000000ULL;      // Process movements every millisecond
+    static constexpr uint64_t kScrollTogglePressNs = 500000000ULL;   // Toggle only on quick press
+
+    explicit InputProcessor(IInputProcessorSink& sink);
+
+    /**
+     * @brief Process one Value or Pointer event; device events are ignored
+     * @param event Event whose timestamp is in monotonic nanoseconds
+     */
+    void Process(const Domain::InputEvent& event);
+
+    /**
+     * @brief Forget button, movement and scroll mode state
+     */
+    void Reset();
+
+    bool IsScrollMode() const { return m_toggle->IsScrollMode(); }
+    uint8_t GetButtonMask() const;
+
+private:
+    IInputProcessorSink& m_sink;
+    bool m_leftDown;
+    bool m_rightDown;
+    bool m_middleDown;
+    std::unique_ptr<Domain::MiddleButtonEmulator> m_toggle;   // Held by pointer so processors stay movable
+    int m_pendingDeltaX;
+    int m_pendingDeltaY;
+    uint64_t m_lastMovementTime;
+
+    void HandleElement(const Domain::InputEvent& event);
+    void HandlePointer(const Domain::InputEvent& event);
+    void HandleButton(const Domain::InputEvent& event);
+    void HandleMovement(const Domain::InputEvent& event);
+    void ApplyButton(uint16_t button, bool pressed, uint64_t timestamp);
+};
+
+} // namespace Application
+} // namespace TPMiddle
+
+#endif // TPMIDDLE_INPUT_PROCESSOR_H
@@ -0,0 +1,178 @@
+#include "InputWorker.h"
+#include "TraceRecorder.h"
+#include <chrono>
+#include <pthread.h>
+#if defined(__APPLE__)
+#include <pthread/qos.h>
+#else
+#include <sched.h>
+#endif
+
+namespace TPMiddle {
+namespace Application {
+
+namespace {
+
+// Polls of an empty ring before the worker parks on the condition variable
+const int kSpinsBeforePark = 64;
+
+// Upper bound on a single park so a missed wakeup can only ever delay, never stall
+const std::chrono::milliseconds kParkTimeout(100);
+
+} // namespace
+
+InputWorker::InputWorker()
+    : m_running(false)
+    , m_stopRequested(false)
+    , m_parked(false)
+    , m_submitted(0)
+    , m_processed(0)
+    , m_batches(0)
+    , m_maxBatch(0) {
+}
+
+InputWorker::~InputWorker() {
+    Stop();
+}
+
+bool InputWorker::Start(BatchHandler handler) {
+    if (m_running.load(std::memory_order_acquire)) {
+        return false;
+    }
+
+    m_handler = std::move(handler);
+    m_stopRequested.store(false, std::memory_order_release);
+    m_running.store(true, std::memory_order_release);
+    m_thread = std::thread(&InputWorker::Run, this);
+    return true;
+}
+
+void InputWorker::Stop() {
+    if (!m_running.load(std::memory_order_acquire)) {
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_parkMutex);
+        m_stopRequested.store(true, std::memory_order_release);
+    }
+    m_parkCondition.notify_one();
+
+    if (m_thread.joinable()) {
+        m_thread.join();
+    }
+    m_running.store(false, std::memory_order_release);
+}
+
+bool InputWorker::Submit(const Domain::InputEvent& event) {
+    if (!m_ring.TryPush(event)) {
+        return false;
+    }
+    m_submitted.fetch_add(1, std::memory_order_relaxed);
+
+    // Pairs with the fence in Park(): either we see the worker parked, or the
+    // worker sees our event before it goes to sleep.
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (m_parked.load(std::memory_order_relaxed)) {
+        std::lock_guard<std::mutex> lock(m_parkMutex);
+        m_parkCondition.notify_one();
+    }
+    return true;
+}
+
+bool InputWorker::SubmitWaiting(const Domain::InputEvent& event) {
+    // Only this thread adds to the ring, so room seen here is still there
+    // for Submit(), and waiting does not count as an overflow
+    while (m_ring.Size() >= Ring::kCapacity) {
+        if (!m_running.load(std::memory_order_acquire)) {
+            return false;
+        }
+        std::this_thread::yield();
+    }
+    return Submit(event);
+}
+
+InputWorkerStatistics InputWorker::GetStatistics() const {
+    InputWorkerStatistics stats;
+    stats.submitted = m_submitted.load(std::memory_order_relaxed);
+    stats.dropped = m_ring.GetOverflowCount();
+    stats.processed = m_processed.load(std::memory_order_relaxed);
+    stats.batches = m_batches.load(std::memory_order_relaxed);
+    stats.maxBatch = m_maxBatch.load(std::memory_order_relaxed);
+    stats.queueDepth = m_ring.Size();
+    return stats;
+}
+
+void InputWorker::Run() {
+    RaiseThreadPriority();
+    TraceRecorder::SetThreadName("input worker");
+
+    int idleSpins = 0;
+    while (!m_stopRequested.load(std::memory_order_acquire)) {
+        if (DrainOnce() > 0) {
+            idleSpins = 0;
+            continue;
+        }
+        if (++idleSpins < kSpinsBeforePark) {
+            std::this_thread::yield();
+            continue;
+        }
+        Park();
+        idleSpins = 0;
+    }
+
+    // Deliver whatever the producer queued before the stop request
+    while (DrainOnce() > 0) {
+    }
+}
+
+size_t InputWorker::DrainOnce() {
+    Domain::InputEvent batch[kMaxBatchSize];
+    size_t count = m_ring.PopBatch(batch, kMaxBatchSize);
+    if (count == 0) {
+        return 0;
+    }
+
+    if (m_handler) {
+        TP_TRACE_SPAN("InputWorker batch");
+        TP_TRACE_COUNTER("input batch size", static_cast<int64_t>(count));
+        m_handler(batch, count);
+    }
+
+    m_processed.fetch_add(count, std::memory_order_relaxed);
+    m_batches.fetch_add(1, std::memory_order_relaxed);
+    if (count > m_maxBatch.load(std::memory_order_relaxed)) {
+        m_maxBatch.store(count, std::memory_order_relaxed);
+    }
+    return count;
+}
+
+void InputWorker::Park() {
+    m_parked.store(true, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+
+    {
+        std::unique_lock<std::mutex> lock(m_parkMutex);
+        m_parkCondition.wait_for(lock, kParkTimeout, [this] {
+            return !m_ring.IsEmpty() || m_stopRequested.load(std::memory_order_acquire);
+        });
+    }
+
+    m_parked.store(false, std::memory_order_relaxed);
+}
+
+void InputWorker::RaiseThreadPriority() {
+#if defined(__APPLE__)
+    pthread_setname_np("com.tpmiddle.input");
+    pthread_set_qos_class_self_np(QOS_CLASS_USER_INTERACTIVE, 0);
+#else
+    pthread_setname_np(pthread_self(), "tpmiddle-input");
+    // Real-time scheduling needs CAP_SYS_NICE; without it we stay at normal priority
+    sched_param param = {};
+    param.sched_priority = sched_get_priority_min(SCHED_FIFO);
+    pthread_setschedparam(pthread_self(), SCHED_FIFO, &param);
+#endif
+}
+
+} // namespace Application
+} // namespace TPMiddle
@@ -0,0 +1,113 @@
+#ifndef TPMIDDLE_INPUT_WORKER_H
+#define TPMIDDLE_INPUT_WORKER_H
+
+#include "../../domain/models/InputEvent.h"
+#include "../../utils/SPSCRing.h"
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+namespace TPMiddle {
+namespace Application {
+
+/**
+ * @brief Counters describing the input queue since the worker was created
+ */
+struct InputWorkerStatistics {
+    uint64_t submitted = 0;   // Events accepted into the ring
+    uint64_t dropped = 0;     // Events rejected because the ring was full
+    uint64_t processed = 0;   // Events handed to the batch handler
+    uint64_t batches = 0;     // Number of handler invocations
+    uint64_t maxBatch = 0;    // Largest batch observed
+    uint64_t queueDepth = 0;  // Events waiting at the time of the snapshot
+};
+
+/**
+ * @brief Dedicated processing thread fed through a lock-free SPSC ring
+ *
+ * The platform input callback is the single producer and only calls Submit(),
+ * which copies a POD event into the ring and, if the worker is parked, wakes
+ * it. The worker drains the ring in batches and hands each batch to the
+ * handler on its own high-priority thread.
+ */
+class InputWorker {
+public:
+    static constexpr size_t kQueueCapacity = 4096;
+    static constexpr size_t kMaxBatchSize = 64;
+
+    using BatchHandler = std::function<void(const Domain::InputEvent* events, size_t count)>;
+
+    InputWorker();
+    ~InputWorker();
+
+    InputWorker(const InputWorker&) = delete;
+    InputWorker& operator=(const InputWorker&) = delete;
+
+    /**
+     * @brief Start the processing thread
+     * @param handler Called on the worker thread for every drained batch
+     * @return bool True if the worker is running, false if it was already started
+     */
+    bool Start(BatchHandler handler);
+
+    /**
+     * @brief Drain remaining events and join the processing thread
+     */
+    void Stop();
+
+    bool IsRunning() const { return m_running.load(std::memory_order_acquire); }
+
+    /**
+     * @brief Queue one event (producer thread only)
+     * @param event The event to copy into the ring
+     * @return bool True if queued, false if the ring was full and the event was dropped
+     */
+    bool Submit(const Domain::InputEvent& event);
+
+    /**
+     * @brief Queue an event that must not be lost, waiting while the ring is full (producer thread only)
+     *
+     * For rare control events such as device attach and removal; input
+     * events use Submit() so a stalled worker never blocks the producer.
+     * @param event The event to copy into the ring
+     * @return bool True if queued, false if the worker is not running to make room
+     */
+    bool SubmitWaiting(const Domain::InputEvent& event);
+
+    /**
+     * @brief Snapshot the queue counters (any thread)
+     */
+    InputWorkerStatistics GetStatistics() const;
+
+private:
+    using Ring = Utils::SPSCRing<Domain::InputEvent, kQueueCapacity>;
+
+    Ring m_ring;
+    BatchHandler m_handler;
+    std::thread m_thread;
+    std::atomic<bool> m_running;
+    std::atomic<bool> m_stopRequested;
+
+    // Parking: the worker only sleeps after announcing it through m_parked
+    std::atomic<bool> m_parked;
+    std::mutex m_parkMutex;
+    std::condition_variable m_parkCondition;
+
+    std::atomic<uint64_t> m_submitted;
+    std::atomic<uint64_t> m_processed;
+    std::atomic<uint64_t> m_batches;
+    std::atomic<uint64_t> m_maxBatch;
+
+    void Run();
+    size_t DrainOnce();
+    void Park();
+    static void RaiseThreadPriority();
+};
+
+} // namespace Application
+} // namespace TPMiddle
+
+#endif // TPMIDDLE_INPUT_WORKER_H
@@ -0,0 +1,122 @@
+#include "LatencyMonitor.h"
+#include <cinttypes>
+#include <cstdio>
+
+namespace TPMiddle {
+namespace Application {
+
+using Domain::InputEvent;
+using Utils::LatencyHistogramSnapshot;
+
+namespace {
+
+std::string FormatDuration(double nanoseconds) {
+    char buffer[32];
+    if (nanoseconds < 1000.0) {
+        std::snprintf(buffer, sizeof(buffer), "%.0f ns", nanoseconds);
+    } else if (nanoseconds < 1000000.0) {
+        std::snprintf(buffer, sizeof(buffer), "%.1f us", nanoseconds / 1000.0);
+    } else {
+        std::snprintf(buffer, sizeof(buffer), "%.2f ms", nanoseconds / 1000000.0);
+    }
+    return buffer;
+}
+
+} // namespace
+
+LatencyMonitor::LatencyMonitor()
+    : m_eventsProcessed(0)
+    , m_outputsPosted(0)
+    , m_momentumFramesPosted(0)
+    , m_currentEventNs(0)
+    , m_currentDequeueNs(0) {
+}
+
+LatencyMonitor& LatencyMonitor::Shared() {
+    static LatencyMonitor monitor;
+    return monitor;
+}
+
+void LatencyMonitor::RecordDequeue(const InputEvent& event, uint64_t dequeueNs) {
+    uint64_t callbackNs = event.timestamp + event.callbackDelayNs;
+
+    Histogram(LatencyStage::HIDToCallback).Record(event.callbackDelayNs);
+    Histogram(LatencyStage::QueueWait).Record(dequeueNs > callbackNs ? dequeueNs - callbackNs : 0);
+    m_eventsProcessed.fetch_add(1, std::memory_order_relaxed);
+
+    m_currentEventNs.store(event.timestamp, std::memory_order_relaxed);
+    m_currentDequeueNs.store(dequeueNs, std::memory_order_relaxed);
+}
+
+void LatencyMonitor::RecordOutput(uint64_t postNs) {
+    m_outputsPosted.fetch_add(1, std::memory_order_relaxed);
+
+    // Outputs not caused by an input event (e.g. a reset) have nothing to attribute
+    uint64_t eventNs = m_currentEventNs.load(std::memory_order_relaxed);
+    uint64_t dequeueNs = m_currentDequeueNs.load(std::memory_order_relaxed);
+    if (eventNs == 0 || postNs < dequeueNs) {
+        return;
+    }
+
+    Histogram(LatencyStage::Processing).Record(postNs - dequeueNs);
+    Histogram(LatencyStage::EndToEnd).Record(postNs > eventNs ? postNs - eventNs : 0);
+}
+
+void LatencyMonitor::RecordFrameOutput(uint64_t sourceNs, uint64_t postNs) {
+    m_outputsPosted.fetch_add(1, std::memory_order_relaxed);
+    if (sourceNs == 0) {
+        m_momentumFramesPosted.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    Histogram(LatencyStage::EndToEnd).Record(postNs > sourceNs ? postNs - sourceNs : 0);
+}
+
+LatencyHistogramSnapshot LatencyMonitor::GetSnapshot(LatencyStage stage) const {
+    return m_histograms[static_cast<size_t>(stage)].Snapshot();
+}
+
+std::string LatencyMonitor::FormatReport(const InputWorkerStatistics& queue) const {
+    char line[192];
+    std::snprintf(line, sizeof(line),
+                  "Events: %" PRIu64 " received, %" PRIu64 " dropped, %" PRIu64 " processed, %" PRIu64
+                  " posted (%" PRIu64 " momentum)\n",
+                  queue.submitted, queue.dropped, GetEventsProcessed(), GetOutputsPosted(), GetMomentumFramesPosted());
+    std::string report = line;
+
+    for (size_t i = 0; i < static_cast<size_t>(LatencyStage::Count); ++i) {
+        LatencyStage stage = static_cast<LatencyStage>(i);
+        LatencyHistogramSnapshot snapshot = GetSnapshot(stage);
+        std::snprintf(line, sizeof(line), "%-14s n=%" PRIu64 "  mean %s  p50 %s  p99 %s  max %s\n",
+                      StageName(stage), snapshot.count,
+                      FormatDuration(snapshot.Mean()).c_str(),
+                      FormatDuration(static_cast<double>(snapshot.Percentile(0.50))).c_str(),
+                      FormatDuration(static_cast<double>(snapshot.Percentile(0.99))).c_str(),
+                      FormatDuration(static_cast<double>(snapshot.max)).c_str());
+        report += line;
+    }
+    return report;
+}
+
+void LatencyMonitor::Reset() {
+    for (auto& histogram : m_histograms) {
+        histogram.Reset();
+    }
+    m_eventsProcessed.store(0, std::memory_order_relaxed);
+    m_outputsPosted.store(0, std::memory_order_relaxed);
+    m_momentumFramesPosted.store(0, std::memory_order_relaxed);
+    m_currentEventNs.store(0, std::memory_order_relaxed);
+    m_currentDequeueNs.store(0, std::memory_order_relaxed);
+}
+
+const char* LatencyMonitor::StageName(LatencyStage stage) {
+    switch (stage) {
+        case LatencyStage::HIDToCallback: return "hid->callback";
+        case LatencyStage::QueueWait: return "queue wait";
+        case LatencyStage::Processing: return "processing";
+        case LatencyStage::EndToEnd: return "end-to-end";
+        default: return "unknown";
+    }
+}
+
+} // namespace Application
+} // namespace TPMiddle
@@ -0,0 +1,109 @@
+#ifndef TPMIDDLE_LATENCY_MONITOR_H
+#define TPMIDDLE_LATENCY_MONITOR_H
+
+#include "../../domain/models/InputEvent.h"
+#include "../../utils/LatencyHistogram.h"
+#include "InputWorker.h"
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+namespace TPMiddle {
+namespace Application {
+
+/**
+ * @brief Segments of the path from a HID report to the synthesized output event
+ */
+enum class LatencyStage : uint8_t {
+    HIDToCallback = 0,   // HID timestamp until the input callback ran
+    QueueWait = 1,       // Callback until the input worker dequeued the event
+    Processing = 2,      // Dequeue until the output event was posted
+    EndToEnd = 3,        // HID timestamp until the output event was posted
+    Count = 4
+};
+
+/**
+ * @brief Per-stage input latency histograms and event counters
+ *
+ * All times are monotonic nanoseconds on the same clock as InputEvent
+ * timestamps. The input worker calls RecordDequeue() for each value event
+ * it processes; whoever posts an output event on that thread calls
+ * RecordOutput(), which attributes the output to the event being processed.
+ * Frame-paced scroll is posted later, often from another thread, so it is
+ * recorded with RecordFrameOutput() against the input it came from.
+ * Recording is lock-free and allocation-free.
+ */
+class LatencyMonitor {
+public:
+    LatencyMonitor();
+
+    LatencyMonitor(const LatencyMonitor&) = delete;
+    LatencyMonitor& operator=(const LatencyMonitor&) = delete;
+
+    /**
+     * @brief Process-wide instance used by the input path and the status bar
+     */
+    static LatencyMonitor& Shared();
+
+    /**
+     * @brief Record the callback and queue stages of an event entering processing
+     * @param event Value event whose timestamp and callbackDelayNs are set
+     * @param dequeueNs Time the worker dequeued the event's batch
+     */
+    void RecordDequeue(const Domain::InputEvent& event, uint64_t dequeueNs);
+
+    /**
+     * @brief Record the processing and end-to-end stages of a posted output event
+     * @param postNs Time the output event was handed to the OS
+     */
+    void RecordOutput(uint64_t postNs);
+
+    /**
+     * @brief Record the end-to-end stage of a frame-paced scroll event
+     *
+     * A frame sums scroll from inputs processed at different times, so only
+     * the end-to-end time from its oldest input is recorded. Momentum frames
+     * have no input behind them; they are counted apart and not timed, since
+     * coasting for hundreds of milliseconds after release is not input latency.
+     * @param sourceNs HID timestamp of the oldest input in the frame, 0 for momentum
+     * @param postNs Time the output event was handed to the OS
+     */
+    void RecordFrameOutput(uint64_t sourceNs, uint64_t postNs);
+
+    Utils::LatencyHistogramSnapshot GetSnapshot(LatencyStage stage) const;
+    uint64_t GetEventsProcessed() const { return m_eventsProcessed.load(std::memory_order_relaxed); }
+    uint64_t GetOutputsPosted() const { return m_outputsPosted.load(std::memory_order_relaxed); }
+    uint64_t GetMomentumFramesPosted() const { return m_momentumFramesPosted.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Human-readable summary, one line per counter group and stage
+     * @param queue Input queue counters to include (received and dropped events)
+     */
+    std::string FormatReport(const InputWorkerStatistics& queue) const;
+
+    /**
+     * @brief Clear all histograms and counters
+     */
+    void Reset();
+
+    static const char* StageName(LatencyStage stage);
+
+private:
+    Utils::LatencyHistogram m_histograms[static_cast<size_t>(LatencyStage::Count)];
+    std::atomic<uint64_t> m_eventsProcessed;
+    std::atomic<uint64_t> m_outputsPosted;
+    std::atomic<uint64_t> m_momentumFramesPosted;   // Included in m_outputsPosted
+
+    // Event currently being processed; written by the worker, read by posters
+    std::atomic<uint64_t> m_currentEventNs;
+    std::atomic<uint64_t> m_currentDequeueNs;
+
+    Utils::LatencyHistogram& Histogram(LatencyStage stage) {
+        return m_histograms[static_cast<size_t>(stage)];
+    }
+};
+
+} // namespace Application
+} // namespace TPMiddle
+
+#endif // TPMIDDLE_LATENCY_MONITOR_H
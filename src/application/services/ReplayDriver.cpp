@@ -0,0 +1,67 @@
+#include "ReplayDriver.h"
+#include "../../utils/MonotonicClock.h"
+#include <algorithm>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+namespace TPMiddle {
+namespace Application {
+
+using Utils::MonotonicClock;
+
+ReplayDriver::ReplayDriver(IPipelineOutput& output, const Domain::ScrollSettings& settings, uint64_t chordWindowNs)
+    : m_output(output)
+    , m_settings(settings)
+    , m_chordWindow(chordWindowNs) {
+}
+
+ReplayResult ReplayDriver::Run(const Domain::InputEvent* events, size_t count, ReplayPacing pacing) {
+    ReplayResult result;
+    InputPipeline pipeline(m_output, m_settings, m_chordWindow);
+    std::vector<uint64_t> latencies(count);
+
+    uint64_t traceStart = count > 0 ? events[0].timestamp : 0;
+    uint64_t replayStart = MonotonicClock::SystemNanoseconds();
+    uint64_t latencyTotal = 0;
+
+    for (size_t i = 0; i < count; ++i) {
+        if (pacing == ReplayPacing::Recorded) {
+            uint64_t due = replayStart + (events[i].timestamp - traceStart);
+            uint64_t now = MonotonicClock::SystemNanoseconds();
+            if (now < due) {
+                std::this_thread::sleep_for(std::chrono::nanoseconds(due - now));
+                now = MonotonicClock::SystemNanoseconds();
+            }
+            result.maxLatenessNs = std::max(result.maxLatenessNs, now - due);
+        }
+
+        uint64_t before = MonotonicClock::SystemNanoseconds();
+        pipeline.Process(events[i]);
+        uint64_t latency = MonotonicClock::SystemNanoseconds() - before;
+        latencies[i] = latency;
+        latencyTotal += latency;
+    }
+
+    if (count > 0) {
+        pipeline.Finish(events[count - 1].timestamp);
+    }
+    result.elapsedNs = MonotonicClock::SystemNanoseconds() - replayStart;
+    result.events = count;
+    result.pipeline = pipeline.GetStatistics();
+    if (result.elapsedNs > 0) {
+        result.eventsPerSecond = static_cast<double>(count) * 1e9 / static_cast<double>(result.elapsedNs);
+    }
+
+    if (count > 0) {
+        std::sort(latencies.begin(), latencies.end());
+        result.latencyMeanNs = latencyTotal / count;
+        result.latencyP50Ns = latencies[count / 2];
+        result.latencyP99Ns = latencies[std::min(count - 1, (count * 99) / 100)];
+        result.latencyMaxNs = latencies[count - 1];
+    }
+    return result;
+}
+
+} // namespace Application
+} // namespace TPMiddle
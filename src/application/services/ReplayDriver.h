@@ -0,0 +1,64 @@
+#ifndef TPMIDDLE_REPLAY_DRIVER_H
+#define TPMIDDLE_REPLAY_DRIVER_H
+
+#include "InputPipeline.h"
+#include <cstddef>
+#include <cstdint>
+
+namespace TPMiddle {
+namespace Application {
+
+/**
+ * @brief How fast a trace is fed into the pipeline
+ */
+enum class ReplayPacing {
+    Recorded,   // Honour the gaps between recorded timestamps
+    Maximum     // Feed events back to back
+};
+
+/**
+ * @brief Throughput and per-event processing latency of one replay
+ */
+struct ReplayResult {
+    uint64_t events = 0;
+    uint64_t elapsedNs = 0;          // Wall time for the whole replay
+    double eventsPerSecond = 0.0;
+    uint64_t latencyMeanNs = 0;      // Per-event processing time
+    uint64_t latencyP50Ns = 0;
+    uint64_t latencyP99Ns = 0;
+    uint64_t latencyMaxNs = 0;
+    uint64_t maxLatenessNs = 0;      // Recorded pacing only: worst delay behind schedule
+    InputPipelineStatistics pipeline;
+};
+
+/**
+ * @brief Headless driver that feeds recorded InputEvents through an InputPipeline
+ *
+ * Event timestamps drive every timing decision in the pipeline, so replaying
+ * the same trace always yields the same outputs regardless of pacing.
+ */
+class ReplayDriver {
+public:
+    ReplayDriver(IPipelineOutput& output,
+                 const Domain::ScrollSettings& settings = Domain::ScrollSettings(),
+                 uint64_t chordWindowNs = 20000000ULL);
+
+    /**
+     * @brief Replay a trace from a fresh pipeline state
+     * @param events Recorded events, oldest first
+     * @param count Number of events
+     * @param pacing Recorded or maximum speed
+     * @return ReplayResult Throughput, latency and pipeline counters
+     */
+    ReplayResult Run(const Domain::InputEvent* events, size_t count, ReplayPacing pacing);
+
+private:
+    IPipelineOutput& m_output;
+    Domain::ScrollSettings m_settings;
+    uint64_t m_chordWindow;
+};
+
+} // namespace Application
+} // namespace TPMiddle
+
+#endif // TPMIDDLE_REPLAY_DRIVER_H
@@ -0,0 +1,120 @@
+#include "ScrollProfiles.h"
+#include <algorithm>
+
+namespace TPMiddle {
+namespace Application {
+
+using Domain::ScrollSettings;
+
+namespace {
+
+int Specificity(const ScrollProfile& profile) {
+    return (profile.application.empty() ? 0 : 2) + (profile.device.empty() ? 0 : 1);
+}
+
+bool Matches(const ScrollProfile& profile, const std::string& application, const ProfileDevice* device) {
+    if (!profile.application.empty() && profile.application != application) {
+        return false;
+    }
+    if (!profile.device.empty()) {
+        return device && (profile.device == device->key || profile.device == device->name);
+    }
+    return true;
+}
+
+} // namespace
+
+void ScrollProfileOverrides::ApplyTo(ScrollSettings& settings) const {
+    if (speedMultiplier) settings.speedMultiplier = *speedMultiplier;
+    if (acceleration) settings.acceleration = *acceleration;
+    if (naturalScrolling) settings.naturalScrolling = *naturalScrolling;
+    if (invertX) settings.invertX = *invertX;
+    if (invertY) settings.invertY = *invertY;
+}
+
+ProfileStore::ProfileStore(std::vector<ScrollProfile> profiles)
+    : m_profiles(std::move(profiles)) {
+    std::stable_sort(m_profiles.begin(), m_profiles.end(),
+                     [](const ScrollProfile& a, const ScrollProfile& b) { return Specificity(a) < Specificity(b); });
+}
+
+ScrollSettings ProfileStore::Resolve(const ScrollSettings& base,
+                                     const std::string& application,
+                                     const ProfileDevice* device) const {
+    ScrollSettings settings = base;
+    for (const ScrollProfile& profile : m_profiles) {
+        if (Matches(profile, application, device)) {
+            profile.overrides.ApplyTo(settings);
+        }
+    }
+    return settings;
+}
+
+ProfileResolver::ProfileResolver()
+    : m_profiles(nullptr)
+    , m_generation(0)
+    , m_resolveCount(0) {
+}
+
+void ProfileResolver::Configure(const ScrollSettings& base, const ProfileStore* profiles,
+                                const std::string& application) {
+    m_base = base;
+    m_profiles = profiles;
+    m_application = application;
+    ResolveAll();
+}
+
+bool ProfileResolver::SetApplication(const std::string& application) {
+    if (application == m_application) {
+        return false;
+    }
+    m_application = application;
+    ResolveAll();
+    return true;
+}
+
+void ProfileResolver::AttachDevice(uint64_t handle, const ProfileDevice& device) {
+    if (handle > kMaxHandle) {
+        return;
+    }
+    if (handle >= m_slots.size()) {
+        m_slots.resize(handle + 1);
+    }
+    Slot& slot = m_slots[handle];
+    slot.attached = true;
+    slot.device = device;
+    slot.settings = Resolve(&slot.device);
+    ++m_generation;
+}
+
+void ProfileResolver::DetachDevice(uint64_t handle) {
+    if (handle < m_slots.size() && m_slots[handle].attached) {
+        m_slots[handle] = Slot();
+        ++m_generation;
+    }
+}
+
+const ScrollSettings& ProfileResolver::ForDevice(uint64_t handle) const {
+    if (handle < m_slots.size() && m_slots[handle].attached) {
+        return m_slots[handle].settings;
+    }
+    return m_applicationSettings;
+}
+
+ScrollSettings ProfileResolver::Resolve(const ProfileDevice* device) {
+    ++m_resolveCount;
+    return m_profiles ? m_profiles->Resolve(m_base, m_application, device) : m_base;
+}
+
+void ProfileResolver::ResolveAll() {
+    m_applicationSettings = Resolve(nullptr);
+    for (Slot& slot : m_slots) {
+        if (slot.attached) {
+            slot.settings = Resolve(&slot.device);
+        }
+    }
+    ++m_generation;
+}
+
+} // namespace Application
+} // namespace TPMiddle
@@ -0,0 +1,140 @@
+#ifndef TPMIDDLE_SCROLL_PROFILES_H
+#define TPMIDDLE_SCROLL_PROFILES_H
+
+#include "../../domain/services/ScrollEngine.h"
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace TPMiddle {
+namespace Application {
+
+/**
+ * @brief Scroll settings a profile replaces; unset values keep the base setting
+ */
+struct ScrollProfileOverrides {
+    std::optional<double> speedMultiplier;
+    std::optional<double> acceleration;
+    std::optional<bool> naturalScrolling;
+    std::optional<bool> invertX;
+    std::optional<bool> invertY;
+
+    void ApplyTo(Domain::ScrollSettings& settings) const;
+};
+
+/**
+ * @brief Overrides for one application, one device, or one device in one application
+ *
+ * An empty application or device matches any. A device is matched by its
+ * identity key ("vendor:product" in hex) or by its product name.
+ */
+struct ScrollProfile {
+    std::string application;          // Bundle identifier
+    std::string device;
+    ScrollProfileOverrides overrides;
+};
+
+/**
+ * @brief Identity of an attached device as seen by profile matching
+ */
+struct ProfileDevice {
+    std::string key;                  // "vendor:product" in hex, e.g. "17ef:6047"
+    std::string name;
+};
+
+/**
+ * @brief Immutable set of profiles
+ *
+ * Resolve() layers every matching profile over the base settings, from the
+ * least to the most specific: catch-all, device only, application only,
+ * then application and device. Among equally specific profiles, later ones
+ * win.
+ */
+class ProfileStore {
+public:
+    ProfileStore() = default;
+    explicit ProfileStore(std::vector<ScrollProfile> profiles);
+
+    Domain::ScrollSettings Resolve(const Domain::ScrollSettings& base,
+                                   const std::string& application,
+                                   const ProfileDevice* device) const;
+
+    const std::vector<ScrollProfile>& GetProfiles() const { return m_profiles; }
+
+private:
+    std::vector<ScrollProfile> m_profiles;    // Sorted by specificity, stable
+};
+
+/**
+ * @brief Cached profile resolution per attached device
+ *
+ * Holds the resolved settings of every attached device in a table indexed
+ * by device handle, so the scroll path looks them up in O(1). Resolution
+ * runs only when the base settings, the profiles or the frontmost
+ * application change (every device) or when a device attaches (that
+ * device). Not thread safe; owned by the input thread.
+ */
+class ProfileResolver {
+public:
+    static constexpr uint64_t kMaxHandle = 65535;
+
+    ProfileResolver();
+
+    /**
+     * @brief Replace the inputs of resolution, re-resolving every device
+     *
+     * The resolver keeps a pointer to the profiles; they must stay alive
+     * until replaced.
+     */
+    void Configure(const Domain::ScrollSettings& base, const ProfileStore* profiles,
+                   const std::string& application);
+
+    /**
+     * @brief Switch the frontmost application
+     * @return bool True if it changed and every device was re-resolved
+     */
+    bool SetApplication(const std::string& application);
+
+    void AttachDevice(uint64_t handle, const ProfileDevice& device);
+    void DetachDevice(uint64_t handle);
+
+    /**
+     * @brief Resolved settings for a device; unknown handles get the application-wide settings
+     */
+    const Domain::ScrollSettings& ForDevice(uint64_t handle) const;
+
+    /**
+     * @brief Changes whenever any resolved settings may have changed
+     */
+    uint64_t GetGeneration() const { return m_generation; }
+
+    /**
+     * @brief Number of resolutions performed, for verifying the cache
+     */
+    uint64_t GetResolveCount() const { return m_resolveCount; }
+
+private:
+    struct Slot {
+        bool attached = false;
+        ProfileDevice device;
+        Domain::ScrollSettings settings;
+    };
+
+    Domain::ScrollSettings m_base;
+    const ProfileStore* m_profiles;
+    std::string m_application;
+    Domain::ScrollSettings m_applicationSettings;
+    std::vector<Slot> m_slots;
+    uint64_t m_generation;
+    uint64_t m_resolveCount;
+
+    Domain::ScrollSettings Resolve(const ProfileDevice* device);
+    void ResolveAll();
+};
+
+} // namespace Application
+} // namespace TPMiddle
+
+#endif // TPMIDDLE_SCROLL_PROFILES_H
@@ -0,0 +1,252 @@
+#ifndef TPMIDDLE_STAGED_PIPELINE_H
+#define TPMIDDLE_STAGED_PIPELINE_H
+
+#include "InputProcessor.h"
+#include "../../domain/models/HIDUsage.h"
+#include "../../domain/models/InputEvent.h"
+#include "../../domain/services/MiddleButtonEmulator.h"
+#include "../../domain/services/ScrollEngine.h"
+#include "../../domain/services/ScrollStages.h"
+#include <cstddef>
+#include <cstdint>
+
+namespace TPMiddle {
+namespace Application {
+
+/**
+ * @brief Everything the pointer stages carry from one sample to the next
+ */
+struct PointerStageState {
+    Domain::MiddleButtonEmulator chord;
+    Domain::MiddleButtonEmulator toggle;   // Fed only the middle button, as in InputProcessor
+    uint16_t buttons = 0;                  // Left, right and middle as of the last sample
+    Domain::ScrollStageState scroll;
+};
+
+/**
+ * @brief Decode stage for Pointer events that are already assembled, such
+ * as evdev frames or recorded traces; other event types are skipped
+ */
+struct PointerEventDecode {
+    using Input = Domain::InputEvent;
+
+    static bool Decode(const Input& input, uint64_t& timestampNs, Domain::PointerSample& sample) {
+        if (input.type != Domain::InputEventType::Pointer) {
+            return false;
+        }
+        timestampNs = input.timestamp;
+        sample = input.pointer;
+        return true;
+    }
+};
+
+/**
+ * @brief Chord stage: turns emulator actions into output
+ *
+ * Only ChordClickPolicy::Hold replays left and right edges, so the
+ * pass-through form does not test for them. The replaying form tests every
+ * action, as InputPipeline does.
+ */
+template <bool ReplaysClicks>
+struct ChordStage {
+    template <typename Output>
+    static void Apply(PointerStageState& state, Output& output, uint64_t timestampNs,
+                      const Domain::MiddleButtonActions& actions) {
+        if (actions.clearScroll) {
+            state.scroll.accumulatedX = 0.0;
+            state.scroll.accumulatedY = 0.0;
+        }
+        if (ReplaysClicks && actions.postLeftDown) {
+            output.PostButton(timestampNs, Domain::kButtonMaskLeft, true);
+        }
+        if (ReplaysClicks && actions.postRightDown) {
+            output.PostButton(timestampNs, Domain::kButtonMaskRight, true);
+        }
+        if (actions.postMiddleDown) {
+            output.PostMiddleButton(timestampNs, true);
+        }
+        if (ReplaysClicks && actions.postLeftUp) {
+            output.PostButton(timestampNs, Domain::kButtonMaskLeft, false);
+        }
+        if (ReplaysClicks && actions.postRightUp) {
+            output.PostButton(timestampNs, Domain::kButtonMaskRight, false);
+        }
+        if (actions.postMiddleUp) {
+            output.PostMiddleButton(timestampNs, false);
+        }
+    }
+
+    template <typename Output>
+    static void RunDeadlines(PointerStageState& state, Output& output, uint64_t timestampNs) {
+        for (uint64_t deadline = state.chord.GetNextDeadline(); deadline <= timestampNs;
+             deadline = state.chord.GetNextDeadline()) {
+            Apply(state, output, deadline, state.chord.Advance(deadline));
+        }
+    }
+};
+
+using PassThroughChord = ChordStage<false>;
+using ReplayingChord = ChordStage<true>;
+
+/**
+ * @brief Run one input through decode -> chord -> accelerate -> direction
+ * -> accumulate -> emit
+ *
+ * Produces what InputPipeline produces for the same samples with pacing and
+ * momentum off: axes are inverted for scrolling, a quick middle click
+ * toggles scroll mode, and movement outside a middle press is motion.
+ */
+template <typename Decode, typename Chord, typename Accelerate, typename Emit, typename Output>
+void RunPointerStages(PointerStageState& state, const Domain::ScrollStageParams& params, Output& output,
+                      const typename Decode::Input& input) {
+    uint64_t timestampNs = 0;
+    Domain::PointerSample sample;
+    if (!Decode::Decode(input, timestampNs, sample)) {
+        return;
+    }
+    Chord::RunDeadlines(state, output, timestampNs);
+
+    const uint16_t kTrackedButtons = Domain::kButtonMaskLeft | Domain::kButtonMaskRight | Domain::kButtonMaskMiddle;
+    uint16_t buttons = sample.buttons & kTrackedButtons;
+    bool middleDown = (buttons & Domain::kButtonMaskMiddle) != 0;
+    if (buttons != state.buttons) {
+        state.buttons = buttons;
+        state.toggle.Update(timestampNs, false, false, middleDown);
+        Chord::Apply(state, output, timestampNs,
+                     state.chord.Update(timestampNs, (buttons & Domain::kButtonMaskLeft) != 0,
+                                        (buttons & Domain::kButtonMaskRight) != 0, middleDown));
+    }
+
+    if (sample.deltaX != 0 || sample.deltaY != 0) {
+        int deltaX = -sample.deltaX;
+        int deltaY = -sample.deltaY;
+        if (state.toggle.IsScrollMode() && !middleDown) {
+            output.PostScroll(timestampNs, deltaX, deltaY);
+        } else if (!state.chord.IsScrollActive()) {
+            output.PostMotion(timestampNs, sample.deltaX, sample.deltaY);
+        } else {
+            Domain::ScrollOutput scroll =
+                Domain::ProcessScrollStages<Accelerate, Emit>(state.scroll, params, timestampNs, deltaX, deltaY);
+            if (scroll.emit) {
+                output.PostScroll(timestampNs, scroll.deltaX, scroll.deltaY);
+            }
+        }
+    }
+
+    if (sample.wheel != 0 || sample.pan != 0) {
+        output.PostScroll(timestampNs, sample.pan, sample.wheel);
+    }
+}
+
+/**
+ * @brief Single-device pointer pipeline built from compile-time stages
+ *
+ * Each setting that changes control flow (click policy, acceleration, speed
+ * cap) selects a stage policy, and all combinations are instantiated ahead
+ * of time. Configure() picks one, so Process() is a single call with no
+ * per-sample setting tests and, for a concrete Output, no virtual dispatch.
+ * Output needs PostMiddleButton, PostButton, PostScroll and PostMotion with
+ * the IPipelineOutput signatures; an IPipelineOutput works as well.
+ *
+ * Scroll is emitted per sample, without frame pacing or momentum, and state
+ * is kept for one device; InputPipeline remains the composition with both.
+ * The Runtime* stage policies with ReplayingChord form the generic path the
+ * selected instantiations are benchmarked against.
+ */
+template <typename Decode, typename Output>
+class StagedPipeline {
+public:
+    using Input = typename Decode::Input;
+    using Kernel = void (*)(PointerStageState&, const Domain::ScrollStageParams&, Output&, const Input&);
+
+    explicit StagedPipeline(Output& output,
+                            const Domain::ScrollSettings& settings = Domain::ScrollSettings(),
+                            uint64_t chordWindowNs = 20000000ULL,
+                            Domain::ChordClickPolicy policy = Domain::ChordClickPolicy::PassThrough)
+        : m_output(output)
+        , m_kernel(nullptr) {
+        m_state.toggle.SetScrollToggleWindow(InputProcessor::kScrollTogglePressNs);
+        Configure(settings, chordWindowNs, policy);
+    }
+
+    StagedPipeline(const StagedPipeline&) = delete;
+    StagedPipeline& operator=(const StagedPipeline&) = delete;
+
+    /**
+     * @brief Apply new settings and select the matching instantiation
+     */
+    void Configure(const Domain::ScrollSettings& settings, uint64_t chordWindowNs,
+                   Domain::ChordClickPolicy policy) {
+        m_settings = settings;
+        m_params = Domain::ScrollEngine::DeriveStageParams(m_settings);
+        m_state.chord.SetChordWindow(chordWindowNs);
+        m_state.chord.SetClickPolicy(policy);
+        m_kernel = SelectKernel(policy == Domain::ChordClickPolicy::Hold, m_params.acceleration != 0.0,
+                                m_params.cap > 0.0);
+    }
+
+    void Process(const Input& input) { m_kernel(m_state, m_params, m_output, input); }
+
+    void Process(const Input* inputs, size_t count) {
+        for (size_t i = 0; i < count; ++i) {
+            m_kernel(m_state, m_params, m_output, inputs[i]);
+        }
+    }
+
+    /**
+     * @brief Fire chord deadlines due by timestampNs when no input arrived
+     */
+    void Advance(uint64_t timestampNs) { ReplayingChord::RunDeadlines(m_state, m_output, timestampNs); }
+
+    /**
+     * @brief When Advance() next has work to do, UINT64_MAX if nothing is pending
+     */
+    uint64_t GetNextDeadline() { return m_state.chord.GetNextDeadline(); }
+
+    /**
+     * @brief Forget button, scroll mode and accumulated movement, e.g. when the device goes away
+     */
+    void Reset(uint64_t timestampNs) {
+        ReplayingChord::Apply(m_state, m_output, timestampNs, m_state.chord.Reset());
+        m_state.toggle.Reset();
+        m_state.buttons = 0;
+        m_state.scroll = Domain::ScrollStageState();
+        m_state.scroll.lastScrollTime = timestampNs;
+    }
+
+    const Domain::ScrollSettings& GetSettings() const { return m_settings; }
+    bool IsScrollMode() const { return m_state.toggle.IsScrollMode(); }
+    Kernel GetKernel() const { return m_kernel; }
+
+    /**
+     * @brief The pre-instantiated kernel for one combination of settings
+     */
+    static Kernel SelectKernel(bool replaysClicks, bool accelerates, bool capped) {
+        using Domain::ConstantAcceleration;
+        using Domain::CurveAcceleration;
+        using Domain::CappedEmit;
+        using Domain::UncappedEmit;
+        static const Kernel kKernels[2][2][2] = {
+            {{&RunPointerStages<Decode, PassThroughChord, ConstantAcceleration, UncappedEmit, Output>,
+              &RunPointerStages<Decode, PassThroughChord, ConstantAcceleration, CappedEmit, Output>},
+             {&RunPointerStages<Decode, PassThroughChord, CurveAcceleration, UncappedEmit, Output>,
+              &RunPointerStages<Decode, PassThroughChord, CurveAcceleration, CappedEmit, Output>}},
+            {{&RunPointerStages<Decode, ReplayingChord, ConstantAcceleration, UncappedEmit, Output>,
+              &RunPointerStages<Decode, ReplayingChord, ConstantAcceleration, CappedEmit, Output>},
+             {&RunPointerStages<Decode, ReplayingChord, CurveAcceleration, UncappedEmit, Output>,
+              &RunPointerStages<Decode, ReplayingChord, CurveAcceleration, CappedEmit, Output>}}};
+        return kKernels[replaysClicks][accelerates][capped];
+    }
+
+private:
+    Output& m_output;
+    Domain::ScrollSettings m_settings;    // Owns the curve m_params points into
+    Domain::ScrollStageParams m_params;
+    PointerStageState m_state;
+    Kernel m_kernel;
+};
+
+} // namespace Application
+} // namespace TPMiddle
+
+#endif // TPMIDDLE_STAGED_PIPELINE_H
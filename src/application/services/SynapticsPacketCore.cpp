@@ -0,0 +1,181 @@
+#include "SynapticsPacketCore.h"
+#include <algorithm>
+
+namespace TPMiddle {
+namespace Application {
+
+struct SynapticsPacketCore::Device {
+    long handle;
+    SynapticsDeviceType type;
+    bool middleDown = false;
+    uint64_t clickTimeout = 0;
+    bool clickPressSent = false;          // The pending click's press went out; its release is next
+    SynapticsPacketCore* core;
+    Utils::WheelTimer clickTimer;
+
+    Device(const SynapticsDeviceInfo& info, SynapticsPacketCore* core)
+        : handle(info.handle), type(info.type), core(core), clickTimer(&SynapticsPacketCore::OnClickDeadline, this) {}
+};
+
+SynapticsPacketCore::SynapticsPacketCore(ISynapticsPacketSource& source, IMiddleButtonOutput& output,
+                                         const SynapticsCoreOptions& options)
+    : m_source(source)
+    , m_output(output)
+    , m_options(options)
+    , m_wheel(1000000ULL)
+    , m_lastSentDown(false)
+    , m_batchCount(0) {
+}
+
+SynapticsPacketCore::~SynapticsPacketCore() = default;
+
+SynapticsPacketCore::Device* SynapticsPacketCore::Find(long handle) const {
+    for (const std::unique_ptr<Device>& device : m_devices) {
+        if (device->handle == handle) {
+            return device.get();
+        }
+    }
+    return nullptr;
+}
+
+bool SynapticsPacketCore::IsMiddlePressed(long handle) const {
+    Device* device = Find(handle);
+    return device && device->middleDown;
+}
+
+void SynapticsPacketCore::Reconcile(const std::vector<SynapticsDeviceInfo>& present,
+                                    std::vector<SynapticsDeviceInfo>* added, std::vector<long>* removed) {
+    for (size_t i = m_devices.size(); i-- > 0;) {
+        long handle = m_devices[i]->handle;
+        bool stillPresent = std::any_of(present.begin(), present.end(),
+                                        [handle](const SynapticsDeviceInfo& info) { return info.handle == handle; });
+        if (!stillPresent) {
+            Erase(i);
+            if (removed) {
+                removed->push_back(handle);
+            }
+        }
+    }
+    for (const SynapticsDeviceInfo& info : present) {
+        if (!Find(info.handle)) {
+            m_devices.emplace_back(new Device(info, this));
+            ++m_statistics.devicesAdded;
+            if (added) {
+                added->push_back(info);
+            }
+        }
+    }
+    Flush();
+}
+
+void SynapticsPacketCore::RemoveDevice(long handle) {
+    for (size_t i = 0; i < m_devices.size(); ++i) {
+        if (m_devices[i]->handle == handle) {
+            Erase(i);
+            break;
+        }
+    }
+    Flush();
+}
+
+void SynapticsPacketCore::Erase(size_t index) {
+    Device& device = *m_devices[index];
+    if (device.middleDown && m_options.normalMode) {
+        Send(false, true);
+    }
+    // A click already started is finished rather than left pressed
+    if (device.clickTimer.IsArmed() && device.clickPressSent) {
+        Send(false, false);
+    }
+    m_wheel.Cancel(device.clickTimer);
+    m_devices.erase(m_devices.begin() + static_cast<std::ptrdiff_t>(index));
+    ++m_statistics.devicesRemoved;
+}
+
+size_t SynapticsPacketCore::ProcessDevice(long handle, uint64_t timestampNs) {
+    Device* device = Find(handle);
+    if (!device) {
+        return 0;
+    }
+
+    size_t count = 0;
+    SynapticsPacket packet;
+    while (m_source.LoadPacket(handle, packet)) {
+        HandlePacket(*device, packet, timestampNs);
+        ++count;
+    }
+    m_statistics.packets += count;
+    Flush();
+    return count;
+}
+
+void SynapticsPacketCore::HandlePacket(Device& device, const SynapticsPacket& packet, uint64_t timestampNs) {
+    uint32_t mask = device.type == SynapticsDeviceType::TouchPad ? m_options.masks.touchPadMiddle
+                                                                 : m_options.masks.middle;
+    bool middleDown = mask != 0 && (packet.buttonState & mask) == mask;
+    if (middleDown == device.middleDown) {
+        return;
+    }
+    device.middleDown = middleDown;
+
+    if (middleDown) {
+        device.clickTimeout = timestampNs + m_options.clickTimeoutNs;
+        if (m_options.normalMode) {
+            Send(true, true);
+        }
+        return;
+    }
+
+    if (m_options.normalMode) {
+        Send(false, true);
+    } else if (m_options.quickClick && timestampNs < device.clickTimeout && !device.clickTimer.IsArmed()) {
+        // Give the driver's own handling of the release time to settle first
+        device.clickPressSent = false;
+        m_wheel.Schedule(device.clickTimer, timestampNs + m_options.clickDelayNs);
+    }
+}
+
+void SynapticsPacketCore::Advance(uint64_t timestampNs) {
+    m_wheel.Advance(timestampNs);
+    Flush();
+}
+
+void SynapticsPacketCore::OnClickDeadline(void* context, uint64_t deadlineNs) {
+    Device& device = *static_cast<Device*>(context);
+    SynapticsPacketCore& core = *device.core;
+    if (!device.clickPressSent) {
+        core.Send(true, false);
+        device.clickPressSent = true;
+        core.m_wheel.Schedule(device.clickTimer, deadlineNs + core.m_options.clickDelayNs);
+    } else {
+        core.Send(false, false);
+        device.clickPressSent = false;
+    }
+}
+
+// Normal mode forwards the merged state of all devices, so a press or
+// release that matches the last one sent is dropped
+void SynapticsPacketCore::Send(bool down, bool filter) {
+    if (filter && down == m_lastSentDown) {
+        ++m_statistics.filteredEdges;
+        return;
+    }
+    m_lastSentDown = down;
+    if (m_batchCount == kMaxBatch) {
+        Flush();
+    }
+    m_batch[m_batchCount++] = down;
+}
+
+void SynapticsPacketCore::Flush() {
+    if (m_batchCount == 0) {
+        return;
+    }
+    m_output.SendMiddleButtons(m_batch, m_batchCount);
+    ++m_statistics.batches;
+    m_statistics.events += m_batchCount;
+    m_batchCount = 0;
+}
+
+} // namespace Application
+} // namespace TPMiddle
@@ -0,0 +1,178 @@
+#ifndef TPMIDDLE_SYNAPTICS_PACKET_CORE_H
+#define TPMIDDLE_SYNAPTICS_PACKET_CORE_H
+
+#include "../../utils/TimerWheel.h"
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace TPMiddle {
+namespace Application {
+
+/**
+ * @brief Device families the Windows tool attaches to
+ */
+enum class SynapticsDeviceType : uint8_t {
+    Stick,        // IBM-compatible stick or Styk
+    TouchPad      // Reports the TrackPoint middle button as an extended button
+};
+
+/**
+ * @brief The part of a SynKit packet the core looks at
+ */
+struct SynapticsPacket {
+    uint32_t buttonState = 0;
+};
+
+/**
+ * @brief Button bits of SynPacket::ButtonState(), supplied by the SynKit side
+ */
+struct SynapticsButtonMasks {
+    uint32_t middle = 0;           // SF_ButtonMiddle
+    uint32_t touchPadMiddle = 0;   // SF_ButtonExtended3
+};
+
+/**
+ * @brief One device as found by enumeration
+ */
+struct SynapticsDeviceInfo {
+    long handle;                   // SynKit device handle
+    SynapticsDeviceType type;
+};
+
+/**
+ * @brief Packets of the attached devices; SynKit in the tool, a queue in tests
+ */
+class ISynapticsPacketSource {
+public:
+    virtual ~ISynapticsPacketSource() = default;
+
+    /**
+     * @brief Take the next queued packet of a device
+     * @return bool False once the device has no more packets
+     */
+    virtual bool LoadPacket(long handle, SynapticsPacket& packet) = 0;
+};
+
+/**
+ * @brief Receives middle button events, one batch per core call
+ */
+class IMiddleButtonOutput {
+public:
+    virtual ~IMiddleButtonOutput() = default;
+
+    /**
+     * @param downs Press (true) or release (false) for each event, oldest first
+     */
+    virtual void SendMiddleButtons(const bool* downs, size_t count) = 0;
+};
+
+/**
+ * @brief Behaviour switches of the Windows tool
+ */
+struct SynapticsCoreOptions {
+    bool normalMode = false;               // -n: forward middle presses and releases as they happen
+    bool quickClick = false;               // Otherwise: send a click for a press shorter than the timeout
+    uint64_t clickTimeoutNs = 250000000ULL;  // Half the double-click time
+    uint64_t clickDelayNs = 50000000ULL;     // Gap before the click and between its press and release
+    SynapticsButtonMasks masks;
+};
+
+/**
+ * @brief Counters for one core
+ */
+struct SynapticsCoreStatistics {
+    uint64_t packets = 0;
+    uint64_t batches = 0;                  // SendMiddleButtons() calls
+    uint64_t events = 0;                   // Middle button events sent
+    uint64_t filteredEdges = 0;            // Normal mode: repeats of the last sent state
+    uint64_t devicesAdded = 0;
+    uint64_t devicesRemoved = 0;
+};
+
+/**
+ * @brief Portable middle button logic of the Windows Synaptics tool
+ *
+ * Reads every pending packet of a signalled device, detects middle button
+ * edges by device type and turns them into middle button events. In normal
+ * mode presses and releases are forwarded, with repeats of the last sent
+ * state dropped across devices. Otherwise the driver handles the middle
+ * button itself, and if quickClick is set a press released within the
+ * timeout becomes a click, paced by deadlines instead of sleeps. Everything
+ * one call produces goes out in a single SendMiddleButtons() batch.
+ *
+ * Devices are keyed by handle; Reconcile() adds and removes only what
+ * changed, so the state of devices that stay attached survives a device
+ * change notification. Timestamps are caller-supplied monotonic
+ * nanoseconds. Not thread safe.
+ */
+class SynapticsPacketCore {
+public:
+    static constexpr size_t kMaxBatch = 64;
+
+    SynapticsPacketCore(ISynapticsPacketSource& source, IMiddleButtonOutput& output,
+                        const SynapticsCoreOptions& options = SynapticsCoreOptions());
+    ~SynapticsPacketCore();
+
+    SynapticsPacketCore(const SynapticsPacketCore&) = delete;
+    SynapticsPacketCore& operator=(const SynapticsPacketCore&) = delete;
+
+    /**
+     * @brief Track exactly the present devices
+     * @param added Receives devices that were not tracked before
+     * @param removed Receives devices that went away; a middle press they held is released
+     */
+    void Reconcile(const std::vector<SynapticsDeviceInfo>& present,
+                   std::vector<SynapticsDeviceInfo>* added, std::vector<long>* removed);
+
+    /**
+     * @brief Stop tracking one device, e.g. when opening it failed
+     */
+    void RemoveDevice(long handle);
+
+    /**
+     * @brief Drain a signalled device's packets
+     * @return size_t Packets processed
+     */
+    size_t ProcessDevice(long handle, uint64_t timestampNs);
+
+    /**
+     * @brief Fire click deadlines due at timestampNs
+     */
+    void Advance(uint64_t timestampNs);
+
+    /**
+     * @brief When Advance() next has work, UINT64_MAX if nothing is pending
+     */
+    uint64_t GetNextDeadline() { return m_wheel.GetNextDeadline(); }
+
+    size_t GetDeviceCount() const { return m_devices.size(); }
+    bool IsMiddlePressed(long handle) const;
+    const SynapticsCoreStatistics& GetStatistics() const { return m_statistics; }
+
+private:
+    struct Device;
+
+    ISynapticsPacketSource& m_source;
+    IMiddleButtonOutput& m_output;
+    SynapticsCoreOptions m_options;
+    std::vector<std::unique_ptr<Device>> m_devices;
+    Utils::TimerWheel<64> m_wheel;         // Declared after m_devices, so it unlinks their timers first
+    bool m_lastSentDown;
+    bool m_batch[kMaxBatch];
+    size_t m_batchCount;
+    SynapticsCoreStatistics m_statistics;
+
+    Device* Find(long handle) const;
+    void Erase(size_t index);
+    void HandlePacket(Device& device, const SynapticsPacket& packet, uint64_t timestampNs);
+    void Send(bool down, bool filter);
+    void Flush();
+    static void OnClickDeadline(void* context, uint64_t deadlineNs);
+};
+
+} // namespace Application
+} // namespace TPMiddle
+
+#endif // TPMIDDLE_SYNAPTICS_PACKET_CORE_H
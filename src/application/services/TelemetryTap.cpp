@@ -0,0 +1,99 @@
+#include "TelemetryTap.h"
+
+namespace TPMiddle {
+namespace Application {
+
+TelemetryTap::TelemetryTap()
+    : m_attached(false)
+    , m_motionX(0)
+    , m_motionY(0)
+    , m_movementEvents(0)
+    , m_lastDelta(0)
+    , m_buttons(0)
+    , m_scrollX(0)
+    , m_scrollY(0)
+    , m_scrollEvents(0)
+    , m_lastPulled()
+    , m_historyHead(0)
+    , m_historyCount(0) {
+}
+
+TelemetryTap& TelemetryTap::Shared() {
+    static TelemetryTap tap;
+    return tap;
+}
+
+void TelemetryTap::Attach(uint64_t timestampNs) {
+    m_lastPulled = LoadTotals();
+    m_historyCount = 0;
+    m_historyHead = 0;
+    m_history[0] = TelemetryFrame();
+    m_history[0].timestamp = timestampNs;
+    m_attached.store(true, std::memory_order_relaxed);
+}
+
+void TelemetryTap::Detach() {
+    m_attached.store(false, std::memory_order_relaxed);
+}
+
+void TelemetryTap::AddMovement(int deltaX, int deltaY) {
+    m_motionX.fetch_add(deltaX, std::memory_order_relaxed);
+    m_motionY.fetch_add(deltaY, std::memory_order_relaxed);
+    m_movementEvents.fetch_add(1, std::memory_order_relaxed);
+    uint32_t packed = static_cast<uint16_t>(static_cast<int16_t>(deltaX)) |
+                      (static_cast<uint32_t>(static_cast<uint16_t>(static_cast<int16_t>(deltaY))) << 16);
+    m_lastDelta.store(packed, std::memory_order_relaxed);
+}
+
+void TelemetryTap::AddScroll(int deltaX, int deltaY) {
+    m_scrollX.fetch_add(deltaX, std::memory_order_relaxed);
+    m_scrollY.fetch_add(deltaY, std::memory_order_relaxed);
+    m_scrollEvents.fetch_add(1, std::memory_order_relaxed);
+}
+
+TelemetryTap::Totals TelemetryTap::LoadTotals() const {
+    Totals totals;
+    totals.motionX = m_motionX.load(std::memory_order_relaxed);
+    totals.motionY = m_motionY.load(std::memory_order_relaxed);
+    totals.scrollX = m_scrollX.load(std::memory_order_relaxed);
+    totals.scrollY = m_scrollY.load(std::memory_order_relaxed);
+    totals.movementEvents = m_movementEvents.load(std::memory_order_relaxed);
+    totals.scrollEvents = m_scrollEvents.load(std::memory_order_relaxed);
+    return totals;
+}
+
+const TelemetryFrame& TelemetryTap::Pull(uint64_t timestampNs) {
+    // Totals only grow, so the difference is exact even though producers
+    // keep running; a value racing the pull lands in the next frame
+    Totals totals = LoadTotals();
+    TelemetryFrame frame;
+    frame.timestamp = timestampNs;
+    frame.motionX = totals.motionX - m_lastPulled.motionX;
+    frame.motionY = totals.motionY - m_lastPulled.motionY;
+    frame.scrollX = totals.scrollX - m_lastPulled.scrollX;
+    frame.scrollY = totals.scrollY - m_lastPulled.scrollY;
+    frame.movementEvents = static_cast<uint32_t>(totals.movementEvents - m_lastPulled.movementEvents);
+    frame.scrollEvents = static_cast<uint32_t>(totals.scrollEvents - m_lastPulled.scrollEvents);
+    uint32_t packed = m_lastDelta.load(std::memory_order_relaxed);
+    frame.lastDeltaX = static_cast<int16_t>(packed & 0xFFFF);
+    frame.lastDeltaY = static_cast<int16_t>(packed >> 16);
+    frame.buttons = m_buttons.load(std::memory_order_relaxed);
+    m_lastPulled = totals;
+
+    m_historyHead = (m_historyCount == 0) ? 0 : (m_historyHead + 1) % kHistoryCapacity;
+    if (m_historyCount < kHistoryCapacity) {
+        ++m_historyCount;
+    }
+    m_history[m_historyHead] = frame;
+    return m_history[m_historyHead];
+}
+
+const TelemetryFrame& TelemetryTap::GetHistory(size_t age) const {
+    if (age >= m_historyCount) {
+        age = m_historyCount ? m_historyCount - 1 : 0;
+    }
+    return m_history[(m_historyHead + kHistoryCapacity - age) % kHistoryCapacity];
+}
+
+} // namespace Application
+} // namespace TPMiddle
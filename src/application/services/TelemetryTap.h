@@ -0,0 +1,122 @@
+#ifndef TPMIDDLE_TELEMETRY_TAP_H
+#define TPMIDDLE_TELEMETRY_TAP_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace TPMiddle {
+namespace Application {
+
+/**
+ * @brief Input activity between two pulls of the telemetry tap
+ */
+struct TelemetryFrame {
+    uint64_t timestamp = 0;          // Monotonic nanoseconds of the pull
+    int64_t motionX = 0;             // Summed pointer movement
+    int64_t motionY = 0;
+    int32_t lastDeltaX = 0;          // Most recent single movement
+    int32_t lastDeltaY = 0;
+    int64_t scrollX = 0;             // Summed posted scroll, pixels
+    int64_t scrollY = 0;
+    uint32_t movementEvents = 0;
+    uint32_t scrollEvents = 0;
+    uint8_t buttons = 0;             // Physical buttons held at the pull, kButtonMask* bits
+};
+
+/**
+ * @brief Aggregated input telemetry for the event viewer
+ *
+ * The input path records every movement, button change and posted scroll
+ * event into running atomic totals; the viewer pulls at display refresh
+ * rate and gets the activity since its previous pull as one fixed-size
+ * frame. Pulled frames are also kept in a fixed trailing ring for drawing
+ * recent history.
+ *
+ * Recording is lock-free, allocation-free and may happen on any thread.
+ * While no viewer is attached it costs one relaxed load. Pull() and the
+ * history accessors belong to a single consumer thread.
+ */
+class TelemetryTap {
+public:
+    static constexpr size_t kHistoryCapacity = 128;
+
+    TelemetryTap();
+
+    TelemetryTap(const TelemetryTap&) = delete;
+    TelemetryTap& operator=(const TelemetryTap&) = delete;
+
+    /**
+     * @brief Process-wide instance fed by the input path and read by the event viewer
+     */
+    static TelemetryTap& Shared();
+
+    /**
+     * @brief Start recording; activity from before the attach is not reported
+     */
+    void Attach(uint64_t timestampNs);
+    void Detach();
+    bool IsAttached() const { return m_attached.load(std::memory_order_relaxed); }
+
+    void RecordMovement(int deltaX, int deltaY) {
+        if (IsAttached()) AddMovement(deltaX, deltaY);
+    }
+    void RecordButtons(uint8_t buttons) {
+        if (IsAttached()) m_buttons.store(buttons, std::memory_order_relaxed);
+    }
+    void RecordScroll(int deltaX, int deltaY) {
+        if (IsAttached()) AddScroll(deltaX, deltaY);
+    }
+
+    /**
+     * @brief Collect the activity since the previous pull and append it to the history
+     */
+    const TelemetryFrame& Pull(uint64_t timestampNs);
+
+    /**
+     * @brief Pulled frames still in the history, at most kHistoryCapacity
+     */
+    size_t GetHistoryCount() const { return m_historyCount; }
+
+    /**
+     * @brief A pulled frame by age, 0 being the latest
+     */
+    const TelemetryFrame& GetHistory(size_t age) const;
+
+private:
+    struct Totals {
+        int64_t motionX;
+        int64_t motionY;
+        int64_t scrollX;
+        int64_t scrollY;
+        uint64_t movementEvents;
+        uint64_t scrollEvents;
+    };
+
+    std::atomic<bool> m_attached;
+
+    // Written by the input path; each group on its own cache line
+    alignas(64) std::atomic<int64_t> m_motionX;
+    std::atomic<int64_t> m_motionY;
+    std::atomic<uint64_t> m_movementEvents;
+    std::atomic<uint32_t> m_lastDelta;        // X in the low half, Y in the high half
+    std::atomic<uint8_t> m_buttons;
+    alignas(64) std::atomic<int64_t> m_scrollX;
+    std::atomic<int64_t> m_scrollY;
+    std::atomic<uint64_t> m_scrollEvents;
+
+    // Consumer only
+    alignas(64) Totals m_lastPulled;
+    TelemetryFrame m_history[kHistoryCapacity];
+    size_t m_historyHead;                     // Index of the latest frame
+    size_t m_historyCount;
+
+    void AddMovement(int deltaX, int deltaY);
+    void AddScroll(int deltaX, int deltaY);
+    Totals LoadTotals() const;
+};
+
+} // namespace Application
+} // namespace TPMiddle
+
+#endif // TPMIDDLE_TELEMETRY_TAP_H
@@ -0,0 +1,249 @@
+#include "TraceRecorder.h"
+#include "../../utils/MonotonicClock.h"
+#include <cerrno>
+#include <cinttypes>
+#include <cstdio>
+#include <cstring>
+#include <mutex>
+#include <unistd.h>
+
+namespace TPMiddle {
+namespace Application {
+
+struct TraceRecorder::ThreadBuffer {
+    std::unique_ptr<TraceRecord[]> records;
+    std::atomic<size_t> count;
+    std::atomic<uint64_t> session;     // Session the records belong to
+    std::atomic<uint64_t> dropped;
+    uint32_t tid;
+    const char* name;
+    bool pooled;                       // Shared by pooled threads; appends take appendMutex
+    std::mutex appendMutex;
+
+    ThreadBuffer(size_t capacity, uint64_t currentSession, uint32_t threadId, const char* threadName, bool isPooled)
+        : records(new TraceRecord[capacity])
+        , count(0)
+        , session(currentSession)
+        , dropped(0)
+        , tid(threadId)
+        , name(threadName)
+        , pooled(isPooled) {
+    }
+};
+
+namespace {
+
+std::atomic<uint64_t> g_nextRecorderId(1);
+thread_local const char* t_threadName = nullptr;
+thread_local bool t_pooled = false;
+
+// Pooled threads keep their own tid in the shared buffer, numbered above
+// the per-thread buffers so the two never collide
+std::atomic<uint32_t> g_nextPooledTid(TraceRecorder::kMaxThreads + 1);
+thread_local uint32_t t_pooledTid = 0;
+
+void WriteJsonString(FILE* file, const char* text) {
+    std::fputc('"', file);
+    for (const char* c = text ? text : ""; *c; ++c) {
+        if (*c == '"' || *c == '\\') {
+            std::fputc('\\', file);
+            std::fputc(*c, file);
+        } else if (static_cast<unsigned char>(*c) < 0x20) {
+            std::fprintf(file, "\\u%04x", static_cast<unsigned>(*c));
+        } else {
+            std::fputc(*c, file);
+        }
+    }
+    std::fputc('"', file);
+}
+
+} // namespace
+
+TraceRecorder TraceRecorder::s_shared;
+
+TraceRecorder::TraceRecorder(size_t recordsPerThread)
+    : m_enabled(false)
+    , m_session(0)
+    , m_startNs(0)
+    , m_unregisteredDrops(0)
+    , m_id(g_nextRecorderId.fetch_add(1, std::memory_order_relaxed))
+    , m_capacity(recordsPerThread)
+    , m_pooledBuffer(nullptr)
+    , m_threadCount(0) {
+}
+
+TraceRecorder::~TraceRecorder() {
+}
+
+void TraceRecorder::SetThreadName(const char* name) {
+    t_threadName = name;
+}
+
+void TraceRecorder::SetThreadPooled() {
+    t_pooled = true;
+}
+
+void TraceRecorder::Start() {
+    m_enabled.store(false, std::memory_order_relaxed);
+    m_session.fetch_add(1, std::memory_order_relaxed);
+    m_startNs.store(Utils::MonotonicClock::SystemNanoseconds(), std::memory_order_relaxed);
+    m_unregisteredDrops.store(0, std::memory_order_relaxed);
+    m_enabled.store(true, std::memory_order_release);
+}
+
+void TraceRecorder::Stop() {
+    m_enabled.store(false, std::memory_order_relaxed);
+}
+
+// Each thread remembers the buffer it last used and which recorder owns
+// it; a thread that alternates between recorders registers again each time
+void TraceRecorder::Append(TracePhase phase, const char* name, int64_t value) {
+    static thread_local uint64_t cachedRecorder = 0;
+    static thread_local ThreadBuffer* cachedBuffer = nullptr;
+    if (cachedRecorder != m_id) {
+        cachedBuffer = RegisterThread();
+        cachedRecorder = m_id;
+    }
+    ThreadBuffer* buffer = cachedBuffer;
+    if (!buffer) {
+        m_unregisteredDrops.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    if (buffer->pooled) {
+        if (t_pooledTid == 0) {
+            t_pooledTid = g_nextPooledTid.fetch_add(1, std::memory_order_relaxed);
+        }
+        std::lock_guard<std::mutex> lock(buffer->appendMutex);
+        Store(*buffer, phase, name, value, t_pooledTid);
+        return;
+    }
+    Store(*buffer, phase, name, value, buffer->tid);
+}
+
+void TraceRecorder::Store(ThreadBuffer& buffer, TracePhase phase, const char* name, int64_t value, uint32_t tid) {
+    // Only one thread at a time writes a buffer, so a new session resets it here
+    uint64_t session = m_session.load(std::memory_order_relaxed);
+    size_t count = buffer.count.load(std::memory_order_relaxed);
+    if (buffer.session.load(std::memory_order_relaxed) != session) {
+        count = 0;
+        buffer.dropped.store(0, std::memory_order_relaxed);
+        buffer.count.store(0, std::memory_order_relaxed);
+        buffer.session.store(session, std::memory_order_release);
+    }
+    if (count >= m_capacity) {
+        buffer.dropped.store(buffer.dropped.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        return;
+    }
+
+    TraceRecord& record = buffer.records[count];
+    record.timestampNs = Utils::MonotonicClock::SystemNanoseconds();
+    record.name = name;
+    record.value = value;
+    record.tid = tid;
+    record.phase = phase;
+    buffer.count.store(count + 1, std::memory_order_release);
+}
+
+TraceRecorder::ThreadBuffer* TraceRecorder::RegisterThread() {
+    std::lock_guard<std::mutex> lock(m_registerMutex);
+    if (t_pooled && m_pooledBuffer) {
+        return m_pooledBuffer;
+    }
+    size_t index = m_threadCount.load(std::memory_order_relaxed);
+    if (index >= kMaxThreads) {
+        return nullptr;
+    }
+    m_threads[index].reset(new ThreadBuffer(m_capacity, m_session.load(std::memory_order_relaxed),
+                                            static_cast<uint32_t>(index + 1), t_pooled ? nullptr : t_threadName,
+                                            t_pooled));
+    if (t_pooled) {
+        m_pooledBuffer = m_threads[index].get();
+    }
+    m_threadCount.store(index + 1, std::memory_order_release);
+    return m_threads[index].get();
+}
+
+size_t TraceRecorder::GetRecordCount() const {
+    uint64_t session = m_session.load(std::memory_order_relaxed);
+    size_t total = 0;
+    size_t threads = m_threadCount.load(std::memory_order_acquire);
+    for (size_t i = 0; i < threads; ++i) {
+        if (m_threads[i]->session.load(std::memory_order_acquire) == session) {
+            total += m_threads[i]->count.load(std::memory_order_acquire);
+        }
+    }
+    return total;
+}
+
+uint64_t TraceRecorder::GetDroppedCount() const {
+    uint64_t session = m_session.load(std::memory_order_relaxed);
+    uint64_t total = m_unregisteredDrops.load(std::memory_order_relaxed);
+    size_t threads = m_threadCount.load(std::memory_order_acquire);
+    for (size_t i = 0; i < threads; ++i) {
+        if (m_threads[i]->session.load(std::memory_order_acquire) == session) {
+            total += m_threads[i]->dropped.load(std::memory_order_relaxed);
+        }
+    }
+    return total;
+}
+
+bool TraceRecorder::ExportChromeJson(const std::string& path) {
+    FILE* file = std::fopen(path.c_str(), "w");
+    if (!file) {
+        m_lastError = path + ": " + std::strerror(errno);
+        return false;
+    }
+
+    // Timestamps are microseconds since Start(), which viewers show as-is
+    uint64_t session = m_session.load(std::memory_order_relaxed);
+    uint64_t startNs = m_startNs.load(std::memory_order_relaxed);
+    int pid = static_cast<int>(getpid());
+    std::fprintf(file, "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n");
+    std::fprintf(file, "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":%d,\"tid\":0,\"args\":{\"name\":\"tpmiddle\"}}", pid);
+
+    size_t threads = m_threadCount.load(std::memory_order_acquire);
+    for (size_t i = 0; i < threads; ++i) {
+        const ThreadBuffer& buffer = *m_threads[i];
+        if (buffer.session.load(std::memory_order_acquire) != session) {
+            continue;
+        }
+        if (buffer.name) {
+            std::fprintf(file, ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":%d,\"tid\":%u,\"args\":{\"name\":",
+                         pid, buffer.tid);
+            WriteJsonString(file, buffer.name);
+            std::fprintf(file, "}}");
+        }
+
+        size_t count = buffer.count.load(std::memory_order_acquire);
+        for (size_t r = 0; r < count; ++r) {
+            const TraceRecord& record = buffer.records[r];
+            uint64_t sinceStart = record.timestampNs > startNs ? record.timestampNs - startNs : 0;
+            std::fprintf(file, ",\n{\"name\":");
+            WriteJsonString(file, record.name);
+            std::fprintf(file, ",\"cat\":\"tpmiddle\",\"ph\":\"%c\",\"ts\":%" PRIu64 ".%03" PRIu64 ",\"pid\":%d,\"tid\":%u",
+                         static_cast<char>(record.phase), sinceStart / 1000, sinceStart % 1000, pid, record.tid);
+            switch (record.phase) {
+                case TracePhase::Instant:
+                    std::fprintf(file, ",\"s\":\"t\",\"args\":{\"value\":%" PRId64 "}", record.value);
+                    break;
+                case TracePhase::Counter:
+                    std::fprintf(file, ",\"args\":{\"value\":%" PRId64 "}", record.value);
+                    break;
+                default:
+                    break;
+            }
+            std::fputc('}', file);
+        }
+    }
+    std::fprintf(file, "\n]}\n");
+
+    bool written = !std::ferror(file);
+    if (std::fclose(file) != 0 || !written) {
+        m_lastError = path + ": write failed";
+        return false;
+    }
+    return true;
+}
+
+} // namespace Application
+} // namespace TPMiddle
@@ -0,0 +1,192 @@
+#ifndef TPMIDDLE_TRACE_RECORDER_H
+#define TPMIDDLE_TRACE_RECORDER_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+
+// Spans and instants stay in the build unless this is set to 0; at run
+// time a disabled recorder costs one relaxed load and branch per site
+#ifndef TPMIDDLE_TRACING
+#define TPMIDDLE_TRACING 1
+#endif
+
+namespace TPMiddle {
+namespace Application {
+
+enum class TracePhase : char {
+    Begin = 'B',
+    End = 'E',
+    Instant = 'i',
+    Counter = 'C'
+};
+
+/**
+ * @brief One trace event as stored in a thread's buffer
+ */
+struct TraceRecord {
+    uint64_t timestampNs;
+    const char* name;        // Static string; only the pointer is stored
+    int64_t value;           // Instant argument or counter value
+    uint32_t tid;            // Recording thread as exported
+    TracePhase phase;
+};
+
+/**
+ * @brief Opt-in recorder of pipeline stage spans, exported as Chrome trace JSON
+ *
+ * Every thread that records gets its own fixed-size buffer the first time
+ * it records while tracing is on; after that, recording is a timestamp
+ * read and a store into that buffer with no lock and no allocation. A
+ * full buffer drops further events of its thread and counts them.
+ *
+ * Dispatch pool threads come and go, so they would each take a buffer and
+ * soon use up kMaxThreads. Work running on them calls SetThreadPooled()
+ * first; those threads then share one buffer, written under a mutex.
+ *
+ * Start() opens a new session and Stop() ends it; buffers are reused
+ * across sessions. Export after Stop(), once in-flight spans have ended.
+ * The JSON opens in chrome://tracing and the Perfetto UI.
+ */
+class TraceRecorder {
+public:
+    static constexpr size_t kDefaultRecordsPerThread = 1 << 17;
+    static constexpr size_t kMaxThreads = 32;
+
+    explicit TraceRecorder(size_t recordsPerThread = kDefaultRecordsPerThread);
+    ~TraceRecorder();
+
+    TraceRecorder(const TraceRecorder&) = delete;
+    TraceRecorder& operator=(const TraceRecorder&) = delete;
+
+    /**
+     * @brief Process-wide instance behind TP_TRACE_SPAN and TP_TRACE_INSTANT
+     */
+    static TraceRecorder& Shared() { return s_shared; }
+
+    /**
+     * @brief Name the calling thread in exported traces; call before it records
+     * @param name Static string
+     */
+    static void SetThreadName(const char* name);
+
+    /**
+     * @brief Record the calling thread's events in the buffer shared by pooled threads
+     *
+     * Call at the top of every dispatch block that records; it is one
+     * thread-local store.
+     */
+    static void SetThreadPooled();
+
+    /**
+     * @brief Discard the previous session and start recording
+     */
+    void Start();
+    void Stop();
+    bool IsEnabled() const { return m_enabled.load(std::memory_order_relaxed); }
+
+    // Hot path; names must be static strings
+    void Begin(const char* name) {
+        if (IsEnabled()) Append(TracePhase::Begin, name, 0);
+    }
+    void End(const char* name) {
+        if (IsEnabled()) Append(TracePhase::End, name, 0);
+    }
+    void Instant(const char* name, int64_t value = 0) {
+        if (IsEnabled()) Append(TracePhase::Instant, name, value);
+    }
+    void Counter(const char* name, int64_t value) {
+        if (IsEnabled()) Append(TracePhase::Counter, name, value);
+    }
+
+    /**
+     * @brief Events recorded in the current or last session, over all threads
+     */
+    size_t GetRecordCount() const;
+
+    /**
+     * @brief Events lost to full buffers or to the thread limit in the same session
+     */
+    uint64_t GetDroppedCount() const;
+
+    /**
+     * @brief Write the current or last session as Chrome trace-event JSON
+     * @return bool True on success; see GetLastError() otherwise
+     */
+    bool ExportChromeJson(const std::string& path);
+    const std::string& GetLastError() const { return m_lastError; }
+
+private:
+    friend class TraceSpan;
+    struct ThreadBuffer;
+
+    static TraceRecorder s_shared;
+
+    std::atomic<bool> m_enabled;
+    std::atomic<uint64_t> m_session;
+    std::atomic<uint64_t> m_startNs;
+    std::atomic<uint64_t> m_unregisteredDrops;
+    const uint64_t m_id;                       // Tells recorders apart in per-thread caches
+    const size_t m_capacity;
+
+    std::mutex m_registerMutex;
+    std::unique_ptr<ThreadBuffer> m_threads[kMaxThreads];
+    ThreadBuffer* m_pooledBuffer;              // One of m_threads; guarded by m_registerMutex
+    std::atomic<size_t> m_threadCount;
+    std::string m_lastError;
+
+    void Append(TracePhase phase, const char* name, int64_t value);
+    void Store(ThreadBuffer& buffer, TracePhase phase, const char* name, int64_t value, uint32_t tid);
+    ThreadBuffer* RegisterThread();
+};
+
+/**
+ * @brief Begin/end span for the enclosing scope
+ *
+ * Whether the span records is decided once, at construction, so a span
+ * that began before Stop() still ends in the trace.
+ */
+class TraceSpan {
+public:
+    TraceSpan(TraceRecorder& recorder, const char* name) : m_recorder(nullptr), m_name(name) {
+        if (recorder.IsEnabled()) {
+            m_recorder = &recorder;
+            recorder.Append(TracePhase::Begin, name, 0);
+        }
+    }
+    ~TraceSpan() {
+        if (m_recorder) {
+            m_recorder->Append(TracePhase::End, m_name, 0);
+        }
+    }
+
+    TraceSpan(const TraceSpan&) = delete;
+    TraceSpan& operator=(const TraceSpan&) = delete;
+
+private:
+    TraceRecorder* m_recorder;
+    const char* m_name;
+};
+
+} // namespace Application
+} // namespace TPMiddle
+
+#define TP_TRACE_CONCAT_INNER(a, b) a##b
+#define TP_TRACE_CONCAT(a, b) TP_TRACE_CONCAT_INNER(a, b)
+
+#if TPMIDDLE_TRACING
+#define TP_TRACE_SPAN(name) \
+    ::TPMiddle::Application::TraceSpan TP_TRACE_CONCAT(tpTraceSpan, __LINE__)( \
+        ::TPMiddle::Application::TraceRecorder::Shared(), name)
+#define TP_TRACE_INSTANT(name, value) ::TPMiddle::Application::TraceRecorder::Shared().Instant(name, value)
+#define TP_TRACE_COUNTER(name, value) ::TPMiddle::Application::TraceRecorder::Shared().Counter(name, value)
+#else
+#define TP_TRACE_SPAN(name) do {} while (0)
+#define TP_TRACE_INSTANT(name, value) do {} while (0)
+#define TP_TRACE_COUNTER(name, value) do {} while (0)
+#endif
+
+#endif // TPMIDDLE_TRACE_RECORDER_H
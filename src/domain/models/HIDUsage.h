@@ -0,0 +1,42 @@
+#ifndef TPMIDDLE_HID_USAGE_H
+#define TPMIDDLE_HID_USAGE_H
+
+#include <cstdint>
+
+namespace TPMiddle {
+namespace Domain {
+
+/**
+ * @brief HID usage tables subset used by the pointer pipeline
+ *
+ * Values come from the USB HID Usage Tables and match IOKit's kHIDPage_* /
+ * kHIDUsage_* constants, so portable code does not need IOKit headers.
+ */
+namespace HIDUsage {
+
+constexpr uint16_t kPageGenericDesktop = 0x01;
+constexpr uint16_t kPageButton = 0x09;
+constexpr uint16_t kPageConsumer = 0x0C;
+
+constexpr uint16_t kPointer = 0x01;
+constexpr uint16_t kMouse = 0x02;
+constexpr uint16_t kX = 0x30;
+constexpr uint16_t kY = 0x31;
+constexpr uint16_t kWheel = 0x38;
+constexpr uint16_t kACPan = 0x238;             // Consumer page horizontal wheel
+
+constexpr uint16_t kButtonLeft = 1;
+constexpr uint16_t kButtonRight = 2;
+constexpr uint16_t kButtonMiddle = 3;
+
+} // namespace HIDUsage
+
+// Button masks passed alongside movement
+constexpr uint8_t kButtonMaskLeft = 0x01;
+constexpr uint8_t kButtonMaskRight = 0x02;
+constexpr uint8_t kButtonMaskMiddle = 0x04;
+
+} // namespace Domain
+} // namespace TPMiddle
+
+#endif // TPMIDDLE_HID_USAGE_H
@@ -0,0 +1,64 @@
+#ifndef TPMIDDLE_INPUT_EVENT_H
+#define TPMIDDLE_INPUT_EVENT_H
+
+#include <cstdint>
+
+namespace TPMiddle {
+namespace Domain {
+
+/**
+ * @brief Kind of record carried by an InputEvent
+ */
+enum class InputEventType : uint8_t {
+    Value = 0,           // One HID element value (usage page, usage, value)
+    DeviceAttached = 1,  // A matching device appeared
+    DeviceRemoved = 2,   // A matching device went away
+    Pointer = 3          // One decoded input report (buttons, X, Y, wheel together)
+};
+
+/**
+ * @brief Payload of an InputEventType::Value event
+ */
+struct ElementValue {
+    int32_t value;           // Integer value of the element
+    uint16_t usagePage;      // HID usage page of the element
+    uint16_t usage;          // HID usage of the element
+};
+
+/**
+ * @brief Payload of an InputEventType::Pointer event
+ */
+struct PointerSample {
+    int16_t deltaX;          // Relative X movement as reported by the device
+    int16_t deltaY;          // Relative Y movement as reported by the device
+    int8_t wheel;            // Vertical wheel detents
+    int8_t pan;              // Horizontal wheel (AC Pan) detents
+    uint16_t buttons;        // Button state, bit 0 = button 1 (left)
+};
+
+/**
+ * @brief Compact, trivially copyable record of one raw input occurrence
+ *
+ * Produced by the HID callback and consumed by the processing thread, so it
+ * must stay a fixed-size POD with no owning members.
+ */
+struct InputEvent {
+    uint64_t timestamp;      // Monotonic nanoseconds at which the HID stack reported the value
+    uint64_t device;         // Compact handle assigned when the device attached
+    union {
+        ElementValue element;    // type == Value
+        PointerSample pointer;   // type == Pointer
+        uint64_t platformDevice; // type == DeviceAttached/DeviceRemoved, opaque platform reference
+    };
+    InputEventType type;
+    uint8_t reserved[3];
+    uint32_t callbackDelayNs; // Time from timestamp until the HID callback ran, saturated
+};
+
+static_assert(sizeof(ElementValue) == 8 && sizeof(PointerSample) == 8, "Payloads share 8 bytes");
+static_assert(sizeof(InputEvent) == 32, "InputEvent must stay a compact 32-byte record");
+
+} // namespace Domain
+} // namespace TPMiddle
+
+#endif // TPMIDDLE_INPUT_EVENT_H
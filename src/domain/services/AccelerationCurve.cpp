@@ -0,0 +1,213 @@
+#include "AccelerationCurve.h"
+#include <cmath>
+#include <cstdlib>
+#include <sstream>
+
+namespace TPMiddle {
+namespace Domain {
+
+namespace {
+
+const size_t kBatchBlock = 64;
+const int kBezierIterations = 48;
+
+double SquaredSpeedAt(uint32_t index) {
+    if (index < AccelerationCurve::kFineEntries) {
+        return static_cast<double>(index);
+    }
+    return static_cast<double>(AccelerationCurve::kFineEntries) +
+           static_cast<double>(index - AccelerationCurve::kFineEntries) * AccelerationCurve::kCoarseStep;
+}
+
+double EvaluatePiecewise(const std::vector<CurvePoint>& points, double speed) {
+    if (speed <= points.front().speed) {
+        return points.front().value;
+    }
+    for (size_t i = 1; i < points.size(); ++i) {
+        if (speed <= points[i].speed) {
+            const CurvePoint& a = points[i - 1];
+            const CurvePoint& b = points[i];
+            return a.value + (b.value - a.value) * (speed - a.speed) / (b.speed - a.speed);
+        }
+    }
+    return points.back().value;
+}
+
+double BezierCoordinate(double p1, double p2, double p3, double t) {
+    double u = 1.0 - t;
+    return 3.0 * u * u * t * p1 + 3.0 * u * t * t * p2 + t * t * t * p3;
+}
+
+// The control points lie within [0, end] horizontally, so x(t) is monotonic
+// and bisection finds the parameter for a speed
+double EvaluateBezier(const std::vector<CurvePoint>& points, double speed) {
+    const CurvePoint& end = points[2];
+    if (speed >= end.speed) {
+        return end.value;
+    }
+    double low = 0.0;
+    double high = 1.0;
+    for (int i = 0; i < kBezierIterations; ++i) {
+        double mid = 0.5 * (low + high);
+        if (BezierCoordinate(points[0].speed, points[1].speed, end.speed, mid) < speed) {
+            low = mid;
+        } else {
+            high = mid;
+        }
+    }
+    return BezierCoordinate(points[0].value, points[1].value, end.value, 0.5 * (low + high));
+}
+
+bool ParseNumber(const std::string& text, double& value) {
+    if (text.empty()) {
+        return false;
+    }
+    char* end = nullptr;
+    value = std::strtod(text.c_str(), &end);
+    return *end == '\0' && std::isfinite(value);
+}
+
+bool ParsePoints(const std::string& text, std::vector<CurvePoint>& points) {
+    std::istringstream stream(text);
+    std::string entry;
+    while (std::getline(stream, entry, ';')) {
+        size_t comma = entry.find(',');
+        CurvePoint point;
+        if (comma == std::string::npos ||
+            !ParseNumber(entry.substr(0, comma), point.speed) ||
+            !ParseNumber(entry.substr(comma + 1), point.value)) {
+            return false;
+        }
+        points.push_back(point);
+    }
+    return !points.empty();
+}
+
+} // namespace
+
+AccelerationCurve::AccelerationCurve() {
+    Build(AccelerationCurveSpec());
+}
+
+bool AccelerationCurve::Build(const AccelerationCurveSpec& spec) {
+    switch (spec.kind) {
+        case AccelerationCurveKind::Linear:
+            break;
+        case AccelerationCurveKind::Power:
+            if (!(spec.exponent > 0.0)) {
+                m_lastError = "Power curve exponent must be positive";
+                return false;
+            }
+            break;
+        case AccelerationCurveKind::PiecewiseLinear:
+            if (spec.points.empty()) {
+                m_lastError = "Piecewise curve needs at least one point";
+                return false;
+            }
+            for (size_t i = 1; i < spec.points.size(); ++i) {
+                if (!(spec.points[i].speed > spec.points[i - 1].speed)) {
+                    m_lastError = "Piecewise curve speeds must be ascending";
+                    return false;
+                }
+            }
+            break;
+        case AccelerationCurveKind::Bezier:
+            if (spec.points.size() != 3 || !(spec.points[2].speed > 0.0) ||
+                spec.points[0].speed < 0.0 || spec.points[0].speed > spec.points[2].speed ||
+                spec.points[1].speed < 0.0 || spec.points[1].speed > spec.points[2].speed) {
+                m_lastError = "Bezier curve needs two control points within [0, end speed] and an end point";
+                return false;
+            }
+            break;
+    }
+
+    std::vector<float> table(kTableSize + 1);
+    for (uint32_t i = 0; i < kTableSize; ++i) {
+        double speed = std::sqrt(SquaredSpeedAt(i));
+        double value = speed;
+        switch (spec.kind) {
+            case AccelerationCurveKind::Linear:
+                break;
+            case AccelerationCurveKind::Power:
+                value = std::pow(speed, spec.exponent);
+                break;
+            case AccelerationCurveKind::PiecewiseLinear:
+                value = EvaluatePiecewise(spec.points, speed);
+                break;
+            case AccelerationCurveKind::Bezier:
+                value = EvaluateBezier(spec.points, speed);
+                break;
+        }
+        table[i] = static_cast<float>(value);
+    }
+    table[kTableSize] = table[kTableSize - 1];
+
+    m_spec = spec;
+    m_table.swap(table);
+    m_lastError.clear();
+    return true;
+}
+
+bool AccelerationCurve::Parse(const std::string& text) {
+    size_t colon = text.find(':');
+    std::string name = text.substr(0, colon);
+    std::string arguments = (colon == std::string::npos) ? std::string() : text.substr(colon + 1);
+
+    AccelerationCurveSpec spec;
+    bool valid = false;
+    if (name == "linear") {
+        spec.kind = AccelerationCurveKind::Linear;
+        valid = arguments.empty();
+    } else if (name == "power") {
+        spec.kind = AccelerationCurveKind::Power;
+        valid = ParseNumber(arguments, spec.exponent);
+    } else if (name == "points") {
+        spec.kind = AccelerationCurveKind::PiecewiseLinear;
+        valid = ParsePoints(arguments, spec.points);
+    } else if (name == "bezier") {
+        spec.kind = AccelerationCurveKind::Bezier;
+        valid = ParsePoints(arguments, spec.points);
+    }
+    if (!valid) {
+        m_lastError = "Malformed acceleration curve \"" + text + "\"";
+        return false;
+    }
+    return Build(spec);
+}
+
+void AccelerationCurve::EvaluateBatch(const int16_t* deltaX, const int16_t* deltaY, size_t count,
+                                      float* values) const {
+    const int32_t kMaxSquared = static_cast<int32_t>(kMaxSquaredSpeed);
+    int32_t squared[kBatchBlock];
+
+    // Whole blocks only, so the first pass has a constant trip count
+    size_t start = 0;
+    for (; start + kBatchBlock <= count; start += kBatchBlock) {
+        const int16_t* blockX = deltaX + start;
+        const int16_t* blockY = deltaY + start;
+
+        // Squared speeds in signed 32-bit lanes: each square is at most 2^30
+        // and is clamped before the sum, and conditional expressions rather
+        // than std::min keep the loop if-convertible
+        for (size_t i = 0; i < kBatchBlock; ++i) {
+            int32_t squareX = static_cast<int32_t>(blockX[i]) * blockX[i];
+            int32_t squareY = static_cast<int32_t>(blockY[i]) * blockY[i];
+            squareX = squareX < kMaxSquared ? squareX : kMaxSquared;
+            squareY = squareY < kMaxSquared ? squareY : kMaxSquared;
+            int32_t sum = squareX + squareY;
+            squared[i] = sum < kMaxSquared ? sum : kMaxSquared;
+        }
+
+        // Table pass; x86 without gathers cannot vectorize the loads, and the
+        // fine/coarse branch is well predicted for TrackPoint traces
+        for (size_t i = 0; i < kBatchBlock; ++i) {
+            values[start + i] = EvaluateSquared(static_cast<uint32_t>(squared[i]));
+        }
+    }
+    for (; start < count; ++start) {
+        values[start] = Evaluate(deltaX[start], deltaY[start]);
+    }
+}
+
+} // namespace Domain
+} // namespace TPMiddle
@@ -0,0 +1,125 @@
+#ifndef TPMIDDLE_ACCELERATION_CURVE_H
+#define TPMIDDLE_ACCELERATION_CURVE_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace TPMiddle {
+namespace Domain {
+
+/**
+ * @brief Shape of the acceleration curve
+ */
+enum class AccelerationCurveKind {
+    Linear,            // shape(s) = s, the original formula
+    Power,             // shape(s) = s^exponent
+    PiecewiseLinear,   // Straight segments between points
+    Bezier             // Cubic Bezier from (0, 0) through two control points to an end point
+};
+
+/**
+ * @brief One (speed, shape) point of a piecewise-linear or Bezier curve
+ */
+struct CurvePoint {
+    double speed;
+    double value;
+};
+
+/**
+ * @brief User-facing description of a curve, compiled by AccelerationCurve::Build()
+ */
+struct AccelerationCurveSpec {
+    AccelerationCurveKind kind = AccelerationCurveKind::Linear;
+    double exponent = 1.0;              // Power only
+    std::vector<CurvePoint> points;     // Piecewise: ascending speeds; Bezier: control 1, control 2, end
+};
+
+/**
+ * @brief Acceleration curve compiled into a lookup table over squared pointer speed
+ *
+ * The acceleration factor for a sample is
+ * 1 + acceleration * shape(speed) * timeDelta, with speed = |(dx, dy)| in
+ * counts per report. Deltas are integers, so the squared speed is an exact
+ * integer and indexes the table directly, which replaces the square root and
+ * the curve math with one load. Squared speeds below kFineEntries have an
+ * entry each; above that entries are kCoarseStep apart and interpolated
+ * linearly. Speeds beyond kMaxSpeed evaluate as kMaxSpeed.
+ *
+ * Curves are built on a configuration thread and shared read-only.
+ */
+class AccelerationCurve {
+public:
+    static constexpr uint32_t kFineEntries = 1024;                  // Squared speed below 1024 (speed 32)
+    static constexpr uint32_t kCoarseShift = 6;
+    static constexpr uint32_t kCoarseStep = 1u << kCoarseShift;
+    static constexpr uint32_t kMaxSpeed = 512;
+    static constexpr uint32_t kMaxSquaredSpeed = kMaxSpeed * kMaxSpeed;
+    static constexpr uint32_t kTableSize = kFineEntries + (kMaxSquaredSpeed - kFineEntries) / kCoarseStep + 1;
+
+    /**
+     * @brief Construct the linear curve
+     */
+    AccelerationCurve();
+
+    /**
+     * @brief Compile a curve into the table
+     * @return bool False for an invalid spec, which leaves the curve unchanged
+     */
+    bool Build(const AccelerationCurveSpec& spec);
+
+    /**
+     * @brief Parse and compile a textual curve
+     *
+     * Accepted forms: "linear", "power:<exponent>",
+     * "points:<speed>,<value>;<speed>,<value>;..." and
+     * "bezier:<x1>,<y1>;<x2>,<y2>;<x3>,<y3>".
+     *
+     * @return bool False if the text is malformed or describes an invalid curve
+     */
+    bool Parse(const std::string& text);
+
+    const AccelerationCurveSpec& GetSpec() const { return m_spec; }
+    const std::string& GetLastError() const { return m_lastError; }
+
+    /**
+     * @brief Shape value for an exact squared speed
+     */
+    float EvaluateSquared(uint32_t squaredSpeed) const {
+        if (squaredSpeed < kFineEntries) {
+            return m_table[squaredSpeed];
+        }
+        uint32_t offset = std::min(squaredSpeed, kMaxSquaredSpeed) - kFineEntries;
+        uint32_t index = kFineEntries + (offset >> kCoarseShift);
+        float fraction = static_cast<float>(offset & (kCoarseStep - 1)) * (1.0f / kCoarseStep);
+        return m_table[index] + (m_table[index + 1] - m_table[index]) * fraction;
+    }
+
+    /**
+     * @brief Shape value for one pointer delta
+     */
+    float Evaluate(int deltaX, int deltaY) const {
+        int64_t squared = static_cast<int64_t>(deltaX) * deltaX + static_cast<int64_t>(deltaY) * deltaY;
+        return EvaluateSquared(static_cast<uint32_t>(std::min<int64_t>(squared, kMaxSquaredSpeed)));
+    }
+
+    /**
+     * @brief Shape values for many pointer deltas, for replay and benchmarks
+     *
+     * Squared speeds are computed in a separate pass over fixed-size blocks
+     * so the compiler can vectorize it; only the table loads remain scalar.
+     */
+    void EvaluateBatch(const int16_t* deltaX, const int16_t* deltaY, size_t count, float* values) const;
+
+private:
+    AccelerationCurveSpec m_spec;
+    std::vector<float> m_table;       // kTableSize entries plus one guard for interpolation
+    std::string m_lastError;
+};
+
+} // namespace Domain
+} // namespace TPMiddle
+
+#endif // TPMIDDLE_ACCELERATION_CURVE_H
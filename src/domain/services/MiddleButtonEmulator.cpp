@@ -0,0 +1,213 @@
+#include "MiddleButtonEmulator.h"
+
+namespace TPMiddle {
+namespace Domain {
+
+namespace {
+
+using Emulator = MiddleButtonEmulator;
+
+enum Action : uint16_t {
+    kNone = 0,
+    kPostMiddleDown = 1 << 0,
+    kPostMiddleUp = 1 << 1,
+    kClearScroll = 1 << 2,
+    kEmitLeftDown = 1 << 3,
+    kEmitLeftUp = 1 << 4,
+    kEmitRightDown = 1 << 5,
+    kEmitRightUp = 1 << 6,
+    kArmChordTimer = 1 << 7,
+    kCancelChordTimer = 1 << 8,
+    kArmToggleTimer = 1 << 9,
+    kCancelToggleTimer = 1 << 10,
+    kToggleScrollMode = 1 << 11,
+
+    // Left and right edges the system already saw under PassThrough
+    kEmitMask = kEmitLeftDown | kEmitLeftUp | kEmitRightDown | kEmitRightUp,
+
+    // Every physical middle press opens the scroll toggle window
+    kPressMiddle = kPostMiddleDown | kArmToggleTimer
+};
+
+struct Transition {
+    Emulator::State next;
+    uint16_t actions;
+};
+
+const Transition kIgnore = {Emulator::kStay, kNone};
+
+// Rows are states, columns LeftDown, LeftUp, RightDown, RightUp, MiddleDown,
+// MiddleUp, ChordTimeout, ToggleTimeout. Left and right edges while the
+// physical middle button is held pass through without changing state.
+const Transition kTransitions[Emulator::kStateCount][Emulator::kInputCount] = {
+    // kIdle
+    {{Emulator::kLeftPending, kArmChordTimer}, kIgnore,
+     {Emulator::kRightPending, kArmChordTimer}, kIgnore,
+     {Emulator::kMiddleQuick, kPressMiddle}, kIgnore, kIgnore, kIgnore},
+    // kLeftPending: a release is a tap, the deadline makes it a hold
+    {kIgnore, {Emulator::kIdle, kCancelChordTimer | kEmitLeftDown | kEmitLeftUp},
+     {Emulator::kChord, kCancelChordTimer | kPostMiddleDown}, kIgnore,
+     {Emulator::kMiddleQuick, kCancelChordTimer | kEmitLeftDown | kPressMiddle}, kIgnore,
+     {Emulator::kLeft, kEmitLeftDown}, kIgnore},
+    // kRightPending
+    {{Emulator::kChord, kCancelChordTimer | kPostMiddleDown}, kIgnore,
+     kIgnore, {Emulator::kIdle, kCancelChordTimer | kEmitRightDown | kEmitRightUp},
+     {Emulator::kMiddleQuick, kCancelChordTimer | kEmitRightDown | kPressMiddle}, kIgnore,
+     {Emulator::kRight, kEmitRightDown}, kIgnore},
+    // kLeft
+    {kIgnore, {Emulator::kIdle, kEmitLeftUp},
+     {Emulator::kBoth, kEmitRightDown}, kIgnore,
+     {Emulator::kMiddleQuick, kPressMiddle}, kIgnore, kIgnore, kIgnore},
+    // kRight
+    {{Emulator::kBoth, kEmitLeftDown}, kIgnore,
+     kIgnore, {Emulator::kIdle, kEmitRightUp},
+     {Emulator::kMiddleQuick, kPressMiddle}, kIgnore, kIgnore, kIgnore},
+    // kBoth
+    {kIgnore, {Emulator::kRight, kEmitLeftUp},
+     kIgnore, {Emulator::kLeft, kEmitRightUp},
+     {Emulator::kMiddleQuick, kPressMiddle}, kIgnore, kIgnore, kIgnore},
+    // kChord: the physical middle button adds nothing to an emulated press
+    {kIgnore, {Emulator::kChordRight, kNone},
+     kIgnore, {Emulator::kChordLeft, kNone},
+     kIgnore, {Emulator::kStay, kClearScroll}, kIgnore, kIgnore},
+    // kChordLeft
+    {kIgnore, {Emulator::kIdle, kPostMiddleUp | kClearScroll},
+     {Emulator::kChord, kNone}, kIgnore,
+     kIgnore, {Emulator::kStay, kClearScroll}, kIgnore, kIgnore},
+    // kChordRight
+    {{Emulator::kChord, kNone}, kIgnore,
+     kIgnore, {Emulator::kIdle, kPostMiddleUp | kClearScroll},
+     kIgnore, {Emulator::kStay, kClearScroll}, kIgnore, kIgnore},
+    // kMiddle
+    {{Emulator::kStay, kEmitLeftDown}, {Emulator::kStay, kEmitLeftUp},
+     {Emulator::kStay, kEmitRightDown}, {Emulator::kStay, kEmitRightUp},
+     kIgnore, {Emulator::kFromButtons, kPostMiddleUp | kClearScroll}, kIgnore, kIgnore},
+    // kMiddleQuick: released in time the click toggles scroll mode
+    {{Emulator::kStay, kEmitLeftDown}, {Emulator::kStay, kEmitLeftUp},
+     {Emulator::kStay, kEmitRightDown}, {Emulator::kStay, kEmitRightUp},
+     kIgnore, {Emulator::kFromButtons, kCancelToggleTimer | kToggleScrollMode | kPostMiddleUp | kClearScroll},
+     kIgnore, {Emulator::kMiddle, kNone}},
+};
+
+const uint64_t kWheelTickNs = 1000000ULL;
+
+} // namespace
+
+MiddleButtonEmulator::MiddleButtonEmulator(uint64_t chordWindowNs, ChordClickPolicy policy)
+    : m_chordWindow(chordWindowNs)
+    , m_toggleWindow(0)
+    , m_policy(policy)
+    , m_state(kIdle)
+    , m_scrollMode(false)
+    , m_leftDown(false)
+    , m_rightDown(false)
+    , m_middleDown(false)
+    , m_wheel(kWheelTickNs)
+    , m_chordTimer(&MiddleButtonEmulator::OnChordTimeout, this)
+    , m_toggleTimer(&MiddleButtonEmulator::OnToggleTimeout, this) {
+}
+
+MiddleButtonActions MiddleButtonEmulator::Update(uint64_t timestampNs, bool leftDown, bool rightDown, bool middleDown) {
+    m_actions = MiddleButtonActions();
+    m_wheel.Advance(timestampNs);
+
+    // Real middle button press takes precedence
+    if (middleDown != m_middleDown) {
+        m_middleDown = middleDown;
+        Apply(middleDown ? kMiddleDown : kMiddleUp, timestampNs);
+    }
+    if (leftDown != m_leftDown) {
+        m_leftDown = leftDown;
+        Apply(leftDown ? kLeftDown : kLeftUp, timestampNs);
+    }
+    if (rightDown != m_rightDown) {
+        m_rightDown = rightDown;
+        Apply(rightDown ? kRightDown : kRightUp, timestampNs);
+    }
+    return m_actions;
+}
+
+MiddleButtonActions MiddleButtonEmulator::Advance(uint64_t timestampNs) {
+    m_actions = MiddleButtonActions();
+    m_wheel.Advance(timestampNs);
+    return m_actions;
+}
+
+MiddleButtonActions MiddleButtonEmulator::Reset() {
+    MiddleButtonActions actions;
+    actions.postMiddleUp = IsMiddlePressed();
+    actions.clearScroll = true;
+
+    m_wheel.Cancel(m_chordTimer);
+    m_wheel.Cancel(m_toggleTimer);
+    m_state = kIdle;
+    m_scrollMode = false;
+    m_leftDown = false;
+    m_rightDown = false;
+    m_middleDown = false;
+    return actions;
+}
+
+bool MiddleButtonEmulator::IsMiddleEmulated() const {
+    return m_state == kChord || m_state == kChordLeft || m_state == kChordRight;
+}
+
+bool MiddleButtonEmulator::IsMiddlePressed() const {
+    return IsMiddleEmulated() || m_state == kMiddle || m_state == kMiddleQuick;
+}
+
+void MiddleButtonEmulator::Apply(Input input, uint64_t timestampNs) {
+    const Transition& transition = kTransitions[m_state][input];
+    uint16_t actions = transition.actions;
+    if (m_policy == ChordClickPolicy::PassThrough) {
+        actions &= ~kEmitMask;
+    }
+
+    if (actions & kArmChordTimer) {
+        m_wheel.Schedule(m_chordTimer, timestampNs + m_chordWindow);
+    }
+    if (actions & kCancelChordTimer) {
+        m_wheel.Cancel(m_chordTimer);
+    }
+    State next = transition.next;
+    if (actions & kArmToggleTimer) {
+        // Without a window no click is quick enough to toggle
+        if (m_toggleWindow > 0) {
+            m_wheel.Schedule(m_toggleTimer, timestampNs + m_toggleWindow);
+        } else {
+            next = kMiddle;
+        }
+    }
+    if (actions & kCancelToggleTimer) {
+        m_wheel.Cancel(m_toggleTimer);
+    }
+    if (actions & kToggleScrollMode) {
+        m_scrollMode = !m_scrollMode;
+        m_actions.scrollModeChanged = true;
+    }
+    m_actions.postMiddleDown |= (actions & kPostMiddleDown) != 0;
+    m_actions.postMiddleUp |= (actions & kPostMiddleUp) != 0;
+    m_actions.clearScroll |= (actions & kClearScroll) != 0;
+    m_actions.postLeftDown |= (actions & kEmitLeftDown) != 0;
+    m_actions.postLeftUp |= (actions & kEmitLeftUp) != 0;
+    m_actions.postRightDown |= (actions & kEmitRightDown) != 0;
+    m_actions.postRightUp |= (actions & kEmitRightUp) != 0;
+
+    if (next == kFromButtons) {
+        // Presses that outlived the middle button can no longer start a chord
+        m_state = m_leftDown ? (m_rightDown ? kBoth : kLeft) : (m_rightDown ? kRight : kIdle);
+    } else if (next != kStay) {
+        m_state = next;
+    }
+}
+
+void MiddleButtonEmulator::OnChordTimeout(void* context, uint64_t deadlineNs) {
+    static_cast<MiddleButtonEmulator*>(context)->Apply(kChordTimeout, deadlineNs);
+}
+
+void MiddleButtonEmulator::OnToggleTimeout(void* context, uint64_t deadlineNs) {
+    static_cast<MiddleButtonEmulator*>(context)->Apply(kToggleTimeout, deadlineNs);
+}
+
+} // namespace Domain
+} // namespace TPMiddle
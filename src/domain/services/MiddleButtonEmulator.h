@@ -0,0 +1,159 @@
+#ifndef TPMIDDLE_MIDDLE_BUTTON_EMULATOR_H
+#define TPMIDDLE_MIDDLE_BUTTON_EMULATOR_H
+
+#include "../../utils/TimerWheel.h"
+#include <cstdint>
+
+namespace TPMiddle {
+namespace Domain {
+
+/**
+ * @brief Actions requested by one MiddleButtonEmulator update
+ *
+ * Left and right actions only occur under ChordClickPolicy::Hold. When
+ * several are set, presses come before releases and the middle release
+ * comes last.
+ */
+struct MiddleButtonActions {
+    bool postMiddleDown = false;   // Emit a middle button press
+    bool postMiddleUp = false;     // Emit a middle button release
+    bool clearScroll = false;      // Drop accumulated scroll movement
+    bool postLeftDown = false;     // Emit a held-back or passed-on left press
+    bool postLeftUp = false;
+    bool postRightDown = false;
+    bool postRightUp = false;
+    bool scrollModeChanged = false; // A quick physical middle click toggled scroll mode
+};
+
+/**
+ * @brief What happens to a left or right press while it could still start a chord
+ */
+enum class ChordClickPolicy {
+    PassThrough,   // The system already saw the press; only the middle button is synthesized
+    Hold           // The press is held back and replayed once it cannot be part of a chord
+};
+
+/**
+ * @brief Platform-neutral middle button state tracking and left+right chord emulation
+ *
+ * A physical middle button is forwarded directly. Pressing left and right
+ * within the chord window emulates a middle press that is released once
+ * both buttons are up. While a middle press (real or emulated) is active,
+ * TrackPoint movement is turned into scrolling.
+ *
+ * Button edges and the chord window deadline drive one transition table.
+ * The deadline runs on a timer wheel over the caller's clock: Update()
+ * first fires anything due at its timestamp, and callers that need held
+ * presses replayed on time call Advance() at GetNextDeadline(). Under
+ * ChordClickPolicy::Hold a press released within the window (a tap) is
+ * replayed as a click, and one still held at the deadline is replayed as a
+ * press at exactly that deadline.
+ *
+ * With a scroll toggle window set, a physical middle click released within
+ * it also toggles scroll mode; the window is a second timer on the wheel.
+ */
+class MiddleButtonEmulator {
+public:
+    /**
+     * @param chordWindowNs Left and right presses less than this far apart emulate a middle press
+     */
+    explicit MiddleButtonEmulator(uint64_t chordWindowNs = 20000000ULL,
+                                  ChordClickPolicy policy = ChordClickPolicy::PassThrough);
+
+    MiddleButtonEmulator(const MiddleButtonEmulator&) = delete;
+    MiddleButtonEmulator& operator=(const MiddleButtonEmulator&) = delete;
+
+    void SetChordWindow(uint64_t chordWindowNs) { m_chordWindow = chordWindowNs; }
+    uint64_t GetChordWindow() const { return m_chordWindow; }
+
+    void SetClickPolicy(ChordClickPolicy policy) { m_policy = policy; }
+    ChordClickPolicy GetClickPolicy() const { return m_policy; }
+
+    /**
+     * @param toggleWindowNs Middle clicks shorter than this toggle scroll mode; 0 (the default) never toggles
+     */
+    void SetScrollToggleWindow(uint64_t toggleWindowNs) { m_toggleWindow = toggleWindowNs; }
+    uint64_t GetScrollToggleWindow() const { return m_toggleWindow; }
+
+    /**
+     * @brief Apply a new physical button state
+     * @param timestampNs Monotonic time of the state change in nanoseconds
+     * @return MiddleButtonActions Events the caller must emit, including any deadline that passed
+     */
+    MiddleButtonActions Update(uint64_t timestampNs, bool leftDown, bool rightDown, bool middleDown);
+
+    /**
+     * @brief Fire deadlines due at timestampNs
+     * @return MiddleButtonActions Events to emit, stamped with the deadline
+     */
+    MiddleButtonActions Advance(uint64_t timestampNs);
+
+    /**
+     * @brief Time the next deadline is due, UINT64_MAX if none is pending
+     */
+    uint64_t GetNextDeadline() { return m_wheel.GetNextDeadline(); }
+
+    /**
+     * @brief Forget all button state and leave scroll mode; held-back presses are dropped
+     * @return MiddleButtonActions A middle release if a middle press was active
+     */
+    MiddleButtonActions Reset();
+
+    bool IsMiddleEmulated() const;
+    bool IsMiddlePressed() const;
+    bool IsScrollActive() const { return IsMiddlePressed(); }
+    bool IsScrollMode() const { return m_scrollMode; }
+
+    // Transition table vocabulary, public for the table definition only
+    enum State : uint8_t {
+        kIdle,
+        kLeftPending,     // Left alone, chord window open
+        kRightPending,
+        kLeft,            // Left alone, window closed
+        kRight,
+        kBoth,            // Both held, too far apart for a chord
+        kChord,           // Emulated middle, both held
+        kChordLeft,       // Emulated middle, left still held
+        kChordRight,
+        kMiddle,          // Physical middle held
+        kMiddleQuick,     // Physical middle held, scroll toggle window open
+        kStateCount,
+        kStay = kStateCount,
+        kFromButtons      // Idle, Left, Right or Both by the buttons held
+    };
+
+    enum Input : uint8_t {
+        kLeftDown,
+        kLeftUp,
+        kRightDown,
+        kRightUp,
+        kMiddleDown,
+        kMiddleUp,
+        kChordTimeout,
+        kToggleTimeout,
+        kInputCount
+    };
+
+private:
+    uint64_t m_chordWindow;
+    uint64_t m_toggleWindow;
+    ChordClickPolicy m_policy;
+    State m_state;
+    bool m_scrollMode;
+    bool m_leftDown;
+    bool m_rightDown;
+    bool m_middleDown;
+    MiddleButtonActions m_actions;       // Collects the output of one Update() or Advance()
+    Utils::TimerWheel<32> m_wheel;
+    Utils::WheelTimer m_chordTimer;
+    Utils::WheelTimer m_toggleTimer;
+
+    void Apply(Input input, uint64_t timestampNs);
+    static void OnChordTimeout(void* context, uint64_t deadlineNs);
+    static void OnToggleTimeout(void* context, uint64_t deadlineNs);
+};
+
+} // namespace Domain
+} // namespace TPMiddle
+
+#endif // TPMIDDLE_MIDDLE_BUTTON_EMULATOR_H
@@ -0,0 +1,117 @@
+#include "MomentumIntegrator.h"
+#include <algorithm>
+#include <cmath>
+
+namespace TPMiddle {
+namespace Domain {
+
+namespace {
+
+const double kStepSeconds = static_cast<double>(MomentumIntegrator::kStepNs) * 1e-9;
+const double kMinFriction = 0.1;
+
+double Clamp(double value, double limit) {
+    return std::min(std::max(value, -limit), limit);
+}
+
+} // namespace
+
+MomentumIntegrator::MomentumIntegrator(double friction, size_t sampleCount)
+    : m_samples()
+    , m_sampleCount(0)
+    , m_sampleHead(0)
+    , m_sampleCapacity(0)
+    , m_decayPerStep(1.0)
+    , m_active(false)
+    , m_stepTime(0)
+    , m_velocityX(0.0)
+    , m_velocityY(0.0) {
+    Configure(friction, sampleCount);
+}
+
+void MomentumIntegrator::Configure(double friction, size_t sampleCount) {
+    // Without friction the phase would never end
+    m_decayPerStep = std::exp(-std::max(friction, kMinFriction) * kStepSeconds);
+    m_sampleCapacity = std::min(std::max(sampleCount, static_cast<size_t>(2)), kMaxSamples);
+    Reset();
+}
+
+void MomentumIntegrator::AddSample(uint64_t timestampNs, double deltaX, double deltaY) {
+    m_samples[m_sampleHead] = {timestampNs, deltaX, deltaY};
+    m_sampleHead = (m_sampleHead + 1) % m_sampleCapacity;
+    m_sampleCount = std::min(m_sampleCount + 1, m_sampleCapacity);
+}
+
+bool MomentumIntegrator::Start(uint64_t timestampNs) {
+    size_t count = m_sampleCount;
+    size_t oldest = (m_sampleHead + m_sampleCapacity - count) % m_sampleCapacity;
+    size_t newest = (m_sampleHead + m_sampleCapacity - 1) % m_sampleCapacity;
+    m_sampleCount = 0;
+    m_active = false;
+    m_velocityX = 0.0;
+    m_velocityY = 0.0;
+
+    if (count < 2 || timestampNs > m_samples[newest].timestamp + kMaxReleaseGapNs) {
+        return false;
+    }
+    if (m_samples[newest].timestamp <= m_samples[oldest].timestamp) {
+        return false;
+    }
+    uint64_t span = m_samples[newest].timestamp - m_samples[oldest].timestamp;
+
+    // The oldest sample only marks the start of the window; its distance was
+    // covered before it
+    double distanceX = 0.0;
+    double distanceY = 0.0;
+    for (size_t i = 1; i < count; ++i) {
+        const Sample& sample = m_samples[(oldest + i) % m_sampleCapacity];
+        distanceX += sample.deltaX;
+        distanceY += sample.deltaY;
+    }
+    double seconds = static_cast<double>(span) * 1e-9;
+    m_velocityX = Clamp(distanceX / seconds, kMaxVelocity);
+    m_velocityY = Clamp(distanceY / seconds, kMaxVelocity);
+
+    if (std::hypot(m_velocityX, m_velocityY) < kMinVelocity) {
+        m_velocityX = 0.0;
+        m_velocityY = 0.0;
+        return false;
+    }
+    m_active = true;
+    m_stepTime = timestampNs;
+    return true;
+}
+
+ScrollOutput MomentumIntegrator::Advance(uint64_t timestampNs) {
+    ScrollOutput output;
+    while (m_active && timestampNs >= m_stepTime + kStepNs) {
+        m_velocityX *= m_decayPerStep;
+        m_velocityY *= m_decayPerStep;
+        output.deltaX += m_velocityX * kStepSeconds;
+        output.deltaY += m_velocityY * kStepSeconds;
+        m_stepTime += kStepNs;
+
+        if (std::hypot(m_velocityX, m_velocityY) < kMinVelocity) {
+            m_active = false;
+            m_velocityX = 0.0;
+            m_velocityY = 0.0;
+        }
+    }
+    output.emit = output.deltaX != 0.0 || output.deltaY != 0.0;
+    return output;
+}
+
+void MomentumIntegrator::Cancel() {
+    m_active = false;
+    m_velocityX = 0.0;
+    m_velocityY = 0.0;
+}
+
+void MomentumIntegrator::Reset() {
+    Cancel();
+    m_sampleCount = 0;
+    m_sampleHead = 0;
+}
+
+} // namespace Domain
+} // namespace TPMiddle
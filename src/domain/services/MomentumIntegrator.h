@@ -0,0 +1,95 @@
+#ifndef TPMIDDLE_MOMENTUM_INTEGRATOR_H
+#define TPMIDDLE_MOMENTUM_INTEGRATOR_H
+
+#include "ScrollEngine.h"
+#include <cstddef>
+#include <cstdint>
+
+namespace TPMiddle {
+namespace Domain {
+
+/**
+ * @brief Inertial scroll phase that follows a released middle-button drag
+ *
+ * While scrolling, every emitted engine delta is recorded as a velocity
+ * sample. Start() seeds a velocity from the last few samples and Advance()
+ * then integrates it in fixed steps with exponential friction until it
+ * falls below a stop threshold. Because the step is fixed, the output for a
+ * given release depends only on the samples and the timestamps passed in,
+ * not on how often Advance() is called.
+ */
+class MomentumIntegrator {
+public:
+    static constexpr size_t kMaxSamples = 16;
+    static constexpr uint64_t kStepNs = 1000000000ULL / 120;
+    static constexpr uint64_t kMaxReleaseGapNs = 50000000ULL;    // Older samples mean the drag had stopped
+    static constexpr double kMinVelocity = 30.0;                 // Pixels per second; slower motion stops
+    static constexpr double kMaxVelocity = 6000.0;               // Pixels per second, per axis
+
+    /**
+     * @param friction Exponential velocity decay per second, larger stops sooner
+     * @param sampleCount Number of recent samples the release velocity is estimated from
+     */
+    explicit MomentumIntegrator(double friction = 3.0, size_t sampleCount = 5);
+
+    void Configure(double friction, size_t sampleCount);
+
+    /**
+     * @brief Record one emitted scroll delta from the drag
+     */
+    void AddSample(uint64_t timestampNs, double deltaX, double deltaY);
+
+    /**
+     * @brief Begin coasting at the velocity of the recent samples
+     * @return bool True if the drag was fast enough to produce momentum
+     */
+    bool Start(uint64_t timestampNs);
+
+    /**
+     * @brief Integrate every whole step up to timestampNs
+     * @return ScrollOutput Scroll distance covered by those steps
+     */
+    ScrollOutput Advance(uint64_t timestampNs);
+
+    /**
+     * @brief Stop coasting, e.g. because new input arrived
+     */
+    void Cancel();
+
+    /**
+     * @brief Stop coasting and forget the recorded samples
+     */
+    void Reset();
+
+    bool IsActive() const { return m_active; }
+
+    /**
+     * @brief Time by which Advance() will have at least one more step to integrate
+     */
+    uint64_t GetNextStepTime() const { return m_stepTime + kStepNs; }
+
+    double GetVelocityX() const { return m_velocityX; }
+    double GetVelocityY() const { return m_velocityY; }
+
+private:
+    struct Sample {
+        uint64_t timestamp;
+        double deltaX;
+        double deltaY;
+    };
+
+    Sample m_samples[kMaxSamples];
+    size_t m_sampleCount;
+    size_t m_sampleHead;            // Index the next sample is written to
+    size_t m_sampleCapacity;
+    double m_decayPerStep;
+    bool m_active;
+    uint64_t m_stepTime;
+    double m_velocityX;
+    double m_velocityY;
+};
+
+} // namespace Domain
+} // namespace TPMiddle
+
+#endif // TPMIDDLE_MOMENTUM_INTEGRATOR_H
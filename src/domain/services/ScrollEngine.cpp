@@ -0,0 +1,53 @@
+#include "ScrollEngine.h"
+
+namespace TPMiddle {
+namespace Domain {
+
+ScrollEngine::ScrollEngine(const ScrollSettings& settings)
+    : m_process(nullptr) {
+    Configure(settings);
+}
+
+void ScrollEngine::Configure(const ScrollSettings& settings) {
+    m_settings = settings;
+    m_params = DeriveStageParams(m_settings);
+    m_process = SelectScrollStages(m_params);
+}
+
+ScrollStageParams ScrollEngine::DeriveStageParams(const ScrollSettings& settings) {
+    // The speed cap is symmetric, so the natural scrolling flip can be folded
+    // into the per-axis inversion sign instead of being applied after capping,
+    // and both into the base speed so each axis costs one multiply per sample.
+    double natural = settings.naturalScrolling ? -1.0 : 1.0;
+    ScrollStageParams params;
+    params.gainX = (settings.invertX ? -1.0 : 1.0) * natural * settings.speedMultiplier;
+    params.gainY = (settings.invertY ? -1.0 : 1.0) * natural * settings.speedMultiplier;
+    params.curve = settings.accelerationCurve ? settings.accelerationCurve.get() : &LinearCurve();
+    params.acceleration = settings.acceleration;
+    params.maxTimeDelta = settings.maxTimeDelta;
+    params.threshold = settings.minMovementThreshold;
+    params.cap = settings.maxScrollSpeed;
+    return params;
+}
+
+ScrollOutput ScrollEngine::ProcessMovement(uint64_t timestampNs, int deltaX, int deltaY) {
+    return m_process(m_state, m_params, timestampNs, deltaX, deltaY);
+}
+
+const AccelerationCurve& ScrollEngine::LinearCurve() {
+    static const AccelerationCurve curve;
+    return curve;
+}
+
+void ScrollEngine::ClearAccumulator() {
+    m_state.accumulatedX = 0.0;
+    m_state.accumulatedY = 0.0;
+}
+
+void ScrollEngine::Reset(uint64_t timestampNs) {
+    ClearAccumulator();
+    m_state.lastScrollTime = timestampNs;
+}
+
+} // namespace Domain
+} // namespace TPMiddle
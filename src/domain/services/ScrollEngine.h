@@ -0,0 +1,101 @@
+#ifndef TPMIDDLE_SCROLL_ENGINE_H
+#define TPMIDDLE_SCROLL_ENGINE_H
+
+#include "AccelerationCurve.h"
+#include "ScrollStages.h"
+#include <cstdint>
+#include <memory>
+
+namespace TPMiddle {
+namespace Domain {
+
+/**
+ * @brief Scroll tuning parameters consumed by ScrollEngine
+ *
+ * Mirrors the scroll settings held by TPConfig so the engine never has to
+ * reach back into Objective-C while processing movement.
+ */
+struct ScrollSettings {
+    double speedMultiplier = 0.5;
+    double acceleration = 1.2;
+    std::shared_ptr<const AccelerationCurve> accelerationCurve;   // Scaled by acceleration, null = linear
+    bool naturalScrolling = true;
+    bool invertX = false;
+    bool invertY = false;
+    double minMovementThreshold = 1.0;   // Minimum accumulated movement to trigger scroll
+    double maxScrollSpeed = 50.0;        // Maximum scroll delta per emitted event, 0 = uncapped
+    double maxTimeDelta = 0.1;           // Cap on the acceleration time window, seconds
+    double frameRate = 60.0;             // Scroll events posted per second at most, 0 = unpaced
+    bool momentum = false;               // Keep coasting after the middle button is released
+    double momentumFriction = 3.0;       // Exponential momentum decay per second
+    int momentumSamples = 5;             // Recent scroll samples the release velocity is taken from
+};
+
+/**
+ * @brief Platform-neutral TrackPoint scroll transform
+ *
+ * Converts timestamped pointer deltas into scroll deltas: acceleration,
+ * direction handling, accumulation, threshold and speed cap. The engine holds
+ * no Foundation or CoreGraphics state and performs no allocation after
+ * construction (curves are compiled by whoever builds the settings), so it
+ * can be benchmarked and unit-tested on any platform.
+ *
+ * The transform is the stage chain of ScrollStages.h. Configure() picks the
+ * instantiation matching the settings, so ProcessMovement() does not test
+ * acceleration or the speed cap per sample.
+ */
+class ScrollEngine {
+public:
+    explicit ScrollEngine(const ScrollSettings& settings = ScrollSettings());
+
+    /**
+     * @brief Replace the active settings
+     * @param settings New scroll settings; per-axis gains are derived here
+     */
+    void Configure(const ScrollSettings& settings);
+
+    /**
+     * @brief Get the active settings
+     * @return const ScrollSettings& The settings last passed to Configure
+     */
+    const ScrollSettings& GetSettings() const { return m_settings; }
+
+    /**
+     * @brief Derive the stage parameters for a set of settings
+     * @return ScrollStageParams Parameters whose curve points into settings
+     */
+    static ScrollStageParams DeriveStageParams(const ScrollSettings& settings);
+
+    /**
+     * @brief Process one movement sample
+     * @param timestampNs Monotonic timestamp of the sample in nanoseconds
+     * @param deltaX Horizontal pointer delta
+     * @param deltaY Vertical pointer delta
+     * @return ScrollOutput The scroll delta to post, with emit set when one is due
+     */
+    ScrollOutput ProcessMovement(uint64_t timestampNs, int deltaX, int deltaY);
+
+    /**
+     * @brief Drop any accumulated, not yet emitted movement
+     */
+    void ClearAccumulator();
+
+    /**
+     * @brief Clear all state and restart the acceleration window
+     * @param timestampNs Monotonic timestamp to measure the next sample against
+     */
+    void Reset(uint64_t timestampNs);
+
+private:
+    ScrollSettings m_settings;
+    ScrollStageParams m_params;          // Curve points into m_settings
+    ScrollStageState m_state;
+    ScrollStagesFunction m_process;      // Instantiation selected by Configure
+
+    static const AccelerationCurve& LinearCurve();
+};
+
+} // namespace Domain
+} // namespace TPMiddle
+
+#endif // TPMIDDLE_SCROLL_ENGINE_H
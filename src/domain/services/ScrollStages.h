@@ -0,0 +1,171 @@
+#ifndef TPMIDDLE_SCROLL_STAGES_H
+#define TPMIDDLE_SCROLL_STAGES_H
+
+#include "AccelerationCurve.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+
+namespace TPMiddle {
+namespace Domain {
+
+/**
+ * @brief Result of feeding one movement sample through the engine
+ */
+struct ScrollOutput {
+    bool emit = false;
+    double deltaX = 0.0;
+    double deltaY = 0.0;
+};
+
+/**
+ * @brief Settings of the scroll stages, derived once per configuration
+ */
+struct ScrollStageParams {
+    double gainX = 1.0;                         // Speed multiplier with direction folded in
+    double gainY = 1.0;
+    const AccelerationCurve* curve = nullptr;   // Never null once derived; owned by the settings
+    double acceleration = 0.0;
+    double maxTimeDelta = 0.1;                  // Seconds
+    double threshold = 1.0;
+    double cap = 0.0;                           // Largest delta per emitted event, 0 = uncapped
+};
+
+/**
+ * @brief Movement carried between samples
+ */
+struct ScrollStageState {
+    double accumulatedX = 0.0;
+    double accumulatedY = 0.0;
+    uint64_t lastScrollTime = 0;
+};
+
+/*
+ * Stage policies for accelerate -> direction -> accumulate -> emit. A
+ * setting that changes control flow picks a policy instead of being tested
+ * per sample; the Runtime* policies test it per sample and form the generic
+ * path the specialized instantiations are measured against.
+ */
+
+/**
+ * @brief Accelerate stage for acceleration == 0: no time or curve lookup at all
+ */
+struct ConstantAcceleration {
+    static double Factor(const ScrollStageParams&, const ScrollStageState&, uint64_t, int, int) {
+        return 1.0;
+    }
+};
+
+/**
+ * @brief Accelerate stage scaling the curve at the pointer speed by the
+ * capped time since the last emitted scroll
+ */
+struct CurveAcceleration {
+    static double Factor(const ScrollStageParams& params, const ScrollStageState& state,
+                         uint64_t timestampNs, int deltaX, int deltaY) {
+        double timeDelta = 0.0;
+        if (timestampNs > state.lastScrollTime) {
+            timeDelta = static_cast<double>(timestampNs - state.lastScrollTime) * 1e-9;
+        }
+        timeDelta = std::min(timeDelta, params.maxTimeDelta);
+        return 1.0 + params.curve->Evaluate(deltaX, deltaY) * params.acceleration * timeDelta;
+    }
+};
+
+struct RuntimeAcceleration {
+    static double Factor(const ScrollStageParams& params, const ScrollStageState& state,
+                         uint64_t timestampNs, int deltaX, int deltaY) {
+        return params.acceleration != 0.0
+            ? CurveAcceleration::Factor(params, state, timestampNs, deltaX, deltaY)
+            : ConstantAcceleration::Factor(params, state, timestampNs, deltaX, deltaY);
+    }
+};
+
+/**
+ * @brief Direction stage; inversion and natural scrolling are folded into
+ * the per-axis gains, so it has a single form
+ */
+struct FoldedDirection {
+    static double X(const ScrollStageParams& params, int deltaX, double factor) {
+        return static_cast<double>(deltaX) * params.gainX * factor;
+    }
+    static double Y(const ScrollStageParams& params, int deltaY, double factor) {
+        return static_cast<double>(deltaY) * params.gainY * factor;
+    }
+};
+
+/**
+ * @brief Accumulate stage: sums movement until either axis reaches the threshold
+ */
+struct ThresholdAccumulate {
+    static bool Add(const ScrollStageParams& params, ScrollStageState& state, double x, double y) {
+        state.accumulatedX += x;
+        state.accumulatedY += y;
+        return std::fabs(state.accumulatedX) >= params.threshold ||
+               std::fabs(state.accumulatedY) >= params.threshold;
+    }
+};
+
+/**
+ * @brief Emit stage clamping each axis to the speed cap
+ */
+struct CappedEmit {
+    static double Limit(const ScrollStageParams& params, double value) {
+        return std::min(std::max(value, -params.cap), params.cap);
+    }
+};
+
+struct UncappedEmit {
+    static double Limit(const ScrollStageParams&, double value) {
+        return value;
+    }
+};
+
+struct RuntimeEmit {
+    static double Limit(const ScrollStageParams& params, double value) {
+        return params.cap > 0.0 ? CappedEmit::Limit(params, value) : value;
+    }
+};
+
+/**
+ * @brief Run one movement sample through the scroll stages
+ */
+template <typename Accelerate, typename Emit>
+inline ScrollOutput ProcessScrollStages(ScrollStageState& state, const ScrollStageParams& params,
+                                        uint64_t timestampNs, int deltaX, int deltaY) {
+    ScrollOutput output;
+    double factor = Accelerate::Factor(params, state, timestampNs, deltaX, deltaY);
+    if (!ThresholdAccumulate::Add(params, state, FoldedDirection::X(params, deltaX, factor),
+                                  FoldedDirection::Y(params, deltaY, factor))) {
+        return output;
+    }
+
+    output.emit = true;
+    output.deltaX = Emit::Limit(params, state.accumulatedX);
+    output.deltaY = Emit::Limit(params, state.accumulatedY);
+    state.accumulatedX = 0.0;
+    state.accumulatedY = 0.0;
+    state.lastScrollTime = timestampNs;
+    return output;
+}
+
+using ScrollStagesFunction = ScrollOutput (*)(ScrollStageState&, const ScrollStageParams&, uint64_t, int, int);
+
+/**
+ * @brief Instantiation of the scroll stages for the given parameters
+ */
+inline ScrollStagesFunction SelectScrollStages(const ScrollStageParams& params) {
+    bool accelerates = params.acceleration != 0.0;
+    bool capped = params.cap > 0.0;
+    if (accelerates) {
+        return capped ? &ProcessScrollStages<CurveAcceleration, CappedEmit>
+                      : &ProcessScrollStages<CurveAcceleration, UncappedEmit>;
+    }
+    return capped ? &ProcessScrollStages<ConstantAcceleration, CappedEmit>
+                  : &ProcessScrollStages<ConstantAcceleration, UncappedEmit>;
+}
+
+} // namespace Domain
+} // namespace TPMiddle
+
+#endif // TPMIDDLE_SCROLL_STAGES_H
@@ -0,0 +1,75 @@
+#include "ScrollSynthesizer.h"
+#include <cmath>
+
+namespace TPMiddle {
+namespace Domain {
+
+ScrollSynthesizer::ScrollSynthesizer(double frameRate)
+    : m_frameInterval(0) {
+    SetFrameRate(frameRate);
+    Reset();
+}
+
+void ScrollSynthesizer::SetFrameRate(double frameRate) {
+    m_frameInterval = frameRate > 0.0 ? static_cast<uint64_t>(1e9 / frameRate) : 0;
+}
+
+ScrollFrame ScrollSynthesizer::Add(uint64_t timestampNs, double deltaX, double deltaY, uint64_t sourceNs) {
+    if (m_sourceTimestamp == 0) {
+        m_sourceTimestamp = sourceNs;
+    }
+    m_pendingX += deltaX;
+    m_pendingY += deltaY;
+    return Tick(timestampNs);
+}
+
+ScrollFrame ScrollSynthesizer::Tick(uint64_t timestampNs) {
+    if (!HasPending()) {
+        return ScrollFrame();
+    }
+    if (m_hasEmitted && timestampNs < m_lastEmitTime + m_frameInterval) {
+        return ScrollFrame();
+    }
+    return Emit(timestampNs);
+}
+
+ScrollFrame ScrollSynthesizer::Flush(uint64_t timestampNs) {
+    ScrollFrame frame;
+    if (HasPending()) {
+        frame = Emit(timestampNs);
+    }
+    m_pendingX = 0.0;
+    m_pendingY = 0.0;
+    m_sourceTimestamp = 0;
+    return frame;
+}
+
+bool ScrollSynthesizer::HasPending() const {
+    return std::fabs(m_pendingX) >= 1.0 || std::fabs(m_pendingY) >= 1.0;
+}
+
+void ScrollSynthesizer::Reset() {
+    m_lastEmitTime = 0;
+    m_hasEmitted = false;
+    m_pendingX = 0.0;
+    m_pendingY = 0.0;
+    m_sourceTimestamp = 0;
+}
+
+ScrollFrame ScrollSynthesizer::Emit(uint64_t timestampNs) {
+    // Post the whole pixels and keep the fraction (same sign) for later frames
+    ScrollFrame frame;
+    frame.emit = true;
+    frame.deltaX = static_cast<int32_t>(std::trunc(m_pendingX));
+    frame.deltaY = static_cast<int32_t>(std::trunc(m_pendingY));
+    m_pendingX -= frame.deltaX;
+    m_pendingY -= frame.deltaY;
+    frame.sourceTimestamp = m_sourceTimestamp;
+    m_sourceTimestamp = 0;
+    m_lastEmitTime = timestampNs;
+    m_hasEmitted = true;
+    return frame;
+}
+
+} // namespace Domain
+} // namespace TPMiddle
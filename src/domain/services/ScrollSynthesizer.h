@@ -0,0 +1,84 @@
+#ifndef TPMIDDLE_SCROLL_SYNTHESIZER_H
+#define TPMIDDLE_SCROLL_SYNTHESIZER_H
+
+#include <cstdint>
+
+namespace TPMiddle {
+namespace Domain {
+
+/**
+ * @brief Whole-pixel scroll event to post, if any
+ */
+struct ScrollFrame {
+    bool emit = false;
+    int32_t deltaX = 0;
+    int32_t deltaY = 0;
+    uint64_t sourceTimestamp = 0;   // Input time of the oldest scroll in the frame, 0 if none came from input
+};
+
+/**
+ * @brief Frame-paced output stage that turns fractional scroll into pixel events
+ *
+ * Scroll deltas from the ScrollEngine are summed, including the fraction
+ * left over from earlier frames, and at most one event per frame interval
+ * is emitted carrying the whole-pixel part. The remainder carries into the
+ * next frame, so slow movement is not lost to truncation.
+ *
+ * The synthesizer has no clock of its own: every call takes the current
+ * monotonic time in nanoseconds, and callers schedule a wakeup at
+ * GetNextFrameTime() while HasPending() is true.
+ */
+class ScrollSynthesizer {
+public:
+    /**
+     * @param frameRate Maximum events per second; 0 emits on every Add()
+     */
+    explicit ScrollSynthesizer(double frameRate = 60.0);
+
+    void SetFrameRate(double frameRate);
+    uint64_t GetFrameInterval() const { return m_frameInterval; }
+
+    /**
+     * @brief Accumulate scroll and emit if a frame is due
+     * @param sourceNs Timestamp of the input the scroll came from, carried to
+     *        the frame that posts it; 0 for scroll with no input behind it
+     */
+    ScrollFrame Add(uint64_t timestampNs, double deltaX, double deltaY, uint64_t sourceNs = 0);
+
+    /**
+     * @brief Emit accumulated whole pixels if a frame is due
+     */
+    ScrollFrame Tick(uint64_t timestampNs);
+
+    /**
+     * @brief Emit accumulated whole pixels now and drop the fractional remainder
+     */
+    ScrollFrame Flush(uint64_t timestampNs);
+
+    /**
+     * @brief True if at least one whole pixel is waiting for the next frame
+     */
+    bool HasPending() const;
+
+    /**
+     * @brief Earliest time the next frame may be emitted
+     */
+    uint64_t GetNextFrameTime() const { return m_hasEmitted ? m_lastEmitTime + m_frameInterval : 0; }
+
+    void Reset();
+
+private:
+    uint64_t m_frameInterval;
+    uint64_t m_lastEmitTime;
+    bool m_hasEmitted;
+    double m_pendingX;
+    double m_pendingY;
+    uint64_t m_sourceTimestamp;   // Oldest input behind the next frame
+
+    ScrollFrame Emit(uint64_t timestampNs);
+};
+
+} // namespace Domain
+} // namespace TPMiddle
+
+#endif // TPMIDDLE_SCROLL_SYNTHESIZER_H
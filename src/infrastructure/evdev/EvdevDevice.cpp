@@ -0,0 +1,101 @@
+#include "EvdevDevice.h"
+#include <linux/input.h>
+#include <sys/ioctl.h>
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <ctime>
+#include <dirent.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace TPMiddle {
+namespace Infrastructure {
+
+namespace {
+
+bool TestBit(const uint8_t* bits, int bit) {
+    return (bits[bit / 8] & (1 << (bit % 8))) != 0;
+}
+
+} // namespace
+
+EvdevDevice::EvdevDevice()
+    : m_fd(-1)
+    , m_vendorId(0)
+    , m_productId(0) {
+}
+
+EvdevDevice::~EvdevDevice() {
+    if (m_fd >= 0) {
+        ::close(m_fd);
+    }
+}
+
+std::vector<std::string> EvdevDevice::ListNodes(const std::string& directory) {
+    std::vector<std::string> nodes;
+    DIR* dir = opendir(directory.c_str());
+    if (!dir) {
+        return nodes;
+    }
+    while (struct dirent* entry = readdir(dir)) {
+        if (std::strncmp(entry->d_name, "event", 5) == 0) {
+            nodes.push_back(directory + "/" + entry->d_name);
+        }
+    }
+    closedir(dir);
+    std::sort(nodes.begin(), nodes.end());
+    return nodes;
+}
+
+bool EvdevDevice::Open(const std::string& path, bool grab) {
+    m_fd = ::open(path.c_str(), O_RDONLY | O_NONBLOCK | O_CLOEXEC);
+    if (m_fd < 0) {
+        m_lastError = path + ": " + std::strerror(errno);
+        return false;
+    }
+
+    char name[256] = {};
+    if (ioctl(m_fd, EVIOCGNAME(sizeof(name) - 1), name) >= 0) {
+        m_name = name;
+    }
+    struct input_id id = {};
+    if (ioctl(m_fd, EVIOCGID, &id) >= 0) {
+        m_vendorId = id.vendor;
+        m_productId = id.product;
+    }
+
+    // Match the time base of the loop's clock and the pipeline's deadlines
+    int clockId = CLOCK_MONOTONIC;
+    if (ioctl(m_fd, EVIOCSCLOCKID, &clockId) < 0) {
+        m_lastError = path + ": cannot select CLOCK_MONOTONIC: " + std::strerror(errno);
+        return false;
+    }
+    if (grab && ioctl(m_fd, EVIOCGRAB, 1) < 0) {
+        m_lastError = path + ": cannot grab: " + std::strerror(errno);
+        return false;
+    }
+    return true;
+}
+
+bool EvdevDevice::IsTrackPoint() const {
+    if (m_fd < 0 || m_name.find("TrackPoint") == std::string::npos) {
+        return false;
+    }
+    uint8_t relative[REL_MAX / 8 + 1] = {};
+    uint8_t keys[KEY_MAX / 8 + 1] = {};
+    if (ioctl(m_fd, EVIOCGBIT(EV_REL, sizeof(relative)), relative) < 0 ||
+        ioctl(m_fd, EVIOCGBIT(EV_KEY, sizeof(keys)), keys) < 0) {
+        return false;
+    }
+    return TestBit(relative, REL_X) && TestBit(relative, REL_Y) && TestBit(keys, BTN_MIDDLE);
+}
+
+int EvdevDevice::Release() {
+    int fd = m_fd;
+    m_fd = -1;
+    return fd;
+}
+
+} // namespace Infrastructure
+} // namespace TPMiddle
@@ -0,0 +1,65 @@
+#ifndef TPMIDDLE_EVDEV_DEVICE_H
+#define TPMIDDLE_EVDEV_DEVICE_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace TPMiddle {
+namespace Infrastructure {
+
+/**
+ * @brief One /dev/input/event* node opened for EvdevInputLoop
+ *
+ * Open() switches the node's timestamps to CLOCK_MONOTONIC and can grab it,
+ * so the system stops seeing its events and TPMiddle re-emits them through
+ * uinput. Linux only.
+ */
+class EvdevDevice {
+public:
+    EvdevDevice();
+    ~EvdevDevice();
+
+    EvdevDevice(const EvdevDevice&) = delete;
+    EvdevDevice& operator=(const EvdevDevice&) = delete;
+
+    /**
+     * @brief Event nodes under a directory, sorted by name
+     */
+    static std::vector<std::string> ListNodes(const std::string& directory = "/dev/input");
+
+    /**
+     * @brief Open a node non-blocking
+     * @param grab Take exclusive access with EVIOCGRAB
+     */
+    bool Open(const std::string& path, bool grab);
+
+    /**
+     * @brief True if the node looks like a TrackPoint: its name says so and it
+     * reports relative X/Y and a middle button
+     */
+    bool IsTrackPoint() const;
+
+    /**
+     * @brief Give up ownership of the descriptor, e.g. to EvdevInputLoop::AddDevice()
+     */
+    int Release();
+
+    int GetFd() const { return m_fd; }
+    const std::string& GetName() const { return m_name; }
+    uint16_t GetVendorId() const { return m_vendorId; }
+    uint16_t GetProductId() const { return m_productId; }
+    const std::string& GetLastError() const { return m_lastError; }
+
+private:
+    int m_fd;
+    std::string m_name;
+    uint16_t m_vendorId;
+    uint16_t m_productId;
+    std::string m_lastError;
+};
+
+} // namespace Infrastructure
+} // namespace TPMiddle
+
+#endif // TPMIDDLE_EVDEV_DEVICE_H
@@ -0,0 +1,61 @@
+#ifndef TPMIDDLE_EVDEV_EVENT_H
+#define TPMIDDLE_EVDEV_EVENT_H
+
+#include "../../utils/MonotonicClock.h"
+#include <sys/time.h>
+#include <cstdint>
+
+namespace TPMiddle {
+namespace Infrastructure {
+
+/**
+ * @brief Wire layout of struct input_event as read from an evdev node and
+ * written to uinput
+ *
+ * Declared here rather than taken from <linux/input.h> so the translation
+ * code and its tests build on every platform; the Linux backend checks the
+ * layout matches the kernel's.
+ */
+struct EvdevWireEvent {
+    struct timeval time;
+    uint16_t type;
+    uint16_t code;
+    int32_t value;
+};
+
+/**
+ * @brief The event types and codes TPMiddle reads or emits, with their
+ * stable values from <linux/input-event-codes.h>
+ */
+namespace Evdev {
+
+constexpr uint16_t kEventSync = 0x00;           // EV_SYN
+constexpr uint16_t kEventKey = 0x01;            // EV_KEY
+constexpr uint16_t kEventRelative = 0x02;       // EV_REL
+
+constexpr uint16_t kSyncReport = 0;             // SYN_REPORT
+constexpr uint16_t kSyncDropped = 3;            // SYN_DROPPED
+
+constexpr uint16_t kButtonLeft = 0x110;         // BTN_LEFT
+constexpr uint16_t kButtonRight = 0x111;        // BTN_RIGHT
+constexpr uint16_t kButtonMiddle = 0x112;       // BTN_MIDDLE
+
+constexpr uint16_t kRelativeX = 0x00;           // REL_X
+constexpr uint16_t kRelativeY = 0x01;           // REL_Y
+constexpr uint16_t kRelativeHWheel = 0x06;      // REL_HWHEEL
+constexpr uint16_t kRelativeWheel = 0x08;       // REL_WHEEL
+constexpr uint16_t kRelativeWheelHiRes = 0x0b;  // REL_WHEEL_HI_RES
+constexpr uint16_t kRelativeHWheelHiRes = 0x0c; // REL_HWHEEL_HI_RES
+
+constexpr int32_t kHiResPerDetent = 120;        // High-resolution wheel units per detent
+
+} // namespace Evdev
+
+inline uint64_t EvdevTimestamp(const EvdevWireEvent& event) {
+    return Utils::MonotonicClock::TimevalToNanoseconds(event.time.tv_sec, event.time.tv_usec);
+}
+
+} // namespace Infrastructure
+} // namespace TPMiddle
+
+#endif // TPMIDDLE_EVDEV_EVENT_H
@@ -0,0 +1,290 @@
+#include "EvdevInputLoop.h"
+#include "../../application/services/TraceRecorder.h"
+#include "../../domain/models/HIDUsage.h"
+#include <linux/input.h>
+#include <sys/epoll.h>
+#include <sys/inotify.h>
+#include <sys/ioctl.h>
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <unistd.h>
+
+namespace TPMiddle {
+namespace Infrastructure {
+
+using Domain::InputEvent;
+using Domain::InputEventType;
+
+static_assert(sizeof(EvdevWireEvent) == sizeof(struct input_event), "EvdevWireEvent must match struct input_event");
+
+namespace {
+
+const uint64_t kMillisecond = 1000000ULL;
+
+InputEvent DeviceEvent(InputEventType type, uint64_t handle, uint64_t timestampNs) {
+    InputEvent event = {};
+    event.type = type;
+    event.device = handle;
+    event.timestamp = timestampNs;
+    return event;
+}
+
+} // namespace
+
+EvdevInputLoop::EvdevInputLoop(Application::InputPipeline& pipeline, UinputWriter& writer, Clock clock)
+    : m_pipeline(pipeline)
+    , m_writer(writer)
+    , m_clock(clock)
+    , m_counters(nullptr)
+    , m_epoll(-1)
+    , m_watch(-1) {
+}
+
+EvdevInputLoop::~EvdevInputLoop() {
+    for (const std::unique_ptr<Device>& device : m_devices) {
+        if (device) {
+            ::close(device->fd);
+        }
+    }
+    if (m_watch >= 0) {
+        ::close(m_watch);
+    }
+    if (m_epoll >= 0) {
+        ::close(m_epoll);
+    }
+}
+
+bool EvdevInputLoop::Initialize() {
+    m_epoll = epoll_create1(EPOLL_CLOEXEC);
+    if (m_epoll < 0) {
+        m_lastError = std::string("epoll_create1: ") + std::strerror(errno);
+        return false;
+    }
+    return true;
+}
+
+bool EvdevInputLoop::AddDevice(int fd, const std::string& path) {
+    uint64_t handle = m_devices.size();
+    struct epoll_event registration = {};
+    registration.events = EPOLLIN;
+    registration.data.u64 = handle;
+    if (m_epoll < 0 || epoll_ctl(m_epoll, EPOLL_CTL_ADD, fd, &registration) != 0) {
+        m_lastError = std::string("epoll_ctl: ") + std::strerror(m_epoll < 0 ? EBADF : errno);
+        ::close(fd);
+        return false;
+    }
+    m_devices.emplace_back(new Device(fd, path, handle));
+
+    InputEvent attached = DeviceEvent(InputEventType::DeviceAttached, handle, m_clock.Now());
+    m_pipeline.Process(attached);
+    return true;
+}
+
+bool EvdevInputLoop::HasDevice(const std::string& path) const {
+    return std::any_of(m_devices.begin(), m_devices.end(), [&path](const std::unique_ptr<Device>& device) {
+        return device && !path.empty() && device->path == path;
+    });
+}
+
+bool EvdevInputLoop::WatchDirectory(const std::string& directory) {
+    if (m_watch >= 0) {
+        m_lastError = "inotify: already watching " + m_watchDirectory;
+        return false;
+    }
+    int watch = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (watch < 0) {
+        m_lastError = std::string("inotify_init1: ") + std::strerror(errno);
+        return false;
+    }
+    if (inotify_add_watch(watch, directory.c_str(), IN_CREATE | IN_ATTRIB | IN_MOVED_TO) < 0) {
+        m_lastError = directory + ": " + std::strerror(errno);
+        ::close(watch);
+        return false;
+    }
+    struct epoll_event registration = {};
+    registration.events = EPOLLIN;
+    registration.data.u64 = kWatchHandle;
+    if (m_epoll < 0 || epoll_ctl(m_epoll, EPOLL_CTL_ADD, watch, &registration) != 0) {
+        m_lastError = std::string("epoll_ctl: ") + std::strerror(m_epoll < 0 ? EBADF : errno);
+        ::close(watch);
+        return false;
+    }
+    m_watch = watch;
+    m_watchDirectory = directory;
+    return true;
+}
+
+std::vector<std::string> EvdevInputLoop::TakeAddedNodes() {
+    std::vector<std::string> nodes;
+    nodes.swap(m_addedNodes);
+    return nodes;
+}
+
+size_t EvdevInputLoop::GetDeviceCount() const {
+    return static_cast<size_t>(std::count_if(m_devices.begin(), m_devices.end(),
+                                             [](const std::unique_ptr<Device>& device) { return device != nullptr; }));
+}
+
+int EvdevInputLoop::GetTimeout(int timeoutMs, uint64_t nowNs) {
+    uint64_t deadline = m_pipeline.GetNextDeadline();
+    if (deadline == UINT64_MAX) {
+        return timeoutMs;
+    }
+    if (deadline <= nowNs) {
+        return 0;
+    }
+    // Round up so the deadline has passed when epoll returns
+    uint64_t waitMs = (deadline - nowNs + kMillisecond - 1) / kMillisecond;
+    if (timeoutMs >= 0 && waitMs > static_cast<uint64_t>(timeoutMs)) {
+        return timeoutMs;
+    }
+    return static_cast<int>(std::min<uint64_t>(waitMs, INT32_MAX));
+}
+
+bool EvdevInputLoop::RunOnce(int timeoutMs) {
+    struct epoll_event ready[kMaxReadyDevices];
+    int count = epoll_wait(m_epoll, ready, kMaxReadyDevices, GetTimeout(timeoutMs, m_clock.Now()));
+    if (count < 0) {
+        if (errno == EINTR) {
+            return true;
+        }
+        m_lastError = std::string("epoll_wait: ") + std::strerror(errno);
+        return false;
+    }
+    ++m_statistics.wakeups;
+    TP_TRACE_SPAN("EvdevInputLoop wakeup");
+    if (m_counters) {
+        m_counters->BeginUpdate();
+    }
+
+    for (int i = 0; i < count; ++i) {
+        uint64_t handle = ready[i].data.u64;
+        if (handle == kWatchHandle) {
+            ReadWatch();
+        } else if (ready[i].events & EPOLLIN) {
+            ReadDevice(handle);
+        } else if (ready[i].events & (EPOLLHUP | EPOLLERR)) {
+            RemoveDevice(handle, m_clock.Now());
+        }
+    }
+
+    uint64_t now = m_clock.Now();
+    if (m_pipeline.GetNextDeadline() <= now) {
+        m_pipeline.Advance(now);
+    }
+    {
+        TP_TRACE_SPAN("UinputWriter::Flush");
+        m_writer.Flush();
+    }
+    if (m_counters) {
+        PublishCounters(now);
+    }
+    return true;
+}
+
+// Pipeline totals are stored whole; per-read counts were added as they came in
+void EvdevInputLoop::PublishCounters(uint64_t nowNs) {
+    const Application::InputPipelineStatistics& pipeline = m_pipeline.GetStatistics();
+    m_counters->Set(LiveCounter::ScrollEvents, pipeline.scrollEvents);
+    m_counters->Set(LiveCounter::MiddleButtonEvents, pipeline.middleButtonEvents);
+    m_counters->Set(LiveCounter::ChordDetections, pipeline.chordDetections);
+    m_counters->EndUpdate(nowNs);
+}
+
+void EvdevInputLoop::ReadDevice(uint64_t handle) {
+    TP_TRACE_SPAN("EvdevInputLoop::ReadDevice");
+    if (handle >= m_devices.size() || !m_devices[handle]) {
+        return;
+    }
+    Device& device = *m_devices[handle];
+
+    // evdev only returns whole events; keep reading while the buffer fills up
+    for (;;) {
+        ssize_t bytes = ::read(device.fd, m_wire, sizeof(m_wire));
+        if (bytes < 0) {
+            if (errno != EAGAIN && errno != EINTR) {
+                RemoveDevice(handle, m_clock.Now());
+            }
+            return;
+        }
+        if (bytes == 0) {
+            RemoveDevice(handle, m_clock.Now());
+            return;
+        }
+        ++m_statistics.reads;
+
+        size_t events = static_cast<size_t>(bytes) / sizeof(EvdevWireEvent);
+        uint64_t dropped = device.assembler.GetStatistics().droppedFrames;
+        size_t samples = device.assembler.Assemble(m_wire, events, m_samples);
+        m_statistics.events += events;
+        m_statistics.samples += samples;
+        if (device.assembler.GetStatistics().droppedFrames != dropped) {
+            uint64_t lost = device.assembler.GetStatistics().droppedFrames - dropped;
+            m_statistics.droppedFrames += lost;
+            if (m_counters) {
+                m_counters->Add(LiveCounter::EventsDropped, lost);
+            }
+            ResyncButtons(device);
+        }
+        if (m_counters && samples > 0) {
+            m_counters->Add(LiveCounter::EventsProcessed, samples);
+            m_counters->AddDeviceReports(handle, samples);
+        }
+        if (samples > 0) {
+            m_pipeline.Process(m_samples, samples);
+        }
+        if (events < kReadBatch) {
+            return;
+        }
+    }
+}
+
+void EvdevInputLoop::ReadWatch() {
+    alignas(struct inotify_event) char buffer[4096];
+    for (;;) {
+        ssize_t bytes = ::read(m_watch, buffer, sizeof(buffer));
+        if (bytes <= 0) {
+            return;
+        }
+        for (ssize_t offset = 0; offset < bytes;) {
+            const struct inotify_event* event = reinterpret_cast<const struct inotify_event*>(buffer + offset);
+            offset += static_cast<ssize_t>(sizeof(struct inotify_event) + event->len);
+            if (event->len == 0 || std::strncmp(event->name, "event", 5) != 0) {
+                continue;
+            }
+            std::string path = m_watchDirectory + "/" + event->name;
+            if (std::find(m_addedNodes.begin(), m_addedNodes.end(), path) == m_addedNodes.end()) {
+                m_addedNodes.push_back(path);
+            }
+        }
+    }
+}
+
+// After SYN_DROPPED the kernel's key state is the only reliable source
+void EvdevInputLoop::ResyncButtons(Device& device) {
+    uint8_t keys[KEY_MAX / 8 + 1] = {};
+    if (ioctl(device.fd, EVIOCGKEY(sizeof(keys)), keys) < 0) {
+        return;
+    }
+    auto isDown = [&keys](int code) { return (keys[code / 8] & (1 << (code % 8))) != 0; };
+    device.assembler.SetButtons((isDown(BTN_LEFT) ? Domain::kButtonMaskLeft : 0) |
+                                (isDown(BTN_RIGHT) ? Domain::kButtonMaskRight : 0) |
+                                (isDown(BTN_MIDDLE) ? Domain::kButtonMaskMiddle : 0));
+}
+
+void EvdevInputLoop::RemoveDevice(uint64_t handle, uint64_t timestampNs) {
+    if (handle >= m_devices.size() || !m_devices[handle]) {
+        return;
+    }
+    epoll_ctl(m_epoll, EPOLL_CTL_DEL, m_devices[handle]->fd, nullptr);
+    ::close(m_devices[handle]->fd);
+    m_devices[handle].reset();
+    ++m_statistics.devicesRemoved;
+
+    InputEvent removed = DeviceEvent(InputEventType::DeviceRemoved, handle, timestampNs);
+    m_pipeline.Process(removed);
+}
+
+} // namespace Infrastructure
+} // namespace TPMiddle
@@ -0,0 +1,145 @@
+#ifndef TPMIDDLE_EVDEV_INPUT_LOOP_H
+#define TPMIDDLE_EVDEV_INPUT_LOOP_H
+
+#include "EvdevReportAssembler.h"
+#include "UinputWriter.h"
+#include "../metrics/LiveCounters.h"
+#include "../../application/services/InputPipeline.h"
+#include "../../utils/MonotonicClock.h"
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace TPMiddle {
+namespace Infrastructure {
+
+/**
+ * @brief Counters for one loop
+ */
+struct EvdevInputLoopStatistics {
+    uint64_t wakeups = 0;
+    uint64_t reads = 0;
+    uint64_t events = 0;            // Raw input_events read
+    uint64_t samples = 0;           // Pointer events handed to the pipeline
+    uint64_t droppedFrames = 0;     // SYN_DROPPED seen across devices
+    uint64_t devicesRemoved = 0;
+};
+
+/**
+ * @brief Single-threaded epoll loop from evdev nodes through an InputPipeline to uinput
+ *
+ * Each wakeup drains every ready device with read()s of up to kReadBatch
+ * input_events, assembles the events into one Pointer sample per
+ * SYN_REPORT and processes them as one batch. The pipeline's own deadlines
+ * (held clicks, momentum, scroll frames) bound the epoll timeout, so they
+ * fire on time with no extra thread. All output of a wakeup leaves in a
+ * single UinputWriter::Flush().
+ *
+ * With WatchDirectory() the same wakeups also notice evdev nodes that
+ * appear, so a replugged device can be opened and added again.
+ *
+ * Event timestamps and the clock must share a time base: the backend sets
+ * CLOCK_MONOTONIC on every device it opens, which is also the default clock.
+ * Linux only.
+ */
+class EvdevInputLoop {
+public:
+    using Clock = Utils::MonotonicClock::Source;
+
+    static constexpr size_t kReadBatch = 256;
+    static constexpr int kMaxReadyDevices = 16;
+    static constexpr uint64_t kWatchHandle = UINT64_MAX;     // epoll tag of the directory watch
+
+    /**
+     * @param clock Monotonic nanoseconds; null uses the system clock (CLOCK_MONOTONIC)
+     */
+    EvdevInputLoop(Application::InputPipeline& pipeline, UinputWriter& writer, Clock clock = nullptr);
+    ~EvdevInputLoop();
+
+    EvdevInputLoop(const EvdevInputLoop&) = delete;
+    EvdevInputLoop& operator=(const EvdevInputLoop&) = delete;
+
+    /**
+     * @brief Create the epoll instance
+     */
+    bool Initialize();
+
+    /**
+     * @brief Watch a non-blocking evdev descriptor; the loop owns and closes it
+     * @param path Node the descriptor was opened from, for HasDevice()
+     * @return bool False if it could not be added, in which case it is closed
+     */
+    bool AddDevice(int fd, const std::string& path = std::string());
+
+    /**
+     * @brief Whether a device opened from path is currently in the loop
+     */
+    bool HasDevice(const std::string& path) const;
+
+    /**
+     * @brief Collect evdev nodes created in, or changing permissions in, directory (inotify)
+     *
+     * udev usually fixes a node's permissions just after creating it, so the
+     * same node can be reported again; a node that could not be opened the
+     * first time is then retried.
+     */
+    bool WatchDirectory(const std::string& directory);
+
+    /**
+     * @brief Nodes reported since the last call, as directory/eventN paths
+     */
+    std::vector<std::string> TakeAddedNodes();
+
+    /**
+     * @brief Wait for input or the next pipeline deadline and process everything ready
+     * @param timeoutMs Longest wait in milliseconds, -1 for no limit
+     * @return bool False if waiting failed
+     */
+    bool RunOnce(int timeoutMs);
+
+    /**
+     * @brief Record every wakeup in live counters; null (the default) records nothing
+     */
+    void SetCounters(LiveCounters* counters) { m_counters = counters; }
+
+    size_t GetDeviceCount() const;
+    const EvdevInputLoopStatistics& GetStatistics() const { return m_statistics; }
+    const std::string& GetLastError() const { return m_lastError; }
+
+private:
+    struct Device {
+        int fd;
+        std::string path;
+        EvdevReportAssembler assembler;
+
+        Device(int fd, const std::string& path, uint64_t handle) : fd(fd), path(path), assembler(handle) {}
+    };
+
+    Application::InputPipeline& m_pipeline;
+    UinputWriter& m_writer;
+    Utils::MonotonicClock m_clock;
+    LiveCounters* m_counters;
+    int m_epoll;
+    int m_watch;                                         // inotify descriptor, -1 when not watching
+    std::string m_watchDirectory;
+    std::vector<std::string> m_addedNodes;
+    std::vector<std::unique_ptr<Device>> m_devices;     // Indexed by handle; null once removed
+    EvdevWireEvent m_wire[kReadBatch];
+    Domain::InputEvent m_samples[kReadBatch];
+    EvdevInputLoopStatistics m_statistics;
+    std::string m_lastError;
+
+    void ReadDevice(uint64_t handle);
+    void ReadWatch();
+    void ResyncButtons(Device& device);
+    void RemoveDevice(uint64_t handle, uint64_t timestampNs);
+    int GetTimeout(int timeoutMs, uint64_t nowNs);
+    void PublishCounters(uint64_t nowNs);
+};
+
+} // namespace Infrastructure
+} // namespace TPMiddle
+
+#endif // TPMIDDLE_EVDEV_INPUT_LOOP_H
@@ -0,0 +1,123 @@
+#include "EvdevReportAssembler.h"
+#include "../../domain/models/HIDUsage.h"
+#include <algorithm>
+#include <limits>
+
+namespace TPMiddle {
+namespace Infrastructure {
+
+using Domain::InputEvent;
+using Domain::InputEventType;
+
+namespace {
+
+template <typename T>
+T Saturate(int32_t value) {
+    int32_t low = std::numeric_limits<T>::min();
+    int32_t high = std::numeric_limits<T>::max();
+    return static_cast<T>(std::min(std::max(value, low), high));
+}
+
+uint16_t ButtonMask(uint16_t code) {
+    switch (code) {
+        case Evdev::kButtonLeft:
+            return Domain::kButtonMaskLeft;
+        case Evdev::kButtonRight:
+            return Domain::kButtonMaskRight;
+        case Evdev::kButtonMiddle:
+            return Domain::kButtonMaskMiddle;
+        default:
+            return 0;
+    }
+}
+
+} // namespace
+
+EvdevReportAssembler::EvdevReportAssembler(uint64_t device)
+    : m_device(device)
+    , m_buttons(0)
+    , m_pendingButtons(0)
+    , m_dropping(false) {
+    ClearFrame();
+}
+
+void EvdevReportAssembler::ClearFrame() {
+    m_pendingButtons = m_buttons;
+    m_deltaX = 0;
+    m_deltaY = 0;
+    m_wheel = 0;
+    m_pan = 0;
+}
+
+size_t EvdevReportAssembler::Assemble(const EvdevWireEvent* events, size_t count, InputEvent* output) {
+    size_t written = 0;
+    m_statistics.events += count;
+
+    for (size_t i = 0; i < count; ++i) {
+        const EvdevWireEvent& event = events[i];
+        if (event.type == Evdev::kEventSync) {
+            if (event.code == Evdev::kSyncDropped) {
+                ++m_statistics.droppedFrames;
+                m_dropping = true;
+                ClearFrame();
+            } else if (event.code == Evdev::kSyncReport) {
+                if (m_dropping) {
+                    m_dropping = false;
+                    ClearFrame();
+                    continue;
+                }
+                if (m_pendingButtons != m_buttons || m_deltaX != 0 || m_deltaY != 0 ||
+                    m_wheel != 0 || m_pan != 0) {
+                    InputEvent& sample = output[written++];
+                    sample = InputEvent();
+                    sample.type = InputEventType::Pointer;
+                    sample.timestamp = EvdevTimestamp(event);
+                    sample.device = m_device;
+                    sample.pointer.deltaX = Saturate<int16_t>(m_deltaX);
+                    sample.pointer.deltaY = Saturate<int16_t>(m_deltaY);
+                    sample.pointer.wheel = Saturate<int8_t>(m_wheel);
+                    sample.pointer.pan = Saturate<int8_t>(m_pan);
+                    sample.pointer.buttons = m_pendingButtons;
+                    ++m_statistics.samples;
+                }
+                m_buttons = m_pendingButtons;
+                ClearFrame();
+            }
+            continue;
+        }
+        if (m_dropping) {
+            continue;
+        }
+
+        if (event.type == Evdev::kEventKey) {
+            uint16_t mask = ButtonMask(event.code);
+            // Value 2 is autorepeat, which does not change the state
+            if (event.value == 1) {
+                m_pendingButtons |= mask;
+            } else if (event.value == 0) {
+                m_pendingButtons &= ~mask;
+            }
+        } else if (event.type == Evdev::kEventRelative) {
+            switch (event.code) {
+                case Evdev::kRelativeX:
+                    m_deltaX += event.value;
+                    break;
+                case Evdev::kRelativeY:
+                    m_deltaY += event.value;
+                    break;
+                case Evdev::kRelativeWheel:
+                    m_wheel += event.value;
+                    break;
+                case Evdev::kRelativeHWheel:
+                    m_pan += event.value;
+                    break;
+                default:
+                    break;
+            }
+        }
+    }
+    return written;
+}
+
+} // namespace Infrastructure
+} // namespace TPMiddle
@@ -0,0 +1,69 @@
+#ifndef TPMIDDLE_EVDEV_REPORT_ASSEMBLER_H
+#define TPMIDDLE_EVDEV_REPORT_ASSEMBLER_H
+
+#include "EvdevEvent.h"
+#include "../../domain/models/InputEvent.h"
+#include <cstddef>
+#include <cstdint>
+
+namespace TPMiddle {
+namespace Infrastructure {
+
+/**
+ * @brief Counters for one assembler
+ */
+struct EvdevAssemblerStatistics {
+    uint64_t events = 0;
+    uint64_t samples = 0;
+    uint64_t droppedFrames = 0;     // SYN_DROPPED seen; the kernel's buffer overflowed
+};
+
+/**
+ * @brief Turns an evdev event stream into Domain::PointerSample events
+ *
+ * Everything between two SYN_REPORTs is one hardware report, so relative
+ * axes are summed and button changes applied, and the frame becomes a single
+ * Pointer event stamped with the SYN_REPORT time. Frames that change
+ * nothing produce no event. After SYN_DROPPED the partial frame and
+ * everything up to the next SYN_REPORT are discarded, as the evdev protocol
+ * requires; button state then continues from the last complete frame until
+ * the caller resynchronizes it with SetButtons().
+ */
+class EvdevReportAssembler {
+public:
+    explicit EvdevReportAssembler(uint64_t device = 0);
+
+    /**
+     * @brief Consume raw events and append one Pointer event per completed frame
+     * @param output Destination with room for at least count events
+     * @return size_t Number of events written to output
+     */
+    size_t Assemble(const EvdevWireEvent* events, size_t count, Domain::InputEvent* output);
+
+    /**
+     * @brief Replace the button state, e.g. from EVIOCGKEY after SYN_DROPPED
+     */
+    void SetButtons(uint16_t buttons) { m_buttons = buttons; m_pendingButtons = buttons; }
+
+    uint16_t GetButtons() const { return m_buttons; }
+    uint64_t GetDevice() const { return m_device; }
+    const EvdevAssemblerStatistics& GetStatistics() const { return m_statistics; }
+
+private:
+    uint64_t m_device;
+    uint16_t m_buttons;             // As of the last complete frame
+    uint16_t m_pendingButtons;
+    int32_t m_deltaX;
+    int32_t m_deltaY;
+    int32_t m_wheel;
+    int32_t m_pan;
+    bool m_dropping;
+    EvdevAssemblerStatistics m_statistics;
+
+    void ClearFrame();
+};
+
+} // namespace Infrastructure
+} // namespace TPMiddle
+
+#endif // TPMIDDLE_EVDEV_REPORT_ASSEMBLER_H
@@ -0,0 +1,73 @@
+#include "UinputDevice.h"
+#include <linux/uinput.h>
+#include <sys/ioctl.h>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace TPMiddle {
+namespace Infrastructure {
+
+UinputDevice::UinputDevice()
+    : m_fd(-1) {
+}
+
+UinputDevice::~UinputDevice() {
+    Destroy();
+}
+
+bool UinputDevice::Create(const std::string& name, const std::string& path) {
+    Destroy();
+    m_fd = ::open(path.c_str(), O_WRONLY | O_NONBLOCK | O_CLOEXEC);
+    if (m_fd < 0) {
+        m_lastError = path + ": " + std::strerror(errno);
+        return false;
+    }
+
+    static const int kButtons[] = {BTN_LEFT, BTN_RIGHT, BTN_MIDDLE};
+    static const int kAxes[] = {REL_X, REL_Y, REL_WHEEL, REL_HWHEEL, REL_WHEEL_HI_RES, REL_HWHEEL_HI_RES};
+
+    if (ioctl(m_fd, UI_SET_EVBIT, EV_KEY) < 0 || ioctl(m_fd, UI_SET_EVBIT, EV_REL) < 0) {
+        return Fail("UI_SET_EVBIT");
+    }
+    for (int button : kButtons) {
+        if (ioctl(m_fd, UI_SET_KEYBIT, button) < 0) {
+            return Fail("UI_SET_KEYBIT");
+        }
+    }
+    for (int axis : kAxes) {
+        if (ioctl(m_fd, UI_SET_RELBIT, axis) < 0) {
+            return Fail("UI_SET_RELBIT");
+        }
+    }
+
+    struct uinput_setup setup = {};
+    setup.id.bustype = BUS_VIRTUAL;
+    std::strncpy(setup.name, name.c_str(), UINPUT_MAX_NAME_SIZE - 1);
+    if (ioctl(m_fd, UI_DEV_SETUP, &setup) < 0) {
+        return Fail("UI_DEV_SETUP");
+    }
+    if (ioctl(m_fd, UI_DEV_CREATE) < 0) {
+        return Fail("UI_DEV_CREATE");
+    }
+    return true;
+}
+
+void UinputDevice::Destroy() {
+    if (m_fd >= 0) {
+        ioctl(m_fd, UI_DEV_DESTROY);
+        ::close(m_fd);
+        m_fd = -1;
+    }
+}
+
+bool UinputDevice::Fail(const char* step) {
+    m_lastError = std::string(step) + ": " + std::strerror(errno);
+    ::close(m_fd);
+    m_fd = -1;
+    return false;
+}
+
+} // namespace Infrastructure
+} // namespace TPMiddle
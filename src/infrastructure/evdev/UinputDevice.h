@@ -0,0 +1,40 @@
+#ifndef TPMIDDLE_UINPUT_DEVICE_H
+#define TPMIDDLE_UINPUT_DEVICE_H
+
+#include <string>
+
+namespace TPMiddle {
+namespace Infrastructure {
+
+/**
+ * @brief Virtual pointer created through /dev/uinput
+ *
+ * Advertises the three buttons, relative X/Y and both wheels in detent and
+ * high-resolution units, which is everything UinputWriter emits. The device
+ * disappears when the object is destroyed. Linux only.
+ */
+class UinputDevice {
+public:
+    UinputDevice();
+    ~UinputDevice();
+
+    UinputDevice(const UinputDevice&) = delete;
+    UinputDevice& operator=(const UinputDevice&) = delete;
+
+    bool Create(const std::string& name, const std::string& path = "/dev/uinput");
+    void Destroy();
+
+    int GetFd() const { return m_fd; }
+    const std::string& GetLastError() const { return m_lastError; }
+
+private:
+    int m_fd;
+    std::string m_lastError;
+
+    bool Fail(const char* step);
+};
+
+} // namespace Infrastructure
+} // namespace TPMiddle
+
+#endif // TPMIDDLE_UINPUT_DEVICE_H
@@ -0,0 +1,119 @@
+#include "UinputWriter.h"
+#include "../../domain/models/HIDUsage.h"
+#include <cerrno>
+#include <cmath>
+#include <cstring>
+#include <unistd.h>
+
+namespace TPMiddle {
+namespace Infrastructure {
+
+UinputWriter::UinputWriter(int fd, double pixelsPerDetent)
+    : m_fd(fd)
+    , m_hiResPerPixel(Evdev::kHiResPerDetent / (pixelsPerDetent > 0.0 ? pixelsPerDetent : 15.0))
+    , m_remainderX(0.0)
+    , m_remainderY(0.0)
+    , m_detentX(0)
+    , m_detentY(0)
+    , m_count(0) {
+}
+
+bool UinputWriter::Flush() {
+    if (m_count == 0) {
+        return true;
+    }
+    size_t bytes = m_count * sizeof(EvdevWireEvent);
+    ssize_t written = ::write(m_fd, m_events, bytes);
+    ++m_statistics.writes;
+    m_count = 0;
+    if (written != static_cast<ssize_t>(bytes)) {
+        ++m_statistics.failedWrites;
+        m_lastError = written < 0 ? std::strerror(errno) : "Short write to uinput device";
+        return false;
+    }
+    return true;
+}
+
+// The largest frame is a scroll with four axes plus its SYN_REPORT
+void UinputWriter::Reserve(size_t events) {
+    if (m_count + events > kCapacity) {
+        Flush();
+    }
+}
+
+void UinputWriter::Append(uint16_t type, uint16_t code, int32_t value) {
+    EvdevWireEvent& event = m_events[m_count++];
+    event.time.tv_sec = 0;          // The kernel stamps uinput events itself
+    event.time.tv_usec = 0;
+    event.type = type;
+    event.code = code;
+    event.value = value;
+}
+
+void UinputWriter::EndFrame() {
+    Append(Evdev::kEventSync, Evdev::kSyncReport, 0);
+    ++m_statistics.frames;
+}
+
+int32_t UinputWriter::TakeWholeUnits(double& remainder, double delta) {
+    remainder += delta * m_hiResPerPixel;
+    double whole = std::trunc(remainder);
+    remainder -= whole;
+    return static_cast<int32_t>(whole);
+}
+
+void UinputWriter::PostMiddleButton(uint64_t, bool isDown) {
+    Reserve(2);
+    Append(Evdev::kEventKey, Evdev::kButtonMiddle, isDown ? 1 : 0);
+    EndFrame();
+}
+
+void UinputWriter::PostButton(uint64_t, uint8_t buttonMask, bool isDown) {
+    uint16_t code = buttonMask == Domain::kButtonMaskRight ? Evdev::kButtonRight : Evdev::kButtonLeft;
+    Reserve(2);
+    Append(Evdev::kEventKey, code, isDown ? 1 : 0);
+    EndFrame();
+}
+
+void UinputWriter::PostMotion(uint64_t, int deltaX, int deltaY) {
+    Reserve(3);
+    if (deltaX != 0) {
+        Append(Evdev::kEventRelative, Evdev::kRelativeX, deltaX);
+    }
+    if (deltaY != 0) {
+        Append(Evdev::kEventRelative, Evdev::kRelativeY, deltaY);
+    }
+    EndFrame();
+}
+
+void UinputWriter::PostScroll(uint64_t, double deltaX, double deltaY) {
+    int32_t hiResX = TakeWholeUnits(m_remainderX, -deltaX);
+    int32_t hiResY = TakeWholeUnits(m_remainderY, deltaY);
+    if (hiResX == 0 && hiResY == 0) {
+        return;
+    }
+
+    Reserve(5);
+    if (hiResY != 0) {
+        Append(Evdev::kEventRelative, Evdev::kRelativeWheelHiRes, hiResY);
+        m_detentY += hiResY;
+        int32_t detents = m_detentY / Evdev::kHiResPerDetent;
+        if (detents != 0) {
+            Append(Evdev::kEventRelative, Evdev::kRelativeWheel, detents);
+            m_detentY -= detents * Evdev::kHiResPerDetent;
+        }
+    }
+    if (hiResX != 0) {
+        Append(Evdev::kEventRelative, Evdev::kRelativeHWheelHiRes, hiResX);
+        m_detentX += hiResX;
+        int32_t detents = m_detentX / Evdev::kHiResPerDetent;
+        if (detents != 0) {
+            Append(Evdev::kEventRelative, Evdev::kRelativeHWheel, detents);
+            m_detentX -= detents * Evdev::kHiResPerDetent;
+        }
+    }
+    EndFrame();
+}
+
+} // namespace Infrastructure
+} // namespace TPMiddle
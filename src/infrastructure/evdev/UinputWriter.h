@@ -0,0 +1,85 @@
+#ifndef TPMIDDLE_UINPUT_WRITER_H
+#define TPMIDDLE_UINPUT_WRITER_H
+
+#include "EvdevEvent.h"
+#include "../../application/services/InputPipeline.h"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace TPMiddle {
+namespace Infrastructure {
+
+/**
+ * @brief Counters for one writer
+ */
+struct UinputWriterStatistics {
+    uint64_t frames = 0;            // SYN_REPORT-terminated groups queued
+    uint64_t writes = 0;            // write() calls
+    uint64_t failedWrites = 0;
+};
+
+/**
+ * @brief Pipeline output that queues evdev events for a uinput device
+ *
+ * Every Post call appends one SYN_REPORT-terminated frame to a fixed
+ * buffer; nothing reaches the kernel until Flush(), which hands the whole
+ * buffer over in a single write(). The input loop flushes once per wakeup,
+ * so output costs one syscall however many reports the wakeup carried.
+ *
+ * Scroll arrives in the pixels the macOS path posts. It is sent as
+ * high-resolution wheel units (kHiResPerDetent per pixelsPerDetent pixels)
+ * together with the legacy detent axis for clients that only read that.
+ * Horizontal scroll is negated: positive is left on macOS, right on Linux.
+ */
+class UinputWriter : public Application::IPipelineOutput {
+public:
+    static constexpr size_t kCapacity = 512;
+
+    /**
+     * @param fd Open uinput device, or any descriptor in tests
+     * @param pixelsPerDetent Scroll pixels that make one wheel detent
+     */
+    explicit UinputWriter(int fd, double pixelsPerDetent = 15.0);
+
+    UinputWriter(const UinputWriter&) = delete;
+    UinputWriter& operator=(const UinputWriter&) = delete;
+
+    /**
+     * @brief Write every queued event at once
+     * @return bool False if the write failed; the queued events are dropped either way
+     */
+    bool Flush();
+
+    size_t GetPendingCount() const { return m_count; }
+    const UinputWriterStatistics& GetStatistics() const { return m_statistics; }
+    const std::string& GetLastError() const { return m_lastError; }
+
+    // IPipelineOutput
+    void PostMiddleButton(uint64_t timestampNs, bool isDown) override;
+    void PostScroll(uint64_t timestampNs, double deltaX, double deltaY) override;
+    void PostButton(uint64_t timestampNs, uint8_t buttonMask, bool isDown) override;
+    void PostMotion(uint64_t timestampNs, int deltaX, int deltaY) override;
+
+private:
+    int m_fd;
+    double m_hiResPerPixel;
+    double m_remainderX;            // Fractional high-resolution units not yet sent
+    double m_remainderY;
+    int32_t m_detentX;              // High-resolution units not yet sent as a whole detent
+    int32_t m_detentY;
+    size_t m_count;
+    EvdevWireEvent m_events[kCapacity];
+    UinputWriterStatistics m_statistics;
+    std::string m_lastError;
+
+    void Reserve(size_t events);
+    void Append(uint16_t type, uint16_t code, int32_t value);
+    void EndFrame();
+    int32_t TakeWholeUnits(double& remainder, double delta);
+};
+
+} // namespace Infrastructure
+} // namespace TPMiddle
+
+#endif // TPMIDDLE_UINPUT_WRITER_H
@@ -0,0 +1,83 @@
+#include "ElementDispatchTable.h"
+#include "../../domain/models/HIDUsage.h"
+#include <algorithm>
+
+namespace TPMiddle {
+namespace Infrastructure {
+
+using namespace Domain;
+
+namespace {
+
+ElementDispatchSlot SlotFor(const HIDElementInfo& element) {
+    ElementDispatchSlot slot;
+    slot.usagePage = element.usagePage;
+    slot.usage = element.usage;
+    slot.logicalMinimum = element.logicalMinimum;
+    slot.logicalMaximum = element.logicalMaximum;
+
+    if (element.usagePage == HIDUsage::kPageButton && element.usage > 0) {
+        slot.handler = ElementHandler::Button;
+        slot.index = static_cast<uint8_t>(std::min<uint16_t>(element.usage - 1, UINT8_MAX));
+    } else if (element.usagePage == HIDUsage::kPageGenericDesktop) {
+        switch (element.usage) {
+            case HIDUsage::kX:
+                slot.handler = ElementHandler::Axis;
+                slot.index = 0;
+                break;
+            case HIDUsage::kY:
+                slot.handler = ElementHandler::Axis;
+                slot.index = 1;
+                break;
+            case HIDUsage::kWheel:
+                slot.handler = ElementHandler::Wheel;
+                break;
+            default:
+                break;
+        }
+    }
+    return slot;
+}
+
+} // namespace
+
+bool ElementDispatchTable::Build(const HIDElementInfo* elements, size_t count, const HIDElementFilter& filter) {
+    m_slots.clear();
+    m_firstCookie = 0;
+    m_mappedCount = 0;
+
+    bool any = false;
+    for (size_t i = 0; i < count; ++i) {
+        if (filter.Accepts(elements[i].usagePage, elements[i].usage) && SlotFor(elements[i]).handler != ElementHandler::None) {
+            m_firstCookie = any ? std::min(m_firstCookie, elements[i].cookie) : elements[i].cookie;
+            any = true;
+        }
+    }
+    if (!any) {
+        return false;
+    }
+
+    for (size_t i = 0; i < count; ++i) {
+        const HIDElementInfo& element = elements[i];
+        if (element.cookie < m_firstCookie || element.cookie - m_firstCookie >= kMaxCookieSpan ||
+            !filter.Accepts(element.usagePage, element.usage)) {
+            continue;
+        }
+        ElementDispatchSlot slot = SlotFor(element);
+        if (slot.handler == ElementHandler::None) {
+            continue;
+        }
+        uint32_t index = element.cookie - m_firstCookie;
+        if (index >= m_slots.size()) {
+            m_slots.resize(index + 1);
+        }
+        if (m_slots[index].handler == ElementHandler::None) {
+            ++m_mappedCount;
+        }
+        m_slots[index] = slot;
+    }
+    return true;
+}
+
+} // namespace Infrastructure
+} // namespace TPMiddle
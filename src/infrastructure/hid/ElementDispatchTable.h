@@ -0,0 +1,98 @@
+#ifndef TPMIDDLE_ELEMENT_DISPATCH_TABLE_H
+#define TPMIDDLE_ELEMENT_DISPATCH_TABLE_H
+
+#include "HIDMatching.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace TPMiddle {
+namespace Infrastructure {
+
+/**
+ * @brief What the input path does with an element's values
+ */
+enum class ElementHandler : uint8_t {
+    None = 0,   // Not consumed; the value is dropped in the callback
+    Button,     // index = button number - 1
+    Axis,       // index 0 = X, 1 = Y
+    Wheel
+};
+
+/**
+ * @brief Static description of one input element, read once at attach
+ */
+struct HIDElementInfo {
+    uint32_t cookie;
+    uint16_t usagePage;
+    uint16_t usage;
+    int32_t logicalMinimum;
+    int32_t logicalMaximum;
+};
+
+/**
+ * @brief Everything the value callback needs about an element
+ */
+struct ElementDispatchSlot {
+    ElementHandler handler = ElementHandler::None;
+    uint8_t index = 0;
+    uint16_t usagePage = 0;
+    uint16_t usage = 0;
+    int32_t logicalMinimum = 0;
+    int32_t logicalMaximum = 0;
+
+    /**
+     * @brief Clamp a value into the element's logical range, when it has one
+     */
+    int32_t Clamp(int64_t value) const {
+        if (logicalMinimum >= logicalMaximum) {
+            return static_cast<int32_t>(value);
+        }
+        return static_cast<int32_t>(value < logicalMinimum ? logicalMinimum
+                                    : value > logicalMaximum ? logicalMaximum : value);
+    }
+};
+
+/**
+ * @brief Element cookie -> dispatch slot, built once per device
+ *
+ * Cookies are small per-device integers, so slots live in a flat array
+ * indexed by cookie minus the lowest mapped cookie. Per-value handling is
+ * one bounds check and one load instead of usage page and usage queries
+ * and a branch chain. Elements the filter rejects, or whose cookie lies
+ * more than kMaxCookieSpan past the lowest mapped one, are unmapped.
+ */
+class ElementDispatchTable {
+public:
+    static constexpr uint32_t kMaxCookieSpan = 1024;
+
+    /**
+     * @brief Replace the table with the elements the filter accepts
+     * @return bool True if at least one element was mapped
+     */
+    bool Build(const HIDElementInfo* elements, size_t count, const HIDElementFilter& filter);
+
+    /**
+     * @brief Slot for a cookie, nullptr if its values are not consumed
+     */
+    const ElementDispatchSlot* Find(uint32_t cookie) const {
+        uint32_t index = cookie - m_firstCookie;
+        if (index >= m_slots.size() || m_slots[index].handler == ElementHandler::None) {
+            return nullptr;
+        }
+        return &m_slots[index];
+    }
+
+    size_t GetMappedCount() const { return m_mappedCount; }
+    bool IsEmpty() const { return m_mappedCount == 0; }
+
+private:
+    std::vector<ElementDispatchSlot> m_slots;
+    uint32_t m_firstCookie = 0;
+    size_t m_mappedCount = 0;
+};
+
+} // namespace Infrastructure
+} // namespace TPMiddle
+
+#endif // TPMIDDLE_ELEMENT_DISPATCH_TABLE_H
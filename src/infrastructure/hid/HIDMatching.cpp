@@ -0,0 +1,89 @@
+#include "HIDMatching.h"
+#include "../../domain/models/HIDUsage.h"
+
+namespace TPMiddle {
+namespace Infrastructure {
+
+using namespace Domain;
+
+HIDMatchCriteria HIDMatchCriteria::Usage(uint16_t usagePage, uint16_t usage) {
+    HIDMatchCriteria criteria;
+    criteria.fields = kUsagePage | kUsage;
+    criteria.usagePage = usagePage;
+    criteria.usage = usage;
+    return criteria;
+}
+
+HIDMatchCriteria& HIDMatchCriteria::Vendor(uint32_t vendor) {
+    fields |= kVendor;
+    vendorID = vendor;
+    return *this;
+}
+
+HIDMatchCriteria& HIDMatchCriteria::Product(uint32_t product) {
+    fields |= kProduct;
+    productID = product;
+    return *this;
+}
+
+bool HIDMatchCriteria::Matches(const HIDDeviceProperties& device) const {
+    if (Has(kVendor) && device.vendorID != vendorID) {
+        return false;
+    }
+    if (Has(kProduct) && device.productID != productID) {
+        return false;
+    }
+    if (!Has(kUsagePage) && !Has(kUsage)) {
+        return true;
+    }
+    for (const HIDUsagePair& pair : device.usages) {
+        if ((!Has(kUsagePage) || pair.usagePage == usagePage) && (!Has(kUsage) || pair.usage == usage)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void HIDDeviceMatcher::Add(const HIDMatchCriteria& criteria) {
+    for (const HIDMatchCriteria& existing : m_criteria) {
+        if (existing.fields == criteria.fields && existing.vendorID == criteria.vendorID &&
+            existing.productID == criteria.productID && existing.usagePage == criteria.usagePage &&
+            existing.usage == criteria.usage) {
+            return;
+        }
+    }
+    m_criteria.push_back(criteria);
+}
+
+bool HIDDeviceMatcher::Matches(const HIDDeviceProperties& device) const {
+    for (const HIDMatchCriteria& criteria : m_criteria) {
+        if (criteria.Matches(device)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void HIDElementFilter::Add(uint16_t usagePage, uint16_t usageMin, uint16_t usageMax) {
+    m_ranges.push_back({usagePage, usageMin, usageMax});
+}
+
+bool HIDElementFilter::Accepts(uint16_t usagePage, uint16_t usage) const {
+    for (const HIDElementRange& range : m_ranges) {
+        if (range.usagePage == usagePage && usage >= range.usageMin && usage <= range.usageMax) {
+            return true;
+        }
+    }
+    return false;
+}
+
+HIDElementFilter HIDElementFilter::Pointer() {
+    HIDElementFilter filter;
+    filter.Add(HIDUsage::kPageButton, HIDUsage::kButtonLeft, HIDUsage::kButtonMiddle);
+    filter.Add(HIDUsage::kPageGenericDesktop, HIDUsage::kX, HIDUsage::kY);
+    filter.Add(HIDUsage::kPageGenericDesktop, HIDUsage::kWheel);
+    return filter;
+}
+
+} // namespace Infrastructure
+} // namespace TPMiddle
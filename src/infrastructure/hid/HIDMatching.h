@@ -0,0 +1,115 @@
+#ifndef TPMIDDLE_HID_MATCHING_H
+#define TPMIDDLE_HID_MATCHING_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace TPMiddle {
+namespace Infrastructure {
+
+/**
+ * @brief One usage page and usage a device reports under its usage pairs
+ */
+struct HIDUsagePair {
+    uint16_t usagePage;
+    uint16_t usage;
+};
+
+/**
+ * @brief Device properties the matcher looks at
+ */
+struct HIDDeviceProperties {
+    uint32_t vendorID = 0;
+    uint32_t productID = 0;
+    std::vector<HIDUsagePair> usages;   // Every top-level collection, primary first
+};
+
+/**
+ * @brief One criteria set; every field that is set must match
+ *
+ * Mirrors an IOKit device matching dictionary: usage page and usage match
+ * against any of the device's usage pairs.
+ */
+struct HIDMatchCriteria {
+    enum Field : uint8_t {
+        kVendor = 1 << 0,
+        kProduct = 1 << 1,
+        kUsagePage = 1 << 2,
+        kUsage = 1 << 3
+    };
+
+    uint8_t fields = 0;
+    uint32_t vendorID = 0;
+    uint32_t productID = 0;
+    uint16_t usagePage = 0;
+    uint16_t usage = 0;
+
+    static HIDMatchCriteria Usage(uint16_t usagePage, uint16_t usage);
+    HIDMatchCriteria& Vendor(uint32_t vendor);
+    HIDMatchCriteria& Product(uint32_t product);
+
+    bool Has(Field field) const { return (fields & field) != 0; }
+    bool Matches(const HIDDeviceProperties& device) const;
+};
+
+/**
+ * @brief Accumulated device criteria, applied together
+ *
+ * A device matches when any criteria set matches, the semantics of
+ * IOHIDManagerSetDeviceMatchingMultiple. The platform layer installs the
+ * whole list at once instead of letting each call replace the last.
+ */
+class HIDDeviceMatcher {
+public:
+    void Add(const HIDMatchCriteria& criteria);
+    void Clear() { m_criteria.clear(); }
+
+    /**
+     * @brief True if any criteria set matches; an empty matcher matches nothing
+     */
+    bool Matches(const HIDDeviceProperties& device) const;
+
+    const std::vector<HIDMatchCriteria>& GetCriteria() const { return m_criteria; }
+
+private:
+    std::vector<HIDMatchCriteria> m_criteria;
+};
+
+/**
+ * @brief Inclusive usage range on one usage page
+ */
+struct HIDElementRange {
+    uint16_t usagePage;
+    uint16_t usageMin;
+    uint16_t usageMax;
+};
+
+/**
+ * @brief Input elements allowed to reach the value callback
+ *
+ * Installed per device as input value matching, so elements the pipeline
+ * ignores (keys, consumer controls, vendor pages) never wake the HID thread.
+ */
+class HIDElementFilter {
+public:
+    void Add(uint16_t usagePage, uint16_t usageMin, uint16_t usageMax);
+    void Add(uint16_t usagePage, uint16_t usage) { Add(usagePage, usage, usage); }
+
+    bool Accepts(uint16_t usagePage, uint16_t usage) const;
+
+    const std::vector<HIDElementRange>& GetRanges() const { return m_ranges; }
+
+    /**
+     * @brief Buttons, X/Y, wheel and AC Pan: everything InputProcessor consumes
+     */
+    static HIDElementFilter Pointer();
+
+private:
+    std::vector<HIDElementRange> m_ranges;
+};
+
+} // namespace Infrastructure
+} // namespace TPMiddle
+
+#endif // TPMIDDLE_HID_MATCHING_H
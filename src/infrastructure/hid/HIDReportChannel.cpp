@@ -0,0 +1,119 @@
+#include "HIDReportChannel.h"
+
+namespace TPMiddle {
+namespace Infrastructure {
+
+void ReportRequest::Complete(bool success, size_t length) {
+    m_channel->Finish(*this, success, length);
+}
+
+HIDReportChannel::HIDReportChannel(IHIDReportBackend& backend, size_t bufferCount, size_t bufferSize)
+    : m_backend(backend)
+    , m_pool(bufferCount, bufferSize)
+    , m_requests(bufferCount)
+    , m_inputReports(0)
+    , m_droppedInputReports(0)
+    , m_transfersStarted(0)
+    , m_transfersFailed(0) {
+    for (uint32_t i = 0; i < bufferCount; ++i) {
+        m_requests[i].m_channel = this;
+        m_requests[i].m_bufferIndex = i;
+    }
+}
+
+bool HIDReportChannel::DeliverInputReport(uint8_t reportId, const uint8_t* data, size_t length, uint64_t timestampNs) {
+    PooledReport report = m_pool.Acquire();
+    if (!report.IsValid() || length > report.GetCapacity()) {
+        m_droppedInputReports.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    for (size_t i = 0; i < length; ++i) {
+        report.MutableData()[i] = data[i];
+    }
+    report.SetContents(length, HIDReportType::Input, reportId, timestampNs);
+
+    // The ring's release store publishes the buffer contents to the consumer
+    if (!m_queue.TryPush(report.GetIndex())) {
+        m_droppedInputReports.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    report.Detach();
+    m_inputReports.fetch_add(1, std::memory_order_relaxed);
+    return true;
+}
+
+bool HIDReportChannel::Receive(PooledReport& report) {
+    uint32_t index;
+    if (!m_queue.TryPop(index)) {
+        return false;
+    }
+    report = PooledReport(&m_pool, index);
+    return true;
+}
+
+bool HIDReportChannel::Send(HIDReportType type, uint8_t reportId, PooledReport report,
+                            ReportCallback callback, void* context) {
+    return Submit(ReportRequest::Direction::Set, type, reportId, std::move(report), callback, context);
+}
+
+bool HIDReportChannel::Request(HIDReportType type, uint8_t reportId, ReportCallback callback, void* context) {
+    PooledReport report = m_pool.Acquire();
+    if (!report.IsValid()) {
+        m_transfersFailed.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    return Submit(ReportRequest::Direction::Get, type, reportId, std::move(report), callback, context);
+}
+
+bool HIDReportChannel::Submit(ReportRequest::Direction direction, HIDReportType type, uint8_t reportId,
+                              PooledReport report, ReportCallback callback, void* context) {
+    if (!report.IsValid()) {
+        m_transfersFailed.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    // The request slot belongs to the buffer, so it is free exactly when the buffer was
+    ReportRequest& request = m_requests[report.GetIndex()];
+    request.direction = direction;
+    request.type = type;
+    request.reportId = reportId;
+    request.buffer = report.MutableData();
+    request.length = direction == ReportRequest::Direction::Set ? report.View().size : report.GetCapacity();
+    request.platformLength = static_cast<long>(request.length);
+    request.m_callback = callback;
+    request.m_context = context;
+
+    report.Detach();
+    m_transfersStarted.fetch_add(1, std::memory_order_relaxed);
+    if (!m_backend.SubmitReport(request)) {
+        m_transfersFailed.fetch_add(1, std::memory_order_relaxed);
+        PooledReport(&m_pool, request.m_bufferIndex).Release();
+        return false;
+    }
+    return true;
+}
+
+void HIDReportChannel::Finish(ReportRequest& request, bool success, size_t length) {
+    PooledReport report(&m_pool, request.m_bufferIndex);
+    if (request.direction == ReportRequest::Direction::Get) {
+        report.SetContents(success ? length : 0, request.type, request.reportId);
+    }
+    if (!success) {
+        m_transfersFailed.fetch_add(1, std::memory_order_relaxed);
+    }
+    if (request.m_callback) {
+        request.m_callback(request.m_context, success, report);
+    }
+}
+
+HIDReportChannelStatistics HIDReportChannel::GetStatistics() const {
+    HIDReportChannelStatistics statistics;
+    statistics.inputReports = m_inputReports.load(std::memory_order_relaxed);
+    statistics.droppedInputReports = m_droppedInputReports.load(std::memory_order_relaxed);
+    statistics.transfersStarted = m_transfersStarted.load(std::memory_order_relaxed);
+    statistics.transfersFailed = m_transfersFailed.load(std::memory_order_relaxed);
+    return statistics;
+}
+
+} // namespace Infrastructure
+} // namespace TPMiddle
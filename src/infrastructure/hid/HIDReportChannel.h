@@ -0,0 +1,155 @@
+#ifndef TPMIDDLE_HID_REPORT_CHANNEL_H
+#define TPMIDDLE_HID_REPORT_CHANNEL_H
+
+#include "ReportBufferPool.h"
+#include "../../utils/SPSCRing.h"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace TPMiddle {
+namespace Infrastructure {
+
+class HIDReportChannel;
+
+/**
+ * @brief Called when an asynchronous report transfer finishes
+ * @param report The buffer that was sent or filled; move it out to keep it
+ */
+using ReportCallback = void (*)(void* context, bool success, PooledReport& report);
+
+/**
+ * @brief One in-flight Get or Set transfer handed to an IHIDReportBackend
+ *
+ * Requests live in a per-buffer table inside the channel, so their address
+ * is stable for the platform API's completion context and submitting one
+ * allocates nothing.
+ */
+struct ReportRequest {
+    enum class Direction : uint8_t {
+        Get,
+        Set
+    };
+
+    Direction direction = Direction::Get;
+    HIDReportType type = HIDReportType::Feature;
+    uint8_t reportId = 0;
+    uint8_t* buffer = nullptr;
+    size_t length = 0;              // Bytes to send, or buffer capacity for Get
+    long platformLength = 0;        // Scratch for APIs that take a length pointer (CFIndex)
+
+    /**
+     * @brief Finish the transfer; backends call this exactly once per accepted request
+     * @param length Bytes received for Get; ignored for Set
+     */
+    void Complete(bool success, size_t length);
+
+private:
+    friend class HIDReportChannel;
+
+    HIDReportChannel* m_channel = nullptr;
+    uint32_t m_bufferIndex = 0;
+    ReportCallback m_callback = nullptr;
+    void* m_context = nullptr;
+};
+
+/**
+ * @brief Platform side of HIDReportChannel
+ */
+class IHIDReportBackend {
+public:
+    virtual ~IHIDReportBackend() = default;
+
+    /**
+     * @brief Start an asynchronous transfer
+     * @return bool False if the transfer could not be started; Complete() is then not called
+     */
+    virtual bool SubmitReport(ReportRequest& request) = 0;
+};
+
+/**
+ * @brief Counters for one channel
+ */
+struct HIDReportChannelStatistics {
+    uint64_t inputReports = 0;
+    uint64_t droppedInputReports = 0;     // Pool exhausted or receive queue full
+    uint64_t transfersStarted = 0;
+    uint64_t transfersFailed = 0;
+};
+
+/**
+ * @brief Asynchronous HID report I/O over a per-device buffer pool
+ *
+ * Input reports are copied once, on the I/O thread, into a pooled buffer
+ * and queued to a single consumer, which reads them in place through a
+ * PooledReport and releases the buffer when done. Output and feature
+ * reports go the other way: the caller fills a pooled buffer and Send()
+ * hands it to the backend, or Request() asks the backend to fill one. In
+ * steady state nothing allocates and no lock is taken.
+ *
+ * Threading: DeliverInputReport() and request completions run on the
+ * backend's I/O thread; Receive(), Acquire(), Send() and Request() on the
+ * consumer thread.
+ */
+class HIDReportChannel {
+public:
+    static constexpr size_t kQueueCapacity = 64;
+
+    HIDReportChannel(IHIDReportBackend& backend, size_t bufferCount = 32, size_t bufferSize = 64);
+
+    HIDReportChannel(const HIDReportChannel&) = delete;
+    HIDReportChannel& operator=(const HIDReportChannel&) = delete;
+
+    /**
+     * @brief Copy an input report from the platform buffer into the pool and queue it
+     * @return bool False if the report was dropped
+     */
+    bool DeliverInputReport(uint8_t reportId, const uint8_t* data, size_t length, uint64_t timestampNs);
+
+    /**
+     * @brief Take the oldest queued input report
+     */
+    bool Receive(PooledReport& report);
+
+    /**
+     * @brief Get an empty buffer to fill for Send()
+     */
+    PooledReport Acquire() { return m_pool.Acquire(); }
+
+    /**
+     * @brief Send an output or feature report held in a pooled buffer
+     * @param report Filled buffer; the channel owns it until the callback returns
+     */
+    bool Send(HIDReportType type, uint8_t reportId, PooledReport report,
+              ReportCallback callback = nullptr, void* context = nullptr);
+
+    /**
+     * @brief Read a feature or input report into a pooled buffer
+     */
+    bool Request(HIDReportType type, uint8_t reportId, ReportCallback callback, void* context = nullptr);
+
+    const ReportBufferPool& GetPool() const { return m_pool; }
+    HIDReportChannelStatistics GetStatistics() const;
+
+private:
+    friend struct ReportRequest;
+
+    IHIDReportBackend& m_backend;
+    ReportBufferPool m_pool;
+    std::vector<ReportRequest> m_requests;      // Indexed by buffer
+    Utils::SPSCRing<uint32_t, kQueueCapacity> m_queue;
+    std::atomic<uint64_t> m_inputReports;
+    std::atomic<uint64_t> m_droppedInputReports;
+    std::atomic<uint64_t> m_transfersStarted;
+    std::atomic<uint64_t> m_transfersFailed;
+
+    bool Submit(ReportRequest::Direction direction, HIDReportType type, uint8_t reportId,
+                PooledReport report, ReportCallback callback, void* context);
+    void Finish(ReportRequest& request, bool success, size_t length);
+};
+
+} // namespace Infrastructure
+} // namespace TPMiddle
+
+#endif // TPMIDDLE_HID_REPORT_CHANNEL_H
@@ -0,0 +1,245 @@
+#include "HIDReportDescriptor.h"
+
+namespace TPMiddle {
+namespace Infrastructure {
+
+namespace {
+
+// Item types and tags from the HID 1.11 specification, section 6.2.2
+enum ItemType : uint8_t {
+    kItemMain = 0,
+    kItemGlobal = 1,
+    kItemLocal = 2
+};
+
+enum MainTag : uint8_t {
+    kMainInput = 0x8,
+    kMainOutput = 0x9,
+    kMainCollection = 0xA,
+    kMainFeature = 0xB,
+    kMainEndCollection = 0xC
+};
+
+enum GlobalTag : uint8_t {
+    kGlobalUsagePage = 0x0,
+    kGlobalLogicalMinimum = 0x1,
+    kGlobalLogicalMaximum = 0x2,
+    kGlobalReportSize = 0x7,
+    kGlobalReportId = 0x8,
+    kGlobalReportCount = 0x9,
+    kGlobalPush = 0xA,
+    kGlobalPop = 0xB
+};
+
+enum LocalTag : uint8_t {
+    kLocalUsage = 0x0,
+    kLocalUsageMinimum = 0x1,
+    kLocalUsageMaximum = 0x2
+};
+
+const uint8_t kLongItemPrefix = 0xFE;
+const size_t kMaxUsagesPerItem = 1024;
+const size_t kMaxGlobalStackDepth = 16;
+
+struct GlobalState {
+    uint16_t usagePage = 0;
+    int32_t logicalMinimum = 0;
+    uint32_t logicalMaximumRaw = 0;
+    uint8_t logicalMaximumSize = 0;
+    uint32_t reportSize = 0;
+    uint8_t reportId = 0;
+    uint32_t reportCount = 0;
+};
+
+// Usages are resolved against the usage page in effect at the main item
+// unless they were given as 4-byte extended usages
+struct LocalUsage {
+    uint32_t value;
+    bool extended;
+};
+
+struct LocalState {
+    std::vector<LocalUsage> usages;
+    LocalUsage usageMinimum = {0, false};
+    bool hasUsageMinimum = false;
+};
+
+int32_t SignExtend(uint32_t value, uint8_t size) {
+    switch (size) {
+        case 1: return static_cast<int8_t>(value);
+        case 2: return static_cast<int16_t>(value);
+        default: return static_cast<int32_t>(value);
+    }
+}
+
+uint32_t Resolve(const LocalUsage& usage, uint16_t usagePage) {
+    return usage.extended ? usage.value : (static_cast<uint32_t>(usagePage) << 16) | (usage.value & 0xFFFF);
+}
+
+} // namespace
+
+uint32_t HIDReportField::UsageAt(size_t index) const {
+    if (usages.empty()) {
+        return 0;
+    }
+    return index < usages.size() ? usages[index] : usages.back();
+}
+
+bool HIDReportDescriptor::Fail(const char* message) {
+    m_lastError = message;
+    return false;
+}
+
+bool HIDReportDescriptor::Parse(const uint8_t* data, size_t length) {
+    m_inputFields.clear();
+    for (uint32_t& bits : m_inputBits) {
+        bits = 0;
+    }
+    m_usesReportIds = false;
+    m_lastError.clear();
+
+    GlobalState global;
+    std::vector<GlobalState> globalStack;
+    LocalState local;
+    int collectionDepth = 0;
+
+    size_t position = 0;
+    while (position < length) {
+        uint8_t prefix = data[position++];
+
+        if (prefix == kLongItemPrefix) {
+            // Long items carry no layout information; skip size + tag + data
+            if (position + 2 > length) {
+                return Fail("Truncated long item");
+            }
+            position += 2 + data[position];
+            continue;
+        }
+
+        uint8_t size = prefix & 0x3;
+        if (size == 3) size = 4;
+        uint8_t type = (prefix >> 2) & 0x3;
+        uint8_t tag = prefix >> 4;
+
+        if (position + size > length) {
+            return Fail("Truncated item");
+        }
+        uint32_t value = 0;
+        for (uint8_t i = 0; i < size; ++i) {
+            value |= static_cast<uint32_t>(data[position + i]) << (8 * i);
+        }
+        position += size;
+
+        if (type == kItemMain) {
+            if (tag == kMainInput) {
+                // Bound both factors first so the product cannot wrap past the check
+                if (global.reportSize > 255 || global.reportCount > kMaxReportBits) {
+                    return Fail("Input report too large");
+                }
+                uint32_t bits = global.reportSize * global.reportCount;
+                if (m_inputBits[global.reportId] + bits > kMaxReportBits) {
+                    return Fail("Input report too large");
+                }
+
+                HIDReportField field;
+                field.reportId = global.reportId;
+                field.bitOffset = m_inputBits[global.reportId];
+                field.bitSize = static_cast<uint8_t>(global.reportSize);
+                field.reportCount = static_cast<uint16_t>(global.reportCount);
+                field.logicalMinimum = global.logicalMinimum;
+                int32_t logicalMaximum = SignExtend(global.logicalMaximumRaw, global.logicalMaximumSize);
+                field.logicalMaximum = logicalMaximum < global.logicalMinimum
+                    ? static_cast<int32_t>(global.logicalMaximumRaw) : logicalMaximum;
+                field.flags = value;
+                for (const LocalUsage& usage : local.usages) {
+                    field.usages.push_back(Resolve(usage, global.usagePage));
+                }
+                m_inputFields.push_back(field);
+                m_inputBits[global.reportId] += bits;
+            } else if (tag == kMainCollection) {
+                ++collectionDepth;
+            } else if (tag == kMainEndCollection) {
+                if (--collectionDepth < 0) {
+                    return Fail("Unbalanced End Collection");
+                }
+            }
+            // Output and Feature items describe other report types
+            local = LocalState();
+        } else if (type == kItemGlobal) {
+            switch (tag) {
+                case kGlobalUsagePage:
+                    global.usagePage = static_cast<uint16_t>(value);
+                    break;
+                case kGlobalLogicalMinimum:
+                    global.logicalMinimum = SignExtend(value, size);
+                    break;
+                case kGlobalLogicalMaximum:
+                    global.logicalMaximumRaw = value;
+                    global.logicalMaximumSize = size;
+                    break;
+                case kGlobalReportSize:
+                    global.reportSize = value;
+                    break;
+                case kGlobalReportId:
+                    if (value == 0 || value > 255) {
+                        return Fail("Invalid report ID");
+                    }
+                    global.reportId = static_cast<uint8_t>(value);
+                    m_usesReportIds = true;
+                    break;
+                case kGlobalReportCount:
+                    global.reportCount = value;
+                    break;
+                case kGlobalPush:
+                    if (globalStack.size() >= kMaxGlobalStackDepth) {
+                        return Fail("Global stack overflow");
+                    }
+                    globalStack.push_back(global);
+                    break;
+                case kGlobalPop:
+                    if (globalStack.empty()) {
+                        return Fail("Pop without Push");
+                    }
+                    global = globalStack.back();
+                    globalStack.pop_back();
+                    break;
+                default:
+                    break;
+            }
+        } else if (type == kItemLocal) {
+            LocalUsage usage = {value, size == 4};
+            switch (tag) {
+                case kLocalUsage:
+                    if (local.usages.size() < kMaxUsagesPerItem) {
+                        local.usages.push_back(usage);
+                    }
+                    break;
+                case kLocalUsageMinimum:
+                    local.usageMinimum = usage;
+                    local.hasUsageMinimum = true;
+                    break;
+                case kLocalUsageMaximum:
+                    if (local.hasUsageMinimum) {
+                        uint32_t first = local.usageMinimum.value & 0xFFFF;
+                        uint32_t last = value & 0xFFFF;
+                        uint32_t pageBits = local.usageMinimum.extended ? (local.usageMinimum.value & 0xFFFF0000) : 0;
+                        for (uint32_t id = first; id <= last && local.usages.size() < kMaxUsagesPerItem; ++id) {
+                            local.usages.push_back({pageBits | id, local.usageMinimum.extended});
+                        }
+                        local.hasUsageMinimum = false;
+                    }
+                    break;
+                default:
+                    break;
+            }
+        }
+    }
+
+    if (m_usesReportIds && m_inputBits[0] != 0) {
+        return Fail("Input items without a report ID in a descriptor that uses report IDs");
+    }
+    return true;
+}
+
+} // namespace Infrastructure
+} // namespace TPMiddle
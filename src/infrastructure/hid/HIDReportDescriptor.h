@@ -0,0 +1,80 @@
+#ifndef TPMIDDLE_HID_REPORT_DESCRIPTOR_H
+#define TPMIDDLE_HID_REPORT_DESCRIPTOR_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace TPMiddle {
+namespace Infrastructure {
+
+/**
+ * @brief One Input main item of a report descriptor
+ *
+ * Describes reportCount consecutive values of bitSize bits each, starting
+ * at bitOffset within the report payload (after the report ID byte, if the
+ * device uses report IDs).
+ */
+struct HIDReportField {
+    uint8_t reportId = 0;
+    uint32_t bitOffset = 0;
+    uint8_t bitSize = 0;
+    uint16_t reportCount = 0;
+    int32_t logicalMinimum = 0;
+    int32_t logicalMaximum = 0;
+    uint32_t flags = 0;                 // Main item data bits (constant, variable, relative, ...)
+    std::vector<uint32_t> usages;       // Extended usages (page << 16 | usage), one per value
+
+    bool IsConstant() const { return (flags & 0x01) != 0; }
+    bool IsVariable() const { return (flags & 0x02) != 0; }
+    bool IsRelative() const { return (flags & 0x04) != 0; }
+
+    /**
+     * @brief Extended usage of the value at index; the last usage repeats
+     */
+    uint32_t UsageAt(size_t index) const;
+};
+
+/**
+ * @brief Parser for HID report descriptors
+ *
+ * Walks the short items once and records the layout of every Input item,
+ * tracking global state (including Push/Pop) and per-report-ID bit offsets.
+ * Output and Feature items only advance their own offsets.
+ */
+class HIDReportDescriptor {
+public:
+    static constexpr uint32_t kMaxReportBits = 8 * 1024;
+
+    /**
+     * @brief Parse a raw descriptor, replacing any previous result
+     * @return bool True if the descriptor is well formed
+     */
+    bool Parse(const uint8_t* data, size_t length);
+
+    const std::vector<HIDReportField>& GetInputFields() const { return m_inputFields; }
+    bool UsesReportIds() const { return m_usesReportIds; }
+    const std::string& GetLastError() const { return m_lastError; }
+
+    /**
+     * @brief Size in bits of the input report payload for a report ID
+     */
+    uint32_t GetInputReportBits(uint8_t reportId) const { return m_inputBits[reportId]; }
+
+    static uint16_t UsagePage(uint32_t extendedUsage) { return static_cast<uint16_t>(extendedUsage >> 16); }
+    static uint16_t UsageId(uint32_t extendedUsage) { return static_cast<uint16_t>(extendedUsage & 0xFFFF); }
+
+private:
+    std::vector<HIDReportField> m_inputFields;
+    uint32_t m_inputBits[256] = {};
+    bool m_usesReportIds = false;
+    std::string m_lastError;
+
+    bool Fail(const char* message);
+};
+
+} // namespace Infrastructure
+} // namespace TPMiddle
+
+#endif // TPMIDDLE_HID_REPORT_DESCRIPTOR_H
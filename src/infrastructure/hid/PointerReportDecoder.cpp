@@ -0,0 +1,160 @@
+#include "PointerReportDecoder.h"
+#include "../../domain/models/HIDUsage.h"
+#include <algorithm>
+#include <limits>
+
+namespace TPMiddle {
+namespace Infrastructure {
+
+using Domain::PointerSample;
+namespace HIDUsage = Domain::HIDUsage;
+
+namespace {
+
+constexpr uint32_t Usage(uint16_t page, uint16_t id) {
+    return (static_cast<uint32_t>(page) << 16) | id;
+}
+
+// Little-endian bit extraction; the plan guarantees the bytes are in range
+int32_t Extract(const uint8_t* payload, const ReportBitField& field) {
+    uint32_t firstByte = field.bitOffset / 8;
+    uint32_t lastByte = (field.bitOffset + field.bitSize - 1) / 8;
+    uint64_t raw = 0;
+    for (uint32_t i = firstByte; i <= lastByte; ++i) {
+        raw |= static_cast<uint64_t>(payload[i]) << (8 * (i - firstByte));
+    }
+    raw >>= field.bitOffset % 8;
+
+    uint64_t mask = (field.bitSize >= 32) ? 0xFFFFFFFFULL : ((1ULL << field.bitSize) - 1);
+    uint32_t value = static_cast<uint32_t>(raw & mask);
+    if (field.isSigned && field.bitSize < 32 && (value & (1u << (field.bitSize - 1)))) {
+        value |= ~static_cast<uint32_t>(mask);
+    }
+    return static_cast<int32_t>(value);
+}
+
+template <typename T>
+T Saturate(int32_t value) {
+    int32_t low = std::numeric_limits<T>::min();
+    int32_t high = std::numeric_limits<T>::max();
+    return static_cast<T>(std::min(std::max(value, low), high));
+}
+
+uint32_t EndByte(const ReportBitField& field) {
+    return field.IsPresent() ? (field.bitOffset + field.bitSize + 7) / 8 : 0;
+}
+
+} // namespace
+
+bool PointerReportDecoder::Build(const HIDReportDescriptor& descriptor) {
+    m_plans.clear();
+    m_usesReportIds = descriptor.UsesReportIds();
+
+    for (const HIDReportField& field : descriptor.GetInputFields()) {
+        if (field.IsConstant() || !field.IsVariable() || field.bitSize == 0 || field.bitSize > 32) {
+            continue;
+        }
+
+        auto plan = std::find_if(m_plans.begin(), m_plans.end(),
+                                 [&field](const PointerReportPlan& p) { return p.reportId == field.reportId; });
+        PointerReportPlan candidate;
+        candidate.reportId = field.reportId;
+        PointerReportPlan& target = (plan != m_plans.end()) ? *plan : candidate;
+        bool used = false;
+
+        for (uint16_t i = 0; i < field.reportCount; ++i) {
+            uint32_t usage = field.UsageAt(i);
+            ReportBitField value;
+            value.bitOffset = field.bitOffset + static_cast<uint32_t>(i) * field.bitSize;
+            value.bitSize = field.bitSize;
+            value.isSigned = field.logicalMinimum < 0;
+
+            if (HIDReportDescriptor::UsagePage(usage) == HIDUsage::kPageButton && field.bitSize == 1) {
+                uint16_t button = HIDReportDescriptor::UsageId(usage);
+                if (button == 0 || button > kMaxButtons) {
+                    continue;
+                }
+                // Extend the previous run when buttons are laid out consecutively
+                uint8_t index = static_cast<uint8_t>(button - 1);
+                if (!target.buttons.empty()) {
+                    ReportButtonRange& last = target.buttons.back();
+                    if (last.bitOffset + last.count == value.bitOffset && last.firstButton + last.count == index) {
+                        ++last.count;
+                        used = true;
+                        continue;
+                    }
+                }
+                target.buttons.push_back({value.bitOffset, 1, index});
+                used = true;
+            } else if (!field.IsRelative()) {
+                continue;
+            } else if (usage == Usage(HIDUsage::kPageGenericDesktop, HIDUsage::kX) && !target.x.IsPresent()) {
+                target.x = value;
+                used = true;
+            } else if (usage == Usage(HIDUsage::kPageGenericDesktop, HIDUsage::kY) && !target.y.IsPresent()) {
+                target.y = value;
+                used = true;
+            } else if (usage == Usage(HIDUsage::kPageGenericDesktop, HIDUsage::kWheel) && !target.wheel.IsPresent()) {
+                target.wheel = value;
+                used = true;
+            } else if (usage == Usage(HIDUsage::kPageConsumer, HIDUsage::kACPan) && !target.pan.IsPresent()) {
+                target.pan = value;
+                used = true;
+            }
+        }
+
+        if (used && plan == m_plans.end()) {
+            m_plans.push_back(candidate);
+        }
+    }
+
+    for (PointerReportPlan& plan : m_plans) {
+        uint32_t bytes = std::max({EndByte(plan.x), EndByte(plan.y), EndByte(plan.wheel), EndByte(plan.pan)});
+        for (const ReportButtonRange& range : plan.buttons) {
+            bytes = std::max(bytes, (range.bitOffset + range.count + 7) / 8);
+        }
+        plan.payloadBytes = bytes;
+    }
+    return IsValid();
+}
+
+bool PointerReportDecoder::Decode(const uint8_t* report, size_t length, PointerSample& sample) const {
+    uint8_t reportId = 0;
+    if (m_usesReportIds) {
+        if (length == 0) {
+            return false;
+        }
+        reportId = report[0];
+        ++report;
+        --length;
+    }
+
+    const PointerReportPlan* plan = nullptr;
+    for (const PointerReportPlan& candidate : m_plans) {
+        if (candidate.reportId == reportId) {
+            plan = &candidate;
+            break;
+        }
+    }
+    if (!plan || length < plan->payloadBytes) {
+        return false;
+    }
+
+    sample.deltaX = plan->x.IsPresent() ? Saturate<int16_t>(Extract(report, plan->x)) : 0;
+    sample.deltaY = plan->y.IsPresent() ? Saturate<int16_t>(Extract(report, plan->y)) : 0;
+    sample.wheel = plan->wheel.IsPresent() ? Saturate<int8_t>(Extract(report, plan->wheel)) : 0;
+    sample.pan = plan->pan.IsPresent() ? Saturate<int8_t>(Extract(report, plan->pan)) : 0;
+
+    uint16_t buttons = 0;
+    for (const ReportButtonRange& range : plan->buttons) {
+        ReportBitField bits;
+        bits.bitOffset = range.bitOffset;
+        bits.bitSize = range.count;
+        buttons |= static_cast<uint16_t>(static_cast<uint32_t>(Extract(report, bits)) << range.firstButton);
+    }
+    sample.buttons = buttons;
+    return true;
+}
+
+} // namespace Infrastructure
+} // namespace TPMiddle
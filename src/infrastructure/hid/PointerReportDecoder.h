@@ -0,0 +1,100 @@
+#ifndef TPMIDDLE_POINTER_REPORT_DECODER_H
+#define TPMIDDLE_POINTER_REPORT_DECODER_H
+
+#include "../../domain/models/InputEvent.h"
+#include "HIDReportDescriptor.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace TPMiddle {
+namespace Infrastructure {
+
+/**
+ * @brief Location of one scalar value inside a report payload
+ */
+struct ReportBitField {
+    uint32_t bitOffset = 0;
+    uint8_t bitSize = 0;          // 0 when the report has no such value
+    bool isSigned = false;
+
+    bool IsPresent() const { return bitSize != 0; }
+};
+
+/**
+ * @brief Contiguous run of one-bit button values
+ */
+struct ReportButtonRange {
+    uint32_t bitOffset;
+    uint8_t count;
+    uint8_t firstButton;          // Zero-based index of the first button in the run
+};
+
+/**
+ * @brief Precomputed extraction plan for one pointer input report
+ */
+struct PointerReportPlan {
+    uint8_t reportId = 0;
+    uint32_t payloadBytes = 0;    // Bytes after the report ID that the plan reads
+    ReportBitField x;
+    ReportBitField y;
+    ReportBitField wheel;
+    ReportBitField pan;
+    std::vector<ReportButtonRange> buttons;
+};
+
+/**
+ * @brief Decodes whole pointer input reports into Domain::PointerSample
+ *
+ * Build() turns a parsed report descriptor into one plan per report ID that
+ * carries relative X/Y, wheel, AC Pan or buttons. Decode() then extracts all
+ * values of a report in a single pass with no allocation, so it can run in
+ * the HID callback.
+ */
+class PointerReportDecoder {
+public:
+    static constexpr size_t kMaxButtons = 16;
+
+    /**
+     * @brief Build extraction plans from a parsed descriptor
+     * @return bool True if at least one pointer report was found
+     */
+    bool Build(const HIDReportDescriptor& descriptor);
+
+    /**
+     * @brief Decode a raw input report
+     * @param report Report bytes, starting with the report ID if the device uses them
+     * @param sample Receives the decoded buttons and deltas
+     * @return bool False if the report is unknown or too short
+     */
+    bool Decode(const uint8_t* report, size_t length, Domain::PointerSample& sample) const;
+
+    bool IsValid() const { return !m_plans.empty(); }
+    const std::vector<PointerReportPlan>& GetPlans() const { return m_plans; }
+
+private:
+    std::vector<PointerReportPlan> m_plans;
+    bool m_usesReportIds = false;
+};
+
+/**
+ * @brief Decode stage of Application::StagedPipeline for raw input reports
+ */
+struct PointerReportDecode {
+    struct Input {
+        const PointerReportDecoder* decoder;
+        const uint8_t* report;
+        size_t length;
+        uint64_t timestamp;       // Monotonic nanoseconds
+    };
+
+    static bool Decode(const Input& input, uint64_t& timestampNs, Domain::PointerSample& sample) {
+        timestampNs = input.timestamp;
+        return input.decoder->Decode(input.report, input.length, sample);
+    }
+};
+
+} // namespace Infrastructure
+} // namespace TPMiddle
+
+#endif // TPMIDDLE_POINTER_REPORT_DECODER_H
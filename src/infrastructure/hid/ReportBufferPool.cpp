@@ -0,0 +1,115 @@
+#include "ReportBufferPool.h"
+
+namespace TPMiddle {
+namespace Infrastructure {
+
+PooledReport::PooledReport(PooledReport&& other) noexcept
+    : m_pool(other.m_pool)
+    , m_index(other.m_index) {
+    other.m_pool = nullptr;
+}
+
+PooledReport& PooledReport::operator=(PooledReport&& other) noexcept {
+    if (this != &other) {
+        Release();
+        m_pool = other.m_pool;
+        m_index = other.m_index;
+        other.m_pool = nullptr;
+    }
+    return *this;
+}
+
+ReportView PooledReport::View() const {
+    ReportView view;
+    if (m_pool) {
+        const ReportBufferPool::Metadata& metadata = m_pool->m_metadata[m_index];
+        view.data = m_pool->DataAt(m_index);
+        view.size = metadata.size;
+        view.type = metadata.type;
+        view.reportId = metadata.reportId;
+        view.timestamp = metadata.timestamp;
+    }
+    return view;
+}
+
+uint8_t* PooledReport::MutableData() {
+    return m_pool ? m_pool->DataAt(m_index) : nullptr;
+}
+
+size_t PooledReport::GetCapacity() const {
+    return m_pool ? m_pool->GetBufferSize() : 0;
+}
+
+void PooledReport::SetContents(size_t size, HIDReportType type, uint8_t reportId, uint64_t timestamp) {
+    if (!m_pool) {
+        return;
+    }
+    ReportBufferPool::Metadata& metadata = m_pool->m_metadata[m_index];
+    metadata.size = size < m_pool->GetBufferSize() ? size : m_pool->GetBufferSize();
+    metadata.type = type;
+    metadata.reportId = reportId;
+    metadata.timestamp = timestamp;
+}
+
+void PooledReport::Release() {
+    if (m_pool) {
+        m_pool->Release(m_index);
+        m_pool = nullptr;
+    }
+}
+
+uint32_t PooledReport::Detach() {
+    m_pool = nullptr;
+    return m_index;
+}
+
+ReportBufferPool::ReportBufferPool(size_t bufferCount, size_t bufferSize)
+    : m_bufferCount(bufferCount)
+    , m_bufferSize(bufferSize)
+    , m_stride((bufferSize + kCacheLine - 1) / kCacheLine * kCacheLine)
+    , m_wordCount((bufferCount + 63) / 64)
+    , m_storage(bufferCount * m_stride)
+    , m_metadata(bufferCount, Metadata{0, HIDReportType::Input, 0, 0})
+    , m_freeBits(new std::atomic<uint64_t>[m_wordCount])
+    , m_exhaustedCount(0) {
+    for (size_t word = 0; word < m_wordCount; ++word) {
+        size_t bits = bufferCount - word * 64;
+        m_freeBits[word].store(bits >= 64 ? ~0ULL : ((1ULL << bits) - 1), std::memory_order_relaxed);
+    }
+}
+
+PooledReport ReportBufferPool::Acquire() {
+    for (size_t word = 0; word < m_wordCount; ++word) {
+        uint64_t bits = m_freeBits[word].load(std::memory_order_relaxed);
+        while (bits != 0) {
+            uint64_t lowest = bits & (~bits + 1);
+            if (m_freeBits[word].compare_exchange_weak(bits, bits & ~lowest,
+                                                       std::memory_order_acquire, std::memory_order_relaxed)) {
+                uint32_t index = static_cast<uint32_t>(word * 64 + __builtin_ctzll(lowest));
+                m_metadata[index].size = 0;
+                return PooledReport(this, index);
+            }
+        }
+    }
+    m_exhaustedCount.fetch_add(1, std::memory_order_relaxed);
+    return PooledReport();
+}
+
+void ReportBufferPool::Release(uint32_t index) {
+    m_freeBits[index / 64].fetch_or(1ULL << (index % 64), std::memory_order_release);
+}
+
+size_t ReportBufferPool::GetAvailableCount() const {
+    size_t available = 0;
+    for (size_t word = 0; word < m_wordCount; ++word) {
+        available += static_cast<size_t>(__builtin_popcountll(m_freeBits[word].load(std::memory_order_relaxed)));
+    }
+    return available;
+}
+
+bool ReportBufferPool::Owns(const uint8_t* data) const {
+    return data >= m_storage.data() && data < m_storage.data() + m_storage.size();
+}
+
+} // namespace Infrastructure
+} // namespace TPMiddle
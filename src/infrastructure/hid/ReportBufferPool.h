@@ -0,0 +1,134 @@
+#ifndef TPMIDDLE_REPORT_BUFFER_POOL_H
+#define TPMIDDLE_REPORT_BUFFER_POOL_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace TPMiddle {
+namespace Infrastructure {
+
+/**
+ * @brief Kind of HID report, matching IOHIDReportType
+ */
+enum class HIDReportType : uint8_t {
+    Input = 0,
+    Output = 1,
+    Feature = 2
+};
+
+/**
+ * @brief Read-only view of a report held in a pooled buffer
+ */
+struct ReportView {
+    const uint8_t* data = nullptr;
+    size_t size = 0;
+    HIDReportType type = HIDReportType::Input;
+    uint8_t reportId = 0;
+    uint64_t timestamp = 0;     // Monotonic nanoseconds, input reports only
+};
+
+class ReportBufferPool;
+
+/**
+ * @brief Move-only handle to one pooled buffer; returns it to the pool when destroyed
+ */
+class PooledReport {
+public:
+    PooledReport() : m_pool(nullptr), m_index(0) {}
+    PooledReport(ReportBufferPool* pool, uint32_t index) : m_pool(pool), m_index(index) {}
+    ~PooledReport() { Release(); }
+
+    PooledReport(PooledReport&& other) noexcept;
+    PooledReport& operator=(PooledReport&& other) noexcept;
+    PooledReport(const PooledReport&) = delete;
+    PooledReport& operator=(const PooledReport&) = delete;
+
+    bool IsValid() const { return m_pool != nullptr; }
+    uint32_t GetIndex() const { return m_index; }
+
+    ReportView View() const;
+    uint8_t* MutableData();
+    size_t GetCapacity() const;
+
+    /**
+     * @brief Set the number of valid bytes and the report identity
+     */
+    void SetContents(size_t size, HIDReportType type, uint8_t reportId, uint64_t timestamp = 0);
+
+    /**
+     * @brief Give the buffer back to the pool early
+     */
+    void Release();
+
+    /**
+     * @brief Stop managing the buffer without releasing it
+     */
+    uint32_t Detach();
+
+private:
+    ReportBufferPool* m_pool;
+    uint32_t m_index;
+};
+
+/**
+ * @brief Fixed set of equally sized report buffers, allocated once
+ *
+ * Acquire() and Release() are lock-free and may be called from any thread:
+ * free buffers are tracked in a bitmap of atomic words. Buffers are padded to
+ * a cache line so neighbours filled on different threads do not share one.
+ */
+class ReportBufferPool {
+public:
+    static constexpr size_t kCacheLine = 64;
+
+    ReportBufferPool(size_t bufferCount, size_t bufferSize);
+
+    ReportBufferPool(const ReportBufferPool&) = delete;
+    ReportBufferPool& operator=(const ReportBufferPool&) = delete;
+
+    /**
+     * @brief Take a free buffer
+     * @return PooledReport Invalid if every buffer is in use; counted in GetExhaustedCount()
+     */
+    PooledReport Acquire();
+
+    size_t GetBufferCount() const { return m_bufferCount; }
+    size_t GetBufferSize() const { return m_bufferSize; }
+    size_t GetAvailableCount() const;
+    uint64_t GetExhaustedCount() const { return m_exhaustedCount.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief True if data points into this pool's storage
+     */
+    bool Owns(const uint8_t* data) const;
+
+private:
+    friend class PooledReport;
+
+    struct Metadata {
+        size_t size;
+        HIDReportType type;
+        uint8_t reportId;
+        uint64_t timestamp;
+    };
+
+    size_t m_bufferCount;
+    size_t m_bufferSize;
+    size_t m_stride;
+    size_t m_wordCount;
+    std::vector<uint8_t> m_storage;
+    std::vector<Metadata> m_metadata;
+    std::unique_ptr<std::atomic<uint64_t>[]> m_freeBits;  // Bit set = buffer free
+    std::atomic<uint64_t> m_exhaustedCount;
+
+    uint8_t* DataAt(uint32_t index) { return m_storage.data() + static_cast<size_t>(index) * m_stride; }
+    void Release(uint32_t index);
+};
+
+} // namespace Infrastructure
+} // namespace TPMiddle
+
+#endif // TPMIDDLE_REPORT_BUFFER_POOL_H
@@ -0,0 +1,371 @@
+#include "BinaryLog.h"
+#include "../../utils/MonotonicClock.h"
+#include <chrono>
+#include <cstring>
+#include <ctime>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace TPMiddle {
+namespace Infrastructure {
+
+namespace {
+
+const char kMagic[8] = {'T', 'P', 'B', 'L', 'O', 'G', 0, 0};
+const size_t kRingMask = BinaryLog::kRingCapacity - 1;
+const std::chrono::milliseconds kFlushInterval(20);
+
+static_assert((BinaryLog::kRingCapacity & kRingMask) == 0, "Ring capacity must be a power of two");
+
+inline LogArgument IntArg(int32_t value) {
+    LogArgument arg;
+    arg.i = value;
+    return arg;
+}
+
+inline LogArgument FloatArg(double value) {
+    LogArgument arg;
+    arg.f = static_cast<float>(value);
+    return arg;
+}
+
+const char* PressedString(int32_t value) {
+    return value ? "PRESSED" : "RELEASED";
+}
+
+int64_t WallClockNanoseconds() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+bool IsValidHeader(const BinaryLogFileHeader& header) {
+    return std::memcmp(header.magic, kMagic, sizeof(kMagic)) == 0 &&
+           header.version == BinaryLog::kFormatVersion &&
+           header.recordSize == sizeof(BinaryLogRecord);
+}
+
+} // namespace
+
+BinaryLog::BinaryLog()
+    : m_slots(new Slot[kRingCapacity])
+    , m_enqueuePosition(0)
+    , m_dequeuePosition(0)
+    , m_dropped(0)
+    , m_droppedReported(0)
+    , m_fd(-1)
+    , m_open(false)
+    , m_stopRequested(false) {
+    for (size_t i = 0; i < kRingCapacity; ++i) {
+        m_slots[i].sequence.store(i, std::memory_order_relaxed);
+    }
+}
+
+BinaryLog::~BinaryLog() {
+    Close();
+    delete[] m_slots;
+}
+
+uint64_t BinaryLog::MonotonicNanoseconds() {
+    return Utils::MonotonicClock::SystemNanoseconds();
+}
+
+bool BinaryLog::Open(const std::string& path) {
+    if (IsOpen()) {
+        return true;
+    }
+
+    // Append like the text log, so earlier sessions of the day are kept
+    m_fd = ::open(path.c_str(), O_RDWR | O_CREAT, 0644);
+    if (m_fd < 0) {
+        return false;
+    }
+    struct stat status;
+    if (fstat(m_fd, &status) != 0) {
+        ::close(m_fd);
+        m_fd = -1;
+        return false;
+    }
+
+    uint64_t monotonicNow = MonotonicNanoseconds();
+    int64_t wallNow = WallClockNanoseconds();
+    off_t size = status.st_size;
+    if (size < static_cast<off_t>(sizeof(BinaryLogFileHeader))) {
+        // New file, or one cut short before its header was complete
+        BinaryLogFileHeader header = {};
+        std::memcpy(header.magic, kMagic, sizeof(kMagic));
+        header.version = kFormatVersion;
+        header.recordSize = sizeof(BinaryLogRecord);
+        header.monotonicAtOpen = monotonicNow;
+        header.wallClockAtOpen = wallNow;
+        if (ftruncate(m_fd, 0) != 0 || lseek(m_fd, 0, SEEK_SET) != 0) {
+            ::close(m_fd);
+            m_fd = -1;
+            return false;
+        }
+        WriteAll(&header, sizeof(header));
+    } else {
+        BinaryLogFileHeader header;
+        off_t records = (size - static_cast<off_t>(sizeof(header))) / static_cast<off_t>(sizeof(BinaryLogRecord));
+        off_t end = static_cast<off_t>(sizeof(header)) + records * static_cast<off_t>(sizeof(BinaryLogRecord));
+        if (pread(m_fd, &header, sizeof(header), 0) != static_cast<ssize_t>(sizeof(header)) ||
+            !IsValidHeader(header) || ftruncate(m_fd, end) != 0 || lseek(m_fd, end, SEEK_SET) != end) {
+            ::close(m_fd);
+            m_fd = -1;
+            return false;
+        }
+
+        // The monotonic clock may have restarted since the header was written
+        BinaryLogRecord session = {};
+        session.timestamp = monotonicNow;
+        session.type = static_cast<uint16_t>(LogEventType::SessionStart);
+        session.argCount = 2;
+        session.args[0].i = static_cast<int32_t>(static_cast<uint64_t>(wallNow) & 0xFFFFFFFFu);
+        session.args[1].i = static_cast<int32_t>(static_cast<uint64_t>(wallNow) >> 32);
+        WriteAll(&session, sizeof(session));
+    }
+
+    m_stopRequested.store(false, std::memory_order_release);
+    m_open.store(true, std::memory_order_release);
+    m_flusher = std::thread(&BinaryLog::RunFlusher, this);
+    return true;
+}
+
+void BinaryLog::Close() {
+    if (!IsOpen()) {
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_wakeMutex);
+        m_stopRequested.store(true, std::memory_order_release);
+    }
+    m_wakeCondition.notify_one();
+    if (m_flusher.joinable()) {
+        m_flusher.join();
+    }
+
+    Flush();
+    m_open.store(false, std::memory_order_release);
+    ::close(m_fd);
+    m_fd = -1;
+}
+
+void BinaryLog::LogButtonState(bool leftDown, bool rightDown, bool middleDown) {
+    LogArgument args[3] = {IntArg(leftDown), IntArg(rightDown), IntArg(middleDown)};
+    Append(LogEventType::ButtonState, args, 3);
+}
+
+void BinaryLog::LogTrackpointMovement(int deltaX, int deltaY, uint8_t buttons) {
+    LogArgument args[3] = {IntArg(deltaX), IntArg(deltaY), IntArg(buttons)};
+    Append(LogEventType::TrackpointMovement, args, 3);
+}
+
+void BinaryLog::LogMiddleButtonEmulation(bool isDown, double delayMs) {
+    LogArgument args[2] = {IntArg(isDown), FloatArg(delayMs)};
+    Append(LogEventType::MiddleButtonEmulation, args, 2);
+}
+
+void BinaryLog::LogScrollEvent(double deltaX, double deltaY) {
+    LogArgument args[2] = {FloatArg(deltaX), FloatArg(deltaY)};
+    Append(LogEventType::ScrollEvent, args, 2);
+}
+
+bool BinaryLog::Append(LogEventType type, const LogArgument* args, uint16_t argCount) {
+    if (!m_open.load(std::memory_order_relaxed)) {
+        return false;
+    }
+
+    // Bounded MPSC enqueue: claim a slot whose sequence matches our position
+    uint64_t position = m_enqueuePosition.load(std::memory_order_relaxed);
+    Slot* slot;
+    for (;;) {
+        slot = &m_slots[position & kRingMask];
+        uint64_t sequence = slot->sequence.load(std::memory_order_acquire);
+        int64_t difference = static_cast<int64_t>(sequence) - static_cast<int64_t>(position);
+        if (difference == 0) {
+            if (m_enqueuePosition.compare_exchange_weak(position, position + 1,
+                                                        std::memory_order_relaxed)) {
+                break;
+            }
+        } else if (difference < 0) {
+            m_dropped.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        } else {
+            position = m_enqueuePosition.load(std::memory_order_relaxed);
+        }
+    }
+
+    BinaryLogRecord& record = slot->record;
+    record.timestamp = MonotonicNanoseconds();
+    record.type = static_cast<uint16_t>(type);
+    record.argCount = argCount;
+    record.sequence = static_cast<uint32_t>(position);
+    for (uint16_t i = 0; i < argCount; ++i) {
+        record.args[i] = args[i];
+    }
+    for (uint16_t i = argCount; i < 6; ++i) {
+        record.args[i].i = 0;
+    }
+    slot->sequence.store(position + 1, std::memory_order_release);
+    return true;
+}
+
+void BinaryLog::Flush() {
+    std::lock_guard<std::mutex> lock(m_flushMutex);
+    while (DrainLocked() > 0) {
+    }
+}
+
+size_t BinaryLog::DrainLocked() {
+    if (m_fd < 0) {
+        return 0;
+    }
+
+    BinaryLogRecord page[kRecordsPerPage];
+    size_t count = 0;
+
+    uint64_t dropped = m_dropped.load(std::memory_order_relaxed);
+    if (dropped != m_droppedReported) {
+        BinaryLogRecord& marker = page[count++];
+        std::memset(&marker, 0, sizeof(marker));
+        marker.timestamp = MonotonicNanoseconds();
+        marker.type = static_cast<uint16_t>(LogEventType::RecordsDropped);
+        marker.argCount = 1;
+        marker.args[0].i = static_cast<int32_t>(dropped - m_droppedReported);
+        m_droppedReported = dropped;
+    }
+
+    while (count < kRecordsPerPage) {
+        Slot& slot = m_slots[m_dequeuePosition & kRingMask];
+        uint64_t sequence = slot.sequence.load(std::memory_order_acquire);
+        if (sequence != m_dequeuePosition + 1) {
+            break;
+        }
+        page[count++] = slot.record;
+        slot.sequence.store(m_dequeuePosition + kRingCapacity, std::memory_order_release);
+        ++m_dequeuePosition;
+    }
+
+    if (count > 0) {
+        WriteAll(page, count * sizeof(BinaryLogRecord));
+    }
+    return count;
+}
+
+void BinaryLog::WriteAll(const void* data, size_t length) {
+    const char* bytes = static_cast<const char*>(data);
+    while (length > 0) {
+        ssize_t written = ::write(m_fd, bytes, length);
+        if (written <= 0) {
+            return;
+        }
+        bytes += written;
+        length -= static_cast<size_t>(written);
+    }
+}
+
+void BinaryLog::RunFlusher() {
+    while (!m_stopRequested.load(std::memory_order_acquire)) {
+        {
+            std::unique_lock<std::mutex> lock(m_wakeMutex);
+            m_wakeCondition.wait_for(lock, kFlushInterval, [this] {
+                return m_stopRequested.load(std::memory_order_acquire);
+            });
+        }
+        Flush();
+    }
+}
+
+bool ReadBinaryLogHeader(FILE* file, BinaryLogFileHeader& header) {
+    if (std::fread(&header, sizeof(header), 1, file) != 1) {
+        return false;
+    }
+    return IsValidHeader(header);
+}
+
+void ApplyBinaryLogSession(BinaryLogFileHeader& header, const BinaryLogRecord& record) {
+    if (record.type != static_cast<uint16_t>(LogEventType::SessionStart)) {
+        return;
+    }
+    uint64_t low = static_cast<uint32_t>(record.args[0].i);
+    uint64_t high = static_cast<uint32_t>(record.args[1].i);
+    header.wallClockAtOpen = static_cast<int64_t>((high << 32) | low);
+    header.monotonicAtOpen = record.timestamp;
+}
+
+std::string FormatBinaryLogRecord(const BinaryLogFileHeader& header, const BinaryLogRecord& record) {
+    // Calendar time of the record, matching TPLogger's "yyyy-MM-dd HH:mm:ss.SSS"
+    int64_t wallNs = header.wallClockAtOpen +
+        (static_cast<int64_t>(record.timestamp) - static_cast<int64_t>(header.monotonicAtOpen));
+    time_t seconds = static_cast<time_t>(wallNs / 1000000000LL);
+    int milliseconds = static_cast<int>((wallNs % 1000000000LL) / 1000000LL);
+    struct tm local;
+    localtime_r(&seconds, &local);
+    char timestamp[32];
+    std::strftime(timestamp, sizeof(timestamp), "%Y-%m-%d %H:%M:%S", &local);
+
+    const LogArgument* a = record.args;
+    char message[512];
+    switch (static_cast<LogEventType>(record.type)) {
+        case LogEventType::ButtonState:
+            std::snprintf(message, sizeof(message),
+                          "[Button Event] State Change:\n"
+                          "- Left Button: %s\n"
+                          "- Right Button: %s\n"
+                          "- Middle Button: %s",
+                          PressedString(a[0].i), PressedString(a[1].i), PressedString(a[2].i));
+            break;
+        case LogEventType::TrackpointMovement:
+            std::snprintf(message, sizeof(message),
+                          "[TrackPoint] Movement Detected:\n"
+                          "- Delta X: %d\n"
+                          "- Delta Y: %d\n"
+                          "- Button State: 0x%02X",
+                          a[0].i, a[1].i, static_cast<unsigned>(a[2].i));
+            break;
+        case LogEventType::MiddleButtonEmulation:
+            std::snprintf(message, sizeof(message),
+                          "[Middle Button] Emulation Event:\n"
+                          "- State: %s\n"
+                          "- Delay Setting: %.2f ms",
+                          a[0].i ? "ACTIVATED" : "DEACTIVATED", a[1].f);
+            break;
+        case LogEventType::ScrollEvent:
+            if (record.argCount >= 5) {
+                // Written before the settings moved to the session header
+                std::snprintf(message, sizeof(message),
+                              "[Scroll] Event Generated:\n"
+                              "- Delta X: %.2f\n"
+                              "- Delta Y: %.2f\n"
+                              "- Speed Multiplier: %.2f\n"
+                              "- Acceleration: %.2f\n"
+                              "- Natural Scrolling: %s",
+                              a[0].f, a[1].f, a[2].f, a[3].f, a[4].i ? "ON" : "OFF");
+            } else {
+                std::snprintf(message, sizeof(message),
+                              "[Scroll] Event Generated:\n"
+                              "- Delta X: %.2f\n"
+                              "- Delta Y: %.2f",
+                              a[0].f, a[1].f);
+            }
+            break;
+        case LogEventType::RecordsDropped:
+            std::snprintf(message, sizeof(message),
+                          "[Logger] %d records dropped (log ring full)", a[0].i);
+            break;
+        case LogEventType::SessionStart:
+            std::snprintf(message, sizeof(message), "[Logger] Logging session started");
+            break;
+        default:
+            std::snprintf(message, sizeof(message), "[Unknown] Record type %u", record.type);
+            break;
+    }
+
+    char line[600];
+    std::snprintf(line, sizeof(line), "[%s.%03d] %s\n", timestamp, milliseconds, message);
+    return line;
+}
+
+} // namespace Infrastructure
+} // namespace TPMiddle
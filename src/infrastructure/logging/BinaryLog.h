@@ -0,0 +1,171 @@
+#ifndef TPMIDDLE_BINARY_LOG_H
+#define TPMIDDLE_BINARY_LOG_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <mutex>
+#include <string>
+#include <thread>
+
+namespace TPMiddle {
+namespace Infrastructure {
+
+/**
+ * @brief Event type ids stored in binary log records
+ */
+enum class LogEventType : uint16_t {
+    ButtonState = 1,            // args: left, right, middle
+    TrackpointMovement = 2,     // args: deltaX, deltaY, buttons
+    MiddleButtonEmulation = 3,  // args: isDown, delay (ms, float)
+    ScrollEvent = 4,            // args: deltaX, deltaY (floats); older files add speed multiplier, acceleration, natural
+    RecordsDropped = 5,         // args: number of records lost since the previous marker
+    SessionStart = 6            // args: wall clock at the record's timestamp, ns since epoch (low, high word)
+};
+
+union LogArgument {
+    int32_t i;
+    float f;
+};
+
+/**
+ * @brief Fixed-size binary log record
+ */
+struct BinaryLogRecord {
+    uint64_t timestamp;   // Monotonic nanoseconds
+    uint16_t type;        // LogEventType
+    uint16_t argCount;
+    uint32_t sequence;    // Producer sequence number, gaps indicate drops
+    LogArgument args[6];
+};
+
+static_assert(sizeof(BinaryLogRecord) == 40, "BinaryLogRecord layout is part of the file format");
+
+/**
+ * @brief Header written once at the start of a binary log file
+ *
+ * The monotonic/wall-clock pair lets the decoder turn record timestamps back
+ * into calendar time. Later sessions appended to the same file start with a
+ * SessionStart record that carries a new pair.
+ */
+struct BinaryLogFileHeader {
+    char magic[8];               // "TPBLOG\0\0"
+    uint32_t version;
+    uint32_t recordSize;
+    int64_t wallClockAtOpen;     // Nanoseconds since the Unix epoch
+    uint64_t monotonicAtOpen;    // BinaryLog::MonotonicNanoseconds() at the same instant
+};
+
+/**
+ * @brief Preallocated binary event log with a background flusher
+ *
+ * Producers copy a fixed-size record into a lock-free bounded ring (any number
+ * of producer threads); no formatting, allocation or I/O happens on the
+ * calling thread. A background thread drains the ring and appends records to
+ * the file in page-sized batches. When the ring is full the record is dropped
+ * and counted, and a RecordsDropped marker is written with the next batch.
+ */
+class BinaryLog {
+public:
+    static constexpr uint32_t kFormatVersion = 1;
+    static constexpr size_t kRingCapacity = 8192;
+    static constexpr size_t kRecordsPerPage = 128;
+
+    BinaryLog();
+    ~BinaryLog();
+
+    BinaryLog(const BinaryLog&) = delete;
+    BinaryLog& operator=(const BinaryLog&) = delete;
+
+    /**
+     * @brief Create the log file, or append a new session to it, and start the flusher
+     *
+     * A partial record left at the end by an interrupted session is cut off
+     * before appending. A file that is not a binary log of this version is
+     * left untouched.
+     * @param path Destination file path
+     * @return bool True if the file was opened, false otherwise
+     */
+    bool Open(const std::string& path);
+
+    /**
+     * @brief Flush everything queued, stop the flusher and close the file
+     */
+    void Close();
+
+    bool IsOpen() const { return m_open.load(std::memory_order_acquire); }
+
+    // Hot-path producers
+    void LogButtonState(bool leftDown, bool rightDown, bool middleDown);
+    void LogTrackpointMovement(int deltaX, int deltaY, uint8_t buttons);
+    void LogMiddleButtonEmulation(bool isDown, double delayMs);
+    void LogScrollEvent(double deltaX, double deltaY);
+
+    /**
+     * @brief Write every queued record to disk now (any thread)
+     */
+    void Flush();
+
+    /**
+     * @brief Number of records dropped because the ring was full
+     */
+    uint64_t GetDroppedCount() const { return m_dropped.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Monotonic clock used for record timestamps
+     */
+    static uint64_t MonotonicNanoseconds();
+
+private:
+    struct alignas(64) Slot {
+        std::atomic<uint64_t> sequence;
+        BinaryLogRecord record;
+    };
+
+    Slot* m_slots;
+    alignas(64) std::atomic<uint64_t> m_enqueuePosition;
+    alignas(64) uint64_t m_dequeuePosition;
+    std::atomic<uint64_t> m_dropped;
+    uint64_t m_droppedReported;
+
+    int m_fd;
+    std::atomic<bool> m_open;
+    std::atomic<bool> m_stopRequested;
+    std::thread m_flusher;
+    std::mutex m_flushMutex;   // Serializes draining between the flusher and Flush()
+    std::mutex m_wakeMutex;
+    std::condition_variable m_wakeCondition;
+
+    bool Append(LogEventType type, const LogArgument* args, uint16_t argCount);
+    size_t DrainLocked();
+    void WriteAll(const void* data, size_t length);
+    void RunFlusher();
+};
+
+/**
+ * @brief Read and validate a binary log file header
+ * @return bool True if the header is present and has a supported version
+ */
+bool ReadBinaryLogHeader(FILE* file, BinaryLogFileHeader& header);
+
+/**
+ * @brief Render a record in the same text format TPLogger writes
+ * @param header Header of the file the record came from
+ * @param record The record to render
+ * @return std::string One log entry, terminated by a newline
+ */
+std::string FormatBinaryLogRecord(const BinaryLogFileHeader& header, const BinaryLogRecord& record);
+
+/**
+ * @brief Move the header's clock pair to the session a SessionStart record opens
+ *
+ * Readers call this for every record before formatting it; other record
+ * types leave the header unchanged.
+ */
+void ApplyBinaryLogSession(BinaryLogFileHeader& header, const BinaryLogRecord& record);
+
+} // namespace Infrastructure
+} // namespace TPMiddle
+
+#endif // TPMIDDLE_BINARY_LOG_H
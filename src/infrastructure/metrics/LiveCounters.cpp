@@ -0,0 +1,171 @@
+#include "LiveCounters.h"
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace TPMiddle {
+namespace Infrastructure {
+
+namespace {
+
+const char kMagic[8] = {'T', 'P', 'S', 'T', 'A', 'T', '\0', '\0'};
+const int kReadAttempts = 64;
+
+void InitializeHeader(LiveCountersBlock& block, uint64_t nowNs) {
+    std::memcpy(block.magic, kMagic, sizeof(kMagic));
+    block.version = LiveCounters::kFormatVersion;
+    block.size = sizeof(LiveCountersBlock);
+    block.counterCount = static_cast<uint32_t>(kLiveCounterCount);
+    block.deviceCapacity = static_cast<uint32_t>(LiveCountersBlock::kMaxDevices);
+    block.pid = static_cast<int32_t>(getpid());
+    block.publishedNs = nowNs;
+    block.updatedNs.store(nowNs, std::memory_order_relaxed);
+}
+
+std::string Describe(const char* operation, const std::string& name) {
+    return std::string(operation) + " " + name + ": " + std::strerror(errno);
+}
+
+} // namespace
+
+LiveCounters::LiveCounters()
+    : m_block(nullptr)
+    , m_private(new LiveCountersBlock())
+    , m_sequence(0) {
+    InitializeHeader(*m_private, 0);
+    m_block = m_private;
+}
+
+LiveCounters::~LiveCounters() {
+    Unpublish();
+    delete m_private;
+}
+
+LiveCounters& LiveCounters::Shared() {
+    static LiveCounters counters;
+    return counters;
+}
+
+bool LiveCounters::Publish(const std::string& name, uint64_t nowNs) {
+    Unpublish();
+
+    // A stale segment from a crashed run is replaced, not reused: macOS
+    // refuses ftruncate on a shared memory object that already has a size
+    shm_unlink(name.c_str());
+    int fd = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0644);
+    if (fd < 0) {
+        m_lastError = Describe("shm_open", name);
+        return false;
+    }
+    if (ftruncate(fd, sizeof(LiveCountersBlock)) != 0) {
+        m_lastError = Describe("ftruncate", name);
+        close(fd);
+        shm_unlink(name.c_str());
+        return false;
+    }
+    void* mapping = mmap(nullptr, sizeof(LiveCountersBlock), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (mapping == MAP_FAILED) {
+        m_lastError = Describe("mmap", name);
+        shm_unlink(name.c_str());
+        return false;
+    }
+
+    LiveCountersBlock* block = static_cast<LiveCountersBlock*>(mapping);
+    std::memset(mapping, 0, sizeof(LiveCountersBlock));
+    InitializeHeader(*block, nowNs);
+    m_block = block;
+    m_sequence = 0;
+    m_name = name;
+    return true;
+}
+
+void LiveCounters::Unpublish() {
+    if (m_name.empty()) {
+        return;
+    }
+    munmap(m_block, sizeof(LiveCountersBlock));
+    shm_unlink(m_name.c_str());
+    m_name.clear();
+    m_block = m_private;
+    m_sequence = m_private->sequence.load(std::memory_order_relaxed);
+}
+
+LiveCountersReader::LiveCountersReader() : m_block(nullptr) {
+}
+
+LiveCountersReader::~LiveCountersReader() {
+    Close();
+}
+
+bool LiveCountersReader::Open(const std::string& name) {
+    Close();
+
+    int fd = shm_open(name.c_str(), O_RDONLY, 0);
+    if (fd < 0) {
+        m_lastError = Describe("shm_open", name);
+        return false;
+    }
+    struct stat info;
+    if (fstat(fd, &info) != 0 || static_cast<size_t>(info.st_size) < sizeof(LiveCountersBlock)) {
+        m_lastError = name + ": segment too small";
+        close(fd);
+        return false;
+    }
+    void* mapping = mmap(nullptr, sizeof(LiveCountersBlock), PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (mapping == MAP_FAILED) {
+        m_lastError = Describe("mmap", name);
+        return false;
+    }
+
+    const LiveCountersBlock* block = static_cast<const LiveCountersBlock*>(mapping);
+    if (std::memcmp(block->magic, kMagic, sizeof(kMagic)) != 0 || block->version != LiveCounters::kFormatVersion ||
+        block->size != sizeof(LiveCountersBlock) || block->counterCount > LiveCountersBlock::kCounterSlots) {
+        m_lastError = name + ": not a supported counters block";
+        munmap(mapping, sizeof(LiveCountersBlock));
+        return false;
+    }
+    m_block = block;
+    return true;
+}
+
+void LiveCountersReader::Close() {
+    if (m_block) {
+        munmap(const_cast<LiveCountersBlock*>(m_block), sizeof(LiveCountersBlock));
+        m_block = nullptr;
+    }
+}
+
+bool LiveCountersReader::Read(LiveCountersSnapshot& snapshot) const {
+    if (!m_block) {
+        return false;
+    }
+    for (int attempt = 0; attempt < kReadAttempts; ++attempt) {
+        uint64_t before = m_block->sequence.load(std::memory_order_acquire);
+        if (before & 1) {
+            continue;
+        }
+        snapshot.updatedNs = m_block->updatedNs.load(std::memory_order_relaxed);
+        for (size_t i = 0; i < LiveCountersBlock::kCounterSlots; ++i) {
+            snapshot.counters[i] = m_block->counters[i].load(std::memory_order_relaxed);
+        }
+        for (size_t i = 0; i < LiveCountersBlock::kMaxDevices; ++i) {
+            snapshot.deviceReports[i] = m_block->deviceReports[i].load(std::memory_order_relaxed);
+        }
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (m_block->sequence.load(std::memory_order_relaxed) == before) {
+            snapshot.pid = m_block->pid;
+            snapshot.publishedNs = m_block->publishedNs;
+            snapshot.sequence = before;
+            return true;
+        }
+    }
+    return false;
+}
+
+} // namespace Infrastructure
+} // namespace TPMiddle
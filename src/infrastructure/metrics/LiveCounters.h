@@ -0,0 +1,188 @@
+#ifndef TPMIDDLE_LIVE_COUNTERS_H
+#define TPMIDDLE_LIVE_COUNTERS_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace TPMiddle {
+namespace Infrastructure {
+
+/**
+ * @brief Counters in the live block; append only, the block records how many it has
+ */
+enum class LiveCounter : uint32_t {
+    EventsProcessed = 0,    // Input events handed to processing
+    EventsDropped,          // Events lost to a full queue or a kernel buffer overrun
+    QueueDepth,             // Gauge: events waiting when the last batch finished
+    ScrollEvents,           // Scroll events posted
+    MiddleButtonEvents,     // Middle button presses and releases posted
+    ChordDetections,        // Left+right chords that became a middle press
+    Count
+};
+
+constexpr size_t kLiveCounterCount = static_cast<size_t>(LiveCounter::Count);
+
+/**
+ * @brief Memory layout of the shared counters segment
+ *
+ * Every counter is a lock-free 64-bit atomic, so readers in other
+ * processes never see a torn value. The sequence is a seqlock: odd while
+ * the input thread is between BeginUpdate() and EndUpdate(), so a reader
+ * that sees the same even value before and after copying holds a
+ * consistent snapshot of one batch.
+ */
+struct LiveCountersBlock {
+    static constexpr size_t kCounterSlots = 16;     // Room for counters added later
+    static constexpr size_t kMaxDevices = 16;       // Per-device report counters by compact handle
+
+    char magic[8];                  // "TPSTAT\0\0"
+    uint32_t version;
+    uint32_t size;                  // sizeof(LiveCountersBlock)
+    uint32_t counterCount;          // Counters in use, <= kCounterSlots
+    uint32_t deviceCapacity;
+    int32_t pid;                    // Publishing process
+    uint32_t reserved;
+    uint64_t publishedNs;           // Writer's monotonic clock when the block was published
+    std::atomic<uint64_t> sequence;
+    std::atomic<uint64_t> updatedNs;                // Writer's clock at the last EndUpdate()
+    std::atomic<uint64_t> counters[kCounterSlots];
+    std::atomic<uint64_t> deviceReports[kMaxDevices];
+};
+
+static_assert(std::atomic<uint64_t>::is_always_lock_free, "Shared counters must be address-free atomics");
+
+/**
+ * @brief Consistent copy of a counters block
+ */
+struct LiveCountersSnapshot {
+    int32_t pid = 0;
+    uint64_t publishedNs = 0;
+    uint64_t updatedNs = 0;
+    uint64_t sequence = 0;
+    uint64_t counters[LiveCountersBlock::kCounterSlots] = {};
+    uint64_t deviceReports[LiveCountersBlock::kMaxDevices] = {};
+
+    uint64_t Get(LiveCounter counter) const { return counters[static_cast<size_t>(counter)]; }
+};
+
+/**
+ * @brief Writer side: live counters, optionally published in POSIX shared memory
+ *
+ * Until Publish() succeeds the counters live in a private block, so the
+ * input path can record unconditionally. Recording is a relaxed atomic
+ * add or store and is safe from any thread; the batch bracket
+ * (BeginUpdate()/EndUpdate()) belongs to the input thread alone. Publish()
+ * and Unpublish() must not race with recording, i.e. call them while input
+ * is stopped.
+ */
+class LiveCounters {
+public:
+    static constexpr uint32_t kFormatVersion = 1;
+    static constexpr const char* kDefaultName = "/tpmiddle-stats";
+
+    LiveCounters();
+    ~LiveCounters();
+
+    LiveCounters(const LiveCounters&) = delete;
+    LiveCounters& operator=(const LiveCounters&) = delete;
+
+    /**
+     * @brief Process-wide instance used by the input path
+     */
+    static LiveCounters& Shared();
+
+    /**
+     * @brief Create the named segment and record into it from now on
+     * @param name POSIX shared memory name, starting with '/'
+     * @param nowNs Monotonic time, stored as the start of the rate window
+     * @return bool True if published; see GetLastError() otherwise
+     */
+    bool Publish(const std::string& name, uint64_t nowNs);
+
+    /**
+     * @brief Remove the segment and go back to the private block
+     */
+    void Unpublish();
+
+    bool IsPublished() const { return !m_name.empty(); }
+    const std::string& GetLastError() const { return m_lastError; }
+
+    // Hot path
+    void BeginUpdate() {
+        m_block->sequence.store(m_sequence + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+    }
+
+    void EndUpdate(uint64_t nowNs) {
+        m_block->updatedNs.store(nowNs, std::memory_order_relaxed);
+        m_sequence += 2;
+        m_block->sequence.store(m_sequence, std::memory_order_release);
+    }
+
+    void Add(LiveCounter counter, uint64_t delta = 1) {
+        m_block->counters[static_cast<size_t>(counter)].fetch_add(delta, std::memory_order_relaxed);
+    }
+
+    void Set(LiveCounter counter, uint64_t value) {
+        m_block->counters[static_cast<size_t>(counter)].store(value, std::memory_order_relaxed);
+    }
+
+    void AddDeviceReports(uint64_t handle, uint64_t count = 1) {
+        if (handle < LiveCountersBlock::kMaxDevices) {
+            m_block->deviceReports[handle].fetch_add(count, std::memory_order_relaxed);
+        }
+    }
+
+    /**
+     * @brief Current value, for tests and in-process reporting
+     */
+    uint64_t Get(LiveCounter counter) const {
+        return m_block->counters[static_cast<size_t>(counter)].load(std::memory_order_relaxed);
+    }
+
+private:
+    LiveCountersBlock* m_block;     // m_private or the mapped segment
+    LiveCountersBlock* m_private;
+    uint64_t m_sequence;
+    std::string m_name;
+    std::string m_lastError;
+};
+
+/**
+ * @brief Read-only view of a published counters block, for tpmiddle-stat
+ */
+class LiveCountersReader {
+public:
+    LiveCountersReader();
+    ~LiveCountersReader();
+
+    LiveCountersReader(const LiveCountersReader&) = delete;
+    LiveCountersReader& operator=(const LiveCountersReader&) = delete;
+
+    /**
+     * @brief Map a published segment and validate its header
+     * @return bool True if the block is usable; see GetLastError() otherwise
+     */
+    bool Open(const std::string& name);
+    void Close();
+
+    /**
+     * @brief Copy a consistent snapshot, retrying while the writer is mid-batch
+     * @return bool False if no consistent copy was obtained within a few attempts
+     */
+    bool Read(LiveCountersSnapshot& snapshot) const;
+
+    uint32_t GetCounterCount() const { return m_block ? m_block->counterCount : 0; }
+    const std::string& GetLastError() const { return m_lastError; }
+
+private:
+    const LiveCountersBlock* m_block;
+    std::string m_lastError;
+};
+
+} // namespace Infrastructure
+} // namespace TPMiddle
+
+#endif // TPMIDDLE_LIVE_COUNTERS_H
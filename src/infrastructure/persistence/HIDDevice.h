@@ -2,8 +2,12 @@
 #define TPMIDDLE_HID_DEVICE_H
 
 #include "../../domain/models/Device.h"
+#include "../hid/HIDReportChannel.h"
+#include <atomic>
+#include <memory>
 #include <string>
 #include <mutex>
+#include <vector>
 
 namespace TPMiddle {
 namespace Infrastructure {
@@ -12,11 +16,21 @@ namespace Infrastructure {
  * @brief Concrete implementation of IDevice for HID devices
  * 
  * This class implements the IDevice interface for physical HID devices,
- * providing the actual implementation for device operations.
+ * providing the actual implementation for device operations. Report I/O goes
+ * through GetReportChannel(), which completes asynchronously on the run loop
+ * of the thread that called Open(); SendReport() and ReadReport() remain as
+ * blocking conveniences.
  */
-class HIDDevice : public Domain::IDevice {
+class HIDDevice : public Domain::IDevice, private IHIDReportBackend {
 public:
     HIDDevice(const std::string& id, const std::string& name, const std::string& deviceType);
+
+    /**
+     * @param platformDevice IOHIDDeviceRef to drive, retained for the object's
+     *        lifetime; Open() opens it and schedules it on the calling thread's run loop
+     */
+    HIDDevice(const std::string& id, const std::string& name, const std::string& deviceType,
+              void* platformDevice);
     ~HIDDevice() override;
 
     // IDevice interface implementation
@@ -33,18 +47,30 @@ public:
     bool SendReport(const std::vector<uint8_t>& report);
     bool ReadReport(std::vector<uint8_t>& report);
 
+    /**
+     * @brief Pooled asynchronous report I/O for this device
+     */
+    HIDReportChannel& GetReportChannel() { return *m_reportChannel; }
+
 private:
-    std::string m_id;
-    std::string m_name;
-    std::string m_deviceType;
+    // Identity never changes after construction, so reading it needs no lock
+    const std::string m_id;
+    const std::string m_name;
+    const std::string m_deviceType;
     std::string m_lastError;
-    bool m_connected;
-    void* m_deviceHandle;  // Platform-specific device handle
-    mutable std::mutex m_mutex;
+    std::atomic<bool> m_connected;
+    void* const m_deviceHandle;  // Platform-specific device handle, fixed at construction
+    void* m_runLoop;             // Run loop the device is scheduled on while open
+    mutable std::mutex m_mutex;  // Guards open state against report submission
+    std::unique_ptr<HIDReportChannel> m_reportChannel;
+    std::vector<uint8_t> m_inputReportBuffer;   // Filled by IOKit before each input callback
 
     void SetLastError(const std::string& error);
     bool InitializeDevice();
     void CleanupDevice();
+
+    // IHIDReportBackend
+    bool SubmitReport(ReportRequest& request) override;
 };
 
 } // namespace Infrastructure
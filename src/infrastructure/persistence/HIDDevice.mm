@@ -1,39 +1,81 @@
 #include "HIDDevice.h"
+#include "../../utils/MonotonicClock.h"
 #include <IOKit/hid/IOHIDManager.h>
 #include <iostream>
 
 namespace TPMiddle {
 namespace Infrastructure {
 
+namespace {
+
+const size_t kReportBufferCount = 32;
+const size_t kReportBufferSize = 64;
+const uint32_t kReportTimeoutMs = 1000;
+
+IOHIDReportType ToIOKit(HIDReportType type) {
+    switch (type) {
+        case HIDReportType::Output: return kIOHIDReportTypeOutput;
+        case HIDReportType::Feature: return kIOHIDReportTypeFeature;
+        default: return kIOHIDReportTypeInput;
+    }
+}
+
+// Runs on the device's run loop; the only copy an input report ever takes
+void InputReportCallback(void* context, IOReturn result, void* /*sender*/, IOHIDReportType /*type*/,
+                         uint32_t reportId, uint8_t* report, CFIndex reportLength) {
+    if (result != kIOReturnSuccess || reportLength <= 0) {
+        return;
+    }
+    HIDReportChannel* channel = static_cast<HIDReportChannel*>(context);
+    channel->DeliverInputReport(static_cast<uint8_t>(reportId), report,
+                                static_cast<size_t>(reportLength),
+                                Utils::MonotonicClock::SystemNanoseconds());
+}
+
+void ReportCompletionCallback(void* context, IOReturn result, void* /*sender*/, IOHIDReportType /*type*/,
+                              uint32_t /*reportId*/, uint8_t* /*report*/, CFIndex reportLength) {
+    ReportRequest* request = static_cast<ReportRequest*>(context);
+    request->Complete(result == kIOReturnSuccess, reportLength > 0 ? static_cast<size_t>(reportLength) : 0);
+}
+
+} // namespace
+
 HIDDevice::HIDDevice(const std::string& id, const std::string& name, const std::string& deviceType)
+    : HIDDevice(id, name, deviceType, nullptr) {
+}
+
+HIDDevice::HIDDevice(const std::string& id, const std::string& name, const std::string& deviceType,
+                     void* platformDevice)
     : m_id(id)
     , m_name(name)
     , m_deviceType(deviceType)
     , m_connected(false)
-    , m_deviceHandle(nullptr) {
+    , m_deviceHandle(platformDevice ? const_cast<void*>(CFRetain(platformDevice)) : nullptr)
+    , m_runLoop(nullptr)
+    , m_reportChannel(new HIDReportChannel(*this, kReportBufferCount, kReportBufferSize))
+    , m_inputReportBuffer(kReportBufferSize) {
 }
 
 HIDDevice::~HIDDevice() {
     Close();
+    if (m_deviceHandle) {
+        CFRelease(m_deviceHandle);
+    }
 }
 
 std::string HIDDevice::GetId() const {
-    std::lock_guard<std::mutex> lock(m_mutex);
     return m_id;
 }
 
 std::string HIDDevice::GetName() const {
-    std::lock_guard<std::mutex> lock(m_mutex);
     return m_name;
 }
 
 bool HIDDevice::IsConnected() const {
-    std::lock_guard<std::mutex> lock(m_mutex);
-    return m_connected;
+    return m_connected.load(std::memory_order_acquire);
 }
 
 std::string HIDDevice::GetDeviceType() const {
-    std::lock_guard<std::mutex> lock(m_mutex);
     return m_deviceType;
 }
 
@@ -43,8 +85,9 @@ std::string HIDDevice::GetLastError() const {
 }
 
 bool HIDDevice::Reset() {
-    std::lock_guard<std::mutex> lock(m_mutex);
+    // Close() and Open() take the lock themselves
     if (!m_connected || !m_deviceHandle) {
+        std::lock_guard<std::mutex> lock(m_mutex);
         SetLastError("Device not connected");
         return false;
     }
@@ -156,16 +199,61 @@ bool HIDDevice::InitializeDevice() {
     // For now, just cleanup the manager
     CFRelease(manager);
 
+    if (m_deviceHandle) {
+        IOHIDDeviceRef device = static_cast<IOHIDDeviceRef>(m_deviceHandle);
+        if (IOHIDDeviceOpen(device, kIOHIDOptionsTypeNone) != kIOReturnSuccess) {
+            SetLastError("Failed to open device");
+            return false;
+        }
+
+        // Input reports and async transfer completions arrive on this run loop
+        CFRunLoopRef runLoop = CFRunLoopGetCurrent();
+        m_runLoop = const_cast<void*>(CFRetain(runLoop));
+        IOHIDDeviceScheduleWithRunLoop(device, runLoop, kCFRunLoopDefaultMode);
+        IOHIDDeviceRegisterInputReportCallback(device, m_inputReportBuffer.data(),
+                                               static_cast<CFIndex>(m_inputReportBuffer.size()),
+                                               InputReportCallback, m_reportChannel.get());
+    }
+
     return true;
 }
 
 void HIDDevice::CleanupDevice() {
     if (m_deviceHandle) {
         IOHIDDeviceRef device = static_cast<IOHIDDeviceRef>(m_deviceHandle);
+        IOHIDDeviceRegisterInputReportCallback(device, m_inputReportBuffer.data(),
+                                               static_cast<CFIndex>(m_inputReportBuffer.size()),
+                                               NULL, NULL);
+        if (m_runLoop) {
+            IOHIDDeviceUnscheduleFromRunLoop(device, static_cast<CFRunLoopRef>(m_runLoop), kCFRunLoopDefaultMode);
+            CFRelease(m_runLoop);
+            m_runLoop = nullptr;
+        }
         IOHIDDeviceClose(device, kIOHIDOptionsTypeNone);
-        m_deviceHandle = nullptr;
     }
 }
 
+bool HIDDevice::SubmitReport(ReportRequest& request) {
+    // Close() unschedules the device under the same lock
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (!m_connected || !m_deviceHandle) {
+        return false;
+    }
+
+    // The request outlives the call, so IOKit can write the length back into it
+    IOHIDDeviceRef device = static_cast<IOHIDDeviceRef>(m_deviceHandle);
+    IOReturn result;
+    if (request.direction == ReportRequest::Direction::Set) {
+        result = IOHIDDeviceSetReportWithCallback(device, ToIOKit(request.type), request.reportId,
+                                                  request.buffer, static_cast<CFIndex>(request.length),
+                                                  kReportTimeoutMs, ReportCompletionCallback, &request);
+    } else {
+        result = IOHIDDeviceGetReportWithCallback(device, ToIOKit(request.type), request.reportId,
+                                                  request.buffer, &request.platformLength,
+                                                  kReportTimeoutMs, ReportCompletionCallback, &request);
+    }
+    return result == kIOReturnSuccess;
+}
+
 } // namespace Infrastructure
 } // namespace TPMiddle
@@ -0,0 +1,161 @@
+#include "InMemoryDeviceRepository.h"
+#include <algorithm>
+
+namespace TPMiddle {
+namespace Infrastructure {
+
+using Domain::IDevice;
+
+const DeviceEntry* DeviceSnapshot::FindByKey(uint32_t key) const {
+    if (key >= m_byKey.size() || m_byKey[key] == kNoEntry) {
+        return nullptr;
+    }
+    return &m_entries[m_byKey[key]];
+}
+
+const DeviceEntry* DeviceSnapshot::FindById(std::string_view id) const {
+    auto entry = m_byId.find(id);
+    return entry != m_byId.end() ? &m_entries[entry->second] : nullptr;
+}
+
+void DeviceSnapshot::BuildIndexes() {
+    m_byKey.clear();
+    m_byId.clear();
+    m_byType.clear();
+    for (uint32_t index = 0; index < m_entries.size(); ++index) {
+        const DeviceEntry& entry = m_entries[index];
+        if (entry.GetKey() >= m_byKey.size()) {
+            m_byKey.resize(entry.GetKey() + 1, kNoEntry);
+        }
+        m_byKey[entry.GetKey()] = index;
+        m_byId.emplace(entry.GetId(), index);
+        m_byType[entry.GetDeviceType()].push_back(index);
+    }
+}
+
+DeviceSnapshot::DeviceSnapshot(const DeviceSnapshot& other)
+    : m_version(other.m_version)
+    , m_entries(other.m_entries) {
+    BuildIndexes();
+}
+
+std::optional<std::shared_ptr<IDevice>> InMemoryDeviceRepository::FindById(const std::string& id) {
+    return m_snapshots.Read([&id](const DeviceSnapshot& snapshot) -> std::optional<std::shared_ptr<IDevice>> {
+        const DeviceEntry* entry = snapshot.FindById(id);
+        if (!entry) {
+            return std::nullopt;
+        }
+        return entry->GetDevice();
+    });
+}
+
+std::vector<std::shared_ptr<IDevice>> InMemoryDeviceRepository::GetConnectedDevices() {
+    return m_snapshots.Read([](const DeviceSnapshot& snapshot) {
+        std::vector<std::shared_ptr<IDevice>> devices;
+        for (size_t i = 0; i < snapshot.GetCount(); ++i) {
+            if (snapshot.At(i).IsConnected()) {
+                devices.push_back(snapshot.At(i).GetDevice());
+            }
+        }
+        return devices;
+    });
+}
+
+std::vector<std::shared_ptr<IDevice>> InMemoryDeviceRepository::GetDevicesByType(const std::string& deviceType) {
+    return m_snapshots.Read([&deviceType](const DeviceSnapshot& snapshot) {
+        std::vector<std::shared_ptr<IDevice>> devices;
+        snapshot.ForEachOfType(deviceType, [&devices](const DeviceEntry& entry) {
+            devices.push_back(entry.GetDevice());
+        });
+        return devices;
+    });
+}
+
+bool InMemoryDeviceRepository::Add(std::shared_ptr<IDevice> device) {
+    if (!device) {
+        return false;
+    }
+    std::lock_guard<std::mutex> lock(m_writeMutex);
+    DeviceSnapshot next = CopyCurrent();
+    if (next.FindById(device->GetId())) {
+        return false;
+    }
+
+    next.m_entries.push_back(MakeEntry(m_keys.Acquire(), device));
+    next.BuildIndexes();
+    Publish(std::move(next));
+    return true;
+}
+
+bool InMemoryDeviceRepository::Remove(const std::string& id) {
+    std::lock_guard<std::mutex> lock(m_writeMutex);
+    DeviceSnapshot next = CopyCurrent();
+    const DeviceEntry* existing = next.FindById(id);
+    if (!existing) {
+        return false;
+    }
+    uint32_t key = existing->GetKey();
+
+    next.m_entries.erase(std::find_if(next.m_entries.begin(), next.m_entries.end(),
+                                      [key](const DeviceEntry& entry) { return entry.GetKey() == key; }));
+    next.BuildIndexes();
+    Publish(std::move(next));
+    m_keys.Release(key);
+    return true;
+}
+
+bool InMemoryDeviceRepository::Update(std::shared_ptr<IDevice> device) {
+    if (!device) {
+        return false;
+    }
+    std::lock_guard<std::mutex> lock(m_writeMutex);
+    DeviceSnapshot next = CopyCurrent();
+    const DeviceEntry* existing = next.FindById(device->GetId());
+    if (!existing) {
+        return false;
+    }
+    uint32_t key = existing->GetKey();
+
+    for (DeviceEntry& entry : next.m_entries) {
+        if (entry.GetKey() == key) {
+            entry = MakeEntry(key, device);
+        }
+    }
+    next.BuildIndexes();
+    Publish(std::move(next));
+    return true;
+}
+
+uint32_t InMemoryDeviceRepository::GetKey(const std::string& id) {
+    return m_snapshots.Read([&id](const DeviceSnapshot& snapshot) {
+        const DeviceEntry* entry = snapshot.FindById(id);
+        return entry ? entry->GetKey() : DeviceSnapshot::kNoEntry;
+    });
+}
+
+size_t InMemoryDeviceRepository::GetRetiredCount() {
+    return m_snapshots.GetRetiredCount();
+}
+
+DeviceSnapshot InMemoryDeviceRepository::CopyCurrent() const {
+    return m_snapshots.Read([](const DeviceSnapshot& snapshot) { return DeviceSnapshot(snapshot); });
+}
+
+void InMemoryDeviceRepository::Publish(DeviceSnapshot&& snapshot) {
+    ++snapshot.m_version;
+    m_snapshots.Publish(std::move(snapshot));
+}
+
+DeviceEntry InMemoryDeviceRepository::MakeEntry(uint32_t key, const std::shared_ptr<IDevice>& device) {
+    DeviceEntry entry;
+    entry.m_key = key;
+    entry.m_id = device->GetId();
+    entry.m_name = device->GetName();
+    entry.m_deviceType = device->GetDeviceType();
+    entry.m_connected = device->IsConnected();
+    entry.m_device = device;
+    return entry;
+}
+
+} // namespace Infrastructure
+} // namespace TPMiddle
@@ -0,0 +1,186 @@
+#ifndef TPMIDDLE_IN_MEMORY_DEVICE_REPOSITORY_H
+#define TPMIDDLE_IN_MEMORY_DEVICE_REPOSITORY_H
+
+#include "../../domain/repositories/DeviceRepository.h"
+#include "../../utils/HandleAllocator.h"
+#include "../../utils/SnapshotCell.h"
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace TPMiddle {
+namespace Infrastructure {
+
+/**
+ * @brief Cached, immutable view of one device in a DeviceSnapshot
+ *
+ * The strings are copied from the IDevice once, when the device is added or
+ * updated, so reading them never calls back into the device.
+ */
+class DeviceEntry {
+public:
+    uint32_t GetKey() const { return m_key; }
+    std::string_view GetId() const { return m_id; }
+    std::string_view GetName() const { return m_name; }
+    std::string_view GetDeviceType() const { return m_deviceType; }
+    bool IsConnected() const { return m_connected; }
+    const std::shared_ptr<Domain::IDevice>& GetDevice() const { return m_device; }
+
+private:
+    friend class InMemoryDeviceRepository;
+
+    uint32_t m_key;
+    std::string m_id;
+    std::string m_name;
+    std::string m_deviceType;
+    bool m_connected;
+    std::shared_ptr<Domain::IDevice> m_device;
+};
+
+/**
+ * @brief Immutable device set with indexes by compact key, id and type
+ */
+class DeviceSnapshot {
+public:
+    static constexpr uint32_t kNoEntry = UINT32_MAX;
+
+    DeviceSnapshot() = default;
+
+    // The indexes point into the entries, so a copy rebuilds them; a move
+    // takes over the entry storage and the indexes stay valid
+    DeviceSnapshot(const DeviceSnapshot& other);
+    DeviceSnapshot(DeviceSnapshot&&) = default;
+    DeviceSnapshot& operator=(const DeviceSnapshot&) = delete;
+
+    size_t GetCount() const { return m_entries.size(); }
+    const DeviceEntry& At(size_t index) const { return m_entries[index]; }
+
+    /**
+     * @brief Look up a device by the compact key assigned when it was added
+     * @return const DeviceEntry* Null if no such device
+     */
+    const DeviceEntry* FindByKey(uint32_t key) const;
+
+    const DeviceEntry* FindById(std::string_view id) const;
+
+    /**
+     * @brief Call function for every device of the given type, in insertion order
+     */
+    template <typename Function>
+    void ForEachOfType(std::string_view deviceType, Function&& function) const {
+        auto indexes = m_byType.find(deviceType);
+        if (indexes == m_byType.end()) {
+            return;
+        }
+        for (uint32_t index : indexes->second) {
+            function(m_entries[index]);
+        }
+    }
+
+    /**
+     * @brief Monotonic version, incremented by every published change
+     */
+    uint64_t GetVersion() const { return m_version; }
+
+private:
+    friend class InMemoryDeviceRepository;
+
+    uint64_t m_version = 0;
+    std::vector<DeviceEntry> m_entries;
+    std::vector<uint32_t> m_byKey;          // Key -> entry index, kNoEntry if unused
+    std::unordered_map<std::string_view, uint32_t> m_byId;
+    std::unordered_map<std::string_view, std::vector<uint32_t>> m_byType;
+
+    void BuildIndexes();
+};
+
+/**
+ * @brief IDeviceRepository kept in memory, with lock-free snapshot reads
+ *
+ * The device set is published as an immutable DeviceSnapshot through a
+ * Utils::SnapshotCell. Writers (hotplug) serialize on a mutex, copy the
+ * current snapshot, apply their change and publish it. Readers on
+ * latency-sensitive threads use a Reader, which protects the snapshot it
+ * returned with a hazard slot instead of a lock; a replaced snapshot is
+ * freed by a later write once no slot points at it.
+ *
+ * The IDeviceRepository methods are for cold paths and read under the
+ * cell's writer mutex.
+ */
+class InMemoryDeviceRepository : public Domain::IDeviceRepository {
+public:
+    static constexpr size_t kMaxReaders = 32;
+
+    /**
+     * @brief Per-thread lock-free read access
+     *
+     * Construct one per reading thread and keep it. A Reader is not thread
+     * safe itself and must not outlive its repository.
+     */
+    class Reader {
+    public:
+        explicit Reader(InMemoryDeviceRepository& repository) : m_reader(repository.m_snapshots) {}
+
+        Reader(const Reader&) = delete;
+        Reader& operator=(const Reader&) = delete;
+
+        /**
+         * @brief Get the current snapshot
+         * @return const DeviceSnapshot& Valid until the next call or until the Reader is destroyed
+         */
+        const DeviceSnapshot& Snapshot() { return m_reader.Get(); }
+
+        /**
+         * @brief False if every hazard slot was taken; Snapshot() then copies under the writer mutex
+         */
+        bool IsLockFree() const { return m_reader.IsLockFree(); }
+
+    private:
+        Utils::SnapshotCell<DeviceSnapshot, kMaxReaders>::Reader m_reader;
+    };
+
+    InMemoryDeviceRepository() = default;
+    ~InMemoryDeviceRepository() override = default;
+
+    InMemoryDeviceRepository(const InMemoryDeviceRepository&) = delete;
+    InMemoryDeviceRepository& operator=(const InMemoryDeviceRepository&) = delete;
+
+    // IDeviceRepository interface implementation
+    std::optional<std::shared_ptr<Domain::IDevice>> FindById(const std::string& id) override;
+    std::vector<std::shared_ptr<Domain::IDevice>> GetConnectedDevices() override;
+    std::vector<std::shared_ptr<Domain::IDevice>> GetDevicesByType(const std::string& deviceType) override;
+    bool Add(std::shared_ptr<Domain::IDevice> device) override;
+    bool Remove(const std::string& id) override;
+    bool Update(std::shared_ptr<Domain::IDevice> device) override;
+
+    /**
+     * @brief Compact key of a device, for storing in hot-path state
+     * @return uint32_t DeviceSnapshot::kNoEntry if the id is unknown
+     */
+    uint32_t GetKey(const std::string& id);
+
+    /**
+     * @brief Snapshots replaced but not yet freed because a reader may hold them
+     */
+    size_t GetRetiredCount();
+
+private:
+    std::mutex m_writeMutex;                                 // Serializes copy-on-write changes
+    Utils::SnapshotCell<DeviceSnapshot, kMaxReaders> m_snapshots;
+    Utils::HandleAllocator m_keys;                           // Guarded by m_writeMutex
+
+    // Caller holds m_writeMutex, so the current snapshot is the one to change
+    DeviceSnapshot CopyCurrent() const;
+    void Publish(DeviceSnapshot&& snapshot);
+    static DeviceEntry MakeEntry(uint32_t key, const std::shared_ptr<Domain::IDevice>& device);
+};
+
+} // namespace Infrastructure
+} // namespace TPMiddle
+
+#endif // TPMIDDLE_IN_MEMORY_DEVICE_REPOSITORY_H
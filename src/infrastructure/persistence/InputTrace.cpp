@@ -0,0 +1,188 @@
+#include "InputTrace.h"
+#include <chrono>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <unordered_map>
+
+namespace TPMiddle {
+namespace Infrastructure {
+
+namespace {
+
+const char kTraceMagic[8] = {'T', 'P', 'T', 'R', 'A', 'C', 'E', 0};
+
+bool WriteFully(int fd, const void* data, size_t length) {
+    const char* bytes = static_cast<const char*>(data);
+    while (length > 0) {
+        ssize_t written = ::write(fd, bytes, length);
+        if (written <= 0) {
+            return false;
+        }
+        bytes += written;
+        length -= static_cast<size_t>(written);
+    }
+    return true;
+}
+
+} // namespace
+
+InputTraceWriter::InputTraceWriter()
+    : m_fd(-1)
+    , m_header()
+    , m_recordCount(0)
+    , m_buffered(0) {
+}
+
+InputTraceWriter::~InputTraceWriter() {
+    Close();
+}
+
+bool InputTraceWriter::Open(const std::string& path) {
+    if (IsOpen()) {
+        return false;
+    }
+
+    m_fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (m_fd < 0) {
+        return false;
+    }
+
+    std::memset(&m_header, 0, sizeof(m_header));
+    std::memcpy(m_header.magic, kTraceMagic, sizeof(kTraceMagic));
+    m_header.version = kFormatVersion;
+    m_header.recordSize = sizeof(Domain::InputEvent);
+    m_header.wallClockAtStart = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+    m_recordCount = 0;
+    m_buffered = 0;
+
+    if (!WriteFully(m_fd, &m_header, sizeof(m_header))) {
+        ::close(m_fd);
+        m_fd = -1;
+        return false;
+    }
+    return true;
+}
+
+bool InputTraceWriter::Append(const Domain::InputEvent& event) {
+    if (!IsOpen()) {
+        return false;
+    }
+    if (m_recordCount == 0 && m_buffered == 0) {
+        m_header.startTimestamp = event.timestamp;
+    }
+
+    m_buffer[m_buffered++] = event;
+    if (m_buffered == kBufferedRecords) {
+        return FlushBuffer();
+    }
+    return true;
+}
+
+bool InputTraceWriter::FlushBuffer() {
+    bool written = WriteFully(m_fd, m_buffer, m_buffered * sizeof(Domain::InputEvent));
+    if (written) {
+        m_recordCount += m_buffered;
+    }
+    m_buffered = 0;
+    return written;
+}
+
+void InputTraceWriter::Close() {
+    if (!IsOpen()) {
+        return;
+    }
+
+    FlushBuffer();
+    m_header.recordCount = m_recordCount;
+    ::pwrite(m_fd, &m_header, sizeof(m_header), 0);
+    ::close(m_fd);
+    m_fd = -1;
+}
+
+InputTraceReader::InputTraceReader()
+    : m_mapping(nullptr)
+    , m_mappingSize(0)
+    , m_header(nullptr)
+    , m_events(nullptr)
+    , m_eventCount(0) {
+}
+
+InputTraceReader::~InputTraceReader() {
+    Close();
+}
+
+bool InputTraceReader::Open(const std::string& path) {
+    Close();
+
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        m_lastError = "Cannot open trace file";
+        return false;
+    }
+
+    struct stat info;
+    if (::fstat(fd, &info) != 0 || static_cast<size_t>(info.st_size) < sizeof(InputTraceHeader)) {
+        ::close(fd);
+        m_lastError = "Trace file is too short";
+        return false;
+    }
+
+    // Private writable mapping: renumbering old traces copies only the touched pages
+    m_mappingSize = static_cast<size_t>(info.st_size);
+    m_mapping = ::mmap(nullptr, m_mappingSize, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (m_mapping == MAP_FAILED) {
+        m_mapping = nullptr;
+        m_lastError = "Cannot map trace file";
+        return false;
+    }
+
+    m_header = static_cast<const InputTraceHeader*>(m_mapping);
+    if (std::memcmp(m_header->magic, kTraceMagic, sizeof(kTraceMagic)) != 0) {
+        m_lastError = "Not a TPMiddle input trace";
+        Close();
+        return false;
+    }
+    if (m_header->version < InputTraceWriter::kOldestReadableVersion ||
+        m_header->version > InputTraceWriter::kFormatVersion ||
+        m_header->recordSize != sizeof(Domain::InputEvent)) {
+        m_lastError = "Unsupported trace version";
+        Close();
+        return false;
+    }
+
+    // Derive the count from the file size so an interrupted capture still replays
+    m_events = reinterpret_cast<const Domain::InputEvent*>(
+        static_cast<const char*>(m_mapping) + sizeof(InputTraceHeader));
+    m_eventCount = (m_mappingSize - sizeof(InputTraceHeader)) / sizeof(Domain::InputEvent);
+    if (m_header->version < InputTraceWriter::kFirstHandleVersion) {
+        RenumberDevices(const_cast<Domain::InputEvent*>(m_events), m_eventCount);
+    }
+    return true;
+}
+
+void InputTraceReader::RenumberDevices(Domain::InputEvent* events, size_t count) {
+    std::unordered_map<uint64_t, uint64_t> handles;
+    for (size_t i = 0; i < count; ++i) {
+        auto entry = handles.emplace(events[i].device, handles.size()).first;
+        events[i].device = entry->second;
+    }
+}
+
+void InputTraceReader::Close() {
+    if (m_mapping) {
+        ::munmap(m_mapping, m_mappingSize);
+    }
+    m_mapping = nullptr;
+    m_mappingSize = 0;
+    m_header = nullptr;
+    m_events = nullptr;
+    m_eventCount = 0;
+}
+
+} // namespace Infrastructure
+} // namespace TPMiddle
@@ -0,0 +1,110 @@
+#ifndef TPMIDDLE_INPUT_TRACE_H
+#define TPMIDDLE_INPUT_TRACE_H
+
+#include "../../domain/models/InputEvent.h"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace TPMiddle {
+namespace Infrastructure {
+
+/**
+ * @brief On-disk header of a raw input trace (*.tptrace)
+ *
+ * The header is 64 bytes and is followed directly by an array of
+ * Domain::InputEvent records, so a mapped file can be used in place.
+ * Timestamps are monotonic nanoseconds.
+ */
+struct InputTraceHeader {
+    char magic[8];              // "TPTRACE\0"
+    uint32_t version;
+    uint32_t recordSize;        // sizeof(Domain::InputEvent)
+    uint64_t recordCount;       // Written on close; 0 if capture was interrupted
+    uint64_t startTimestamp;    // Timestamp of the first record
+    int64_t wallClockAtStart;   // Nanoseconds since the Unix epoch when capture started
+    uint8_t reserved[24];
+};
+
+static_assert(sizeof(InputTraceHeader) == 64, "InputTraceHeader layout is part of the file format");
+
+/**
+ * @brief Buffered writer for input traces
+ *
+ * Append() only copies into an in-memory page; the page is written when it
+ * fills up and on Close().
+ */
+class InputTraceWriter {
+public:
+    // Version 2 adds Pointer events; version 3 stores compact device handles.
+    // Older records share the same layout
+    static constexpr uint32_t kFormatVersion = 3;
+    static constexpr uint32_t kFirstHandleVersion = 3;
+    static constexpr uint32_t kOldestReadableVersion = 1;
+    static constexpr size_t kBufferedRecords = 2048;
+
+    InputTraceWriter();
+    ~InputTraceWriter();
+
+    InputTraceWriter(const InputTraceWriter&) = delete;
+    InputTraceWriter& operator=(const InputTraceWriter&) = delete;
+
+    bool Open(const std::string& path);
+    bool Append(const Domain::InputEvent& event);
+    void Close();
+
+    bool IsOpen() const { return m_fd >= 0; }
+    uint64_t GetRecordCount() const { return m_recordCount; }
+
+private:
+    int m_fd;
+    InputTraceHeader m_header;
+    uint64_t m_recordCount;
+    size_t m_buffered;
+    Domain::InputEvent m_buffer[kBufferedRecords];
+
+    bool FlushBuffer();
+};
+
+/**
+ * @brief Read-only memory-mapped view of an input trace
+ *
+ * Traces older than version 3 recorded platform device references; their
+ * devices are renumbered to compact handles in order of first appearance
+ * so they replay through the per-device state table.
+ */
+class InputTraceReader {
+public:
+    InputTraceReader();
+    ~InputTraceReader();
+
+    InputTraceReader(const InputTraceReader&) = delete;
+    InputTraceReader& operator=(const InputTraceReader&) = delete;
+
+    /**
+     * @brief Map a trace file and validate its header
+     * @return bool True if the trace is usable; see GetLastError() otherwise
+     */
+    bool Open(const std::string& path);
+    void Close();
+
+    const InputTraceHeader& GetHeader() const { return *m_header; }
+    const Domain::InputEvent* GetEvents() const { return m_events; }
+    size_t GetEventCount() const { return m_eventCount; }
+    const std::string& GetLastError() const { return m_lastError; }
+
+private:
+    void* m_mapping;
+    size_t m_mappingSize;
+    const InputTraceHeader* m_header;
+    const Domain::InputEvent* m_events;
+    size_t m_eventCount;
+    std::string m_lastError;
+
+    void RenumberDevices(Domain::InputEvent* events, size_t count);
+};
+
+} // namespace Infrastructure
+} // namespace TPMiddle
+
+#endif // TPMIDDLE_INPUT_TRACE_H
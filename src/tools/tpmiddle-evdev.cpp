@@ -0,0 +1,207 @@
+// Linux backend: grabs TrackPoint evdev nodes, runs their input through the
+// portable processing pipeline and re-emits pointer motion, clicks and
+// middle-button scrolling through a uinput virtual device.
+// Needs read access to /dev/input/event* and write access to /dev/uinput.
+// /dev/input is watched, so a matching device that is replugged is grabbed
+// again. Live counters are published in shared memory for tpmiddle-stat.
+// --chrome-trace records the pipeline stages until exit as Chrome
+// trace-event JSON.
+
+#include "../application/services/TraceRecorder.h"
+#include "../infrastructure/evdev/EvdevDevice.h"
+#include "../infrastructure/evdev/EvdevInputLoop.h"
+#include "../infrastructure/evdev/UinputDevice.h"
+#include "../infrastructure/evdev/UinputWriter.h"
+#include "../infrastructure/metrics/LiveCounters.h"
+#include "../utils/MonotonicClock.h"
+#include <algorithm>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace TPMiddle::Application;
+using namespace TPMiddle::Infrastructure;
+using TPMiddle::Domain::AccelerationCurve;
+using TPMiddle::Domain::ChordClickPolicy;
+using TPMiddle::Domain::ScrollSettings;
+using TPMiddle::Utils::MonotonicClock;
+
+namespace {
+
+volatile std::sig_atomic_t g_running = 1;
+
+void HandleSignal(int) {
+    g_running = 0;
+}
+
+const char* const kInputDirectory = "/dev/input";
+
+// Scanned nodes are taken only if they are TrackPoints; named ones always.
+// Quiet attempts are hotplug retries, which fail until udev fixes permissions.
+bool AddNode(EvdevInputLoop& loop, const std::string& path, bool scan, bool quiet) {
+    EvdevDevice device;
+    if (!device.Open(path, false)) {
+        if (!quiet) {
+            std::fprintf(stderr, "%s\n", device.GetLastError().c_str());
+        }
+        return false;
+    }
+    if (scan && !device.IsTrackPoint()) {
+        return false;
+    }
+    // Reopen with the grab only once the device is known to be ours
+    EvdevDevice grabbed;
+    if (!grabbed.Open(path, true)) {
+        std::fprintf(stderr, "%s\n", grabbed.GetLastError().c_str());
+        return false;
+    }
+    std::printf("using %s: %s (%04x:%04x)\n", path.c_str(), grabbed.GetName().c_str(),
+                grabbed.GetVendorId(), grabbed.GetProductId());
+    if (!loop.AddDevice(grabbed.Release(), path)) {
+        std::fprintf(stderr, "%s\n", loop.GetLastError().c_str());
+        return false;
+    }
+    return true;
+}
+
+void PrintUsage(const char* program) {
+    std::fprintf(stderr,
+                 "usage: %s [--device PATH]... [--speed X] [--curve SPEC] [--chord-window MS]\n"
+                 "          [--pixels-per-detent N] [--no-natural] [--momentum]\n"
+                 "          [--stats NAME | --no-stats] [--chrome-trace PATH] [--verbose]\n",
+                 program);
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    std::vector<std::string> paths;
+    ScrollSettings settings;
+    uint64_t chordWindowNs = 20000000ULL;
+    double pixelsPerDetent = 15.0;
+    std::string statsName = LiveCounters::kDefaultName;
+    const char* chromeTracePath = nullptr;
+    bool verbose = false;
+
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--device") == 0 && i + 1 < argc) {
+            paths.push_back(argv[++i]);
+        } else if (std::strcmp(argv[i], "--speed") == 0 && i + 1 < argc) {
+            settings.speedMultiplier = std::atof(argv[++i]);
+        } else if (std::strcmp(argv[i], "--curve") == 0 && i + 1 < argc) {
+            std::shared_ptr<AccelerationCurve> curve = std::make_shared<AccelerationCurve>();
+            if (!curve->Parse(argv[++i])) {
+                std::fprintf(stderr, "%s\n", curve->GetLastError().c_str());
+                return 2;
+            }
+            settings.accelerationCurve = curve;
+        } else if (std::strcmp(argv[i], "--chord-window") == 0 && i + 1 < argc) {
+            chordWindowNs = static_cast<uint64_t>(std::max(0, std::atoi(argv[++i]))) * 1000000ULL;
+        } else if (std::strcmp(argv[i], "--pixels-per-detent") == 0 && i + 1 < argc) {
+            pixelsPerDetent = std::atof(argv[++i]);
+        } else if (std::strcmp(argv[i], "--no-natural") == 0) {
+            settings.naturalScrolling = false;
+        } else if (std::strcmp(argv[i], "--momentum") == 0) {
+            settings.momentum = true;
+        } else if (std::strcmp(argv[i], "--stats") == 0 && i + 1 < argc) {
+            statsName = argv[++i];
+        } else if (std::strcmp(argv[i], "--no-stats") == 0) {
+            statsName.clear();
+        } else if (std::strcmp(argv[i], "--chrome-trace") == 0 && i + 1 < argc) {
+            chromeTracePath = argv[++i];
+        } else if (std::strcmp(argv[i], "--verbose") == 0) {
+            verbose = true;
+        } else {
+            PrintUsage(argv[0]);
+            return 2;
+        }
+    }
+
+    UinputDevice output;
+    if (!output.Create("TPMiddle Virtual Pointer")) {
+        std::fprintf(stderr, "uinput: %s\n", output.GetLastError().c_str());
+        return 1;
+    }
+
+    // The grabbed devices are ours alone, so clicks that may start a chord
+    // are held back instead of reaching the system early
+    UinputWriter writer(output.GetFd(), pixelsPerDetent);
+    InputPipeline pipeline(writer, settings, chordWindowNs);
+    pipeline.SetClickPolicy(ChordClickPolicy::Hold);
+
+    EvdevInputLoop loop(pipeline, writer);
+    if (!loop.Initialize()) {
+        std::fprintf(stderr, "%s\n", loop.GetLastError().c_str());
+        return 1;
+    }
+
+    bool scan = paths.empty();
+    for (const std::string& path : scan ? EvdevDevice::ListNodes(kInputDirectory) : paths) {
+        AddNode(loop, path, scan, scan);
+    }
+    if (loop.GetDeviceCount() == 0) {
+        std::fprintf(stderr, "no TrackPoint found; pass --device /dev/input/eventN\n");
+        return 1;
+    }
+    // Without the watch the loop still runs, but ends with the last device
+    bool watching = loop.WatchDirectory(kInputDirectory);
+    if (!watching) {
+        std::fprintf(stderr, "hotplug: %s\n", loop.GetLastError().c_str());
+    }
+
+    // Counters are recorded either way; a failed publish only hides them
+    LiveCounters& counters = LiveCounters::Shared();
+    if (!statsName.empty() && !counters.Publish(statsName, MonotonicClock::SystemNanoseconds())) {
+        std::fprintf(stderr, "stats: %s\n", counters.GetLastError().c_str());
+    }
+    loop.SetCounters(&counters);
+
+    TraceRecorder& recorder = TraceRecorder::Shared();
+    if (chromeTracePath) {
+        TraceRecorder::SetThreadName("evdev loop");
+        recorder.Start();
+    }
+
+    std::signal(SIGINT, HandleSignal);
+    std::signal(SIGTERM, HandleSignal);
+    while (g_running && (watching || loop.GetDeviceCount() > 0)) {
+        if (!loop.RunOnce(250)) {
+            std::fprintf(stderr, "%s\n", loop.GetLastError().c_str());
+            counters.Unpublish();
+            return 1;
+        }
+        for (const std::string& path : loop.TakeAddedNodes()) {
+            bool wanted = scan || std::find(paths.begin(), paths.end(), path) != paths.end();
+            if (wanted && !loop.HasDevice(path)) {
+                AddNode(loop, path, scan, true);
+            }
+        }
+    }
+    counters.Unpublish();
+
+    if (chromeTracePath) {
+        recorder.Stop();
+        if (!recorder.ExportChromeJson(chromeTracePath)) {
+            std::fprintf(stderr, "%s\n", recorder.GetLastError().c_str());
+        } else if (verbose) {
+            std::printf("chrome trace: %zu events written to %s, %llu dropped\n", recorder.GetRecordCount(),
+                        chromeTracePath, (unsigned long long)recorder.GetDroppedCount());
+        }
+    }
+
+    if (verbose) {
+        const EvdevInputLoopStatistics& stats = loop.GetStatistics();
+        const UinputWriterStatistics& writes = writer.GetStatistics();
+        std::printf("wakeups %llu, reads %llu, events %llu, samples %llu, dropped frames %llu\n"
+                    "output frames %llu in %llu writes\n",
+                    (unsigned long long)stats.wakeups, (unsigned long long)stats.reads,
+                    (unsigned long long)stats.events, (unsigned long long)stats.samples,
+                    (unsigned long long)stats.droppedFrames,
+                    (unsigned long long)writes.frames, (unsigned long long)writes.writes);
+    }
+    return 0;
+}
@@ -0,0 +1,41 @@
+// Offline decoder for TPLogger binary logs (*.tplog).
+// Prints records in the same text format as the regular TPMiddle log.
+
+#include "../infrastructure/logging/BinaryLog.h"
+#include <cstdio>
+#include <string>
+
+using namespace TPMiddle::Infrastructure;
+
+int main(int argc, char* argv[]) {
+    if (argc != 2) {
+        std::fprintf(stderr, "usage: %s <file.tplog>\n", argv[0]);
+        return 2;
+    }
+
+    FILE* file = std::fopen(argv[1], "rb");
+    if (!file) {
+        std::perror(argv[1]);
+        return 1;
+    }
+
+    BinaryLogFileHeader header;
+    if (!ReadBinaryLogHeader(file, header)) {
+        std::fprintf(stderr, "%s: not a TPMiddle binary log or unsupported version\n", argv[1]);
+        std::fclose(file);
+        return 1;
+    }
+
+    BinaryLogRecord records[BinaryLog::kRecordsPerPage];
+    size_t count;
+    while ((count = std::fread(records, sizeof(BinaryLogRecord), BinaryLog::kRecordsPerPage, file)) > 0) {
+        for (size_t i = 0; i < count; ++i) {
+            ApplyBinaryLogSession(header, records[i]);
+            std::string line = FormatBinaryLogRecord(header, records[i]);
+            std::fputs(line.c_str(), stdout);
+        }
+    }
+
+    std::fclose(file);
+    return 0;
+}
@@ -0,0 +1,177 @@
+// Headless replay of a recorded TPMiddle input trace (*.tptrace).
+// Feeds the trace through the portable processing pipeline and reports
+// throughput, per-event latency and the synthetic output it produced.
+// With --curve the trace is replayed with that acceleration curve, and the
+// curve is also evaluated over every pointer sample in one batch.
+// With --chrome-trace the pipeline stages of the first run are written as
+// Chrome trace-event JSON.
+
+#include "../application/services/ReplayDriver.h"
+#include "../application/services/TraceRecorder.h"
+#include "../infrastructure/persistence/InputTrace.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace TPMiddle::Application;
+using namespace TPMiddle::Infrastructure;
+using TPMiddle::Domain::AccelerationCurve;
+using TPMiddle::Domain::InputEvent;
+using TPMiddle::Domain::InputEventType;
+using TPMiddle::Domain::ScrollSettings;
+
+namespace {
+
+class CountingOutput : public IPipelineOutput {
+public:
+    uint64_t middleDown = 0;
+    uint64_t middleUp = 0;
+    uint64_t scrolls = 0;
+    double scrollX = 0.0;
+    double scrollY = 0.0;
+
+    void PostMiddleButton(uint64_t, bool isDown) override {
+        if (isDown) {
+            ++middleDown;
+        } else {
+            ++middleUp;
+        }
+    }
+
+    void PostScroll(uint64_t, double deltaX, double deltaY) override {
+        ++scrolls;
+        scrollX += deltaX;
+        scrollY += deltaY;
+    }
+};
+
+void PrintUsage(const char* program) {
+    std::fprintf(stderr,
+                 "usage: %s [--pacing recorded|max] [--repeat N] [--curve SPEC] [--chrome-trace PATH]\n"
+                 "          <trace.tptrace>\n",
+                 program);
+}
+
+void PrintCurveSummary(const AccelerationCurve& curve, const InputEvent* events, size_t count) {
+    std::vector<int16_t> deltaX;
+    std::vector<int16_t> deltaY;
+    for (size_t i = 0; i < count; ++i) {
+        if (events[i].type == InputEventType::Pointer) {
+            deltaX.push_back(events[i].pointer.deltaX);
+            deltaY.push_back(events[i].pointer.deltaY);
+        }
+    }
+    if (deltaX.empty()) {
+        std::printf("curve: no pointer samples in trace\n");
+        return;
+    }
+
+    std::vector<float> values(deltaX.size());
+    auto start = std::chrono::steady_clock::now();
+    curve.EvaluateBatch(deltaX.data(), deltaY.data(), deltaX.size(), values.data());
+    auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start);
+
+    double sum = 0.0;
+    float peak = 0.0f;
+    for (float value : values) {
+        sum += value;
+        peak = std::max(peak, value);
+    }
+    std::printf("curve: %zu pointer samples, shape mean %.3f, max %.3f, %.2f ns/sample\n",
+                values.size(), sum / values.size(), peak,
+                static_cast<double>(elapsed.count()) / values.size());
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    ReplayPacing pacing = ReplayPacing::Maximum;
+    int repeat = 1;
+    const char* path = nullptr;
+    const char* chromeTracePath = nullptr;
+    std::shared_ptr<AccelerationCurve> curve;
+
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--pacing") == 0 && i + 1 < argc) {
+            const char* mode = argv[++i];
+            if (std::strcmp(mode, "recorded") == 0) {
+                pacing = ReplayPacing::Recorded;
+            } else if (std::strcmp(mode, "max") == 0) {
+                pacing = ReplayPacing::Maximum;
+            } else {
+                PrintUsage(argv[0]);
+                return 2;
+            }
+        } else if (std::strcmp(argv[i], "--repeat") == 0 && i + 1 < argc) {
+            repeat = std::max(1, std::atoi(argv[++i]));
+        } else if (std::strcmp(argv[i], "--curve") == 0 && i + 1 < argc) {
+            curve = std::make_shared<AccelerationCurve>();
+            if (!curve->Parse(argv[++i])) {
+                std::fprintf(stderr, "%s\n", curve->GetLastError().c_str());
+                return 2;
+            }
+        } else if (std::strcmp(argv[i], "--chrome-trace") == 0 && i + 1 < argc) {
+            chromeTracePath = argv[++i];
+        } else if (argv[i][0] != '-' && !path) {
+            path = argv[i];
+        } else {
+            PrintUsage(argv[0]);
+            return 2;
+        }
+    }
+    if (!path) {
+        PrintUsage(argv[0]);
+        return 2;
+    }
+
+    InputTraceReader trace;
+    if (!trace.Open(path)) {
+        std::fprintf(stderr, "%s: %s\n", path, trace.GetLastError().c_str());
+        return 1;
+    }
+
+    std::printf("trace: %s, %zu events, pacing %s\n", path, trace.GetEventCount(),
+                pacing == ReplayPacing::Recorded ? "recorded" : "max");
+
+    ScrollSettings settings;
+    if (curve) {
+        settings.accelerationCurve = curve;
+        PrintCurveSummary(*curve, trace.GetEvents(), trace.GetEventCount());
+    }
+
+    TraceRecorder& recorder = TraceRecorder::Shared();
+    for (int run = 0; run < repeat; ++run) {
+        CountingOutput output;
+        ReplayDriver driver(output, settings);
+        if (chromeTracePath && run == 0) {
+            recorder.Start();
+        }
+        ReplayResult result = driver.Run(trace.GetEvents(), trace.GetEventCount(), pacing);
+        if (chromeTracePath && run == 0) {
+            recorder.Stop();
+            if (!recorder.ExportChromeJson(chromeTracePath)) {
+                std::fprintf(stderr, "%s\n", recorder.GetLastError().c_str());
+                return 1;
+            }
+            std::printf("chrome trace: %zu events written to %s, %llu dropped\n", recorder.GetRecordCount(),
+                        chromeTracePath, (unsigned long long)recorder.GetDroppedCount());
+        }
+
+        std::printf("run %d: %.0f events/s, latency mean %llu ns, p50 %llu ns, p99 %llu ns, max %llu ns",
+                    run + 1, result.eventsPerSecond,
+                    (unsigned long long)result.latencyMeanNs, (unsigned long long)result.latencyP50Ns,
+                    (unsigned long long)result.latencyP99Ns, (unsigned long long)result.latencyMaxNs);
+        if (pacing == ReplayPacing::Recorded) {
+            std::printf(", max lateness %llu ns", (unsigned long long)result.maxLatenessNs);
+        }
+        std::printf("\n  output: %llu scroll events (sum %.2f, %.2f), middle down %llu, up %llu\n",
+                    (unsigned long long)output.scrolls, output.scrollX, output.scrollY,
+                    (unsigned long long)output.middleDown, (unsigned long long)output.middleUp);
+    }
+    return 0;
+}
@@ -0,0 +1,136 @@
+// Live view of a running TPMiddle's counters, in the manner of vmstat.
+// The first line averages everything since the counters were published;
+// each later line covers one interval. Rates are per second, qdepth is the
+// queue depth when the last input batch finished, and the last column
+// lists report rates for every device that sent input in the interval.
+
+#include "../infrastructure/metrics/LiveCounters.h"
+#include <cerrno>
+#include <chrono>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
+
+using namespace TPMiddle::Infrastructure;
+
+namespace {
+
+const int kHeaderEvery = 20;
+
+volatile std::sig_atomic_t g_running = 1;
+
+void HandleSignal(int) {
+    g_running = 0;
+}
+
+void PrintUsage(const char* program) {
+    std::fprintf(stderr, "usage: %s [--name NAME] [interval [count]]\n", program);
+}
+
+void PrintHeader() {
+    std::printf("%10s %8s %6s %9s %8s %7s  %s\n", "ev/s", "drop/s", "qdepth", "scroll/s", "middle/s", "chord/s",
+                "device reports/s");
+}
+
+double Rate(uint64_t now, uint64_t before, double seconds) {
+    return now >= before ? static_cast<double>(now - before) / seconds : 0.0;
+}
+
+void PrintLine(const LiveCountersSnapshot& now, const LiveCountersSnapshot& before, double seconds) {
+    std::printf("%10.0f %8.0f %6llu %9.0f %8.0f %7.0f ",
+                Rate(now.Get(LiveCounter::EventsProcessed), before.Get(LiveCounter::EventsProcessed), seconds),
+                Rate(now.Get(LiveCounter::EventsDropped), before.Get(LiveCounter::EventsDropped), seconds),
+                (unsigned long long)now.Get(LiveCounter::QueueDepth),
+                Rate(now.Get(LiveCounter::ScrollEvents), before.Get(LiveCounter::ScrollEvents), seconds),
+                Rate(now.Get(LiveCounter::MiddleButtonEvents), before.Get(LiveCounter::MiddleButtonEvents), seconds),
+                Rate(now.Get(LiveCounter::ChordDetections), before.Get(LiveCounter::ChordDetections), seconds));
+    for (size_t i = 0; i < LiveCountersBlock::kMaxDevices; ++i) {
+        if (now.deviceReports[i] != before.deviceReports[i]) {
+            std::printf(" %zu:%.0f", i, Rate(now.deviceReports[i], before.deviceReports[i], seconds));
+        }
+    }
+    std::printf("\n");
+    std::fflush(stdout);
+}
+
+bool WriterAlive(int32_t pid) {
+    return kill(pid, 0) == 0 || errno != ESRCH;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    std::string name = LiveCounters::kDefaultName;
+    double interval = 0.0;
+    long count = -1;
+
+    int positional = 0;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--name") == 0 && i + 1 < argc) {
+            name = argv[++i];
+        } else if (argv[i][0] != '-' && positional == 0 && std::atof(argv[i]) > 0.0) {
+            interval = std::atof(argv[i]);
+            ++positional;
+        } else if (argv[i][0] != '-' && positional == 1 && std::atol(argv[i]) > 0) {
+            count = std::atol(argv[i]);
+            ++positional;
+        } else {
+            PrintUsage(argv[0]);
+            return 2;
+        }
+    }
+    // Like vmstat: no interval prints the summary line once
+    if (interval <= 0.0) {
+        count = 1;
+    }
+
+    LiveCountersReader reader;
+    if (!reader.Open(name)) {
+        std::fprintf(stderr, "%s\n", reader.GetLastError().c_str());
+        return 1;
+    }
+
+    LiveCountersSnapshot previous;
+    if (!reader.Read(previous)) {
+        std::fprintf(stderr, "%s: counters are being rewritten too fast to read\n", name.c_str());
+        return 1;
+    }
+
+    // Averages since publication use the writer's own clock
+    LiveCountersSnapshot start;
+    double lifetime = static_cast<double>(previous.updatedNs - previous.publishedNs) / 1e9;
+    PrintHeader();
+    PrintLine(previous, start, lifetime > 0.0 ? lifetime : 1.0);
+
+    std::signal(SIGINT, HandleSignal);
+    std::signal(SIGTERM, HandleSignal);
+    auto last = std::chrono::steady_clock::now();
+    for (long line = 1; g_running && (count < 0 || line < count); ++line) {
+        std::this_thread::sleep_for(std::chrono::duration<double>(interval));
+        if (!g_running) {
+            break;
+        }
+        if (!WriterAlive(previous.pid)) {
+            std::fprintf(stderr, "%s: writer %d has exited\n", name.c_str(), previous.pid);
+            return 1;
+        }
+
+        LiveCountersSnapshot current;
+        if (!reader.Read(current)) {
+            continue;
+        }
+        auto now = std::chrono::steady_clock::now();
+        double seconds = std::chrono::duration<double>(now - last).count();
+        last = now;
+
+        if (line % kHeaderEvery == 0) {
+            PrintHeader();
+        }
+        PrintLine(current, previous, seconds);
+        previous = current;
+    }
+    return 0;
+}
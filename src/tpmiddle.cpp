@@ -13,6 +13,19 @@
 #endif
 
 #include "SynKit.h"
+#include "application/services/SynapticsPacketCore.h"
+#include "utils/MonotonicClock.h"
+#include <stdint.h>
+#include <vector>
+
+using TPMiddle::Application::IMiddleButtonOutput;
+using TPMiddle::Application::ISynapticsPacketSource;
+using TPMiddle::Application::SynapticsCoreOptions;
+using TPMiddle::Application::SynapticsDeviceInfo;
+using TPMiddle::Application::SynapticsDeviceType;
+using TPMiddle::Application::SynapticsPacket;
+using TPMiddle::Application::SynapticsPacketCore;
+
 int connectionTypes[] = { SE_ConnectionAny };
 char* connectionTypeNames[] = { "(any connection)" };
 int connectionTypeCount = 1;
@@ -27,8 +40,6 @@ char* wantedDeviceTypeNames[] = {"IBMCompatibleStick", "Styk", "TouchPad"};
 int wantedDeviceTypeCount = 3;
 
 static bool NORMAL_MODE = 0;
-static bool DELTA_DEBUG = 0;
-//#define DISABLE_ALL_EVENTS
 
 void listDevices(ISynAPI *pAPI)
 {
@@ -50,114 +61,158 @@ void listDevices(ISynAPI *pAPI)
 #endif
 }
 
-#define MAX_DEVICE_COUNT 100
-
-struct deviceState
+// Opened SynKit devices by handle; the packet logic lives in SynapticsPacketCore
+struct openedDevice
 {
+	long handle;
 	ISynDevice* device;
 	HANDLE event;
-	BOOL isMiddleClicked;
-	ULONGLONG middleClickTimeout;
-
-	SynDeviceType deviceType;
 };
-deviceState deviceStates[MAX_DEVICE_COUNT];
-int connectedDeviceCount = 0;
+std::vector<openedDevice> openedDevices;
 
-HANDLE hEvents[MAX_DEVICE_COUNT + 1];
+class SynKitPacketSource : public ISynapticsPacketSource
+{
+public:
+	bool LoadPacket(long handle, SynapticsPacket& packet) override
+	{
+		openedDevice* opened = findOpenedDevice(handle);
+		if (!opened || opened->device->LoadPacket(m_packet) == SYNE_FAIL) return false;
+		packet.buttonState = (uint32_t)m_packet.ButtonState();
+		return true;
+	}
 
-void connectDevices(ISynAPI *pAPI, bool resetOnly = false)
+	static openedDevice* findOpenedDevice(long handle)
+	{
+		for (size_t i = 0; i < openedDevices.size(); ++i)
+			if (openedDevices[i].handle == handle) return &openedDevices[i];
+		return NULL;
+	}
+
+private:
+	SynPacket m_packet;
+};
+
+// One SendInput per batch the core produces
+class SendInputOutput : public IMiddleButtonOutput
 {
+public:
+	void SendMiddleButtons(const bool* downs, size_t count) override
+	{
+		INPUT inputs[SynapticsPacketCore::kMaxBatch];
+		ZeroMemory(inputs, sizeof(inputs));
+		for (size_t i = 0; i < count; ++i)
+		{
+			inputs[i].type = INPUT_MOUSE;
+			inputs[i].mi.dwFlags = downs[i] ? MOUSEEVENTF_MIDDLEDOWN : MOUSEEVENTF_MIDDLEUP;
+		}
+		SendInput((UINT)count, inputs, sizeof(INPUT));
 #ifdef _DEBUG
-	__time64_t ltime;
-	_time64( &ltime );
-	printf("Connecting to devices: %s", _ctime64( &ltime ) );
+		__time64_t ltime;
+		_time64( &ltime );
+		printf("SendInput: %u middle button events, last %s, %s", (unsigned)count, downs[count - 1] ? "down" : "up", _ctime64( &ltime ));
 #endif
+	}
+};
+
+// GetTickCount64() moves in 10-16 ms steps, coarser than a chord window;
+// the shared clock reads the performance counter
+uint64_t nowNanoseconds()
+{
+	return TPMiddle::Utils::MonotonicClock::SystemNanoseconds();
+}
 
-	connectedDeviceCount = 0;
+std::vector<SynapticsDeviceInfo> findWantedDevices(ISynAPI *pAPI)
+{
+	std::vector<SynapticsDeviceInfo> found;
 	for (int conn = 0; conn < connectionTypeCount; ++conn)
 		for (int dev = 0; dev < wantedDeviceTypeCount; ++dev)
 		{
 			long handle = -1;
-
 			while (pAPI->FindDevice(connectionTypes[conn], wantedDeviceTypes[dev], &handle) == SYN_OK)
 			{
+				SynapticsDeviceInfo info;
+				info.handle = handle;
+				info.type = wantedDeviceTypes[dev] == SE_DeviceTouchPad ? SynapticsDeviceType::TouchPad : SynapticsDeviceType::Stick;
+				found.push_back(info);
+			}
+		}
+
+	// MsgWaitForMultipleObjects also waits on the API event
+	if (found.size() > MAXIMUM_WAIT_OBJECTS - 2) found.resize(MAXIMUM_WAIT_OBJECTS - 2);
+	return found;
+}
+
+bool openDevice(ISynAPI *pAPI, long handle, bool resetOnly)
+{
 #ifdef _DEBUG
-				printf("Connecting to: connection %d, device %d, logical_id %d, %s on %s\n", conn, dev, connectedDeviceCount, wantedDeviceTypeNames[dev], connectionTypeNames[conn]);
+	printf("Connecting to: handle %ld\n", handle);
 #endif
-				if (pAPI->CreateDevice(handle, &deviceStates[connectedDeviceCount].device) != SYN_OK)
-				{
+	openedDevice opened;
+	opened.handle = handle;
+	if (pAPI->CreateDevice(handle, &opened.device) != SYN_OK)
+	{
 #ifdef _DEBUG
-					printf("Cannot obtain a device object.\n");
+		printf("Cannot obtain a device object.\n");
 #else
-					MessageBox(NULL, "Cannot obtain a device object.", "TP Middle", MB_ICONERROR | MB_OK);
+		MessageBox(NULL, "Cannot obtain a device object.", "TP Middle", MB_ICONERROR | MB_OK);
 #endif
-					continue;
-				}
-
-				char eventName[100];
-				sprintf(eventName, "tpmiddleDevice%d_%d", GetCurrentProcessId(), connectedDeviceCount);
-				deviceStates[connectedDeviceCount].event = CreateEvent(0, 0, 0, eventName);
-				deviceStates[connectedDeviceCount].device->SetEventNotification(deviceStates[connectedDeviceCount].event);
-				hEvents[connectedDeviceCount + 1] = deviceStates[connectedDeviceCount].event;
-
-				deviceStates[connectedDeviceCount].isMiddleClicked = FALSE;
-				deviceStates[connectedDeviceCount].middleClickTimeout = 0;
-				deviceStates[connectedDeviceCount].device->GetProperty(SP_DeviceType, (long *)&deviceStates[connectedDeviceCount].deviceType);
-
-				if (NORMAL_MODE || resetOnly)
-				{
-					long lMask;
-					deviceStates[connectedDeviceCount].device->GetProperty(SP_MiddleButtonAction, &lMask);
-					if (resetOnly)
-					{
-						lMask &= ~SF_ActionAll;
-						lMask |= SF_ActionAuxilliary;
-					}
-					if (NORMAL_MODE) lMask &= ~SF_ActionAll;
-					deviceStates[connectedDeviceCount].device->SetProperty(SP_MiddleButtonAction, lMask);
-				}
-
-				++connectedDeviceCount;
-			}
+		return false;
+	}
+
+	char eventName[100];
+	sprintf(eventName, "tpmiddleDevice%d_%ld", GetCurrentProcessId(), handle);
+	opened.event = CreateEvent(0, 0, 0, eventName);
+	opened.device->SetEventNotification(opened.event);
+
+	if (NORMAL_MODE || resetOnly)
+	{
+		long lMask;
+		opened.device->GetProperty(SP_MiddleButtonAction, &lMask);
+		if (resetOnly)
+		{
+			lMask &= ~SF_ActionAll;
+			lMask |= SF_ActionAuxilliary;
 		}
+		if (NORMAL_MODE) lMask &= ~SF_ActionAll;
+		opened.device->SetProperty(SP_MiddleButtonAction, lMask);
+	}
+
+	openedDevices.push_back(opened);
+	return true;
 }
 
-void disconnectDevices(ISynAPI *pAPI)
+void closeDevice(long handle)
 {
 #ifdef _DEBUG
-	__time64_t ltime;
-	_time64( &ltime );
-	printf("Disconnecting devices: %s", _ctime64( &ltime ) );
+	printf("Disconnecting: handle %ld\n", handle);
 #endif
-
-	for (int i = 0; i < connectedDeviceCount; ++i)
+	for (size_t i = 0; i < openedDevices.size(); ++i)
 	{
-		CloseHandle(deviceStates[i].event);
-		deviceStates[i].device->Release();
-		deviceStates[i].device = NULL;
+		if (openedDevices[i].handle != handle) continue;
+		CloseHandle(openedDevices[i].event);
+		openedDevices[i].device->Release();
+		openedDevices.erase(openedDevices.begin() + i);
+		return;
 	}
-
-	connectedDeviceCount = 0;
 }
 
-void sendMiddleMouse(int devNum, bool buttondown)
+// Opens and closes only the devices that changed; the others keep their state
+void reconnectDevices(ISynAPI *pAPI, SynapticsPacketCore& core)
 {
-	static bool lastbuttondown = false;
-	if (NORMAL_MODE && buttondown == lastbuttondown) return;
-	lastbuttondown = buttondown;
-	INPUT Input={0};
-
-	ZeroMemory(&Input,sizeof(INPUT));
-	Input.type = INPUT_MOUSE;
-	Input.mi.dwFlags = MOUSEEVENTF_MIDDLEUP;
-	if (buttondown) Input.mi.dwFlags = MOUSEEVENTF_MIDDLEDOWN;
-	SendInput(1,&Input,sizeof(INPUT));
 #ifdef _DEBUG
 	__time64_t ltime;
 	_time64( &ltime );
-	printf("Packet: device %d, sendMiddleMouse=%i, %s", devNum, buttondown, _ctime64( &ltime ));
+	printf("Reconnecting devices: %s", _ctime64( &ltime ) );
 #endif
+	std::vector<SynapticsDeviceInfo> added;
+	std::vector<long> removed;
+	core.Reconcile(findWantedDevices(pAPI), &added, &removed);
+
+	for (size_t i = 0; i < removed.size(); ++i)
+		closeDevice(removed[i]);
+	for (size_t i = 0; i < added.size(); ++i)
+		if (!openDevice(pAPI, added[i].handle, false))
+			core.RemoveDevice(added[i].handle);
 }
 
 // Derived from http://www.cmake.org/pipermail/cmake/2004-June/005172.html
@@ -301,114 +356,60 @@ int WINAPI WinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance, LPSTR lpCmdLine
 
 	char eventName[100];
 	sprintf(eventName, "tpmiddleApi%d", GetCurrentProcessId());
-	hEvents[0] = CreateEvent(0, 0, 0, eventName);
-	pAPI->SetEventNotification(hEvents[0]);
+	HANDLE apiEvent = CreateEvent(0, 0, 0, eventName);
+	pAPI->SetEventNotification(apiEvent);
 	
 	listDevices(pAPI);
 
-	connectDevices(pAPI, resetOnly);
 	if (resetOnly)
 	{
-		disconnectDevices(pAPI);
+		std::vector<SynapticsDeviceInfo> devices = findWantedDevices(pAPI);
+		for (size_t i = 0; i < devices.size(); ++i)
+			if (openDevice(pAPI, devices[i].handle, true))
+				closeDevice(devices[i].handle);
 		pAPI->Release();
 		exit(0);
 	}
 
-	SynPacket Packet;
-    bool deviceOldMiddleClick = FALSE;
+	SynapticsCoreOptions options;
+	options.normalMode = NORMAL_MODE;
+	options.clickTimeoutNs = GetDoubleClickTime() / 2 * 1000000ULL;
+	options.masks.middle = SF_ButtonMiddle;
+	options.masks.touchPadMiddle = SF_ButtonExtended3;
+
+	SynKitPacketSource source;
+	SendInputOutput output;
+	SynapticsPacketCore core(source, output, options);
+	reconnectDevices(pAPI, core);
+
+	std::vector<HANDLE> waitHandles;
 	while (true)
 	{
-		DWORD res = MsgWaitForMultipleObjects(connectedDeviceCount + 1, hEvents, FALSE, INFINITE, QS_ALLINPUT);
+		waitHandles.assign(1, apiEvent);
+		for (size_t i = 0; i < openedDevices.size(); ++i)
+			waitHandles.push_back(openedDevices[i].event);
+
+		// Sleep until input or the core's next deadline, whichever comes first
+		DWORD timeout = INFINITE;
+		uint64_t deadline = core.GetNextDeadline();
+		if (deadline != UINT64_MAX)
+		{
+			uint64_t now = nowNanoseconds();
+			timeout = deadline <= now ? 0 : (DWORD)((deadline - now + 999999) / 1000000);
+		}
+
+		DWORD count = (DWORD)waitHandles.size();
+		DWORD res = MsgWaitForMultipleObjects(count, waitHandles.data(), FALSE, timeout, QS_ALLINPUT);
 		if (res == WAIT_OBJECT_0)
 		{
 			listDevices(pAPI);
-			disconnectDevices(pAPI);
-			connectDevices(pAPI);
+			reconnectDevices(pAPI, core);
 		}
-		else if (res <= WAIT_OBJECT_0 + connectedDeviceCount)
+		else if (res > WAIT_OBJECT_0 && res < WAIT_OBJECT_0 + count)
 		{
-			int devNum = res - WAIT_OBJECT_0 - 1;
-			while (deviceStates[devNum].device->LoadPacket(Packet) != SYNE_FAIL)
-			{
-				bool deviceMiddleClick = FALSE;
-				if (deviceStates[devNum].deviceType == SE_DeviceTouchPad)
-                {
-					deviceMiddleClick = (Packet.ButtonState() & SF_ButtonExtended3) == SF_ButtonExtended3;
-				}
-				else
-                {
-					deviceMiddleClick = (Packet.ButtonState() & SF_ButtonMiddle) == SF_ButtonMiddle;
-				}
-
-#if defined(_DEBUG) && !defined(DISABLE_ALL_EVENTS)
-				__time64_t ltime;
-				_time64( &ltime );
-
-
-				if (deviceStates[devNum].deviceType == SE_DeviceTouchPad)
-                {
-					if (!DELTA_DEBUG || (DELTA_DEBUG && !!deviceMiddleClick != !!deviceStates[devNum].isMiddleClicked))
-					printf("Packet: device %d, state %x, deviceIsM: %d, isM: %d, %s", devNum, Packet.ButtonState(), deviceMiddleClick, deviceStates[devNum].isMiddleClicked, _ctime64(&ltime));
-				}
-				else
-                {
-					if (!DELTA_DEBUG || (DELTA_DEBUG && !!deviceMiddleClick != !!deviceStates[devNum].isMiddleClicked))
-					printf("Packet: device %d, state %x, xyz %d %d %d, deviceIsM: %d, isM: %d, %s", devNum, Packet.ButtonState(), Packet.XDelta(),
-						Packet.YDelta(), Packet.ZDelta(), deviceMiddleClick, deviceStates[devNum].isMiddleClicked, _ctime64(&ltime));
-				}
-#endif
-				if ((!deviceStates[devNum].isMiddleClicked) && deviceMiddleClick)
-				{
-					deviceStates[devNum].isMiddleClicked = TRUE;
-					deviceStates[devNum].middleClickTimeout = GetTickCount64() + GetDoubleClickTime() / 2;
-					if (NORMAL_MODE)
-					{
-						sendMiddleMouse(devNum, true);
-					}
-					else
-					{
-#ifdef _DEBUG
-						__time64_t ltime;
-						_time64( &ltime );
-						printf("Middle click started: device %d, %s", devNum, _ctime64( &ltime ) );
-#endif
-					}
-				}
-
-				if (deviceStates[devNum].isMiddleClicked && !deviceMiddleClick)
-				{
-					deviceStates[devNum].isMiddleClicked = FALSE;
-					if (NORMAL_MODE)
-					{
-						sendMiddleMouse(devNum, false);
-					}
-					else
-					{
-						if (deviceStates[devNum].middleClickTimeout > GetTickCount64() && false)
-						{
-							Sleep(50);
-							sendMiddleMouse(devNum, true);
-							Sleep(50);
-							sendMiddleMouse(devNum, false);
-#ifdef _DEBUG
-							__time64_t ltime;
-							_time64( &ltime );
-							printf("Middle click finished: device %d, %s", devNum, _ctime64( &ltime ) );
-#endif
-						}
-						else
-						{
-#ifdef _DEBUG
-							__time64_t ltime;
-							_time64( &ltime );
-							printf("Middle click timeouted: device %d, %s", devNum, _ctime64( &ltime ) );
-#endif
-						}
-					}
-				}
-			}
+			core.ProcessDevice(openedDevices[res - WAIT_OBJECT_0 - 1].handle, nowNanoseconds());
 		}
-		else if (res == WAIT_OBJECT_0 + connectedDeviceCount + 1)
+		else if (res == WAIT_OBJECT_0 + count)
 		{
 			MSG msg;
 			while (PeekMessage(&msg, NULL, 0, 0, PM_REMOVE)) {
@@ -416,11 +417,15 @@ int WINAPI WinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance, LPSTR lpCmdLine
 				DispatchMessage(&msg);
 			}
 		}
-		else
-			return FALSE;
+		else if (res != WAIT_TIMEOUT)
+			break;
+
+		core.Advance(nowNanoseconds());
 	}
 
-	disconnectDevices(pAPI);
+	while (!openedDevices.empty())
+		closeDevice(openedDevices.back().handle);
+	CloseHandle(apiEvent);
 	pAPI->Release();
 
 	return 0;
@@ -0,0 +1,52 @@
+#ifndef TPMIDDLE_HANDLE_ALLOCATOR_H
+#define TPMIDDLE_HANDLE_ALLOCATOR_H
+
+#include <cstdint>
+#include <vector>
+
+namespace TPMiddle {
+namespace Utils {
+
+/**
+ * @brief Hands out small integer handles and reuses released ones
+ *
+ * Handles stay dense, so they can index a flat table directly. Not thread
+ * safe; the owner decides which thread allocates.
+ */
+class HandleAllocator {
+public:
+    HandleAllocator() : m_next(0) {}
+
+    /**
+     * @brief Get an unused handle, preferring the most recently released one
+     */
+    uint32_t Acquire() {
+        if (!m_free.empty()) {
+            uint32_t handle = m_free.back();
+            m_free.pop_back();
+            return handle;
+        }
+        return m_next++;
+    }
+
+    /**
+     * @brief Return a handle obtained from Acquire()
+     */
+    void Release(uint32_t handle) {
+        m_free.push_back(handle);
+    }
+
+    /**
+     * @brief Number of handles in use
+     */
+    size_t GetActiveCount() const { return m_next - m_free.size(); }
+
+private:
+    uint32_t m_next;
+    std::vector<uint32_t> m_free;
+};
+
+} // namespace Utils
+} // namespace TPMiddle
+
+#endif // TPMIDDLE_HANDLE_ALLOCATOR_H
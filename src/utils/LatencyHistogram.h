@@ -0,0 +1,149 @@
+#ifndef TPMIDDLE_LATENCY_HISTOGRAM_H
+#define TPMIDDLE_LATENCY_HISTOGRAM_H
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace TPMiddle {
+namespace Utils {
+
+/**
+ * @brief Log-linear bucket layout shared by LatencyHistogram and its snapshots
+ *
+ * Values below 16 get exact buckets; above that every power of two is split
+ * into 16 linear sub-buckets, so a bucket is never wider than 1/16 (~6%) of
+ * its lower bound. Values up to 2^40 ns (about 18 minutes) are tracked;
+ * anything larger lands in the last bucket.
+ */
+struct LatencyBuckets {
+    static constexpr unsigned kSubBucketBits = 4;
+    static constexpr uint64_t kSubBucketCount = 1ULL << kSubBucketBits;
+    static constexpr unsigned kMaxValueBits = 40;
+    static constexpr size_t kBucketCount = (kMaxValueBits - kSubBucketBits + 1) * kSubBucketCount;
+
+    static size_t IndexOf(uint64_t value) {
+        if (value < kSubBucketCount) {
+            return static_cast<size_t>(value);
+        }
+        unsigned msb = 63u - static_cast<unsigned>(__builtin_clzll(value));
+        if (msb >= kMaxValueBits) {
+            return kBucketCount - 1;
+        }
+        unsigned exponent = msb - kSubBucketBits + 1;
+        uint64_t subBucket = (value >> (exponent - 1)) & (kSubBucketCount - 1);
+        return static_cast<size_t>(exponent * kSubBucketCount + subBucket);
+    }
+
+    static uint64_t LowerBound(size_t index) {
+        uint64_t exponent = index / kSubBucketCount;
+        uint64_t subBucket = index % kSubBucketCount;
+        if (exponent == 0) {
+            return subBucket;
+        }
+        return (kSubBucketCount + subBucket) << (exponent - 1);
+    }
+
+    static uint64_t UpperBound(size_t index) {
+        uint64_t exponent = index / kSubBucketCount;
+        uint64_t width = exponent == 0 ? 1 : (1ULL << (exponent - 1));
+        return LowerBound(index) + width - 1;
+    }
+};
+
+/**
+ * @brief Plain copy of a LatencyHistogram taken at one point in time
+ */
+struct LatencyHistogramSnapshot {
+    std::array<uint64_t, LatencyBuckets::kBucketCount> buckets{};
+    uint64_t count = 0;
+    uint64_t sum = 0;
+    uint64_t max = 0;
+
+    double Mean() const { return count ? static_cast<double>(sum) / static_cast<double>(count) : 0.0; }
+
+    /**
+     * @brief Value at or below which the given fraction of samples fall
+     * @param quantile Fraction in [0, 1], e.g. 0.99 for p99
+     * @return uint64_t Upper bound of the matching bucket, capped at the recorded max
+     */
+    uint64_t Percentile(double quantile) const {
+        if (count == 0) {
+            return 0;
+        }
+        uint64_t rank = static_cast<uint64_t>(quantile * static_cast<double>(count) + 0.5);
+        if (rank == 0) rank = 1;
+        if (rank > count) rank = count;
+
+        uint64_t seen = 0;
+        for (size_t i = 0; i < buckets.size(); ++i) {
+            seen += buckets[i];
+            if (seen >= rank) {
+                uint64_t upper = LatencyBuckets::UpperBound(i);
+                return upper < max ? upper : max;
+            }
+        }
+        return max;
+    }
+};
+
+/**
+ * @brief Lock-free latency histogram with HDR-style log-linear buckets
+ *
+ * Record() is a handful of relaxed atomic adds with no allocation, so it is
+ * cheap enough to stay enabled in release builds and may be called from any
+ * thread. Snapshot() can run concurrently with writers; the copy is not an
+ * atomic cut across buckets, which is acceptable for monitoring.
+ */
+class LatencyHistogram {
+public:
+    LatencyHistogram() { Reset(); }
+
+    LatencyHistogram(const LatencyHistogram&) = delete;
+    LatencyHistogram& operator=(const LatencyHistogram&) = delete;
+
+    void Record(uint64_t value) {
+        m_buckets[LatencyBuckets::IndexOf(value)].fetch_add(1, std::memory_order_relaxed);
+        m_count.fetch_add(1, std::memory_order_relaxed);
+        m_sum.fetch_add(value, std::memory_order_relaxed);
+
+        uint64_t currentMax = m_max.load(std::memory_order_relaxed);
+        while (value > currentMax &&
+               !m_max.compare_exchange_weak(currentMax, value, std::memory_order_relaxed)) {
+        }
+    }
+
+    LatencyHistogramSnapshot Snapshot() const {
+        LatencyHistogramSnapshot snapshot;
+        for (size_t i = 0; i < m_buckets.size(); ++i) {
+            snapshot.buckets[i] = m_buckets[i].load(std::memory_order_relaxed);
+            snapshot.count += snapshot.buckets[i];
+        }
+        snapshot.sum = m_sum.load(std::memory_order_relaxed);
+        snapshot.max = m_max.load(std::memory_order_relaxed);
+        return snapshot;
+    }
+
+    uint64_t GetCount() const { return m_count.load(std::memory_order_relaxed); }
+
+    void Reset() {
+        for (auto& bucket : m_buckets) {
+            bucket.store(0, std::memory_order_relaxed);
+        }
+        m_count.store(0, std::memory_order_relaxed);
+        m_sum.store(0, std::memory_order_relaxed);
+        m_max.store(0, std::memory_order_relaxed);
+    }
+
+private:
+    std::array<std::atomic<uint64_t>, LatencyBuckets::kBucketCount> m_buckets;
+    std::atomic<uint64_t> m_count;
+    std::atomic<uint64_t> m_sum;
+    std::atomic<uint64_t> m_max;
+};
+
+} // namespace Utils
+} // namespace TPMiddle
+
+#endif // TPMIDDLE_LATENCY_HISTOGRAM_H
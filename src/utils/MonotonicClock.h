@@ -0,0 +1,93 @@
+#ifndef TPMIDDLE_MONOTONIC_CLOCK_H
+#define TPMIDDLE_MONOTONIC_CLOCK_H
+
+#include <chrono>
+#include <cstdint>
+#if defined(__APPLE__)
+#include <mach/mach_time.h>
+#elif defined(__linux__)
+#include <time.h>
+#endif
+
+namespace TPMiddle {
+namespace Utils {
+
+/**
+ * @brief The one time base for input timestamps, deadlines and measurements
+ *
+ * Nanoseconds on the clock the platform stamps input with, so a device's
+ * sample time and the time it is processed can be compared directly:
+ * - macOS: mach_absolute_time(), the host tick clock of IOHIDValueGetTimeStamp()
+ *   and IOHID report timestamps, converted with a timebase read once
+ * - Linux: CLOCK_MONOTONIC, which evdev uses for input_event times once the
+ *   device is switched to it with EVIOCSCLOCKID
+ * - elsewhere: std::chrono::steady_clock
+ *
+ * Code that decides on time takes a MonotonicClock (or its Source) so
+ * tests can substitute a fake clock.
+ */
+class MonotonicClock {
+public:
+    using Source = uint64_t (*)();
+
+    /**
+     * @param source Replacement time source; null selects the system clock
+     */
+    explicit MonotonicClock(Source source = nullptr) : m_source(source ? source : &SystemNanoseconds) {}
+
+    uint64_t Now() const { return m_source(); }
+    Source GetSource() const { return m_source; }
+
+    static uint64_t SystemNanoseconds() {
+#if defined(__APPLE__)
+        return HostTicksToNanoseconds(mach_absolute_time());
+#elif defined(__linux__)
+        struct timespec now;
+        clock_gettime(CLOCK_MONOTONIC, &now);
+        return static_cast<uint64_t>(now.tv_sec) * 1000000000ULL + static_cast<uint64_t>(now.tv_nsec);
+#else
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count());
+#endif
+    }
+
+    /**
+     * @brief Convert a hardware timestamp in host ticks to clock nanoseconds
+     *
+     * Host ticks are nanoseconds everywhere but macOS, where the ratio
+     * differs per CPU (1:1 on Intel, 125:3 on Apple silicon).
+     */
+    static uint64_t HostTicksToNanoseconds(uint64_t ticks) {
+#if defined(__APPLE__)
+        static const mach_timebase_info_data_t timebase = [] {
+            mach_timebase_info_data_t info;
+            mach_timebase_info(&info);
+            return info;
+        }();
+        if (timebase.numer == timebase.denom) {
+            return ticks;
+        }
+        // Quotient and remainder apart so the multiply cannot overflow
+        uint64_t whole = ticks / timebase.denom;
+        uint64_t remainder = ticks % timebase.denom;
+        return whole * timebase.numer + remainder * timebase.numer / timebase.denom;
+#else
+        return ticks;
+#endif
+    }
+
+    /**
+     * @brief Convert a timeval-style stamp (evdev input_event) to clock nanoseconds
+     */
+    static uint64_t TimevalToNanoseconds(int64_t seconds, int64_t microseconds) {
+        return static_cast<uint64_t>(seconds) * 1000000000ULL + static_cast<uint64_t>(microseconds) * 1000ULL;
+    }
+
+private:
+    Source m_source;
+};
+
+} // namespace Utils
+} // namespace TPMiddle
+
+#endif // TPMIDDLE_MONOTONIC_CLOCK_H
@@ -0,0 +1,124 @@
+#ifndef TPMIDDLE_SPSC_RING_H
+#define TPMIDDLE_SPSC_RING_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+namespace TPMiddle {
+namespace Utils {
+
+/**
+ * @brief Bounded lock-free single-producer/single-consumer ring
+ *
+ * Exactly one thread may call TryPush and exactly one (other) thread may call
+ * TryPop/PopBatch. Storage is inline, so neither side ever allocates. A push
+ * into a full ring fails immediately and is counted in GetOverflowCount().
+ *
+ * @tparam T Trivially copyable element type
+ * @tparam Capacity Number of slots, must be a power of two
+ */
+template <typename T, size_t Capacity>
+class SPSCRing {
+    static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0,
+                  "SPSCRing capacity must be a power of two");
+    static_assert(std::is_trivially_copyable<T>::value,
+                  "SPSCRing elements must be trivially copyable");
+
+public:
+    static constexpr size_t kCapacity = Capacity;
+
+    SPSCRing() : m_head(0), m_cachedTail(0), m_overflowCount(0), m_tail(0), m_cachedHead(0) {}
+
+    SPSCRing(const SPSCRing&) = delete;
+    SPSCRing& operator=(const SPSCRing&) = delete;
+
+    /**
+     * @brief Append one element (producer side)
+     * @param item The element to copy into the ring
+     * @return bool True if stored, false if the ring was full
+     */
+    bool TryPush(const T& item) {
+        const uint64_t head = m_head.load(std::memory_order_relaxed);
+        if (head - m_cachedTail >= Capacity) {
+            m_cachedTail = m_tail.load(std::memory_order_acquire);
+            if (head - m_cachedTail >= Capacity) {
+                m_overflowCount.fetch_add(1, std::memory_order_relaxed);
+                return false;
+            }
+        }
+        m_slots[head & kMask] = item;
+        m_head.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief Remove one element (consumer side)
+     * @param item Receives the oldest element
+     * @return bool True if an element was returned, false if the ring was empty
+     */
+    bool TryPop(T& item) {
+        return PopBatch(&item, 1) == 1;
+    }
+
+    /**
+     * @brief Remove up to maxCount elements in one acquire/release pair (consumer side)
+     * @param items Destination array with room for maxCount elements
+     * @param maxCount Maximum number of elements to remove
+     * @return size_t Number of elements copied into items
+     */
+    size_t PopBatch(T* items, size_t maxCount) {
+        const uint64_t tail = m_tail.load(std::memory_order_relaxed);
+        if (m_cachedHead - tail < maxCount) {
+            m_cachedHead = m_head.load(std::memory_order_acquire);
+        }
+        size_t available = static_cast<size_t>(m_cachedHead - tail);
+        size_t count = available < maxCount ? available : maxCount;
+        for (size_t i = 0; i < count; ++i) {
+            items[i] = m_slots[(tail + i) & kMask];
+        }
+        if (count > 0) {
+            m_tail.store(tail + count, std::memory_order_release);
+        }
+        return count;
+    }
+
+    /**
+     * @brief Approximate number of queued elements (safe from either side)
+     */
+    size_t Size() const {
+        uint64_t head = m_head.load(std::memory_order_acquire);
+        uint64_t tail = m_tail.load(std::memory_order_acquire);
+        return static_cast<size_t>(head - tail);
+    }
+
+    bool IsEmpty() const { return Size() == 0; }
+
+    /**
+     * @brief Number of pushes rejected because the ring was full
+     */
+    uint64_t GetOverflowCount() const {
+        return m_overflowCount.load(std::memory_order_relaxed);
+    }
+
+private:
+    static constexpr size_t kMask = Capacity - 1;
+    static constexpr size_t kCacheLine = 64;
+
+    // Producer-owned line
+    alignas(kCacheLine) std::atomic<uint64_t> m_head;
+    uint64_t m_cachedTail;
+    std::atomic<uint64_t> m_overflowCount;
+
+    // Consumer-owned line
+    alignas(kCacheLine) std::atomic<uint64_t> m_tail;
+    uint64_t m_cachedHead;
+
+    alignas(kCacheLine) T m_slots[Capacity];
+};
+
+} // namespace Utils
+} // namespace TPMiddle
+
+#endif // TPMIDDLE_SPSC_RING_H
@@ -0,0 +1,209 @@
+#ifndef TPMIDDLE_SNAPSHOT_CELL_H
+#define TPMIDDLE_SNAPSHOT_CELL_H
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+namespace TPMiddle {
+namespace Utils {
+
+/**
+ * @brief Single immutable value published to readers by atomic pointer swap
+ *
+ * Publish() copies the value into a new node and swaps it in under a writer
+ * mutex. Readers hold a Reader, which protects the node it last returned with
+ * a hazard slot; while nothing has been published since, Get() is a single
+ * acquire load and a compare. Replaced nodes are freed by a later Publish()
+ * once no slot points at them.
+ *
+ * @tparam T Copyable value type
+ * @tparam MaxReaders Hazard slots; further Readers fall back to copying under the mutex
+ */
+template <typename T, size_t MaxReaders = 8>
+class SnapshotCell {
+    struct Node {
+        T value;
+        uint64_t version;
+    };
+
+public:
+    static constexpr size_t kMaxReaders = MaxReaders;
+
+    /**
+     * @brief Per-thread lock-free read access
+     *
+     * Construct one per reading thread and keep it. A Reader is not thread
+     * safe itself and must not outlive its cell.
+     */
+    class Reader {
+    public:
+        explicit Reader(SnapshotCell& cell) : m_cell(cell), m_slot(nullptr), m_held(nullptr) {
+            for (size_t i = 0; i < kMaxReaders; ++i) {
+                bool expected = false;
+                if (cell.m_slotInUse[i].compare_exchange_strong(expected, true)) {
+                    m_slot = &cell.m_hazards[i];
+                    break;
+                }
+            }
+        }
+
+        ~Reader() {
+            if (m_slot) {
+                m_slot->store(nullptr);
+                m_cell.m_slotInUse[static_cast<size_t>(m_slot - m_cell.m_hazards)].store(false);
+            }
+        }
+
+        Reader(const Reader&) = delete;
+        Reader& operator=(const Reader&) = delete;
+
+        /**
+         * @brief Get the current value
+         * @return const T& Valid until the next call or until the Reader is destroyed
+         */
+        const T& Get() {
+            const Node* node = m_cell.m_current.load(std::memory_order_acquire);
+            if (node == m_held) {
+                return node->value;
+            }
+            if (!m_slot) {
+                std::lock_guard<std::mutex> lock(m_cell.m_writeMutex);
+                m_fallback.reset(new Node(*m_cell.m_current.load()));
+                m_held = nullptr;
+                return m_fallback->value;
+            }
+
+            // Publish the hazard, then confirm the node was not replaced (and
+            // possibly reclaimed) before the writer could see it
+            for (;;) {
+                m_slot->store(node);
+                const Node* current = m_cell.m_current.load();
+                if (current == node) {
+                    m_held = node;
+                    return node->value;
+                }
+                node = current;
+            }
+        }
+
+        /**
+         * @brief Version of the value last returned by Get(), 0 before the first call
+         */
+        uint64_t GetVersion() const {
+            return m_held ? m_held->version : (m_fallback ? m_fallback->version : 0);
+        }
+
+        /**
+         * @brief False if every hazard slot was taken; Get() then copies under the writer mutex
+         */
+        bool IsLockFree() const { return m_slot != nullptr; }
+
+    private:
+        SnapshotCell& m_cell;
+        std::atomic<const Node*>* m_slot;
+        const Node* m_held;
+        std::unique_ptr<Node> m_fallback;
+    };
+
+    explicit SnapshotCell(const T& initial = T()) : m_current(new Node{initial, 1}) {
+        for (size_t i = 0; i < kMaxReaders; ++i) {
+            m_slotInUse[i].store(false);
+            m_hazards[i].store(nullptr);
+        }
+    }
+
+    ~SnapshotCell() {
+        delete m_current.load();
+        for (const Node* node : m_retired) {
+            delete node;
+        }
+    }
+
+    SnapshotCell(const SnapshotCell&) = delete;
+    SnapshotCell& operator=(const SnapshotCell&) = delete;
+
+    /**
+     * @brief Replace the value seen by readers
+     * @return uint64_t Version of the new value
+     */
+    uint64_t Publish(const T& value) {
+        std::lock_guard<std::mutex> lock(m_writeMutex);
+        uint64_t version = m_current.load()->version + 1;
+        m_retired.push_back(m_current.exchange(new Node{value, version}));
+        ReclaimRetired();
+        return version;
+    }
+
+    uint64_t Publish(T&& value) {
+        std::lock_guard<std::mutex> lock(m_writeMutex);
+        uint64_t version = m_current.load()->version + 1;
+        m_retired.push_back(m_current.exchange(new Node{std::move(value), version}));
+        ReclaimRetired();
+        return version;
+    }
+
+    /**
+     * @brief Call function with the current value under the writer mutex, for cold paths
+     *
+     * Nothing can be published meanwhile, so the value stays valid for the call.
+     */
+    template <typename Function>
+    auto Read(Function&& function) const {
+        std::lock_guard<std::mutex> lock(m_writeMutex);
+        return function(static_cast<const T&>(m_current.load()->value));
+    }
+
+    /**
+     * @brief Copy of the current value, for cold paths
+     */
+    T Copy() const {
+        return Read([](const T& value) { return value; });
+    }
+
+    uint64_t GetVersion() const {
+        std::lock_guard<std::mutex> lock(m_writeMutex);
+        return m_current.load()->version;
+    }
+
+    /**
+     * @brief Values replaced but not yet freed because a reader may hold them
+     */
+    size_t GetRetiredCount() {
+        std::lock_guard<std::mutex> lock(m_writeMutex);
+        ReclaimRetired();
+        return m_retired.size();
+    }
+
+private:
+    mutable std::mutex m_writeMutex;
+    std::atomic<const Node*> m_current;
+    std::vector<const Node*> m_retired;     // Guarded by m_writeMutex
+    std::atomic<bool> m_slotInUse[kMaxReaders];
+    std::atomic<const Node*> m_hazards[kMaxReaders];
+
+    void ReclaimRetired() {
+        const Node* protectedNodes[kMaxReaders];
+        for (size_t i = 0; i < kMaxReaders; ++i) {
+            protectedNodes[i] = m_hazards[i].load();
+        }
+        auto isProtected = [&protectedNodes](const Node* node) {
+            return std::find(protectedNodes, protectedNodes + kMaxReaders, node) != protectedNodes + kMaxReaders;
+        };
+        auto kept = std::stable_partition(m_retired.begin(), m_retired.end(), isProtected);
+        for (auto it = kept; it != m_retired.end(); ++it) {
+            delete *it;
+        }
+        m_retired.erase(kept, m_retired.end());
+    }
+};
+
+} // namespace Utils
+} // namespace TPMiddle
+
+#endif // TPMIDDLE_SNAPSHOT_CELL_H
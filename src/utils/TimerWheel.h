@@ -0,0 +1,218 @@
+#ifndef TPMIDDLE_TIMER_WHEEL_H
+#define TPMIDDLE_TIMER_WHEEL_H
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+
+namespace TPMiddle {
+namespace Utils {
+
+/**
+ * @brief Timer owned by its user and linked into a TimerWheel while armed
+ *
+ * Callback receives the context and the exact deadline the timer was
+ * scheduled for, which is not the time Advance() happened to run.
+ */
+struct WheelTimer {
+    using Callback = void (*)(void* context, uint64_t deadlineNs);
+
+    WheelTimer(Callback callback = nullptr, void* context = nullptr)
+        : callback(callback), context(context) {}
+
+    WheelTimer(const WheelTimer&) = delete;
+    WheelTimer& operator=(const WheelTimer&) = delete;
+
+    bool IsArmed() const { return armed; }
+    uint64_t GetDeadline() const { return deadline; }
+
+    Callback callback;
+    void* context;
+
+private:
+    template <size_t> friend class TimerWheel;
+    uint64_t deadline = 0;
+    uint64_t tick = 0;          // Slot tick, never earlier than the wheel's cursor
+    WheelTimer* next = nullptr;
+    WheelTimer* prev = nullptr;
+    bool armed = false;
+};
+
+/**
+ * @brief Hashed timer wheel over an injected monotonic clock
+ *
+ * Timers hash into Slots buckets by deadline tick, so Schedule() and Cancel()
+ * are O(1) and allocation free. Advance() fires every timer whose deadline
+ * has passed, in deadline order, and is a single compare while nothing is
+ * due. A timer more than one rotation away simply stays in its bucket until
+ * its own tick comes round. Not thread safe.
+ *
+ * @tparam Slots Number of buckets, must be a power of two
+ */
+template <size_t Slots = 256>
+class TimerWheel {
+    static_assert(Slots >= 2 && (Slots & (Slots - 1)) == 0, "TimerWheel slot count must be a power of two");
+
+public:
+    static constexpr uint64_t kNever = std::numeric_limits<uint64_t>::max();
+
+    /**
+     * @param tickNs Bucket width; deadlines stay exact, this only sets the hashing granularity
+     * @param nowNs Current time
+     */
+    explicit TimerWheel(uint64_t tickNs = 1000000ULL, uint64_t nowNs = 0)
+        : m_tickNs(tickNs ? tickNs : 1)
+        , m_cursor(nowNs / m_tickNs)
+        , m_count(0)
+        , m_nextDeadline(kNever)
+        , m_nextDirty(false) {
+        for (size_t i = 0; i < Slots; ++i) {
+            m_slots[i] = nullptr;
+        }
+    }
+
+    ~TimerWheel() { Clear(); }
+
+    TimerWheel(const TimerWheel&) = delete;
+    TimerWheel& operator=(const TimerWheel&) = delete;
+
+    /**
+     * @brief Arm a timer, rescheduling it if already armed
+     * @param deadlineNs May be in the past, in which case the next Advance() fires it
+     */
+    void Schedule(WheelTimer& timer, uint64_t deadlineNs) {
+        if (timer.armed) {
+            Unlink(timer);
+        }
+        uint64_t tick = deadlineNs / m_tickNs;
+        timer.deadline = deadlineNs;
+        timer.tick = tick > m_cursor ? tick : m_cursor;
+        WheelTimer*& head = m_slots[timer.tick & kMask];
+        timer.prev = nullptr;
+        timer.next = head;
+        if (head) {
+            head->prev = &timer;
+        }
+        head = &timer;
+        timer.armed = true;
+        ++m_count;
+        if (!m_nextDirty && deadlineNs < m_nextDeadline) {
+            m_nextDeadline = deadlineNs;
+        }
+    }
+
+    void Cancel(WheelTimer& timer) {
+        if (timer.armed) {
+            Unlink(timer);
+        }
+    }
+
+    /**
+     * @brief Fire every timer due at nowNs
+     * @return size_t Number of timers fired
+     *
+     * Callbacks may schedule or cancel timers, including the one firing.
+     */
+    size_t Advance(uint64_t nowNs) {
+        size_t fired = 0;
+        while (GetNextDeadline() <= nowNs) {
+            WheelTimer* timer = FindEarliest();
+            m_cursor = timer->tick;
+            Unlink(*timer);
+            ++fired;
+            if (timer->callback) {
+                timer->callback(timer->context, timer->deadline);
+            }
+        }
+        // Everything still armed is due after nowNs, so its tick is not behind this one
+        uint64_t tick = nowNs / m_tickNs;
+        if (tick > m_cursor) {
+            m_cursor = tick;
+        }
+        return fired;
+    }
+
+    /**
+     * @brief Earliest armed deadline, kNever if none
+     */
+    uint64_t GetNextDeadline() {
+        if (m_nextDirty) {
+            WheelTimer* earliest = FindEarliest();
+            m_nextDeadline = earliest ? earliest->deadline : kNever;
+            m_nextDirty = false;
+        }
+        return m_nextDeadline;
+    }
+
+    size_t GetArmedCount() const { return m_count; }
+
+    void Clear() {
+        for (size_t i = 0; i < Slots; ++i) {
+            while (m_slots[i]) {
+                Unlink(*m_slots[i]);
+            }
+        }
+    }
+
+private:
+    static constexpr uint64_t kMask = Slots - 1;
+
+    uint64_t m_tickNs;
+    uint64_t m_cursor;          // Tick of the last Advance(); no armed timer has an earlier tick
+    size_t m_count;
+    uint64_t m_nextDeadline;
+    bool m_nextDirty;
+    WheelTimer* m_slots[Slots];
+
+    void Unlink(WheelTimer& timer) {
+        if (timer.prev) {
+            timer.prev->next = timer.next;
+        } else {
+            m_slots[timer.tick & kMask] = timer.next;
+        }
+        if (timer.next) {
+            timer.next->prev = timer.prev;
+        }
+        timer.next = nullptr;
+        timer.prev = nullptr;
+        timer.armed = false;
+        --m_count;
+        if (timer.deadline == m_nextDeadline) {
+            m_nextDirty = true;
+        }
+    }
+
+    // Walk one rotation from the cursor: the first bucket holding a timer for
+    // that very tick holds the earliest deadline. Only timers a rotation or
+    // more away need the full scan.
+    WheelTimer* FindEarliest() const {
+        if (m_count == 0) {
+            return nullptr;
+        }
+        for (uint64_t tick = m_cursor; tick < m_cursor + Slots; ++tick) {
+            WheelTimer* best = nullptr;
+            for (WheelTimer* timer = m_slots[tick & kMask]; timer; timer = timer->next) {
+                if (timer->tick == tick && (!best || timer->deadline < best->deadline)) {
+                    best = timer;
+                }
+            }
+            if (best) {
+                return best;
+            }
+        }
+        WheelTimer* best = nullptr;
+        for (size_t i = 0; i < Slots; ++i) {
+            for (WheelTimer* timer = m_slots[i]; timer; timer = timer->next) {
+                if (!best || timer->deadline < best->deadline) {
+                    best = timer;
+                }
+            }
+        }
+        return best;
+    }
+};
+
+} // namespace Utils
+} // namespace TPMiddle
+
+#endif // TPMIDDLE_TIMER_WHEEL_H
@@ -0,0 +1,66 @@
+#include "../support/BenchHarness.h"
+#include "../../src/domain/services/AccelerationCurve.h"
+#include <cmath>
+#include <vector>
+
+using namespace TPMiddle::Domain;
+using TPMiddle::Testing::DoNotOptimize;
+
+namespace {
+
+const size_t kTraceLength = 4096;
+
+struct Trace {
+    std::vector<int16_t> deltaX;
+    std::vector<int16_t> deltaY;
+
+    Trace() : deltaX(kTraceLength), deltaY(kTraceLength) {
+        // Mostly slow TrackPoint motion with occasional fast flicks
+        uint32_t seed = 12345;
+        for (size_t i = 0; i < kTraceLength; ++i) {
+            seed = seed * 1664525u + 1013904223u;
+            int range = (seed >> 28) == 0 ? 120 : 12;
+            deltaX[i] = static_cast<int16_t>(static_cast<int>((seed >> 8) % (2 * range + 1)) - range);
+            deltaY[i] = static_cast<int16_t>(static_cast<int>((seed >> 16) % (2 * range + 1)) - range);
+        }
+    }
+};
+
+const Trace& SharedTrace() {
+    static const Trace trace;
+    return trace;
+}
+
+} // namespace
+
+TP_BENCH(benchAccelerationFormulaSqrt) {
+    const Trace& trace = SharedTrace();
+    for (uint64_t i = 0; i < iterations; ++i) {
+        size_t j = i & (kTraceLength - 1);
+        double dx = trace.deltaX[j];
+        double dy = trace.deltaY[j];
+        DoNotOptimize(std::sqrt(dx * dx + dy * dy));
+    }
+}
+
+TP_BENCH(benchAccelerationCurveLookup) {
+    const Trace& trace = SharedTrace();
+    AccelerationCurve curve;
+    curve.Parse("bezier:4,0;8,30;64,40");
+    for (uint64_t i = 0; i < iterations; ++i) {
+        size_t j = i & (kTraceLength - 1);
+        DoNotOptimize(curve.Evaluate(trace.deltaX[j], trace.deltaY[j]));
+    }
+}
+
+// Reported per sample: each iteration evaluates one sample of a batched trace
+TP_BENCH(benchAccelerationCurveBatch) {
+    const Trace& trace = SharedTrace();
+    AccelerationCurve curve;
+    curve.Parse("bezier:4,0;8,30;64,40");
+    std::vector<float> values(kTraceLength);
+    for (uint64_t done = 0; done < iterations; done += kTraceLength) {
+        curve.EvaluateBatch(trace.deltaX.data(), trace.deltaY.data(), kTraceLength, values.data());
+        DoNotOptimize(values[done & (kTraceLength - 1)]);
+    }
+}
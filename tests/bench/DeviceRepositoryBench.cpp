@@ -0,0 +1,83 @@
+#include "../support/BenchHarness.h"
+#include "../../src/infrastructure/persistence/InMemoryDeviceRepository.h"
+#include <atomic>
+#include <string>
+#include <thread>
+
+using namespace TPMiddle::Domain;
+using namespace TPMiddle::Infrastructure;
+using TPMiddle::Testing::DoNotOptimize;
+
+namespace {
+
+class BenchDevice : public IDevice {
+public:
+    explicit BenchDevice(const std::string& id) : m_id(id) {}
+
+    std::string GetId() const override { return m_id; }
+    std::string GetName() const override { return "Bench device " + m_id; }
+    bool IsConnected() const override { return true; }
+    std::string GetDeviceType() const override { return "TrackPoint"; }
+    std::string GetLastError() const override { return std::string(); }
+    bool Reset() override { return true; }
+
+private:
+    std::string m_id;
+};
+
+void Populate(InMemoryDeviceRepository& repository, int count) {
+    for (int i = 0; i < count; ++i) {
+        repository.Add(std::make_shared<BenchDevice>("device-" + std::to_string(i)));
+    }
+}
+
+} // namespace
+
+TP_BENCH(benchRepositorySnapshotFindByKey) {
+    InMemoryDeviceRepository repository;
+    Populate(repository, 8);
+    InMemoryDeviceRepository::Reader reader(repository);
+    for (uint64_t i = 0; i < iterations; ++i) {
+        const DeviceSnapshot& snapshot = reader.Snapshot();
+        DoNotOptimize(snapshot.FindByKey(static_cast<uint32_t>(i & 7))->IsConnected());
+    }
+}
+
+TP_BENCH(benchRepositorySnapshotFindById) {
+    InMemoryDeviceRepository repository;
+    Populate(repository, 8);
+    InMemoryDeviceRepository::Reader reader(repository);
+    const std::string id = "device-5";
+    for (uint64_t i = 0; i < iterations; ++i) {
+        DoNotOptimize(reader.Snapshot().FindById(id)->GetName().size());
+    }
+}
+
+TP_BENCH(benchRepositoryLockedFindById) {
+    InMemoryDeviceRepository repository;
+    Populate(repository, 8);
+    const std::string id = "device-5";
+    for (uint64_t i = 0; i < iterations; ++i) {
+        DoNotOptimize((*repository.FindById(id))->GetName().size());
+    }
+}
+
+TP_BENCH(benchRepositorySnapshotFindByKeyDuringHotplug) {
+    InMemoryDeviceRepository repository;
+    Populate(repository, 8);
+    std::atomic<bool> stop(false);
+    std::thread writer([&]() {
+        for (int i = 0; !stop.load(std::memory_order_relaxed); ++i) {
+            std::string id = "hotplug-" + std::to_string(i & 1);
+            repository.Add(std::make_shared<BenchDevice>(id));
+            repository.Remove(id);
+        }
+    });
+
+    InMemoryDeviceRepository::Reader reader(repository);
+    for (uint64_t i = 0; i < iterations; ++i) {
+        DoNotOptimize(reader.Snapshot().FindByKey(static_cast<uint32_t>(i & 7)));
+    }
+    stop.store(true);
+    writer.join();
+}
@@ -0,0 +1,70 @@
+#include "../support/BenchHarness.h"
+#include "../../src/domain/models/HIDUsage.h"
+#include "../../src/infrastructure/hid/ElementDispatchTable.h"
+#include <vector>
+
+using namespace TPMiddle::Domain;
+using namespace TPMiddle::Infrastructure;
+using TPMiddle::Testing::DoNotOptimize;
+
+namespace {
+
+// A composite TrackPoint keyboard: 100 keys, then the pointer elements
+std::vector<HIDElementInfo> CompositeElements() {
+    std::vector<HIDElementInfo> elements;
+    uint32_t cookie = 2;
+    for (uint16_t key = 0x04; key < 0x68; ++key) {
+        elements.push_back({cookie++, 0x07, key, 0, 1});
+    }
+    elements.push_back({cookie++, HIDUsage::kPageButton, HIDUsage::kButtonLeft, 0, 1});
+    elements.push_back({cookie++, HIDUsage::kPageButton, HIDUsage::kButtonRight, 0, 1});
+    elements.push_back({cookie++, HIDUsage::kPageButton, HIDUsage::kButtonMiddle, 0, 1});
+    elements.push_back({cookie++, HIDUsage::kPageGenericDesktop, HIDUsage::kX, -127, 127});
+    elements.push_back({cookie++, HIDUsage::kPageGenericDesktop, HIDUsage::kY, -127, 127});
+    elements.push_back({cookie++, HIDUsage::kPageGenericDesktop, HIDUsage::kWheel, -127, 127});
+    return elements;
+}
+
+// Cookies of a value stream that is mostly X/Y with occasional buttons
+uint32_t StreamCookie(const std::vector<HIDElementInfo>& elements, uint64_t i) {
+    size_t pointer = elements.size() - 6;
+    return elements[pointer + ((i & 15) == 0 ? (i >> 4) % 3 : 3 + (i & 1))].cookie;
+}
+
+} // namespace
+
+TP_BENCH(benchElementDispatchTableLookup) {
+    std::vector<HIDElementInfo> elements = CompositeElements();
+    ElementDispatchTable table;
+    table.Build(elements.data(), elements.size(), HIDElementFilter::Pointer());
+    for (uint64_t i = 0; i < iterations; ++i) {
+        const ElementDispatchSlot* slot = table.Find(StreamCookie(elements, i));
+        DoNotOptimize(slot ? slot->Clamp(static_cast<int64_t>(i & 7) - 3) : 0);
+    }
+}
+
+// Per-value element search by cookie plus the filter and usage branch
+// chain, standing in for the usage queries the table replaces
+TP_BENCH(benchElementUsageLookupAndBranch) {
+    std::vector<HIDElementInfo> elements = CompositeElements();
+    HIDElementFilter filter = HIDElementFilter::Pointer();
+    for (uint64_t i = 0; i < iterations; ++i) {
+        uint32_t cookie = StreamCookie(elements, i);
+        const HIDElementInfo* element = nullptr;
+        for (const HIDElementInfo& candidate : elements) {
+            if (candidate.cookie == cookie) {
+                element = &candidate;
+                break;
+            }
+        }
+        int handler = 0;
+        if (element && filter.Accepts(element->usagePage, element->usage)) {
+            if (element->usagePage == HIDUsage::kPageButton) {
+                handler = 1;
+            } else if (element->usagePage == HIDUsage::kPageGenericDesktop) {
+                handler = element->usage == HIDUsage::kWheel ? 3 : 2;
+            }
+        }
+        DoNotOptimize(handler);
+    }
+}
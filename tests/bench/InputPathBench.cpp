@@ -0,0 +1,148 @@
+#include "../support/BenchHarness.h"
+#include "../../src/application/services/InputConfig.h"
+#include "../../src/application/services/TraceRecorder.h"
+#include "../../src/domain/services/MiddleButtonEmulator.h"
+#include "../../src/domain/services/ScrollEngine.h"
+#include "../../src/domain/services/ScrollSynthesizer.h"
+#include "../../src/infrastructure/evdev/EvdevReportAssembler.h"
+#include "../../src/infrastructure/hid/PointerReportDecoder.h"
+#include "../../src/infrastructure/logging/BinaryLog.h"
+#include <cstdio>
+#include <cstdlib>
+#include <unistd.h>
+
+using namespace TPMiddle::Application;
+using namespace TPMiddle::Domain;
+using namespace TPMiddle::Infrastructure;
+using TPMiddle::Testing::DoNotOptimize;
+
+// One case per stage an input report passes through, in pipeline order
+
+namespace {
+
+const uint64_t kSampleIntervalNs = 1000000ULL;   // 1 kHz
+
+// Boot-protocol style mouse: 3 buttons, 5 bits padding, 8-bit X, Y, wheel
+const uint8_t kBootMouseDescriptor[] = {
+    0x05, 0x01, 0x09, 0x02, 0xA1, 0x01, 0x09, 0x01, 0xA1, 0x00,
+    0x05, 0x09, 0x19, 0x01, 0x29, 0x03, 0x15, 0x00, 0x25, 0x01,
+    0x95, 0x03, 0x75, 0x01, 0x81, 0x02, 0x95, 0x01, 0x75, 0x05,
+    0x81, 0x03, 0x05, 0x01, 0x09, 0x30, 0x09, 0x31, 0x09, 0x38,
+    0x15, 0x81, 0x25, 0x7F, 0x75, 0x08, 0x95, 0x03, 0x81, 0x06,
+    0xC0, 0xC0
+};
+
+EvdevWireEvent Wire(uint16_t type, uint16_t code, int32_t value) {
+    EvdevWireEvent event = {};
+    event.type = type;
+    event.code = code;
+    event.value = value;
+    return event;
+}
+
+} // namespace
+
+TP_BENCH(benchDecodeBootReport) {
+    HIDReportDescriptor descriptor;
+    descriptor.Parse(kBootMouseDescriptor, sizeof(kBootMouseDescriptor));
+    PointerReportDecoder decoder;
+    decoder.Build(descriptor);
+
+    uint8_t report[4] = {0, 0, 0, 0};
+    PointerSample sample;
+    for (uint64_t i = 0; i < iterations; ++i) {
+        report[0] = static_cast<uint8_t>(i & 3);
+        report[1] = static_cast<uint8_t>(i);
+        report[2] = static_cast<uint8_t>(i >> 3);
+        DoNotOptimize(decoder.Decode(report, sizeof(report), sample));
+        DoNotOptimize(sample);
+    }
+}
+
+TP_BENCH(benchAssembleEvdevFrame) {
+    EvdevReportAssembler assembler;
+    EvdevWireEvent frame[3] = {
+        Wire(Evdev::kEventRelative, Evdev::kRelativeX, 0),
+        Wire(Evdev::kEventRelative, Evdev::kRelativeY, 0),
+        Wire(Evdev::kEventSync, Evdev::kSyncReport, 0)
+    };
+    InputEvent output[1];
+    for (uint64_t i = 0; i < iterations; ++i) {
+        frame[0].value = static_cast<int32_t>(i & 7) - 3;
+        frame[1].value = static_cast<int32_t>((i >> 3) & 7) - 3;
+        DoNotOptimize(assembler.Assemble(frame, 3, output));
+    }
+}
+
+// Left and right presses alternating between chords and lone clicks
+TP_BENCH(benchChordEmulatorUpdate) {
+    MiddleButtonEmulator emulator;
+    for (uint64_t i = 0; i < iterations; ++i) {
+        unsigned phase = static_cast<unsigned>(i & 7);
+        bool left = phase == 1 || phase == 2 || phase == 5;
+        bool right = phase == 2 || phase == 3;
+        DoNotOptimize(emulator.Update(i * kSampleIntervalNs, left, right, false));
+    }
+}
+
+TP_BENCH(benchScrollAccumulate) {
+    ScrollEngine engine{ScrollSettings()};
+    ScrollSynthesizer synthesizer;
+    for (uint64_t i = 0; i < iterations; ++i) {
+        uint64_t timestamp = i * kSampleIntervalNs;
+        ScrollOutput output = engine.ProcessMovement(timestamp, static_cast<int>(i & 3) - 1, -3);
+        if (output.emit) {
+            DoNotOptimize(synthesizer.Add(timestamp, output.deltaX, output.deltaY));
+        }
+    }
+}
+
+// Producer side only; the flusher drains to a scratch file on its own thread
+TP_BENCH(benchBinaryLogPerEvent) {
+    char path[] = "/tmp/tpmiddle-bench-XXXXXX";
+    int fd = mkstemp(path);
+    if (fd < 0) {
+        return;
+    }
+    close(fd);
+
+    BinaryLog log;
+    if (log.Open(path)) {
+        for (uint64_t i = 0; i < iterations; ++i) {
+            log.LogTrackpointMovement(static_cast<int>(i & 7), -3, 0);
+        }
+        log.Close();
+    }
+    std::remove(path);
+}
+
+TP_BENCH(benchConfigSnapshotRead) {
+    InputConfigCell cell;
+    InputConfigCell::Reader reader(cell);
+    for (uint64_t i = 0; i < iterations; ++i) {
+        DoNotOptimize(reader.Get().chordWindowNs);
+    }
+}
+
+// What every instrumented stage pays while no trace is being recorded
+TP_BENCH(benchTraceSpanDisabled) {
+    TraceRecorder recorder(16);
+    for (uint64_t i = 0; i < iterations; ++i) {
+        TraceSpan span(recorder, "stage");
+        DoNotOptimize(i);
+    }
+}
+
+// Two records into the calling thread's buffer; restarted before it fills
+TP_BENCH(benchTraceSpanRecording) {
+    TraceRecorder recorder(1 << 12);
+    recorder.Start();
+    for (uint64_t i = 0; i < iterations; ++i) {
+        if ((i & 1023) == 0) {
+            recorder.Start();
+        }
+        TraceSpan span(recorder, "stage");
+        DoNotOptimize(i);
+    }
+    recorder.Stop();
+}
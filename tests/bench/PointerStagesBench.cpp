@@ -0,0 +1,128 @@
+#include "../support/BenchHarness.h"
+#include "../../src/application/services/InputPipeline.h"
+#include "../../src/application/services/StagedPipeline.h"
+#include "../../src/domain/models/HIDUsage.h"
+#include "../../src/infrastructure/hid/PointerReportDecoder.h"
+
+using namespace TPMiddle::Application;
+using namespace TPMiddle::Domain;
+using namespace TPMiddle::Infrastructure;
+using TPMiddle::Testing::DoNotOptimize;
+
+// The selected stage instantiation against the generic stages and against
+// InputPipeline, on the same 1 kHz stream; one operation is one sample.
+// Pacing and momentum are off so every case does the same work per sample.
+
+namespace {
+
+const uint64_t kSampleIntervalNs = 1000000ULL;   // 1 kHz
+
+// Boot-protocol style mouse: 3 buttons, 5 bits padding, 8-bit X, Y, wheel
+const uint8_t kBootMouseDescriptor[] = {
+    0x05, 0x01, 0x09, 0x02, 0xA1, 0x01, 0x09, 0x01, 0xA1, 0x00,
+    0x05, 0x09, 0x19, 0x01, 0x29, 0x03, 0x15, 0x00, 0x25, 0x01,
+    0x95, 0x03, 0x75, 0x01, 0x81, 0x02, 0x95, 0x01, 0x75, 0x05,
+    0x81, 0x03, 0x05, 0x01, 0x09, 0x30, 0x09, 0x31, 0x09, 0x38,
+    0x15, 0x81, 0x25, 0x7F, 0x75, 0x08, 0x95, 0x03, 0x81, 0x06,
+    0xC0, 0xC0
+};
+
+struct DiscardingOutput {
+    void PostMiddleButton(uint64_t, bool isDown) { DoNotOptimize(isDown); }
+    void PostButton(uint64_t, uint8_t buttonMask, bool) { DoNotOptimize(buttonMask); }
+    void PostScroll(uint64_t, double deltaX, double deltaY) {
+        DoNotOptimize(deltaX);
+        DoNotOptimize(deltaY);
+    }
+    void PostMotion(uint64_t, int deltaX, int deltaY) {
+        DoNotOptimize(deltaX);
+        DoNotOptimize(deltaY);
+    }
+};
+
+class DiscardingPipelineOutput : public IPipelineOutput {
+public:
+    void PostMiddleButton(uint64_t timestampNs, bool isDown) override { m_output.PostMiddleButton(timestampNs, isDown); }
+    void PostButton(uint64_t timestampNs, uint8_t buttonMask, bool isDown) override {
+        m_output.PostButton(timestampNs, buttonMask, isDown);
+    }
+    void PostScroll(uint64_t timestampNs, double deltaX, double deltaY) override {
+        m_output.PostScroll(timestampNs, deltaX, deltaY);
+    }
+    void PostMotion(uint64_t timestampNs, int deltaX, int deltaY) override {
+        m_output.PostMotion(timestampNs, deltaX, deltaY);
+    }
+
+private:
+    DiscardingOutput m_output;
+};
+
+ScrollSettings BenchSettings() {
+    ScrollSettings settings;
+    settings.frameRate = 0.0;
+    settings.momentum = false;
+    return settings;
+}
+
+// Middle-button scrolling for half of every 1024 samples, pointing otherwise
+InputEvent Sample(uint64_t i) {
+    InputEvent event = InputEvent();
+    event.type = InputEventType::Pointer;
+    event.timestamp = i * kSampleIntervalNs;
+    event.pointer.buttons = ((i >> 9) & 1) ? 0 : kButtonMaskMiddle;
+    event.pointer.deltaX = static_cast<int16_t>(static_cast<int>(i & 7) - 3);
+    event.pointer.deltaY = static_cast<int16_t>(static_cast<int>((i >> 3) & 7) - 3);
+    return event;
+}
+
+} // namespace
+
+// Every setting tested per sample and every post a virtual call
+TP_BENCH(benchPointerStagesGeneric) {
+    DiscardingPipelineOutput output;
+    PointerStageState state;
+    state.toggle.SetScrollToggleWindow(InputProcessor::kScrollTogglePressNs);
+    ScrollSettings settings = BenchSettings();
+    ScrollStageParams params = ScrollEngine::DeriveStageParams(settings);
+    void (*volatile kernel)(PointerStageState&, const ScrollStageParams&, IPipelineOutput&, const InputEvent&) =
+        &RunPointerStages<PointerEventDecode, ReplayingChord, RuntimeAcceleration, RuntimeEmit, IPipelineOutput>;
+    for (uint64_t i = 0; i < iterations; ++i) {
+        kernel(state, params, output, Sample(i));
+    }
+}
+
+TP_BENCH(benchPointerStagesSelected) {
+    DiscardingOutput output;
+    StagedPipeline<PointerEventDecode, DiscardingOutput> pipeline(output, BenchSettings());
+    for (uint64_t i = 0; i < iterations; ++i) {
+        pipeline.Process(Sample(i));
+    }
+}
+
+// Same stream through DeviceStateTable, InputProcessor and the sinks, for reference
+TP_BENCH(benchPointerStagesInputPipeline) {
+    DiscardingPipelineOutput output;
+    InputPipeline pipeline(output, BenchSettings());
+    for (uint64_t i = 0; i < iterations; ++i) {
+        pipeline.Process(Sample(i));
+    }
+}
+
+// Raw boot reports decoded as the first stage of the selected instantiation
+TP_BENCH(benchPointerStagesSelectedRawReport) {
+    HIDReportDescriptor descriptor;
+    descriptor.Parse(kBootMouseDescriptor, sizeof(kBootMouseDescriptor));
+    PointerReportDecoder decoder;
+    decoder.Build(descriptor);
+
+    DiscardingOutput output;
+    StagedPipeline<PointerReportDecode, DiscardingOutput> pipeline(output, BenchSettings());
+    uint8_t report[4] = {0, 0, 0, 0};
+    for (uint64_t i = 0; i < iterations; ++i) {
+        InputEvent event = Sample(i);
+        report[0] = static_cast<uint8_t>(event.pointer.buttons);
+        report[1] = static_cast<uint8_t>(event.pointer.deltaX);
+        report[2] = static_cast<uint8_t>(event.pointer.deltaY);
+        pipeline.Process({&decoder, report, sizeof(report), event.timestamp});
+    }
+}
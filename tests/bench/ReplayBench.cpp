@@ -0,0 +1,149 @@
+#include "../support/BenchHarness.h"
+#include "../../src/application/services/InputPipeline.h"
+#include "../../src/domain/models/HIDUsage.h"
+#include "../../src/infrastructure/persistence/InputTrace.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <unistd.h>
+#include <vector>
+
+using namespace TPMiddle::Application;
+using namespace TPMiddle::Domain;
+using namespace TPMiddle::Infrastructure;
+using TPMiddle::Testing::DoNotOptimize;
+
+// Whole-pipeline replays; one operation is one event. Set
+// TPMIDDLE_BENCH_TRACE to a *.tptrace file to replay a real recording in
+// benchReplayRecordedTrace instead of the synthetic 1 kHz one.
+
+namespace {
+
+const uint64_t kSecond = 1000000000ULL;
+const size_t kBatch = 64;   // Events per Process() call, as the input worker drains them
+
+class DiscardingOutput : public IPipelineOutput {
+public:
+    void PostMiddleButton(uint64_t, bool isDown) override { DoNotOptimize(isDown); }
+    void PostScroll(uint64_t, double deltaX, double deltaY) override {
+        DoNotOptimize(deltaX);
+        DoNotOptimize(deltaY);
+    }
+};
+
+// Two seconds of pointer reports at rateHz cycling through pointing,
+// middle-button scrolling and a left+right chord
+std::vector<InputEvent> SyntheticTrace(uint64_t rateHz) {
+    uint64_t interval = kSecond / rateHz;
+    size_t count = static_cast<size_t>(2 * rateHz);
+    std::vector<InputEvent> trace(count);
+    for (size_t i = 0; i < count; ++i) {
+        size_t phase = i % 256;
+        uint16_t buttons = 0;
+        if (phase >= 100 && phase < 200) {
+            buttons = kButtonMaskMiddle;
+        } else if (phase == 220) {
+            buttons = kButtonMaskLeft;
+        } else if (phase > 220 && phase < 230) {
+            buttons = kButtonMaskLeft | kButtonMaskRight;
+        }
+
+        InputEvent& event = trace[i];
+        event = InputEvent();
+        event.type = InputEventType::Pointer;
+        event.timestamp = i * interval;
+        event.pointer.buttons = buttons;
+        event.pointer.deltaX = static_cast<int16_t>(static_cast<int>(i & 7) - 3);
+        event.pointer.deltaY = static_cast<int16_t>(static_cast<int>((i >> 3) & 7) - 4);
+    }
+    return trace;
+}
+
+// Loops over the trace, shifting timestamps so time keeps moving forward
+void Replay(const InputEvent* events, size_t count, uint64_t iterations) {
+    if (count == 0) {
+        return;
+    }
+    uint64_t span = events[count - 1].timestamp - events[0].timestamp + kSecond / 1000;
+    DiscardingOutput output;
+    InputPipeline pipeline(output);
+    InputEvent batch[kBatch];
+
+    uint64_t offset = 0;
+    size_t position = 0;
+    for (uint64_t done = 0; done < iterations;) {
+        size_t take = static_cast<size_t>(std::min<uint64_t>({kBatch, iterations - done, count - position}));
+        for (size_t i = 0; i < take; ++i) {
+            batch[i] = events[position + i];
+            batch[i].timestamp += offset;
+        }
+        pipeline.Process(batch, take);
+        done += take;
+        position += take;
+        if (position == count) {
+            position = 0;
+            offset += span;
+        }
+    }
+    DoNotOptimize(pipeline.GetStatistics().scrollEvents);
+}
+
+void ReplaySynthetic(uint64_t rateHz, uint64_t iterations) {
+    std::vector<InputEvent> trace = SyntheticTrace(rateHz);
+    Replay(trace.data(), trace.size(), iterations);
+}
+
+// A recording round-tripped through the trace writer and the mapped reader
+bool WriteSyntheticRecording(const char* path) {
+    std::vector<InputEvent> trace = SyntheticTrace(1000);
+    InputTraceWriter writer;
+    if (!writer.Open(path)) {
+        return false;
+    }
+    for (const InputEvent& event : trace) {
+        writer.Append(event);
+    }
+    writer.Close();
+    return true;
+}
+
+} // namespace
+
+TP_BENCH(benchReplaySynthetic125Hz) {
+    ReplaySynthetic(125, iterations);
+}
+
+TP_BENCH(benchReplaySynthetic1kHz) {
+    ReplaySynthetic(1000, iterations);
+}
+
+TP_BENCH(benchReplaySynthetic8kHz) {
+    ReplaySynthetic(8000, iterations);
+}
+
+TP_BENCH(benchReplayRecordedTrace) {
+    const char* recorded = std::getenv("TPMIDDLE_BENCH_TRACE");
+    char scratch[] = "/tmp/tpmiddle-bench-XXXXXX";
+    if (!recorded) {
+        int fd = mkstemp(scratch);
+        if (fd < 0) {
+            return;
+        }
+        close(fd);
+        if (!WriteSyntheticRecording(scratch)) {
+            std::remove(scratch);
+            return;
+        }
+    }
+
+    InputTraceReader reader;
+    if (reader.Open(recorded ? recorded : scratch)) {
+        Replay(reader.GetEvents(), reader.GetEventCount(), iterations);
+    } else {
+        std::fprintf(stderr, "benchReplayRecordedTrace: %s\n", reader.GetLastError().c_str());
+    }
+    reader.Close();
+    if (!recorded) {
+        std::remove(scratch);
+    }
+}
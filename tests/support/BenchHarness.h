@@ -0,0 +1,49 @@
+#ifndef TPMIDDLE_BENCH_HARNESS_H
+#define TPMIDDLE_BENCH_HARNESS_H
+
+#include <cstdint>
+#include <vector>
+
+namespace TPMiddle {
+namespace Testing {
+
+/**
+ * @brief Minimal self-registering benchmark runner, the TP_TEST counterpart
+ *
+ * Each TP_BENCH body runs the measured operation `iterations` times.
+ * BenchMain.cpp grows the iteration count until a run takes long enough to
+ * time reliably and reports nanoseconds per operation.
+ */
+struct BenchmarkCase {
+    const char* name;
+    void (*function)(uint64_t iterations);
+};
+
+inline std::vector<BenchmarkCase>& BenchmarkRegistry() {
+    static std::vector<BenchmarkCase> registry;
+    return registry;
+}
+
+struct BenchmarkRegistrar {
+    BenchmarkRegistrar(const char* name, void (*function)(uint64_t)) {
+        BenchmarkRegistry().push_back({name, function});
+    }
+};
+
+/**
+ * @brief Keep the compiler from discarding a computed value
+ */
+template <typename T>
+inline void DoNotOptimize(const T& value) {
+    asm volatile("" : : "r,m"(value) : "memory");
+}
+
+} // namespace Testing
+} // namespace TPMiddle
+
+#define TP_BENCH(name) \
+    static void name(uint64_t iterations); \
+    static TPMiddle::Testing::BenchmarkRegistrar name##_registrar(#name, name); \
+    static void name(uint64_t iterations)
+
+#endif // TPMIDDLE_BENCH_HARNESS_H
@@ -0,0 +1,180 @@
+#include "BenchHarness.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <string>
+#include <vector>
+
+using namespace TPMiddle::Testing;
+
+namespace {
+
+const double kMinimumRunSeconds = 0.2;
+const double kDefaultMaxSlowdown = 1.5;
+const double kBaselineSlackNs = 1.0;   // Sub-nanosecond cases jitter by more than any ratio
+
+struct BenchmarkResult {
+    const char* name;
+    double nsPerOp;
+    uint64_t iterations;
+    double thresholdNs;   // 0 when the case has no threshold
+    double baselineNs;    // 0 when the baseline has no such case
+};
+
+double RunSeconds(const BenchmarkCase& benchmark, uint64_t iterations) {
+    auto start = std::chrono::steady_clock::now();
+    benchmark.function(iterations);
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+// One "<case name> <max ns/op>" pair per line; '#' starts a comment
+bool LoadThresholds(const char* path, std::map<std::string, double>& thresholds) {
+    FILE* file = std::fopen(path, "r");
+    if (!file) {
+        return false;
+    }
+    char line[256];
+    while (std::fgets(line, sizeof(line), file)) {
+        char name[160];
+        double limit = 0.0;
+        if (line[0] != '#' && std::sscanf(line, "%159s %lf", name, &limit) == 2) {
+            thresholds[name] = limit;
+        }
+    }
+    std::fclose(file);
+    return true;
+}
+
+// Reads the cases back from a results.json written by WriteJson, typically
+// from the same machine running an older build
+bool LoadBaseline(const char* path, std::map<std::string, double>& baseline) {
+    FILE* file = std::fopen(path, "r");
+    if (!file) {
+        return false;
+    }
+    char line[512];
+    while (std::fgets(line, sizeof(line), file)) {
+        char name[160];
+        double nsPerOp = 0.0;
+        const char* entry = std::strstr(line, "{\"name\": \"");
+        if (entry && std::sscanf(entry, "{\"name\": \"%159[^\"]\", \"ns_per_op\": %lf", name, &nsPerOp) == 2) {
+            baseline[name] = nsPerOp;
+        }
+    }
+    std::fclose(file);
+    return true;
+}
+
+bool WriteJson(const char* path, const std::vector<BenchmarkResult>& results, int regressions, int slowdowns) {
+    FILE* file = std::fopen(path, "w");
+    if (!file) {
+        return false;
+    }
+    std::fprintf(file, "{\n  \"benchmarks\": [");
+    for (size_t i = 0; i < results.size(); ++i) {
+        const BenchmarkResult& result = results[i];
+        std::fprintf(file, "%s\n    {\"name\": \"%s\", \"ns_per_op\": %.2f, \"iterations\": %llu",
+                     i ? "," : "", result.name, result.nsPerOp,
+                     static_cast<unsigned long long>(result.iterations));
+        if (result.thresholdNs > 0.0) {
+            std::fprintf(file, ", \"threshold_ns\": %.2f, \"passed\": %s", result.thresholdNs,
+                         result.nsPerOp <= result.thresholdNs ? "true" : "false");
+        }
+        if (result.baselineNs > 0.0) {
+            std::fprintf(file, ", \"baseline_ns\": %.2f", result.baselineNs);
+        }
+        std::fprintf(file, "}");
+    }
+    std::fprintf(file, "\n  ],\n  \"regressions\": %d,\n  \"slowdowns\": %d\n}\n", regressions, slowdowns);
+    return std::fclose(file) == 0;
+}
+
+void PrintUsage(const char* program) {
+    std::fprintf(stderr, "usage: %s [--json PATH] [--thresholds PATH] [--report-only] "
+                         "[--baseline PATH] [--max-slowdown RATIO] [FILTER]\n", program);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const char* filter = nullptr;
+    const char* jsonPath = nullptr;
+    bool reportOnly = false;     // Flag cases over their limit without failing
+    double maxSlowdown = kDefaultMaxSlowdown;
+    std::map<std::string, double> thresholds;
+    std::map<std::string, double> baseline;   // Always enforced, --report-only or not
+
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--json") == 0 && i + 1 < argc) {
+            jsonPath = argv[++i];
+        } else if (std::strcmp(argv[i], "--thresholds") == 0 && i + 1 < argc) {
+            if (!LoadThresholds(argv[++i], thresholds)) {
+                std::fprintf(stderr, "cannot read thresholds from %s\n", argv[i]);
+                return 2;
+            }
+        } else if (std::strcmp(argv[i], "--report-only") == 0) {
+            reportOnly = true;
+        } else if (std::strcmp(argv[i], "--baseline") == 0 && i + 1 < argc) {
+            if (!LoadBaseline(argv[++i], baseline)) {
+                std::fprintf(stderr, "cannot read baseline from %s\n", argv[i]);
+                return 2;
+            }
+        } else if (std::strcmp(argv[i], "--max-slowdown") == 0 && i + 1 < argc) {
+            maxSlowdown = std::atof(argv[++i]);
+            if (maxSlowdown < 1.0) {
+                std::fprintf(stderr, "--max-slowdown must be at least 1\n");
+                return 2;
+            }
+        } else if (argv[i][0] != '-' && !filter) {
+            filter = argv[i];
+        } else {
+            PrintUsage(argv[0]);
+            return 2;
+        }
+    }
+
+    std::vector<BenchmarkResult> results;
+    int regressions = 0;
+    int slowdowns = 0;
+    for (const BenchmarkCase& benchmark : BenchmarkRegistry()) {
+        if (filter && !std::strstr(benchmark.name, filter)) {
+            continue;
+        }
+        uint64_t iterations = 1;
+        double seconds = RunSeconds(benchmark, iterations);
+        while (seconds < kMinimumRunSeconds && iterations < (1ULL << 40)) {
+            iterations *= (seconds > 0.0 && seconds < kMinimumRunSeconds / 10) ? 10 : 2;
+            seconds = RunSeconds(benchmark, iterations);
+        }
+
+        auto threshold = thresholds.find(benchmark.name);
+        auto previous = baseline.find(benchmark.name);
+        BenchmarkResult result = {benchmark.name, seconds * 1e9 / static_cast<double>(iterations), iterations,
+                                  threshold != thresholds.end() ? threshold->second : 0.0,
+                                  previous != baseline.end() ? previous->second : 0.0};
+        bool regressed = result.thresholdNs > 0.0 && result.nsPerOp > result.thresholdNs;
+        bool slower = result.baselineNs > 0.0 &&
+            result.nsPerOp > result.baselineNs * maxSlowdown + kBaselineSlackNs;
+        regressions += regressed ? 1 : 0;
+        slowdowns += slower ? 1 : 0;
+        results.push_back(result);
+
+        std::printf("%-48s %12.1f ns/op %14llu iterations%s%s\n", result.name, result.nsPerOp,
+                    static_cast<unsigned long long>(iterations), regressed ? "  REGRESSION" : "",
+                    slower ? "  SLOWER THAN BASELINE" : "");
+    }
+
+    if (jsonPath && !WriteJson(jsonPath, results, regressions, slowdowns)) {
+        std::fprintf(stderr, "cannot write %s\n", jsonPath);
+        return 2;
+    }
+    if (regressions) {
+        std::printf("%d benchmark(s) over threshold\n", regressions);
+    }
+    if (slowdowns) {
+        std::printf("%d benchmark(s) more than %.2fx slower than the baseline\n", slowdowns, maxSlowdown);
+    }
+    return (regressions && !reportOnly) || slowdowns ? 1 : 0;
+}
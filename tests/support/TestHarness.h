@@ -0,0 +1,61 @@
+#ifndef TPMIDDLE_TEST_HARNESS_H
+#define TPMIDDLE_TEST_HARNESS_H
+
+#include <cmath>
+#include <cstdio>
+#include <vector>
+
+namespace TPMiddle {
+namespace Testing {
+
+/**
+ * @brief Minimal self-registering test runner for the portable core
+ *
+ * XCTest is only available on macOS; the portable sources are also built and
+ * tested on Linux, so they use this small harness instead. Each TP_TEST
+ * registers itself at static-initialization time and is run by TestMain.cpp.
+ */
+struct TestCase {
+    const char* name;
+    void (*function)();
+};
+
+inline std::vector<TestCase>& Registry() {
+    static std::vector<TestCase> registry;
+    return registry;
+}
+
+inline int& FailureCount() {
+    static int failures = 0;
+    return failures;
+}
+
+struct Registrar {
+    Registrar(const char* name, void (*function)()) {
+        Registry().push_back({name, function});
+    }
+};
+
+inline void ReportFailure(const char* file, int line, const char* expression) {
+    std::fprintf(stderr, "  %s:%d: assertion failed: %s\n", file, line, expression);
+    ++FailureCount();
+}
+
+} // namespace Testing
+} // namespace TPMiddle
+
+#define TP_TEST(name) \
+    static void name(); \
+    static TPMiddle::Testing::Registrar name##_registrar(#name, name); \
+    static void name()
+
+#define TP_ASSERT_TRUE(expr) \
+    do { if (!(expr)) TPMiddle::Testing::ReportFailure(__FILE__, __LINE__, #expr); } while (0)
+
+#define TP_ASSERT_FALSE(expr) TP_ASSERT_TRUE(!(expr))
+
+#define TP_ASSERT_EQ(a, b) TP_ASSERT_TRUE((a) == (b))
+
+#define TP_ASSERT_NEAR(a, b, eps) TP_ASSERT_TRUE(std::fabs((double)(a) - (double)(b)) <= (eps))
+
+#endif // TPMIDDLE_TEST_HARNESS_H
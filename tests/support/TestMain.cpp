@@ -0,0 +1,19 @@
+#include "TestHarness.h"
+
+using namespace TPMiddle::Testing;
+
+int main() {
+    int failedTests = 0;
+    for (const TestCase& test : Registry()) {
+        int failuresBefore = FailureCount();
+        test.function();
+        bool passed = FailureCount() == failuresBefore;
+        std::printf("[%s] %s\n", passed ? " OK " : "FAIL", test.name);
+        if (!passed) {
+            ++failedTests;
+        }
+    }
+
+    std::printf("%zu tests, %d failed\n", Registry().size(), failedTests);
+    return failedTests == 0 ? 0 : 1;
+}
@@ -0,0 +1,117 @@
+#include "../../support/TestHarness.h"
+#include "../../../src/application/services/DeviceStateTable.h"
+#include "../../../src/domain/models/HIDUsage.h"
+#include "../../../src/utils/HandleAllocator.h"
+#include <vector>
+
+using namespace TPMiddle::Application;
+using namespace TPMiddle::Domain;
+using TPMiddle::Utils::HandleAllocator;
+
+namespace {
+
+const uint64_t kMillisecond = 1000000ULL;
+
+struct RecordingSink : public IInputProcessorSink {
+    struct Buttons {
+        bool left;
+        bool right;
+        bool middle;
+    };
+    std::vector<Buttons> buttons;
+    std::vector<int> movementsY;
+
+    void OnButtonState(uint64_t, bool left, bool right, bool middle) override {
+        buttons.push_back({left, right, middle});
+    }
+    void OnMovement(uint64_t, int, int deltaY, uint8_t) override {
+        movementsY.push_back(deltaY);
+    }
+    void OnScrollModeChanged(uint64_t, bool) override {}
+    void OnDirectScroll(uint64_t, int, int) override {}
+};
+
+InputEvent Element(uint64_t device, uint64_t timestamp, uint16_t usagePage, uint16_t usage, int32_t value) {
+    InputEvent event = {};
+    event.type = InputEventType::Value;
+    event.device = device;
+    event.timestamp = timestamp;
+    event.element.usagePage = usagePage;
+    event.element.usage = usage;
+    event.element.value = value;
+    return event;
+}
+
+} // namespace
+
+TP_TEST(testDeviceStateTableKeepsButtonsPerDevice) {
+    RecordingSink sink;
+    DeviceStateTable table(sink);
+    table.Attach(0);
+    table.Attach(1);
+
+    // Left held on device 0; device 1 releasing its own left must not release it
+    table.Process(Element(0, 1 * kMillisecond, HIDUsage::kPageButton, HIDUsage::kButtonLeft, 1));
+    table.Process(Element(1, 2 * kMillisecond, HIDUsage::kPageButton, HIDUsage::kButtonLeft, 0));
+    table.Process(Element(1, 3 * kMillisecond, HIDUsage::kPageButton, HIDUsage::kButtonRight, 1));
+
+    TP_ASSERT_EQ(sink.buttons.size(), 3u);
+    TP_ASSERT_TRUE(sink.buttons[1].left);
+    TP_ASSERT_TRUE(sink.buttons[2].left && sink.buttons[2].right);
+    TP_ASSERT_EQ(table.Find(0)->GetButtonMask(), kButtonMaskLeft);
+    TP_ASSERT_EQ(table.Find(1)->GetButtonMask(), kButtonMaskRight);
+
+    // Unplugging device 0 releases the button it held
+    table.Detach(0, 4 * kMillisecond);
+    TP_ASSERT_EQ(sink.buttons.size(), 4u);
+    TP_ASSERT_FALSE(sink.buttons[3].left);
+    TP_ASSERT_TRUE(sink.buttons[3].right);
+    TP_ASSERT_TRUE(table.Find(0) == nullptr);
+    TP_ASSERT_EQ(table.GetAttachedCount(), 1u);
+}
+
+TP_TEST(testDeviceStateTableKeepsPendingMotionPerDevice) {
+    RecordingSink sink;
+    DeviceStateTable table(sink);
+
+    // Both devices move inside one coalescing interval; neither sees the other's delta
+    table.Process(Element(0, 10 * kMillisecond, HIDUsage::kPageGenericDesktop, HIDUsage::kY, -2));
+    table.Process(Element(1, 10 * kMillisecond, HIDUsage::kPageGenericDesktop, HIDUsage::kY, -5));
+    table.Process(Element(0, 10 * kMillisecond + 100, HIDUsage::kPageGenericDesktop, HIDUsage::kY, -1));
+    table.Process(Element(0, 12 * kMillisecond, HIDUsage::kPageGenericDesktop, HIDUsage::kY, -4));
+    table.Process(Element(1, 12 * kMillisecond, HIDUsage::kPageGenericDesktop, HIDUsage::kY, -6));
+
+    TP_ASSERT_EQ(sink.movementsY.size(), 4u);
+    TP_ASSERT_EQ(sink.movementsY[0], 2);
+    TP_ASSERT_EQ(sink.movementsY[1], 5);
+    TP_ASSERT_EQ(sink.movementsY[2], 5);
+    TP_ASSERT_EQ(sink.movementsY[3], 6);
+    TP_ASSERT_EQ(table.GetAttachedCount(), 2u);
+}
+
+TP_TEST(testDeviceStateTableGrowsWithHandles) {
+    RecordingSink sink;
+    DeviceStateTable table(sink);
+    HandleAllocator handles;
+
+    // Well past the old fixed device count
+    for (int i = 0; i < 40; ++i) {
+        table.Attach(handles.Acquire());
+    }
+    TP_ASSERT_EQ(table.GetAttachedCount(), 40u);
+
+    // Released handles are reused and start clean
+    table.Process(Element(7, kMillisecond, HIDUsage::kPageButton, HIDUsage::kButtonMiddle, 1));
+    table.Detach(7, 2 * kMillisecond);
+    handles.Release(7);
+    uint32_t reused = handles.Acquire();
+    TP_ASSERT_EQ(reused, 7u);
+    table.Attach(reused);
+    TP_ASSERT_EQ(table.Find(7)->GetButtonMask(), 0);
+    TP_ASSERT_EQ(handles.GetActiveCount(), 40u);
+
+    // Garbage handles are dropped instead of growing the table
+    table.Process(Element(DeviceStateTable::kMaxHandle + 1, 3 * kMillisecond,
+                          HIDUsage::kPageButton, HIDUsage::kButtonLeft, 1));
+    TP_ASSERT_EQ(table.GetAttachedCount(), 40u);
+}
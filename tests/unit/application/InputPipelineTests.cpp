@@ -0,0 +1,283 @@
+#include "../../support/TestHarness.h"
+#include "../../../src/application/services/ReplayDriver.h"
+#include "../../../src/domain/models/HIDUsage.h"
+#include <utility>
+#include <vector>
+
+using namespace TPMiddle::Application;
+using namespace TPMiddle::Domain;
+
+namespace {
+
+const uint64_t kMillisecond = 1000000ULL;
+
+InputEvent Value(uint64_t timestamp, uint16_t usagePage, uint16_t usage, int32_t value) {
+    InputEvent event = {};
+    event.type = InputEventType::Value;
+    event.timestamp = timestamp;
+    event.element.usagePage = usagePage;
+    event.element.usage = usage;
+    event.element.value = value;
+    return event;
+}
+
+InputEvent Button(uint64_t timestamp, uint16_t button, bool pressed) {
+    return Value(timestamp, HIDUsage::kPageButton, button, pressed ? 1 : 0);
+}
+
+InputEvent Axis(uint64_t timestamp, uint16_t axis, int32_t delta) {
+    return Value(timestamp, HIDUsage::kPageGenericDesktop, axis, delta);
+}
+
+InputEvent Pointer(uint64_t timestamp, uint16_t buttons, int16_t deltaX, int16_t deltaY) {
+    InputEvent event = {};
+    event.type = InputEventType::Pointer;
+    event.timestamp = timestamp;
+    event.pointer.buttons = buttons;
+    event.pointer.deltaX = deltaX;
+    event.pointer.deltaY = deltaY;
+    return event;
+}
+
+struct RecordedOutput : public IPipelineOutput {
+    struct Entry {
+        uint64_t timestamp;
+        int kind;   // 0 = middle up, 1 = middle down, 2 = scroll, 3 = left down, 4 = left up
+        double deltaX;
+        double deltaY;
+    };
+    std::vector<Entry> entries;
+
+    void PostMiddleButton(uint64_t timestamp, bool isDown) override {
+        entries.push_back({timestamp, isDown ? 1 : 0, 0.0, 0.0});
+    }
+    void PostScroll(uint64_t timestamp, double deltaX, double deltaY) override {
+        entries.push_back({timestamp, 2, deltaX, deltaY});
+    }
+    void PostButton(uint64_t timestamp, uint8_t buttonMask, bool isDown) override {
+        if (buttonMask == kButtonMaskLeft) {
+            entries.push_back({timestamp, isDown ? 3 : 4, 0.0, 0.0});
+        }
+    }
+};
+
+struct MovementSink : public IInputProcessorSink {
+    std::vector<std::pair<int, int>> movements;
+
+    void OnButtonState(uint64_t, bool, bool, bool) override {}
+    void OnMovement(uint64_t, int deltaX, int deltaY, uint8_t) override {
+        movements.push_back(std::make_pair(deltaX, deltaY));
+    }
+    void OnScrollModeChanged(uint64_t, bool) override {}
+    void OnDirectScroll(uint64_t, int, int) override {}
+};
+
+std::vector<InputEvent> MiddleDragTrace() {
+    std::vector<InputEvent> trace;
+    uint64_t t = 100 * kMillisecond;
+    trace.push_back(Button(t, HIDUsage::kButtonMiddle, true));
+    for (int i = 0; i < 50; ++i) {
+        t += 2 * kMillisecond;
+        trace.push_back(Axis(t, HIDUsage::kX, 1));
+        trace.push_back(Axis(t, HIDUsage::kY, -3));
+    }
+    t += 600 * kMillisecond;
+    trace.push_back(Button(t, HIDUsage::kButtonMiddle, false));
+    return trace;
+}
+
+} // namespace
+
+TP_TEST(testPipelineMiddleDragProducesScroll) {
+    RecordedOutput output;
+    ScrollSettings settings;
+    settings.naturalScrolling = false;
+    settings.acceleration = 0.0;
+    settings.speedMultiplier = 1.0;
+    InputPipeline pipeline(output, settings);
+
+    std::vector<InputEvent> trace = MiddleDragTrace();
+    pipeline.Process(trace.data(), trace.size());
+
+    TP_ASSERT_TRUE(output.entries.size() > 2);
+    TP_ASSERT_EQ(output.entries.front().kind, 1);
+    TP_ASSERT_EQ(output.entries.back().kind, 0);
+
+    // Y movement was inverted by the processor, so scroll Y is positive
+    bool scrolledUp = false;
+    for (const RecordedOutput::Entry& entry : output.entries) {
+        scrolledUp = scrolledUp || (entry.kind == 2 && entry.deltaY > 0.0);
+    }
+    TP_ASSERT_TRUE(scrolledUp);
+    TP_ASSERT_EQ(pipeline.GetStatistics().eventsProcessed, trace.size());
+    TP_ASSERT_FALSE(pipeline.GetDevices().IsScrollMode());
+}
+
+TP_TEST(testPipelineQuickMiddleClickTogglesScrollMode) {
+    RecordedOutput output;
+    InputPipeline pipeline(output);
+
+    pipeline.Process(Button(0, HIDUsage::kButtonMiddle, true));
+    pipeline.Process(Button(100 * kMillisecond, HIDUsage::kButtonMiddle, false));
+    TP_ASSERT_TRUE(pipeline.GetDevices().IsScrollMode());
+
+    // In scroll mode movement is posted as a direct scroll
+    size_t before = output.entries.size();
+    pipeline.Process(Axis(200 * kMillisecond, HIDUsage::kY, 4));
+    TP_ASSERT_EQ(output.entries.size(), before + 1);
+    TP_ASSERT_EQ(output.entries.back().kind, 2);
+    TP_ASSERT_NEAR(output.entries.back().deltaY, -4.0, 1e-9);
+}
+
+TP_TEST(testPipelineHeldClickIsReplayedAtChordDeadline) {
+    RecordedOutput output;
+    InputPipeline pipeline(output, ScrollSettings(), 20 * kMillisecond);
+    pipeline.SetClickPolicy(ChordClickPolicy::Hold);
+
+    pipeline.Process(Button(100 * kMillisecond, HIDUsage::kButtonLeft, true));
+    TP_ASSERT_TRUE(output.entries.empty());
+
+    // The press is replayed when the window closed, not when the next event arrived
+    pipeline.Process(Button(300 * kMillisecond, HIDUsage::kButtonLeft, false));
+    TP_ASSERT_EQ(output.entries.size(), 2u);
+    TP_ASSERT_EQ(output.entries[0].kind, 3);
+    TP_ASSERT_EQ(output.entries[0].timestamp, 120 * kMillisecond);
+    TP_ASSERT_EQ(output.entries[1].kind, 4);
+    TP_ASSERT_EQ(output.entries[1].timestamp, 300 * kMillisecond);
+    TP_ASSERT_EQ(pipeline.GetStatistics().replayedButtonEvents, 2u);
+}
+
+TP_TEST(testPipelineCountsChordsApartFromPhysicalMiddle) {
+    RecordedOutput output;
+    InputPipeline pipeline(output, ScrollSettings(), 20 * kMillisecond);
+
+    pipeline.Process(Button(0, HIDUsage::kButtonLeft, true));
+    pipeline.Process(Button(5 * kMillisecond, HIDUsage::kButtonRight, true));
+    pipeline.Process(Button(50 * kMillisecond, HIDUsage::kButtonLeft, false));
+    pipeline.Process(Button(55 * kMillisecond, HIDUsage::kButtonRight, false));
+    pipeline.Process(Button(900 * kMillisecond, HIDUsage::kButtonMiddle, true));
+    pipeline.Process(Button(1500 * kMillisecond, HIDUsage::kButtonMiddle, false));
+
+    TP_ASSERT_EQ(pipeline.GetStatistics().middleButtonEvents, 4u);
+    TP_ASSERT_EQ(pipeline.GetStatistics().chordDetections, 1u);
+}
+
+TP_TEST(testPipelineMovementWithinIntervalIsCoalesced) {
+    RecordedOutput output;
+    InputPipeline pipeline(output);
+
+    pipeline.Process(Axis(10 * kMillisecond, HIDUsage::kX, 2));
+    pipeline.Process(Axis(10 * kMillisecond + 1000, HIDUsage::kY, 2));
+    TP_ASSERT_EQ(pipeline.GetStatistics().movements, 1u);
+    pipeline.Process(Axis(12 * kMillisecond, HIDUsage::kY, 2));
+    TP_ASSERT_EQ(pipeline.GetStatistics().movements, 2u);
+}
+
+TP_TEST(testProcessorElementDeltasAreSummedNotOverwritten) {
+    MovementSink sink;
+    InputProcessor processor(sink);
+
+    processor.Process(Axis(10 * kMillisecond, HIDUsage::kY, -2));
+    processor.Process(Axis(10 * kMillisecond + 100, HIDUsage::kY, -3));
+    processor.Process(Axis(10 * kMillisecond + 200, HIDUsage::kY, -4));
+    processor.Process(Axis(12 * kMillisecond, HIDUsage::kX, 1));
+
+    // The second movement carries everything coalesced inside the interval
+    TP_ASSERT_EQ(sink.movements.size(), 2u);
+    TP_ASSERT_EQ(sink.movements[0].second, 2);
+    TP_ASSERT_EQ(sink.movements[1].first, -1);
+    TP_ASSERT_EQ(sink.movements[1].second, 7);
+}
+
+TP_TEST(testPipelinePointerSamplesKeepAxesTogether) {
+    RecordedOutput output;
+    ScrollSettings settings;
+    settings.naturalScrolling = false;
+    settings.acceleration = 0.0;
+    settings.speedMultiplier = 1.0;
+    settings.frameRate = 0.0;
+    InputPipeline pipeline(output, settings);
+
+    pipeline.Process(Pointer(0, kButtonMaskMiddle, 0, 0));
+    TP_ASSERT_EQ(output.entries.size(), 1u);
+    TP_ASSERT_EQ(output.entries[0].kind, 1);
+
+    // Back-to-back reports are never gated; each carries both axes
+    pipeline.Process(Pointer(100, kButtonMaskMiddle, 2, -3));
+    pipeline.Process(Pointer(200, kButtonMaskMiddle, 2, -3));
+    TP_ASSERT_EQ(output.entries.size(), 3u);
+    TP_ASSERT_NEAR(output.entries[1].deltaX, -2.0, 1e-9);
+    TP_ASSERT_NEAR(output.entries[1].deltaY, 3.0, 1e-9);
+    TP_ASSERT_EQ(pipeline.GetStatistics().movements, 2u);
+
+    pipeline.Process(Pointer(600 * kMillisecond, 0, 0, 0));
+    TP_ASSERT_EQ(output.entries.back().kind, 0);
+}
+
+TP_TEST(testPipelineMomentumCoastsUntilNewInput) {
+    ScrollSettings settings;
+    settings.naturalScrolling = false;
+    settings.acceleration = 0.0;
+    settings.speedMultiplier = 1.0;
+    settings.momentum = true;
+
+    // Release right after a fast drag
+    std::vector<InputEvent> trace;
+    trace.push_back(Pointer(0, kButtonMaskMiddle, 0, 0));
+    for (uint64_t i = 1; i <= 10; ++i) {
+        trace.push_back(Pointer(i * 8 * kMillisecond, kButtonMaskMiddle, 0, -8));
+    }
+    trace.push_back(Pointer(82 * kMillisecond, 0, 0, 0));
+
+    RecordedOutput coasting;
+    InputPipeline free(coasting, settings);
+    free.Process(trace.data(), trace.size());
+    free.Finish(82 * kMillisecond);
+
+    double coasted = 0.0;
+    uint64_t lastScroll = 0;
+    bool released = false;
+    for (const RecordedOutput::Entry& entry : coasting.entries) {
+        released = released || entry.kind == 0;
+        if (released && entry.kind == 2) {
+            coasted += entry.deltaY;
+            lastScroll = entry.timestamp;
+        }
+    }
+    TP_ASSERT_TRUE(coasted > 50.0);
+    TP_ASSERT_TRUE(lastScroll > 500 * kMillisecond);
+
+    // Any input after the release stops the coast at once
+    RecordedOutput interrupted;
+    InputPipeline stopped(interrupted, settings);
+    trace.push_back(Pointer(150 * kMillisecond, 0, 1, 0));
+    stopped.Process(trace.data(), trace.size());
+    stopped.Finish(150 * kMillisecond);
+
+    for (const RecordedOutput::Entry& entry : interrupted.entries) {
+        TP_ASSERT_TRUE(entry.timestamp <= 150 * kMillisecond);
+    }
+    TP_ASSERT_TRUE(interrupted.entries.size() < coasting.entries.size());
+}
+
+TP_TEST(testReplayIsDeterministic) {
+    std::vector<InputEvent> trace = MiddleDragTrace();
+
+    RecordedOutput first;
+    RecordedOutput second;
+    ReplayDriver(first).Run(trace.data(), trace.size(), ReplayPacing::Maximum);
+    ReplayResult result = ReplayDriver(second).Run(trace.data(), trace.size(), ReplayPacing::Maximum);
+
+    TP_ASSERT_EQ(first.entries.size(), second.entries.size());
+    bool identical = first.entries.size() == second.entries.size();
+    for (size_t i = 0; identical && i < first.entries.size(); ++i) {
+        identical = first.entries[i].timestamp == second.entries[i].timestamp &&
+                    first.entries[i].kind == second.entries[i].kind &&
+                    first.entries[i].deltaX == second.entries[i].deltaX &&
+                    first.entries[i].deltaY == second.entries[i].deltaY;
+    }
+    TP_ASSERT_TRUE(identical);
+    TP_ASSERT_EQ(result.events, trace.size());
+    TP_ASSERT_TRUE(result.latencyP50Ns <= result.latencyP99Ns);
+    TP_ASSERT_TRUE(result.latencyP99Ns <= result.latencyMaxNs);
+}
@@ -0,0 +1,124 @@
+#include "../../support/TestHarness.h"
+#include "../../../src/application/services/InputWorker.h"
+#include <thread>
+
+using namespace TPMiddle::Application;
+using TPMiddle::Domain::InputEvent;
+using TPMiddle::Domain::InputEventType;
+
+namespace {
+
+InputEvent MakeValueEvent(uint64_t sequence) {
+    InputEvent event = {};
+    event.type = InputEventType::Value;
+    event.timestamp = sequence;
+    event.element.usagePage = 0x01;
+    event.element.usage = 0x30;
+    event.element.value = static_cast<int32_t>(sequence & 0x7F);
+    return event;
+}
+
+} // namespace
+
+TP_TEST(testInputWorkerDeliversSyntheticProducerInOrder) {
+    InputWorker worker;
+    uint64_t received = 0;
+    bool inOrder = true;
+    uint64_t expected = 0;
+
+    TP_ASSERT_TRUE(worker.Start([&](const InputEvent* events, size_t count) {
+        for (size_t i = 0; i < count; ++i) {
+            inOrder = inOrder && events[i].timestamp >= expected;
+            expected = events[i].timestamp + 1;
+            ++received;
+        }
+    }));
+
+    const uint64_t kCount = 50000;
+    uint64_t accepted = 0;
+    std::thread producer([&] {
+        for (uint64_t i = 0; i < kCount; ++i) {
+            if (worker.Submit(MakeValueEvent(i))) {
+                ++accepted;
+            }
+            if ((i & 1023) == 0) {
+                std::this_thread::yield();
+            }
+        }
+    });
+    producer.join();
+    worker.Stop();
+
+    InputWorkerStatistics stats = worker.GetStatistics();
+    TP_ASSERT_TRUE(inOrder);
+    TP_ASSERT_EQ(received, accepted);
+    TP_ASSERT_EQ(stats.submitted, accepted);
+    TP_ASSERT_EQ(stats.processed, accepted);
+    TP_ASSERT_EQ(stats.submitted + stats.dropped, kCount);
+    TP_ASSERT_TRUE(stats.maxBatch <= InputWorker::kMaxBatchSize);
+    TP_ASSERT_EQ(stats.queueDepth, 0u);
+}
+
+TP_TEST(testInputWorkerCountsDropsWhenFull) {
+    InputWorker worker;
+
+    // Not started: nothing drains, so the ring fills and further events are dropped
+    for (uint64_t i = 0; i < InputWorker::kQueueCapacity + 10; ++i) {
+        worker.Submit(MakeValueEvent(i));
+    }
+    InputWorkerStatistics stats = worker.GetStatistics();
+    TP_ASSERT_EQ(stats.submitted, InputWorker::kQueueCapacity);
+    TP_ASSERT_EQ(stats.dropped, 10u);
+    TP_ASSERT_EQ(stats.queueDepth, InputWorker::kQueueCapacity);
+
+    // Starting and stopping delivers everything that was queued
+    uint64_t received = 0;
+    worker.Start([&](const InputEvent*, size_t count) { received += count; });
+    worker.Stop();
+    TP_ASSERT_EQ(received, InputWorker::kQueueCapacity);
+}
+
+TP_TEST(testInputWorkerWakesFromPark) {
+    InputWorker worker;
+    std::atomic<uint64_t> received(0);
+    worker.Start([&](const InputEvent*, size_t count) {
+        received.fetch_add(count, std::memory_order_relaxed);
+    });
+
+    // Let the worker go idle and park, then feed single events
+    for (int i = 0; i < 5; ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        worker.Submit(MakeValueEvent(i));
+    }
+    for (int spin = 0; spin < 1000 && received.load() < 5; ++spin) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    TP_ASSERT_EQ(received.load(), 5u);
+    worker.Stop();
+}
+
+TP_TEST(testInputWorkerSubmitWaitingNeverDrops) {
+    InputWorker worker;
+    uint64_t received = 0;
+    worker.Start([&](const InputEvent*, size_t count) {
+        // Slower than the producer, so the ring runs full
+        std::this_thread::sleep_for(std::chrono::microseconds(20));
+        received += count;
+    });
+
+    const uint64_t kCount = InputWorker::kQueueCapacity * 3;
+    for (uint64_t i = 0; i < kCount; ++i) {
+        TP_ASSERT_TRUE(worker.SubmitWaiting(MakeValueEvent(i)));
+    }
+    worker.Stop();
+
+    InputWorkerStatistics stats = worker.GetStatistics();
+    TP_ASSERT_EQ(received, kCount);
+    TP_ASSERT_EQ(stats.dropped, 0u);
+
+    // A stopped worker cannot make room, so a full ring refuses instead of waiting
+    for (uint64_t i = 0; i < InputWorker::kQueueCapacity; ++i) {
+        worker.Submit(MakeValueEvent(i));
+    }
+    TP_ASSERT_FALSE(worker.SubmitWaiting(MakeValueEvent(0)));
+}
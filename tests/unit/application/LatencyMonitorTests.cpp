@@ -0,0 +1,84 @@
+#include "../../support/TestHarness.h"
+#include "../../../src/application/services/LatencyMonitor.h"
+
+using namespace TPMiddle::Application;
+using namespace TPMiddle::Domain;
+
+TP_TEST(testLatencyMonitorAttributesOutputToCurrentEvent) {
+    LatencyMonitor monitor;
+
+    InputEvent event = {};
+    event.type = InputEventType::Value;
+    event.timestamp = 1000000;
+    event.callbackDelayNs = 20000;
+
+    monitor.RecordDequeue(event, 1050000);
+    monitor.RecordOutput(1080000);
+    monitor.RecordOutput(1090000);
+
+    TP_ASSERT_EQ(monitor.GetEventsProcessed(), 1u);
+    TP_ASSERT_EQ(monitor.GetOutputsPosted(), 2u);
+    TP_ASSERT_EQ(monitor.GetSnapshot(LatencyStage::HIDToCallback).max, 20000u);
+    TP_ASSERT_EQ(monitor.GetSnapshot(LatencyStage::QueueWait).max, 30000u);
+    TP_ASSERT_EQ(monitor.GetSnapshot(LatencyStage::Processing).count, 2u);
+    TP_ASSERT_EQ(monitor.GetSnapshot(LatencyStage::Processing).max, 40000u);
+    TP_ASSERT_EQ(monitor.GetSnapshot(LatencyStage::EndToEnd).max, 90000u);
+}
+
+TP_TEST(testLatencyMonitorIgnoresUnattributedOutput) {
+    LatencyMonitor monitor;
+    monitor.RecordOutput(5000);
+
+    TP_ASSERT_EQ(monitor.GetOutputsPosted(), 1u);
+    TP_ASSERT_EQ(monitor.GetSnapshot(LatencyStage::EndToEnd).count, 0u);
+}
+
+TP_TEST(testLatencyMonitorAttributesFramesToTheirSourceInput) {
+    LatencyMonitor monitor;
+
+    // A later event is being processed when the timer posts the frame
+    InputEvent event = {};
+    event.type = InputEventType::Value;
+    event.timestamp = 9000000;
+    monitor.RecordDequeue(event, 9100000);
+    monitor.RecordFrameOutput(1000000, 9500000);
+
+    TP_ASSERT_EQ(monitor.GetOutputsPosted(), 1u);
+    TP_ASSERT_EQ(monitor.GetSnapshot(LatencyStage::Processing).count, 0u);
+    TP_ASSERT_EQ(monitor.GetSnapshot(LatencyStage::EndToEnd).count, 1u);
+    TP_ASSERT_EQ(monitor.GetSnapshot(LatencyStage::EndToEnd).max, 8500000u);
+}
+
+TP_TEST(testLatencyMonitorKeepsMomentumOutOfLatency) {
+    LatencyMonitor monitor;
+    InputEvent event = {};
+    event.type = InputEventType::Value;
+    event.timestamp = 1000000;
+    monitor.RecordDequeue(event, 1050000);
+    monitor.RecordFrameOutput(1000000, 1200000);
+
+    // Coasting 400 ms after the last input is not input latency
+    monitor.RecordFrameOutput(0, 401000000);
+    monitor.RecordFrameOutput(0, 417000000);
+
+    TP_ASSERT_EQ(monitor.GetOutputsPosted(), 3u);
+    TP_ASSERT_EQ(monitor.GetMomentumFramesPosted(), 2u);
+    TP_ASSERT_EQ(monitor.GetSnapshot(LatencyStage::EndToEnd).count, 1u);
+    TP_ASSERT_EQ(monitor.GetSnapshot(LatencyStage::EndToEnd).max, 200000u);
+    TP_ASSERT_TRUE(monitor.FormatReport(InputWorkerStatistics()).find("3 posted (2 momentum)") != std::string::npos);
+}
+
+TP_TEST(testLatencyMonitorReportIncludesQueueCounters) {
+    LatencyMonitor monitor;
+    InputWorkerStatistics queue;
+    queue.submitted = 42;
+    queue.dropped = 3;
+
+    std::string report = monitor.FormatReport(queue);
+    TP_ASSERT_TRUE(report.find("42 received") != std::string::npos);
+    TP_ASSERT_TRUE(report.find("3 dropped") != std::string::npos);
+    TP_ASSERT_TRUE(report.find("end-to-end") != std::string::npos);
+
+    monitor.Reset();
+    TP_ASSERT_EQ(monitor.GetEventsProcessed(), 0u);
+}
@@ -0,0 +1,100 @@
+#include "../../support/TestHarness.h"
+#include "../../../src/application/services/ScrollProfiles.h"
+#include <vector>
+
+using namespace TPMiddle::Application;
+using namespace TPMiddle::Domain;
+
+namespace {
+
+const ProfileDevice kBuiltIn = {"17ef:6009", "ThinkPad TrackPoint"};
+const ProfileDevice kExternal = {"17ef:6047", "ThinkPad Compact USB Keyboard with TrackPoint"};
+
+ScrollProfile MakeProfile(const std::string& application, const std::string& device, double speed) {
+    ScrollProfile profile;
+    profile.application = application;
+    profile.device = device;
+    profile.overrides.speedMultiplier = speed;
+    return profile;
+}
+
+ScrollSettings Base() {
+    ScrollSettings settings;
+    settings.speedMultiplier = 0.5;
+    settings.acceleration = 1.2;
+    return settings;
+}
+
+} // namespace
+
+TP_TEST(testProfileStoreLayersBySpecificity) {
+    // Deliberately listed most specific first
+    ScrollProfile terminal = MakeProfile("com.apple.Terminal", "", 0.2);
+    terminal.overrides.naturalScrolling = false;
+    ProfileStore store({
+        MakeProfile("com.apple.Terminal", "17ef:6047", 0.9),
+        terminal,
+        MakeProfile("", "ThinkPad TrackPoint", 0.3),
+        MakeProfile("", "", 0.4),
+    });
+
+    TP_ASSERT_NEAR(store.Resolve(Base(), "com.google.Chrome", nullptr).speedMultiplier, 0.4, 1e-12);
+    TP_ASSERT_NEAR(store.Resolve(Base(), "com.google.Chrome", &kBuiltIn).speedMultiplier, 0.3, 1e-12);
+    TP_ASSERT_NEAR(store.Resolve(Base(), "com.apple.Terminal", &kBuiltIn).speedMultiplier, 0.2, 1e-12);
+
+    ScrollSettings external = store.Resolve(Base(), "com.apple.Terminal", &kExternal);
+    TP_ASSERT_NEAR(external.speedMultiplier, 0.9, 1e-12);
+    // Lower layers still contribute what the top one leaves unset
+    TP_ASSERT_FALSE(external.naturalScrolling);
+    TP_ASSERT_NEAR(external.acceleration, 1.2, 1e-12);
+}
+
+TP_TEST(testProfileResolverCachesPerDevice) {
+    ProfileStore store({
+        MakeProfile("com.apple.Terminal", "", 0.2),
+        MakeProfile("", "17ef:6047", 0.8),
+    });
+    ProfileResolver resolver;
+    resolver.Configure(Base(), &store, "");
+    resolver.AttachDevice(0, kBuiltIn);
+    resolver.AttachDevice(1, kExternal);
+    uint64_t resolves = resolver.GetResolveCount();
+
+    // Lookups never resolve
+    for (int i = 0; i < 100; ++i) {
+        TP_ASSERT_NEAR(resolver.ForDevice(0).speedMultiplier, 0.5, 1e-12);
+        TP_ASSERT_NEAR(resolver.ForDevice(1).speedMultiplier, 0.8, 1e-12);
+    }
+    TP_ASSERT_EQ(resolver.GetResolveCount(), resolves);
+
+    // Switching application re-resolves the application default and both devices, once
+    uint64_t generation = resolver.GetGeneration();
+    TP_ASSERT_TRUE(resolver.SetApplication("com.apple.Terminal"));
+    TP_ASSERT_EQ(resolver.GetResolveCount(), resolves + 3);
+    TP_ASSERT_TRUE(resolver.GetGeneration() != generation);
+    // An application profile outranks a device-only one
+    TP_ASSERT_NEAR(resolver.ForDevice(0).speedMultiplier, 0.2, 1e-12);
+    TP_ASSERT_NEAR(resolver.ForDevice(1).speedMultiplier, 0.2, 1e-12);
+    TP_ASSERT_FALSE(resolver.SetApplication("com.apple.Terminal"));
+    TP_ASSERT_EQ(resolver.GetResolveCount(), resolves + 3);
+}
+
+TP_TEST(testProfileResolverFallsBackForUnknownDevices) {
+    ProfileStore store({MakeProfile("", "17ef:6047", 0.8), MakeProfile("org.vim.MacVim", "", 0.1)});
+    ProfileResolver resolver;
+    TP_ASSERT_NEAR(resolver.ForDevice(3).speedMultiplier, ScrollSettings().speedMultiplier, 1e-12);
+
+    resolver.Configure(Base(), &store, "");
+    resolver.AttachDevice(3, kExternal);
+    TP_ASSERT_NEAR(resolver.ForDevice(3).speedMultiplier, 0.8, 1e-12);
+    TP_ASSERT_NEAR(resolver.ForDevice(7).speedMultiplier, 0.5, 1e-12);
+
+    resolver.DetachDevice(3);
+    TP_ASSERT_NEAR(resolver.ForDevice(3).speedMultiplier, 0.5, 1e-12);
+    resolver.SetApplication("org.vim.MacVim");
+    TP_ASSERT_NEAR(resolver.ForDevice(7).speedMultiplier, 0.1, 1e-12);
+
+    // Without profiles the base settings pass through
+    resolver.Configure(Base(), nullptr, "org.vim.MacVim");
+    TP_ASSERT_NEAR(resolver.ForDevice(7).speedMultiplier, 0.5, 1e-12);
+}
@@ -0,0 +1,221 @@
+#include "../../support/TestHarness.h"
+#include "../../../src/application/services/InputPipeline.h"
+#include "../../../src/application/services/StagedPipeline.h"
+#include "../../../src/domain/models/HIDUsage.h"
+#include "../../../src/infrastructure/hid/PointerReportDecoder.h"
+#include <vector>
+
+using namespace TPMiddle::Application;
+using namespace TPMiddle::Domain;
+using TPMiddle::Infrastructure::HIDReportDescriptor;
+using TPMiddle::Infrastructure::PointerReportDecode;
+using TPMiddle::Infrastructure::PointerReportDecoder;
+
+namespace {
+
+const uint64_t kMillisecond = 1000000ULL;
+
+// Boot-protocol style mouse: 3 buttons, 5 bits padding, 8-bit X, Y, wheel
+const uint8_t kBootMouseDescriptor[] = {
+    0x05, 0x01, 0x09, 0x02, 0xA1, 0x01, 0x09, 0x01, 0xA1, 0x00,
+    0x05, 0x09, 0x19, 0x01, 0x29, 0x03, 0x15, 0x00, 0x25, 0x01,
+    0x95, 0x03, 0x75, 0x01, 0x81, 0x02, 0x95, 0x01, 0x75, 0x05,
+    0x81, 0x03, 0x05, 0x01, 0x09, 0x30, 0x09, 0x31, 0x09, 0x38,
+    0x15, 0x81, 0x25, 0x7F, 0x75, 0x08, 0x95, 0x03, 0x81, 0x06,
+    0xC0, 0xC0
+};
+
+struct Entry {
+    uint64_t timestamp;
+    int kind;   // 0 = middle up, 1 = middle down, 2 = scroll, 3 = button down, 4 = button up, 5 = motion
+    double deltaX;
+    double deltaY;
+
+    bool operator==(const Entry& other) const {
+        return timestamp == other.timestamp && kind == other.kind &&
+               deltaX == other.deltaX && deltaY == other.deltaY;
+    }
+};
+
+// Concrete output: the stages call it without virtual dispatch
+struct RecordingOutput {
+    std::vector<Entry> entries;
+
+    void PostMiddleButton(uint64_t timestamp, bool isDown) {
+        entries.push_back({timestamp, isDown ? 1 : 0, 0.0, 0.0});
+    }
+    void PostButton(uint64_t timestamp, uint8_t buttonMask, bool isDown) {
+        entries.push_back({timestamp, isDown ? 3 : 4, static_cast<double>(buttonMask), 0.0});
+    }
+    void PostScroll(uint64_t timestamp, double deltaX, double deltaY) {
+        entries.push_back({timestamp, 2, deltaX, deltaY});
+    }
+    void PostMotion(uint64_t timestamp, int deltaX, int deltaY) {
+        entries.push_back({timestamp, 5, static_cast<double>(deltaX), static_cast<double>(deltaY)});
+    }
+};
+
+struct RecordingPipelineOutput : public IPipelineOutput {
+    RecordingOutput recorded;
+
+    void PostMiddleButton(uint64_t timestamp, bool isDown) override { recorded.PostMiddleButton(timestamp, isDown); }
+    void PostButton(uint64_t timestamp, uint8_t buttonMask, bool isDown) override {
+        recorded.PostButton(timestamp, buttonMask, isDown);
+    }
+    void PostScroll(uint64_t timestamp, double deltaX, double deltaY) override {
+        recorded.PostScroll(timestamp, deltaX, deltaY);
+    }
+    void PostMotion(uint64_t timestamp, int deltaX, int deltaY) override {
+        recorded.PostMotion(timestamp, deltaX, deltaY);
+    }
+};
+
+InputEvent Pointer(uint64_t timestamp, uint16_t buttons, int16_t deltaX, int16_t deltaY, int8_t wheel = 0) {
+    InputEvent event = {};
+    event.type = InputEventType::Pointer;
+    event.timestamp = timestamp;
+    event.pointer.buttons = buttons;
+    event.pointer.deltaX = deltaX;
+    event.pointer.deltaY = deltaY;
+    event.pointer.wheel = wheel;
+    return event;
+}
+
+// Each phase holds its buttons for 12 samples at 125 Hz, moving and now and then turning the wheel
+std::vector<InputEvent> MixedTrace() {
+    std::vector<InputEvent> trace;
+    uint64_t t = 100 * kMillisecond;
+    const uint16_t left = kButtonMaskLeft;
+    const uint16_t right = kButtonMaskRight;
+    const uint16_t middle = kButtonMaskMiddle;
+    // A slow chord, a chord, a tap, a long middle drag, then a quick middle click
+    const uint16_t phases[] = {0, left, left | right, right, 0, left | right, left | right, 0, left, 0,
+                               middle, middle, middle, middle, middle, middle, 0, middle, 0, 0, right, 0};
+    for (uint16_t buttons : phases) {
+        for (int i = 0; i < 12; ++i) {
+            t += (i == 0) ? 5 * kMillisecond : 8 * kMillisecond;
+            trace.push_back(Pointer(t, buttons, static_cast<int16_t>((i % 5) - 1), static_cast<int16_t>(3 - (i % 7)),
+                                    static_cast<int8_t>(i == 6 ? 1 : 0)));
+        }
+    }
+    return trace;
+}
+
+ScrollSettings Settings(bool accelerates, bool capped) {
+    ScrollSettings settings;
+    settings.acceleration = accelerates ? 1.2 : 0.0;
+    settings.maxScrollSpeed = capped ? 2.0 : 0.0;
+    return settings;
+}
+
+} // namespace
+
+TP_TEST(testStagedPipelineSelectsKernelOnConfigure) {
+    RecordingOutput output;
+    using Pipeline = StagedPipeline<PointerEventDecode, RecordingOutput>;
+    Pipeline pipeline(output);
+    TP_ASSERT_TRUE(pipeline.GetKernel() == Pipeline::SelectKernel(false, true, true));
+
+    pipeline.Configure(Settings(false, false), 20 * kMillisecond, ChordClickPolicy::Hold);
+    TP_ASSERT_TRUE(pipeline.GetKernel() == Pipeline::SelectKernel(true, false, false));
+    TP_ASSERT_TRUE(Pipeline::SelectKernel(true, false, false) != Pipeline::SelectKernel(false, false, false));
+    TP_ASSERT_TRUE(Pipeline::SelectKernel(false, true, false) != Pipeline::SelectKernel(false, false, false));
+    TP_ASSERT_TRUE(Pipeline::SelectKernel(false, false, true) != Pipeline::SelectKernel(false, false, false));
+}
+
+// Every specialized instantiation must produce exactly what the generic stages
+// produce, down to the last bit of every scroll delta
+TP_TEST(testStagedPipelineMatchesGenericStages) {
+    std::vector<InputEvent> trace = MixedTrace();
+    bool matched = true;
+    for (int combination = 0; combination < 8; ++combination) {
+        bool hold = (combination & 4) != 0;
+        ScrollSettings settings = Settings((combination & 2) != 0, (combination & 1) != 0);
+        ChordClickPolicy policy = hold ? ChordClickPolicy::Hold : ChordClickPolicy::PassThrough;
+
+        RecordingOutput selected;
+        StagedPipeline<PointerEventDecode, RecordingOutput> pipeline(selected, settings, 20 * kMillisecond, policy);
+        pipeline.Process(trace.data(), trace.size());
+
+        RecordingOutput generic;
+        PointerStageState state;
+        state.toggle.SetScrollToggleWindow(InputProcessor::kScrollTogglePressNs);
+        state.chord.SetChordWindow(20 * kMillisecond);
+        state.chord.SetClickPolicy(policy);
+        ScrollStageParams params = ScrollEngine::DeriveStageParams(settings);
+        for (const InputEvent& event : trace) {
+            RunPointerStages<PointerEventDecode, ReplayingChord, RuntimeAcceleration, RuntimeEmit>(
+                state, params, generic, event);
+        }
+
+        matched = matched && !selected.entries.empty() && selected.entries == generic.entries;
+    }
+    TP_ASSERT_TRUE(matched);
+}
+
+// With whole-pixel scroll and pacing and momentum off, InputPipeline posts the same output
+TP_TEST(testStagedPipelineMatchesInputPipeline) {
+    ScrollSettings settings;
+    settings.speedMultiplier = 1.0;
+    settings.acceleration = 0.0;
+    settings.maxScrollSpeed = 0.0;
+    settings.frameRate = 0.0;
+    std::vector<InputEvent> trace = MixedTrace();
+
+    RecordingOutput staged;
+    StagedPipeline<PointerEventDecode, RecordingOutput> pipeline(staged, settings);
+    pipeline.Process(trace.data(), trace.size());
+
+    RecordingPipelineOutput reference;
+    InputPipeline inputPipeline(reference, settings);
+    inputPipeline.Process(trace.data(), trace.size());
+
+    TP_ASSERT_EQ(staged.entries.size(), reference.recorded.entries.size());
+    TP_ASSERT_TRUE(staged.entries == reference.recorded.entries);
+    TP_ASSERT_EQ(pipeline.IsScrollMode(), inputPipeline.GetDevices().IsScrollMode());
+}
+
+TP_TEST(testStagedPipelineQuickMiddleClickTogglesScrollMode) {
+    RecordingOutput output;
+    StagedPipeline<PointerEventDecode, RecordingOutput> pipeline(output);
+
+    pipeline.Process(Pointer(0, kButtonMaskMiddle, 0, 0));
+    pipeline.Process(Pointer(100 * kMillisecond, 0, 0, 0));
+    TP_ASSERT_TRUE(pipeline.IsScrollMode());
+
+    pipeline.Process(Pointer(200 * kMillisecond, 0, 0, 4));
+    TP_ASSERT_EQ(output.entries.back().kind, 2);
+    TP_ASSERT_NEAR(output.entries.back().deltaY, -4.0, 1e-9);
+
+    pipeline.Reset(300 * kMillisecond);
+    TP_ASSERT_FALSE(pipeline.IsScrollMode());
+}
+
+TP_TEST(testStagedPipelineDecodesRawReports) {
+    HIDReportDescriptor descriptor;
+    TP_ASSERT_TRUE(descriptor.Parse(kBootMouseDescriptor, sizeof(kBootMouseDescriptor)));
+    PointerReportDecoder decoder;
+    TP_ASSERT_TRUE(decoder.Build(descriptor));
+
+    ScrollSettings settings;
+    settings.speedMultiplier = 1.0;
+    settings.acceleration = 0.0;
+    settings.naturalScrolling = false;
+    RecordingOutput output;
+    StagedPipeline<PointerReportDecode, RecordingOutput> pipeline(output, settings);
+
+    const uint8_t middleDown[] = {0x04, 0x00, 0x00, 0x00};
+    const uint8_t drag[] = {0x04, 0x00, 0xFD, 0x00};   // Y = -3
+    pipeline.Process({&decoder, middleDown, sizeof(middleDown), 10 * kMillisecond});
+    pipeline.Process({&decoder, drag, sizeof(drag), 18 * kMillisecond});
+
+    TP_ASSERT_EQ(output.entries.size(), 2u);
+    TP_ASSERT_EQ(output.entries[0].kind, 1);
+    TP_ASSERT_EQ(output.entries[1].kind, 2);
+    TP_ASSERT_NEAR(output.entries[1].deltaY, 3.0, 1e-9);
+
+    // A report the decoder cannot read is dropped before any stage runs
+    const uint8_t truncated[] = {0x04};
+    pipeline.Process({&decoder, truncated, sizeof(truncated), 26 * kMillisecond});
+    TP_ASSERT_EQ(output.entries.size(), 2u);
+}
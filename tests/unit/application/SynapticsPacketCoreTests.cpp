@@ -0,0 +1,162 @@
+#include "../../support/TestHarness.h"
+#include "../../../src/application/services/SynapticsPacketCore.h"
+#include <deque>
+#include <map>
+#include <vector>
+
+using namespace TPMiddle::Application;
+
+namespace {
+
+const uint64_t kMillisecond = 1000000ULL;
+const uint32_t kMiddle = 0x04;
+const uint32_t kExtended3 = 0x400;
+
+struct MockPacketSource : public ISynapticsPacketSource {
+    std::map<long, std::deque<SynapticsPacket>> queues;
+
+    void Push(long handle, uint32_t buttonState) {
+        SynapticsPacket packet;
+        packet.buttonState = buttonState;
+        queues[handle].push_back(packet);
+    }
+
+    bool LoadPacket(long handle, SynapticsPacket& packet) override {
+        std::deque<SynapticsPacket>& queue = queues[handle];
+        if (queue.empty()) {
+            return false;
+        }
+        packet = queue.front();
+        queue.pop_front();
+        return true;
+    }
+};
+
+struct RecordingOutput : public IMiddleButtonOutput {
+    std::vector<std::vector<bool>> batches;
+
+    void SendMiddleButtons(const bool* downs, size_t count) override {
+        batches.push_back(std::vector<bool>(downs, downs + count));
+    }
+};
+
+SynapticsCoreOptions Options(bool normalMode, bool quickClick = false) {
+    SynapticsCoreOptions options;
+    options.normalMode = normalMode;
+    options.quickClick = quickClick;
+    options.masks.middle = kMiddle;
+    options.masks.touchPadMiddle = kExtended3;
+    return options;
+}
+
+} // namespace
+
+TP_TEST(testSynapticsNormalModeForwardsEdgesByDeviceType) {
+    MockPacketSource source;
+    RecordingOutput output;
+    SynapticsPacketCore core(source, output, Options(true));
+    core.Reconcile({{1, SynapticsDeviceType::Stick}, {2, SynapticsDeviceType::TouchPad}}, nullptr, nullptr);
+
+    // The touchpad's middle bit does nothing on the stick, and the other way round
+    source.Push(1, kExtended3);
+    source.Push(1, kMiddle);
+    source.Push(1, kMiddle | 0x01);
+    source.Push(1, 0);
+    TP_ASSERT_EQ(core.ProcessDevice(1, 0), 4u);
+    TP_ASSERT_EQ(output.batches.size(), 1u);
+    TP_ASSERT_EQ(output.batches[0].size(), 2u);
+    TP_ASSERT_TRUE(output.batches[0][0]);
+    TP_ASSERT_FALSE(output.batches[0][1]);
+
+    source.Push(2, kMiddle);
+    core.ProcessDevice(2, kMillisecond);
+    TP_ASSERT_EQ(output.batches.size(), 1u);
+    source.Push(2, kExtended3);
+    core.ProcessDevice(2, 2 * kMillisecond);
+    TP_ASSERT_EQ(output.batches.size(), 2u);
+    TP_ASSERT_TRUE(core.IsMiddlePressed(2));
+}
+
+TP_TEST(testSynapticsNormalModeFiltersRepeatedEdgesAcrossDevices) {
+    MockPacketSource source;
+    RecordingOutput output;
+    SynapticsPacketCore core(source, output, Options(true));
+    core.Reconcile({{1, SynapticsDeviceType::Stick}, {2, SynapticsDeviceType::Stick}}, nullptr, nullptr);
+
+    source.Push(1, kMiddle);
+    core.ProcessDevice(1, 0);
+    source.Push(2, kMiddle);
+    core.ProcessDevice(2, 0);
+    source.Push(1, 0);
+    core.ProcessDevice(1, 0);
+    source.Push(2, 0);
+    core.ProcessDevice(2, 0);
+
+    TP_ASSERT_EQ(core.GetStatistics().events, 2u);
+    TP_ASSERT_EQ(core.GetStatistics().filteredEdges, 2u);
+}
+
+TP_TEST(testSynapticsQuickClickIsPacedByDeadlines) {
+    MockPacketSource source;
+    RecordingOutput output;
+    SynapticsPacketCore core(source, output, Options(false, true));
+    core.Reconcile({{1, SynapticsDeviceType::Stick}}, nullptr, nullptr);
+
+    source.Push(1, kMiddle);
+    core.ProcessDevice(1, 0);
+    source.Push(1, 0);
+    core.ProcessDevice(1, 100 * kMillisecond);
+    TP_ASSERT_TRUE(output.batches.empty());
+    TP_ASSERT_EQ(core.GetNextDeadline(), 150 * kMillisecond);
+
+    core.Advance(149 * kMillisecond);
+    TP_ASSERT_TRUE(output.batches.empty());
+    core.Advance(150 * kMillisecond);
+    TP_ASSERT_EQ(output.batches.size(), 1u);
+    TP_ASSERT_TRUE(output.batches[0][0]);
+    TP_ASSERT_EQ(core.GetNextDeadline(), 200 * kMillisecond);
+
+    // A late wakeup still sends the release, in the same batch order
+    core.Advance(500 * kMillisecond);
+    TP_ASSERT_EQ(output.batches.size(), 2u);
+    TP_ASSERT_FALSE(output.batches[1][0]);
+    TP_ASSERT_EQ(core.GetNextDeadline(), UINT64_MAX);
+
+    // A press held past the timeout is left to the driver
+    source.Push(1, kMiddle);
+    core.ProcessDevice(1, kMillisecond * 1000);
+    source.Push(1, 0);
+    core.ProcessDevice(1, kMillisecond * 1400);
+    TP_ASSERT_EQ(core.GetNextDeadline(), UINT64_MAX);
+}
+
+TP_TEST(testSynapticsReconcileKeepsSurvivingDevices) {
+    MockPacketSource source;
+    RecordingOutput output;
+    SynapticsPacketCore core(source, output, Options(true));
+    std::vector<SynapticsDeviceInfo> added;
+    std::vector<long> removed;
+    core.Reconcile({{1, SynapticsDeviceType::Stick}, {2, SynapticsDeviceType::Stick}}, &added, &removed);
+    TP_ASSERT_EQ(added.size(), 2u);
+
+    source.Push(1, kMiddle);
+    core.ProcessDevice(1, 0);
+
+    // Device 2 goes away and 3 arrives; 1 keeps its pressed state
+    added.clear();
+    core.Reconcile({{1, SynapticsDeviceType::Stick}, {3, SynapticsDeviceType::TouchPad}}, &added, &removed);
+    TP_ASSERT_EQ(added.size(), 1u);
+    TP_ASSERT_EQ(added[0].handle, 3L);
+    TP_ASSERT_EQ(removed.size(), 1u);
+    TP_ASSERT_EQ(removed[0], 2L);
+    TP_ASSERT_TRUE(core.IsMiddlePressed(1));
+    TP_ASSERT_EQ(output.batches.size(), 1u);
+
+    // Losing the device that holds the button releases it
+    removed.clear();
+    core.Reconcile({{3, SynapticsDeviceType::TouchPad}}, nullptr, &removed);
+    TP_ASSERT_EQ(removed.size(), 1u);
+    TP_ASSERT_EQ(output.batches.size(), 2u);
+    TP_ASSERT_FALSE(output.batches[1][0]);
+    TP_ASSERT_EQ(core.GetDeviceCount(), 1u);
+}
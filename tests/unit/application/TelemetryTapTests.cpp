@@ -0,0 +1,107 @@
+#include "../../support/TestHarness.h"
+#include "../../../src/application/services/TelemetryTap.h"
+#include "../../../src/domain/models/HIDUsage.h"
+#include <thread>
+#include <vector>
+
+using namespace TPMiddle::Application;
+using TPMiddle::Domain::kButtonMaskLeft;
+using TPMiddle::Domain::kButtonMaskMiddle;
+
+TP_TEST(testTelemetryTapIgnoresInputWhileDetached) {
+    TelemetryTap tap;
+    tap.RecordMovement(5, 5);
+    tap.RecordScroll(1, 1);
+    tap.RecordButtons(kButtonMaskLeft);
+    TP_ASSERT_FALSE(tap.IsAttached());
+
+    tap.Attach(0);
+    const TelemetryFrame& frame = tap.Pull(1000);
+    TP_ASSERT_EQ(frame.movementEvents, 0u);
+    TP_ASSERT_EQ(frame.scrollEvents, 0u);
+    TP_ASSERT_EQ(frame.motionX, 0);
+    TP_ASSERT_EQ(frame.buttons, 0);
+}
+
+TP_TEST(testTelemetryTapAggregatesBetweenPulls) {
+    TelemetryTap tap;
+    tap.Attach(0);
+    tap.RecordMovement(3, -2);
+    tap.RecordMovement(4, -1);
+    tap.RecordScroll(0, 12);
+    tap.RecordButtons(kButtonMaskMiddle);
+
+    TelemetryFrame first = tap.Pull(1000);
+    TP_ASSERT_EQ(first.timestamp, 1000u);
+    TP_ASSERT_EQ(first.motionX, 7);
+    TP_ASSERT_EQ(first.motionY, -3);
+    TP_ASSERT_EQ(first.lastDeltaX, 4);
+    TP_ASSERT_EQ(first.lastDeltaY, -1);
+    TP_ASSERT_EQ(first.scrollY, 12);
+    TP_ASSERT_EQ(first.movementEvents, 2u);
+    TP_ASSERT_EQ(first.scrollEvents, 1u);
+    TP_ASSERT_EQ(first.buttons, kButtonMaskMiddle);
+
+    // Only activity since the previous pull is reported; button state persists
+    tap.RecordMovement(-1, 0);
+    TelemetryFrame second = tap.Pull(2000);
+    TP_ASSERT_EQ(second.motionX, -1);
+    TP_ASSERT_EQ(second.movementEvents, 1u);
+    TP_ASSERT_EQ(second.scrollEvents, 0u);
+    TP_ASSERT_EQ(second.buttons, kButtonMaskMiddle);
+
+    tap.Detach();
+    tap.RecordMovement(100, 100);
+    TP_ASSERT_EQ(tap.Pull(3000).motionX, 0);
+}
+
+TP_TEST(testTelemetryTapKeepsTrailingHistory) {
+    TelemetryTap tap;
+    tap.Attach(0);
+    const size_t pulls = TelemetryTap::kHistoryCapacity + 10;
+    for (size_t i = 0; i < pulls; ++i) {
+        tap.RecordMovement(static_cast<int>(i), 0);
+        tap.Pull(i);
+    }
+
+    TP_ASSERT_EQ(tap.GetHistoryCount(), TelemetryTap::kHistoryCapacity);
+    TP_ASSERT_EQ(tap.GetHistory(0).motionX, static_cast<int64_t>(pulls - 1));
+    TP_ASSERT_EQ(tap.GetHistory(5).timestamp, pulls - 6);
+    TP_ASSERT_EQ(tap.GetHistory(TelemetryTap::kHistoryCapacity - 1).timestamp, pulls - TelemetryTap::kHistoryCapacity);
+
+    // Re-attaching starts a fresh history
+    tap.Attach(0);
+    TP_ASSERT_EQ(tap.GetHistoryCount(), 0u);
+}
+
+TP_TEST(testTelemetryTapCountsConcurrentProducers) {
+    TelemetryTap tap;
+    tap.Attach(0);
+    const int kEvents = 50000;
+
+    std::thread movement([&tap, kEvents]() {
+        for (int i = 0; i < kEvents; ++i) {
+            tap.RecordMovement(1, -1);
+        }
+    });
+    std::thread scroll([&tap, kEvents]() {
+        for (int i = 0; i < kEvents; ++i) {
+            tap.RecordScroll(2, 0);
+        }
+    });
+
+    int64_t motionX = 0;
+    int64_t scrollX = 0;
+    uint64_t pulls = 0;
+    while (motionX < kEvents || scrollX < 2 * kEvents) {
+        const TelemetryFrame& frame = tap.Pull(++pulls);
+        motionX += frame.motionX;
+        scrollX += frame.scrollX;
+    }
+    movement.join();
+    scroll.join();
+
+    TP_ASSERT_EQ(motionX, kEvents);
+    TP_ASSERT_EQ(scrollX, 2 * kEvents);
+    TP_ASSERT_EQ(tap.Pull(++pulls).movementEvents, 0u);
+}
@@ -0,0 +1,161 @@
+#include "../../support/TestHarness.h"
+#include "../../../src/application/services/TraceRecorder.h"
+#include <cstdio>
+#include <string>
+#include <thread>
+#include <unistd.h>
+
+using namespace TPMiddle::Application;
+
+namespace {
+
+std::string TemporaryTracePath(const char* name) {
+    return std::string("/tmp/tpmiddle-") + name + "-" + std::to_string(getpid()) + ".json";
+}
+
+std::string ReadFile(const std::string& path) {
+    std::string text;
+    FILE* file = std::fopen(path.c_str(), "r");
+    if (!file) {
+        return text;
+    }
+    char chunk[4096];
+    size_t bytes;
+    while ((bytes = std::fread(chunk, 1, sizeof(chunk), file)) > 0) {
+        text.append(chunk, bytes);
+    }
+    std::fclose(file);
+    return text;
+}
+
+size_t CountOccurrences(const std::string& haystack, const char* needle) {
+    size_t count = 0;
+    for (size_t at = haystack.find(needle); at != std::string::npos; at = haystack.find(needle, at + 1)) {
+        ++count;
+    }
+    return count;
+}
+
+} // namespace
+
+TP_TEST(testTraceRecorderIgnoresEventsWhileDisabled) {
+    TraceRecorder recorder(64);
+    recorder.Instant("before start");
+    {
+        TraceSpan span(recorder, "before start");
+    }
+    TP_ASSERT_EQ(recorder.GetRecordCount(), 0u);
+
+    recorder.Start();
+    recorder.Stop();
+    recorder.Counter("after stop", 1);
+    TP_ASSERT_EQ(recorder.GetRecordCount(), 0u);
+}
+
+TP_TEST(testTraceRecorderExportsChromeTraceEvents) {
+    TraceRecorder recorder(64);
+    std::thread([&recorder]() {
+        TraceRecorder::SetThreadName("worker \"one\"");
+        recorder.Start();
+        {
+            TraceSpan outer(recorder, "handleMovement");
+            TraceSpan inner(recorder, "postScrollEvent");
+            recorder.Instant("chord", 3);
+        }
+        recorder.Counter("queue depth", 7);
+        recorder.Stop();
+    }).join();
+    TP_ASSERT_EQ(recorder.GetRecordCount(), 6u);
+
+    std::string path = TemporaryTracePath("chrome-trace");
+    TP_ASSERT_TRUE(recorder.ExportChromeJson(path));
+    std::string json = ReadFile(path);
+    unlink(path.c_str());
+
+    TP_ASSERT_EQ(json.find("{\"displayTimeUnit\":\"ns\",\"traceEvents\":["), 0u);
+    TP_ASSERT_EQ(CountOccurrences(json, "\"ph\":\"B\""), 2u);
+    TP_ASSERT_EQ(CountOccurrences(json, "\"ph\":\"E\""), 2u);
+    TP_ASSERT_EQ(CountOccurrences(json, "\"name\":\"handleMovement\""), 2u);
+    TP_ASSERT_TRUE(json.find("\"name\":\"chord\",\"cat\":\"tpmiddle\",\"ph\":\"i\"") != std::string::npos);
+    TP_ASSERT_TRUE(json.find("\"s\":\"t\",\"args\":{\"value\":3}") != std::string::npos);
+    TP_ASSERT_TRUE(json.find("\"ph\":\"C\"") != std::string::npos);
+    TP_ASSERT_TRUE(json.find("\"args\":{\"name\":\"worker \\\"one\\\"\"}") != std::string::npos);
+    TP_ASSERT_EQ(json.substr(json.size() - 4), std::string("\n]}\n"));
+
+    // Spans end in reverse order of their beginning
+    TP_ASSERT_TRUE(json.find("\"name\":\"postScrollEvent\",\"cat\":\"tpmiddle\",\"ph\":\"E\"") <
+                   json.find("\"name\":\"handleMovement\",\"cat\":\"tpmiddle\",\"ph\":\"E\""));
+}
+
+TP_TEST(testTraceRecorderCountsDropsAndResetsPerSession) {
+    TraceRecorder recorder(4);
+    recorder.Start();
+    for (int i = 0; i < 10; ++i) {
+        recorder.Instant("tick", i);
+    }
+    recorder.Stop();
+    TP_ASSERT_EQ(recorder.GetRecordCount(), 4u);
+    TP_ASSERT_EQ(recorder.GetDroppedCount(), 6u);
+
+    // A new session starts from an empty buffer
+    recorder.Start();
+    recorder.Instant("tick", 0);
+    recorder.Stop();
+    TP_ASSERT_EQ(recorder.GetRecordCount(), 1u);
+    TP_ASSERT_EQ(recorder.GetDroppedCount(), 0u);
+}
+
+TP_TEST(testTraceRecorderKeepsThreadsApart) {
+    TraceRecorder recorder(1024);
+    recorder.Start();
+    std::thread first([&recorder]() {
+        for (int i = 0; i < 500; ++i) {
+            TraceSpan span(recorder, "first");
+        }
+    });
+    std::thread second([&recorder]() {
+        for (int i = 0; i < 500; ++i) {
+            TraceSpan span(recorder, "second");
+        }
+    });
+    first.join();
+    second.join();
+    recorder.Stop();
+
+    TP_ASSERT_EQ(recorder.GetRecordCount(), 2000u);
+    TP_ASSERT_EQ(recorder.GetDroppedCount(), 0u);
+
+    std::string path = TemporaryTracePath("threads");
+    TP_ASSERT_TRUE(recorder.ExportChromeJson(path));
+    std::string json = ReadFile(path);
+    unlink(path.c_str());
+    TP_ASSERT_EQ(CountOccurrences(json, "\"tid\":1"), 1000u);
+    TP_ASSERT_EQ(CountOccurrences(json, "\"tid\":2"), 1000u);
+}
+
+// Dispatch pool threads share one buffer instead of using up the thread slots
+TP_TEST(testTraceRecorderPooledThreadsShareOneBuffer) {
+    TraceRecorder recorder(1024);
+    recorder.Start();
+    for (size_t i = 0; i < TraceRecorder::kMaxThreads + 8; ++i) {
+        std::thread([&recorder]() {
+            TraceRecorder::SetThreadPooled();
+            TraceSpan span(recorder, "frame");
+        }).join();
+    }
+    std::thread([&recorder]() {
+        TraceSpan span(recorder, "dedicated");
+    }).join();
+    recorder.Stop();
+
+    TP_ASSERT_EQ(recorder.GetRecordCount(), 2 * (TraceRecorder::kMaxThreads + 8) + 2);
+    TP_ASSERT_EQ(recorder.GetDroppedCount(), 0u);
+
+    std::string path = TemporaryTracePath("pooled");
+    TP_ASSERT_TRUE(recorder.ExportChromeJson(path));
+    std::string json = ReadFile(path);
+    unlink(path.c_str());
+    // The shared buffer is tid 1, the dedicated thread tid 2; pooled records keep their own tids
+    TP_ASSERT_EQ(CountOccurrences(json, "\"tid\":1}"), 0u);
+    TP_ASSERT_EQ(CountOccurrences(json, "\"tid\":2}"), 2u);
+}
@@ -0,0 +1,97 @@
+#include "../../support/TestHarness.h"
+#include "../../../src/domain/services/AccelerationCurve.h"
+#include "../../../src/domain/services/ScrollEngine.h"
+#include <cmath>
+#include <memory>
+#include <vector>
+
+using namespace TPMiddle::Domain;
+
+TP_TEST(testAccelerationCurveLinearMatchesSpeed) {
+    AccelerationCurve curve;
+    TP_ASSERT_NEAR(curve.Evaluate(0, 0), 0.0, 1e-6);
+    TP_ASSERT_NEAR(curve.Evaluate(3, 4), 5.0, 1e-6);
+    TP_ASSERT_NEAR(curve.Evaluate(-7, 2), std::sqrt(53.0), 1e-5);
+
+    // Coarse region is interpolated between entries
+    TP_ASSERT_NEAR(curve.Evaluate(40, -30), 50.0, 1e-3);
+    TP_ASSERT_NEAR(curve.Evaluate(301, 17), std::sqrt(301.0 * 301.0 + 17.0 * 17.0), 1e-3);
+
+    // Beyond the table the speed saturates
+    TP_ASSERT_NEAR(curve.Evaluate(32767, -32768), AccelerationCurve::kMaxSpeed, 1e-3);
+}
+
+TP_TEST(testAccelerationCurveShapes) {
+    AccelerationCurve curve;
+    TP_ASSERT_TRUE(curve.Parse("power:2"));
+    TP_ASSERT_NEAR(curve.Evaluate(3, 4), 25.0, 1e-5);
+    TP_ASSERT_NEAR(curve.Evaluate(60, 80), 10000.0, 1.0);
+
+    TP_ASSERT_TRUE(curve.Parse("points:2,0;10,8;20,8"));
+    TP_ASSERT_NEAR(curve.Evaluate(1, 0), 0.0, 1e-6);     // Held below the first point
+    TP_ASSERT_NEAR(curve.Evaluate(6, 0), 4.0, 1e-6);
+    TP_ASSERT_NEAR(curve.Evaluate(15, 0), 8.0, 1e-6);
+    TP_ASSERT_NEAR(curve.Evaluate(100, 0), 8.0, 1e-6);   // Held beyond the last point
+
+    // Control points on the chord make the Bezier a straight line
+    TP_ASSERT_TRUE(curve.Parse("bezier:10,5;20,10;30,15"));
+    TP_ASSERT_NEAR(curve.Evaluate(0, 0), 0.0, 1e-5);
+    TP_ASSERT_NEAR(curve.Evaluate(12, 0), 6.0, 1e-4);
+    TP_ASSERT_NEAR(curve.Evaluate(30, 0), 15.0, 1e-5);
+    TP_ASSERT_NEAR(curve.Evaluate(100, 0), 15.0, 1e-5);
+    TP_ASSERT_EQ(curve.GetSpec().kind, AccelerationCurveKind::Bezier);
+}
+
+TP_TEST(testAccelerationCurveRejectsInvalidSpecs) {
+    AccelerationCurve curve;
+    TP_ASSERT_TRUE(curve.Parse("power:1.5"));
+
+    const char* invalid[] = {"", "cubic", "linear:2", "power:", "power:-1", "power:x",
+                             "points:", "points:1,1;1,2", "points:4", "bezier:1,1;2,2", "bezier:1,1;40,2;30,3"};
+    for (const char* text : invalid) {
+        TP_ASSERT_FALSE(curve.Parse(text));
+        TP_ASSERT_FALSE(curve.GetLastError().empty());
+    }
+
+    // A rejected spec leaves the previous curve in place
+    TP_ASSERT_EQ(curve.GetSpec().kind, AccelerationCurveKind::Power);
+    TP_ASSERT_NEAR(curve.Evaluate(4, 0), 8.0, 1e-5);
+}
+
+TP_TEST(testAccelerationCurveBatchMatchesScalar) {
+    AccelerationCurve curve;
+    TP_ASSERT_TRUE(curve.Parse("bezier:4,0;8,30;64,40"));
+
+    std::vector<int16_t> dx;
+    std::vector<int16_t> dy;
+    for (int i = -300; i <= 300; i += 7) {
+        dx.push_back(static_cast<int16_t>(i));
+        dy.push_back(static_cast<int16_t>((i * 13) % 211));
+    }
+    dx.push_back(-32768);
+    dy.push_back(-32768);
+
+    std::vector<float> values(dx.size());
+    curve.EvaluateBatch(dx.data(), dy.data(), dx.size(), values.data());
+    for (size_t i = 0; i < dx.size(); ++i) {
+        TP_ASSERT_EQ(values[i], curve.Evaluate(dx[i], dy[i]));
+    }
+}
+
+TP_TEST(testScrollEngineUsesConfiguredCurve) {
+    auto curve = std::make_shared<AccelerationCurve>();
+    TP_ASSERT_TRUE(curve->Parse("power:2"));
+
+    ScrollSettings settings;
+    settings.speedMultiplier = 1.0;
+    settings.acceleration = 2.0;
+    settings.naturalScrolling = false;
+    settings.accelerationCurve = curve;
+    ScrollEngine engine(settings);
+    engine.Reset(0);
+
+    // shape 25, dt 50 ms: factor = 1 + 25 * 2 * 0.05 = 3.5
+    ScrollOutput output = engine.ProcessMovement(50000000ULL, 3, 4);
+    TP_ASSERT_NEAR(output.deltaX, 10.5, 1e-6);
+    TP_ASSERT_NEAR(output.deltaY, 14.0, 1e-6);
+}
@@ -0,0 +1,150 @@
+#include "../../support/TestHarness.h"
+#include "../../../src/domain/services/MiddleButtonEmulator.h"
+
+using namespace TPMiddle::Domain;
+
+namespace {
+
+const uint64_t kMillisecond = 1000000ULL;
+
+} // namespace
+
+TP_TEST(testEmulatorForwardsPhysicalMiddleButton) {
+    MiddleButtonEmulator emulator;
+
+    MiddleButtonActions actions = emulator.Update(0, false, false, true);
+    TP_ASSERT_TRUE(actions.postMiddleDown);
+    TP_ASSERT_TRUE(emulator.IsScrollActive());
+
+    actions = emulator.Update(10 * kMillisecond, false, false, false);
+    TP_ASSERT_TRUE(actions.postMiddleUp);
+    TP_ASSERT_TRUE(actions.clearScroll);
+    TP_ASSERT_FALSE(emulator.IsScrollActive());
+}
+
+TP_TEST(testEmulatorChordWithinWindowEmulatesMiddle) {
+    MiddleButtonEmulator emulator(20 * kMillisecond);
+
+    TP_ASSERT_FALSE(emulator.Update(0, true, false, false).postMiddleDown);
+    MiddleButtonActions actions = emulator.Update(15 * kMillisecond, true, true, false);
+    TP_ASSERT_TRUE(actions.postMiddleDown);
+    TP_ASSERT_TRUE(emulator.IsMiddleEmulated());
+
+    // Releasing only one button keeps the emulated press
+    TP_ASSERT_FALSE(emulator.Update(30 * kMillisecond, false, true, false).postMiddleUp);
+    actions = emulator.Update(40 * kMillisecond, false, false, false);
+    TP_ASSERT_TRUE(actions.postMiddleUp);
+    TP_ASSERT_FALSE(emulator.IsMiddleEmulated());
+}
+
+TP_TEST(testEmulatorChordOutsideWindowIsIgnored) {
+    MiddleButtonEmulator emulator(20 * kMillisecond);
+
+    emulator.Update(0, true, false, false);
+    MiddleButtonActions actions = emulator.Update(50 * kMillisecond, true, true, false);
+    TP_ASSERT_FALSE(actions.postMiddleDown);
+    TP_ASSERT_FALSE(emulator.IsScrollActive());
+}
+
+TP_TEST(testEmulatorResetReleasesEmulatedMiddle) {
+    MiddleButtonEmulator emulator;
+    emulator.Update(0, true, true, false);
+    TP_ASSERT_TRUE(emulator.IsMiddleEmulated());
+
+    MiddleButtonActions actions = emulator.Reset();
+    TP_ASSERT_TRUE(actions.postMiddleUp);
+    TP_ASSERT_FALSE(emulator.IsScrollActive());
+    TP_ASSERT_FALSE(emulator.Reset().postMiddleUp);
+}
+
+TP_TEST(testEmulatorPassThroughNeverReplaysClicks) {
+    MiddleButtonEmulator emulator(20 * kMillisecond);
+
+    MiddleButtonActions actions = emulator.Update(0, true, false, false);
+    actions = emulator.Advance(30 * kMillisecond);
+    TP_ASSERT_FALSE(actions.postLeftDown);
+    actions = emulator.Update(40 * kMillisecond, false, false, false);
+    TP_ASSERT_FALSE(actions.postLeftUp);
+}
+
+TP_TEST(testEmulatorHoldReplaysTapAsClick) {
+    MiddleButtonEmulator emulator(20 * kMillisecond, ChordClickPolicy::Hold);
+
+    MiddleButtonActions actions = emulator.Update(0, true, false, false);
+    TP_ASSERT_FALSE(actions.postLeftDown);
+    TP_ASSERT_EQ(emulator.GetNextDeadline(), 20 * kMillisecond);
+
+    actions = emulator.Update(8 * kMillisecond, false, false, false);
+    TP_ASSERT_TRUE(actions.postLeftDown);
+    TP_ASSERT_TRUE(actions.postLeftUp);
+    TP_ASSERT_EQ(emulator.GetNextDeadline(), UINT64_MAX);
+}
+
+TP_TEST(testEmulatorHoldReleasesPressAtDeadline) {
+    MiddleButtonEmulator emulator(20 * kMillisecond, ChordClickPolicy::Hold);
+
+    emulator.Update(5 * kMillisecond, false, true, false);
+    TP_ASSERT_FALSE(emulator.Advance(24 * kMillisecond).postRightDown);
+    MiddleButtonActions actions = emulator.Advance(25 * kMillisecond);
+    TP_ASSERT_TRUE(actions.postRightDown);
+    TP_ASSERT_FALSE(actions.postRightUp);
+
+    // A late second button is an ordinary press, not a chord
+    actions = emulator.Update(60 * kMillisecond, true, true, false);
+    TP_ASSERT_TRUE(actions.postLeftDown);
+    TP_ASSERT_FALSE(actions.postMiddleDown);
+    actions = emulator.Update(70 * kMillisecond, false, false, false);
+    TP_ASSERT_TRUE(actions.postLeftUp);
+    TP_ASSERT_TRUE(actions.postRightUp);
+}
+
+TP_TEST(testEmulatorHoldSwallowsChordedClicks) {
+    MiddleButtonEmulator emulator(20 * kMillisecond, ChordClickPolicy::Hold);
+
+    emulator.Update(0, true, false, false);
+    MiddleButtonActions actions = emulator.Update(10 * kMillisecond, true, true, false);
+    TP_ASSERT_TRUE(actions.postMiddleDown);
+    TP_ASSERT_FALSE(actions.postLeftDown);
+    TP_ASSERT_FALSE(actions.postRightDown);
+    TP_ASSERT_FALSE(emulator.Advance(50 * kMillisecond).postLeftDown);
+
+    actions = emulator.Update(60 * kMillisecond, false, false, false);
+    TP_ASSERT_TRUE(actions.postMiddleUp);
+    TP_ASSERT_FALSE(actions.postLeftUp);
+    TP_ASSERT_FALSE(actions.postRightUp);
+}
+
+TP_TEST(testEmulatorQuickMiddleClickTogglesScrollMode) {
+    MiddleButtonEmulator emulator;
+    emulator.SetScrollToggleWindow(500 * kMillisecond);
+
+    emulator.Update(0, false, false, true);
+    TP_ASSERT_EQ(emulator.GetNextDeadline(), 500 * kMillisecond);
+    MiddleButtonActions actions = emulator.Update(100 * kMillisecond, false, false, false);
+    TP_ASSERT_TRUE(actions.postMiddleUp);
+    TP_ASSERT_TRUE(actions.scrollModeChanged);
+    TP_ASSERT_TRUE(emulator.IsScrollMode());
+
+    // Held past the window the click only releases the middle button
+    emulator.Update(1000 * kMillisecond, false, false, true);
+    actions = emulator.Update(1500 * kMillisecond, false, false, false);
+    TP_ASSERT_TRUE(actions.postMiddleUp);
+    TP_ASSERT_FALSE(actions.scrollModeChanged);
+    TP_ASSERT_TRUE(emulator.IsScrollMode());
+
+    emulator.Update(2000 * kMillisecond, false, false, true);
+    TP_ASSERT_TRUE(emulator.Update(2100 * kMillisecond, false, false, false).scrollModeChanged);
+    TP_ASSERT_FALSE(emulator.IsScrollMode());
+}
+
+TP_TEST(testEmulatorWithoutToggleWindowNeverTogglesScrollMode) {
+    MiddleButtonEmulator emulator;
+
+    emulator.Update(0, false, false, true);
+    TP_ASSERT_EQ(emulator.GetNextDeadline(), UINT64_MAX);
+    TP_ASSERT_TRUE(emulator.IsMiddlePressed());
+    MiddleButtonActions actions = emulator.Update(kMillisecond, false, false, false);
+    TP_ASSERT_TRUE(actions.postMiddleUp);
+    TP_ASSERT_FALSE(actions.scrollModeChanged);
+    TP_ASSERT_FALSE(emulator.IsScrollMode());
+}
@@ -0,0 +1,90 @@
+#include "../../support/TestHarness.h"
+#include "../../../src/domain/services/MomentumIntegrator.h"
+
+using namespace TPMiddle::Domain;
+
+namespace {
+
+const uint64_t kMillisecond = 1000000ULL;
+
+// Five samples of 10 px, 10 ms apart: 40 px over 40 ms = 1000 px/s
+void AddSteadyDrag(MomentumIntegrator& momentum) {
+    for (uint64_t i = 0; i < 5; ++i) {
+        momentum.AddSample(i * 10 * kMillisecond, 0.0, 10.0);
+    }
+}
+
+} // namespace
+
+TP_TEST(testMomentumEstimatesReleaseVelocity) {
+    MomentumIntegrator momentum(3.0, 5);
+    AddSteadyDrag(momentum);
+
+    TP_ASSERT_TRUE(momentum.Start(45 * kMillisecond));
+    TP_ASSERT_TRUE(momentum.IsActive());
+    TP_ASSERT_NEAR(momentum.GetVelocityX(), 0.0, 1e-9);
+    TP_ASSERT_NEAR(momentum.GetVelocityY(), 1000.0, 1e-6);
+
+    // No step is due until a full timestep has passed
+    TP_ASSERT_FALSE(momentum.Advance(45 * kMillisecond + MomentumIntegrator::kStepNs - 1).emit);
+    ScrollOutput step = momentum.Advance(45 * kMillisecond + MomentumIntegrator::kStepNs);
+    TP_ASSERT_TRUE(step.emit);
+    TP_ASSERT_TRUE(step.deltaY > 0.0 && step.deltaY < 1000.0 / 120.0);
+    TP_ASSERT_TRUE(momentum.GetVelocityY() < 1000.0);
+}
+
+TP_TEST(testMomentumIsIndependentOfAdvanceCadence) {
+    MomentumIntegrator coarse(3.0, 5);
+    MomentumIntegrator fine(3.0, 5);
+    AddSteadyDrag(coarse);
+    AddSteadyDrag(fine);
+    coarse.Start(40 * kMillisecond);
+    fine.Start(40 * kMillisecond);
+
+    // Irregular 17 ms wakeups against 1 ms wakeups cover the same steps
+    double coarseTotal = 0.0;
+    double fineTotal = 0.0;
+    uint64_t end = 40 * kMillisecond + 5000 * kMillisecond;
+    for (uint64_t t = 40 * kMillisecond; t <= end; t += 17 * kMillisecond) {
+        coarseTotal += coarse.Advance(t).deltaY;
+    }
+    coarseTotal += coarse.Advance(end).deltaY;
+    for (uint64_t t = 40 * kMillisecond; t <= end; t += kMillisecond) {
+        fineTotal += fine.Advance(t).deltaY;
+    }
+    TP_ASSERT_FALSE(coarse.IsActive());
+    TP_ASSERT_FALSE(fine.IsActive());
+    TP_ASSERT_EQ(coarseTotal, fineTotal);
+
+    // Exponential friction coasts roughly velocity / friction pixels
+    TP_ASSERT_TRUE(coarseTotal > 300.0 && coarseTotal < 340.0);
+}
+
+TP_TEST(testMomentumNeedsRecentFastDrag) {
+    MomentumIntegrator momentum(3.0, 5);
+
+    // Released well after the drag stopped
+    AddSteadyDrag(momentum);
+    TP_ASSERT_FALSE(momentum.Start(200 * kMillisecond));
+
+    // Too slow to coast
+    for (uint64_t i = 0; i < 5; ++i) {
+        momentum.AddSample(i * 100 * kMillisecond, 0.0, 1.0);
+    }
+    TP_ASSERT_FALSE(momentum.Start(400 * kMillisecond));
+
+    // A single sample gives no velocity
+    momentum.AddSample(500 * kMillisecond, 0.0, 50.0);
+    TP_ASSERT_FALSE(momentum.Start(500 * kMillisecond));
+}
+
+TP_TEST(testMomentumCancelStopsImmediately) {
+    MomentumIntegrator momentum(3.0, 5);
+    AddSteadyDrag(momentum);
+    TP_ASSERT_TRUE(momentum.Start(40 * kMillisecond));
+    TP_ASSERT_TRUE(momentum.Advance(60 * kMillisecond).emit);
+
+    momentum.Cancel();
+    TP_ASSERT_FALSE(momentum.IsActive());
+    TP_ASSERT_FALSE(momentum.Advance(100 * kMillisecond).emit);
+}
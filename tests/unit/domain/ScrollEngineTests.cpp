@@ -0,0 +1,107 @@
+#include "../../support/TestHarness.h"
+#include "../../../src/domain/services/ScrollEngine.h"
+
+using namespace TPMiddle::Domain;
+
+namespace {
+
+const uint64_t kMillisecond = 1000000ULL;
+
+ScrollSettings PlainSettings() {
+    ScrollSettings settings;
+    settings.speedMultiplier = 1.0;
+    settings.acceleration = 0.0;
+    settings.naturalScrolling = false;
+    return settings;
+}
+
+} // namespace
+
+TP_TEST(testScrollEngineAccumulatesBelowThreshold) {
+    ScrollSettings settings = PlainSettings();
+    settings.speedMultiplier = 0.25;
+    ScrollEngine engine(settings);
+    engine.Reset(0);
+
+    // 0.25 + 0.25 + 0.25 stays below the 1.0 threshold, the fourth sample crosses it
+    TP_ASSERT_FALSE(engine.ProcessMovement(1 * kMillisecond, 1, 0).emit);
+    TP_ASSERT_FALSE(engine.ProcessMovement(2 * kMillisecond, 1, 0).emit);
+    TP_ASSERT_FALSE(engine.ProcessMovement(3 * kMillisecond, 1, 0).emit);
+
+    ScrollOutput output = engine.ProcessMovement(4 * kMillisecond, 1, 0);
+    TP_ASSERT_TRUE(output.emit);
+    TP_ASSERT_NEAR(output.deltaX, 1.0, 1e-9);
+    TP_ASSERT_NEAR(output.deltaY, 0.0, 1e-9);
+}
+
+TP_TEST(testScrollEngineDirectionSigns) {
+    ScrollSettings settings = PlainSettings();
+    ScrollEngine engine(settings);
+
+    ScrollOutput output = engine.ProcessMovement(kMillisecond, 3, -2);
+    TP_ASSERT_NEAR(output.deltaX, 3.0, 1e-9);
+    TP_ASSERT_NEAR(output.deltaY, -2.0, 1e-9);
+
+    settings.invertX = true;
+    engine.Configure(settings);
+    output = engine.ProcessMovement(2 * kMillisecond, 3, -2);
+    TP_ASSERT_NEAR(output.deltaX, -3.0, 1e-9);
+    TP_ASSERT_NEAR(output.deltaY, -2.0, 1e-9);
+
+    // Natural scrolling flips both axes on top of inversion
+    settings.naturalScrolling = true;
+    engine.Configure(settings);
+    output = engine.ProcessMovement(3 * kMillisecond, 3, -2);
+    TP_ASSERT_NEAR(output.deltaX, 3.0, 1e-9);
+    TP_ASSERT_NEAR(output.deltaY, 2.0, 1e-9);
+}
+
+TP_TEST(testScrollEngineCapsSpeed) {
+    ScrollSettings settings = PlainSettings();
+    settings.maxScrollSpeed = 10.0;
+    ScrollEngine engine(settings);
+
+    ScrollOutput output = engine.ProcessMovement(kMillisecond, 100, -100);
+    TP_ASSERT_TRUE(output.emit);
+    TP_ASSERT_NEAR(output.deltaX, 10.0, 1e-9);
+    TP_ASSERT_NEAR(output.deltaY, -10.0, 1e-9);
+}
+
+TP_TEST(testScrollEngineAccelerationUsesCappedTimeDelta) {
+    ScrollSettings settings = PlainSettings();
+    settings.acceleration = 2.0;
+    ScrollEngine engine(settings);
+    engine.Reset(0);
+
+    // speed 5, dt 50 ms: factor = 1 + 5 * 2 * 0.05 = 1.5
+    ScrollOutput output = engine.ProcessMovement(50 * kMillisecond, 3, 4);
+    TP_ASSERT_NEAR(output.deltaX, 4.5, 1e-9);
+    TP_ASSERT_NEAR(output.deltaY, 6.0, 1e-9);
+
+    // dt of one second is capped at 100 ms: factor = 1 + 5 * 2 * 0.1 = 2
+    output = engine.ProcessMovement(1050 * kMillisecond, 3, 4);
+    TP_ASSERT_NEAR(output.deltaX, 6.0, 1e-9);
+    TP_ASSERT_NEAR(output.deltaY, 8.0, 1e-9);
+}
+
+TP_TEST(testScrollEngineClearAccumulatorDropsPendingMovement) {
+    ScrollSettings settings = PlainSettings();
+    settings.speedMultiplier = 0.5;
+    ScrollEngine engine(settings);
+
+    TP_ASSERT_FALSE(engine.ProcessMovement(kMillisecond, 1, 0).emit);
+    engine.ClearAccumulator();
+    TP_ASSERT_FALSE(engine.ProcessMovement(2 * kMillisecond, 1, 0).emit);
+    TP_ASSERT_TRUE(engine.ProcessMovement(3 * kMillisecond, 1, 0).emit);
+}
+
+TP_TEST(testScrollEngineZeroSpeedCapIsUncapped) {
+    ScrollSettings settings = PlainSettings();
+    settings.maxScrollSpeed = 0.0;
+    ScrollEngine engine(settings);
+
+    ScrollOutput output = engine.ProcessMovement(kMillisecond, 100, -100);
+    TP_ASSERT_TRUE(output.emit);
+    TP_ASSERT_NEAR(output.deltaX, 100.0, 1e-9);
+    TP_ASSERT_NEAR(output.deltaY, -100.0, 1e-9);
+}
@@ -0,0 +1,105 @@
+#include "../../support/TestHarness.h"
+#include "../../../src/domain/services/ScrollSynthesizer.h"
+
+using namespace TPMiddle::Domain;
+
+namespace {
+
+const uint64_t kMillisecond = 1000000ULL;
+
+} // namespace
+
+TP_TEST(testSynthesizerCarriesFractionalRemainder) {
+    ScrollSynthesizer synthesizer(0.0);
+
+    // 0.25 px per sample: nothing is lost, a pixel appears every fourth sample
+    int32_t total = 0;
+    int emitted = 0;
+    for (int i = 0; i < 12; ++i) {
+        ScrollFrame frame = synthesizer.Add(static_cast<uint64_t>(i) * kMillisecond, 0.0, 0.25);
+        if (frame.emit) {
+            total += frame.deltaY;
+            ++emitted;
+        }
+    }
+    TP_ASSERT_EQ(total, 3);
+    TP_ASSERT_EQ(emitted, 3);
+
+    // Negative motion truncates toward zero and keeps its own remainder
+    ScrollFrame frame = synthesizer.Add(20 * kMillisecond, -2.5, 0.0);
+    TP_ASSERT_TRUE(frame.emit);
+    TP_ASSERT_EQ(frame.deltaX, -2);
+    frame = synthesizer.Add(21 * kMillisecond, -0.5, 0.0);
+    TP_ASSERT_EQ(frame.deltaX, -1);
+}
+
+TP_TEST(testSynthesizerEmitsAtMostOncePerFrame) {
+    ScrollSynthesizer synthesizer(100.0);   // 10 ms frames
+    TP_ASSERT_EQ(synthesizer.GetFrameInterval(), 10 * kMillisecond);
+
+    // First motion after idle goes out immediately
+    ScrollFrame frame = synthesizer.Add(0, 0.0, 2.0);
+    TP_ASSERT_TRUE(frame.emit);
+    TP_ASSERT_EQ(frame.deltaY, 2);
+
+    // Motion inside the frame is coalesced until the frame is due
+    TP_ASSERT_FALSE(synthesizer.Add(2 * kMillisecond, 0.0, 1.5).emit);
+    TP_ASSERT_FALSE(synthesizer.Add(5 * kMillisecond, 0.0, 1.5).emit);
+    TP_ASSERT_TRUE(synthesizer.HasPending());
+    TP_ASSERT_EQ(synthesizer.GetNextFrameTime(), 10 * kMillisecond);
+    TP_ASSERT_FALSE(synthesizer.Tick(9 * kMillisecond).emit);
+
+    frame = synthesizer.Tick(10 * kMillisecond);
+    TP_ASSERT_TRUE(frame.emit);
+    TP_ASSERT_EQ(frame.deltaY, 3);
+    TP_ASSERT_FALSE(synthesizer.HasPending());
+    TP_ASSERT_FALSE(synthesizer.Tick(30 * kMillisecond).emit);
+}
+
+TP_TEST(testSynthesizerFlushDropsRemainder) {
+    ScrollSynthesizer synthesizer(100.0);
+    synthesizer.Add(0, 0.0, 1.0);
+    synthesizer.Add(1 * kMillisecond, 0.0, 2.75);
+
+    ScrollFrame frame = synthesizer.Flush(2 * kMillisecond);
+    TP_ASSERT_TRUE(frame.emit);
+    TP_ASSERT_EQ(frame.deltaY, 2);
+
+    // The 0.75 left over is dropped, so the next gesture starts clean
+    TP_ASSERT_FALSE(synthesizer.Add(50 * kMillisecond, 0.0, 0.5).emit);
+    TP_ASSERT_FALSE(synthesizer.Flush(60 * kMillisecond).emit);
+}
+
+TP_TEST(testSynthesizerCarriesOldestSourceTimestamp) {
+    ScrollSynthesizer synthesizer(100.0);
+    ScrollFrame frame = synthesizer.Add(1 * kMillisecond, 0.0, 2.0, 900000);
+    TP_ASSERT_TRUE(frame.emit);
+    TP_ASSERT_EQ(frame.sourceTimestamp, 900000u);
+
+    // A paced frame is attributed to the oldest input it carries, even when
+    // the timer posts it
+    synthesizer.Add(3 * kMillisecond, 0.0, 1.5, 2 * kMillisecond);
+    synthesizer.Add(6 * kMillisecond, 0.0, 1.5, 5 * kMillisecond);
+    frame = synthesizer.Tick(11 * kMillisecond);
+    TP_ASSERT_TRUE(frame.emit);
+    TP_ASSERT_EQ(frame.sourceTimestamp, 2 * kMillisecond);
+
+    // Scroll with no input behind it carries none
+    frame = synthesizer.Add(30 * kMillisecond, 0.0, 3.0);
+    TP_ASSERT_TRUE(frame.emit);
+    TP_ASSERT_EQ(frame.sourceTimestamp, 0u);
+}
+
+TP_TEST(testSynthesizerMomentumFramesCarryNoSource) {
+    ScrollSynthesizer synthesizer(100.0);
+    synthesizer.Add(0, 0.0, 2.0, 1);
+    synthesizer.Add(2 * kMillisecond, 0.0, 1.5, 2 * kMillisecond);
+
+    // Release flushes the input's pixels; the coast that follows has no input behind it
+    ScrollFrame frame = synthesizer.Flush(3 * kMillisecond);
+    TP_ASSERT_TRUE(frame.emit);
+    TP_ASSERT_EQ(frame.sourceTimestamp, 2 * kMillisecond);
+    frame = synthesizer.Add(20 * kMillisecond, 0.0, 4.0);
+    TP_ASSERT_TRUE(frame.emit);
+    TP_ASSERT_EQ(frame.sourceTimestamp, 0u);
+}
@@ -0,0 +1,214 @@
+#include "../../support/TestHarness.h"
+#include "../../../src/infrastructure/logging/BinaryLog.h"
+#include <string>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+using namespace TPMiddle::Infrastructure;
+
+namespace {
+
+std::string TemporaryLogPath(const char* name) {
+    return std::string("/tmp/tpmiddle-") + name + "-" + std::to_string(getpid()) + ".tplog";
+}
+
+std::vector<BinaryLogRecord> ReadRecords(const std::string& path, BinaryLogFileHeader& header) {
+    std::vector<BinaryLogRecord> records;
+    FILE* file = std::fopen(path.c_str(), "rb");
+    if (!file) {
+        return records;
+    }
+    if (ReadBinaryLogHeader(file, header)) {
+        BinaryLogRecord record;
+        while (std::fread(&record, sizeof(record), 1, file) == 1) {
+            records.push_back(record);
+        }
+    }
+    std::fclose(file);
+    return records;
+}
+
+bool Contains(const std::string& haystack, const char* needle) {
+    return haystack.find(needle) != std::string::npos;
+}
+
+} // namespace
+
+TP_TEST(testBinaryLogRoundTripsToTextFormat) {
+    std::string path = TemporaryLogPath("roundtrip");
+    BinaryLog log;
+    TP_ASSERT_TRUE(log.Open(path));
+
+    log.LogButtonState(true, false, true);
+    log.LogTrackpointMovement(-3, 7, 0x04);
+    log.LogMiddleButtonEmulation(true, 20.0);
+    log.LogScrollEvent(1.5, -2.25);
+    log.Close();
+
+    BinaryLogFileHeader header;
+    std::vector<BinaryLogRecord> records = ReadRecords(path, header);
+    TP_ASSERT_EQ(records.size(), 4u);
+    if (records.size() != 4) {
+        return;
+    }
+
+    std::string button = FormatBinaryLogRecord(header, records[0]);
+    TP_ASSERT_TRUE(Contains(button, "[Button Event] State Change:\n- Left Button: PRESSED\n"
+                                    "- Right Button: RELEASED\n- Middle Button: PRESSED\n"));
+    TP_ASSERT_EQ(button[0], '[');
+    TP_ASSERT_EQ(button[24], ']');   // "[yyyy-MM-dd HH:mm:ss.SSS]"
+
+    std::string movement = FormatBinaryLogRecord(header, records[1]);
+    TP_ASSERT_TRUE(Contains(movement, "- Delta X: -3\n- Delta Y: 7\n- Button State: 0x04"));
+
+    std::string emulation = FormatBinaryLogRecord(header, records[2]);
+    TP_ASSERT_TRUE(Contains(emulation, "- State: ACTIVATED\n- Delay Setting: 20.00 ms"));
+
+    std::string scroll = FormatBinaryLogRecord(header, records[3]);
+    TP_ASSERT_TRUE(Contains(scroll, "- Delta X: 1.50\n- Delta Y: -2.25"));
+    TP_ASSERT_FALSE(Contains(scroll, "Speed Multiplier"));
+
+    // Older files carry the scroll settings in every scroll record
+    BinaryLogRecord legacy = records[3];
+    legacy.argCount = 5;
+    legacy.args[2].f = 0.5f;
+    legacy.args[3].f = 1.2f;
+    legacy.args[4].i = 1;
+    TP_ASSERT_TRUE(Contains(FormatBinaryLogRecord(header, legacy),
+                            "- Delta X: 1.50\n- Delta Y: -2.25\n- Speed Multiplier: 0.50\n"
+                            "- Acceleration: 1.20\n- Natural Scrolling: ON"));
+
+    TP_ASSERT_TRUE(records[0].timestamp <= records[3].timestamp);
+    unlink(path.c_str());
+}
+
+TP_TEST(testBinaryLogConcurrentProducersKeepEveryRecord) {
+    std::string path = TemporaryLogPath("concurrent");
+    BinaryLog log;
+    TP_ASSERT_TRUE(log.Open(path));
+
+    const int kThreads = 4;
+    const int kPerThread = 1000;
+    std::vector<std::thread> producers;
+    for (int t = 0; t < kThreads; ++t) {
+        producers.emplace_back([&log, t] {
+            for (int i = 0; i < kPerThread; ++i) {
+                log.LogTrackpointMovement(t, i, 0);
+                if ((i & 63) == 0) {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+    for (std::thread& producer : producers) {
+        producer.join();
+    }
+    log.Close();
+
+    BinaryLogFileHeader header;
+    std::vector<BinaryLogRecord> records = ReadRecords(path, header);
+    size_t movementRecords = 0;
+    int32_t dropped = 0;
+    for (const BinaryLogRecord& record : records) {
+        if (record.type == static_cast<uint16_t>(LogEventType::TrackpointMovement)) {
+            ++movementRecords;
+        } else if (record.type == static_cast<uint16_t>(LogEventType::RecordsDropped)) {
+            dropped += record.args[0].i;
+        }
+    }
+    TP_ASSERT_EQ(movementRecords + static_cast<size_t>(dropped), static_cast<size_t>(kThreads * kPerThread));
+    TP_ASSERT_EQ(static_cast<uint64_t>(dropped), log.GetDroppedCount());
+    unlink(path.c_str());
+}
+
+TP_TEST(testBinaryLogDropsAndReportsWhenRingIsFull) {
+    std::string path = TemporaryLogPath("overflow");
+    BinaryLog log;
+    TP_ASSERT_TRUE(log.Open(path));
+
+    // Outrun the 20 ms flusher interval with more records than the ring holds
+    for (size_t i = 0; i < BinaryLog::kRingCapacity * 3; ++i) {
+        log.LogButtonState(i & 1, false, false);
+    }
+    uint64_t dropped = log.GetDroppedCount();
+    log.Close();
+
+    BinaryLogFileHeader header;
+    std::vector<BinaryLogRecord> records = ReadRecords(path, header);
+    int64_t reported = 0;
+    size_t kept = 0;
+    for (const BinaryLogRecord& record : records) {
+        if (record.type == static_cast<uint16_t>(LogEventType::RecordsDropped)) {
+            reported += record.args[0].i;
+        } else {
+            ++kept;
+        }
+    }
+    TP_ASSERT_EQ(static_cast<uint64_t>(reported), dropped);
+    TP_ASSERT_EQ(kept + static_cast<size_t>(reported), BinaryLog::kRingCapacity * 3);
+    unlink(path.c_str());
+}
+
+TP_TEST(testBinaryLogAppendsSessionsToExistingFile) {
+    std::string path = TemporaryLogPath("sessions");
+    unlink(path.c_str());
+    {
+        BinaryLog log;
+        TP_ASSERT_TRUE(log.Open(path));
+        log.LogButtonState(true, false, false);
+        log.Close();
+    }
+
+    // A torn record from an interrupted session is cut off before appending
+    FILE* file = std::fopen(path.c_str(), "ab");
+    TP_ASSERT_TRUE(file != nullptr);
+    std::fwrite("torn", 1, 4, file);
+    std::fclose(file);
+    {
+        BinaryLog log;
+        TP_ASSERT_TRUE(log.Open(path));
+        log.LogButtonState(false, true, false);
+        log.Close();
+    }
+
+    BinaryLogFileHeader header;
+    std::vector<BinaryLogRecord> records = ReadRecords(path, header);
+    TP_ASSERT_EQ(records.size(), 3u);
+    if (records.size() != 3) {
+        return;
+    }
+    TP_ASSERT_EQ(records[0].type, static_cast<uint16_t>(LogEventType::ButtonState));
+    TP_ASSERT_EQ(records[1].type, static_cast<uint16_t>(LogEventType::SessionStart));
+    TP_ASSERT_EQ(records[2].type, static_cast<uint16_t>(LogEventType::ButtonState));
+    TP_ASSERT_TRUE(Contains(FormatBinaryLogRecord(header, records[1]), "[Logger] Logging session started"));
+
+    // The second session is timed against its own clock pair
+    BinaryLogFileHeader first = header;
+    ApplyBinaryLogSession(header, records[0]);
+    TP_ASSERT_EQ(header.monotonicAtOpen, first.monotonicAtOpen);
+    ApplyBinaryLogSession(header, records[1]);
+    TP_ASSERT_EQ(header.monotonicAtOpen, records[1].timestamp);
+    TP_ASSERT_TRUE(header.wallClockAtOpen >= first.wallClockAtOpen);
+    unlink(path.c_str());
+}
+
+TP_TEST(testBinaryLogLeavesForeignFilesUntouched) {
+    std::string path = TemporaryLogPath("foreign");
+    FILE* file = std::fopen(path.c_str(), "wb");
+    TP_ASSERT_TRUE(file != nullptr);
+    const char text[] = "not a binary log, but long enough to hold a header";
+    std::fwrite(text, 1, sizeof(text), file);
+    std::fclose(file);
+
+    BinaryLog log;
+    TP_ASSERT_FALSE(log.Open(path));
+    TP_ASSERT_FALSE(log.IsOpen());
+
+    file = std::fopen(path.c_str(), "rb");
+    char contents[sizeof(text)] = {};
+    TP_ASSERT_EQ(std::fread(contents, 1, sizeof(contents), file), sizeof(text));
+    std::fclose(file);
+    TP_ASSERT_EQ(std::string(contents), std::string(text));
+    unlink(path.c_str());
+}
@@ -0,0 +1,70 @@
+#include "../../support/TestHarness.h"
+#include "../../../src/domain/models/HIDUsage.h"
+#include "../../../src/infrastructure/hid/ElementDispatchTable.h"
+
+using namespace TPMiddle::Domain;
+using namespace TPMiddle::Infrastructure;
+
+namespace {
+
+// Cookies as a composite TrackPoint keyboard reports them: keys first
+const HIDElementInfo kElements[] = {
+    {2, 0x07, 0x04, 0, 1},                                          // Keyboard a
+    {3, 0x07, 0x05, 0, 1},
+    {10, HIDUsage::kPageButton, HIDUsage::kButtonLeft, 0, 1},
+    {11, HIDUsage::kPageButton, HIDUsage::kButtonRight, 0, 1},
+    {12, HIDUsage::kPageButton, HIDUsage::kButtonMiddle, 0, 1},
+    {13, HIDUsage::kPageGenericDesktop, HIDUsage::kX, -127, 127},
+    {14, HIDUsage::kPageGenericDesktop, HIDUsage::kY, -127, 127},
+    {15, HIDUsage::kPageGenericDesktop, HIDUsage::kWheel, -127, 127},
+    {16, HIDUsage::kPageConsumer, HIDUsage::kACPan, -127, 127},
+};
+
+} // namespace
+
+TP_TEST(testDispatchTableMapsConsumedElements) {
+    ElementDispatchTable table;
+    TP_ASSERT_TRUE(table.Build(kElements, sizeof(kElements) / sizeof(kElements[0]), HIDElementFilter::Pointer()));
+    TP_ASSERT_EQ(table.GetMappedCount(), 6u);
+
+    const ElementDispatchSlot* middle = table.Find(12);
+    TP_ASSERT_TRUE(middle != nullptr);
+    TP_ASSERT_TRUE(middle->handler == ElementHandler::Button);
+    TP_ASSERT_EQ(middle->index, 2);
+    TP_ASSERT_EQ(middle->usage, HIDUsage::kButtonMiddle);
+
+    const ElementDispatchSlot* y = table.Find(14);
+    TP_ASSERT_TRUE(y != nullptr);
+    TP_ASSERT_TRUE(y->handler == ElementHandler::Axis);
+    TP_ASSERT_EQ(y->index, 1);
+    TP_ASSERT_TRUE(table.Find(15)->handler == ElementHandler::Wheel);
+}
+
+TP_TEST(testDispatchTableLeavesOtherCookiesUnmapped) {
+    ElementDispatchTable table;
+    table.Build(kElements, sizeof(kElements) / sizeof(kElements[0]), HIDElementFilter::Pointer());
+
+    TP_ASSERT_TRUE(table.Find(2) == nullptr);     // Below the first mapped cookie
+    TP_ASSERT_TRUE(table.Find(16) == nullptr);    // AC Pan is not consumed per element
+    TP_ASSERT_TRUE(table.Find(17) == nullptr);
+    TP_ASSERT_TRUE(table.Find(0xFFFFFFFFu) == nullptr);
+
+    // Nothing consumable leaves an empty table
+    TP_ASSERT_FALSE(table.Build(kElements, 2, HIDElementFilter::Pointer()));
+    TP_ASSERT_TRUE(table.IsEmpty());
+    TP_ASSERT_TRUE(table.Find(10) == nullptr);
+}
+
+TP_TEST(testDispatchSlotClampsToLogicalRange) {
+    ElementDispatchTable table;
+    table.Build(kElements, sizeof(kElements) / sizeof(kElements[0]), HIDElementFilter::Pointer());
+
+    const ElementDispatchSlot* x = table.Find(13);
+    TP_ASSERT_EQ(x->Clamp(-5), -5);
+    TP_ASSERT_EQ(x->Clamp(300), 127);
+    TP_ASSERT_EQ(x->Clamp(-300), -127);
+
+    // No logical range: values pass unchanged
+    ElementDispatchSlot unbounded;
+    TP_ASSERT_EQ(unbounded.Clamp(1000), 1000);
+}
@@ -0,0 +1,216 @@
+// epoll is Linux only; the loop is exercised over pipes, so no input device is needed
+#ifdef __linux__
+
+#include "../../support/TestHarness.h"
+#include "../../../src/infrastructure/evdev/EvdevInputLoop.h"
+#include <fcntl.h>
+#include <string>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <vector>
+
+using namespace TPMiddle::Application;
+using namespace TPMiddle::Infrastructure;
+using namespace TPMiddle::Domain;
+
+namespace {
+
+const uint64_t kMillisecond = 1000000ULL;
+
+uint64_t g_now = 0;
+
+uint64_t FakeClock() {
+    return g_now;
+}
+
+// One pipe standing in for an evdev node and one for the uinput device
+struct FakeDevices {
+    int input[2];
+    int output[2];
+
+    FakeDevices() {
+        pipe2(input, O_NONBLOCK | O_CLOEXEC);
+        pipe2(output, O_NONBLOCK | O_CLOEXEC);
+    }
+    ~FakeDevices() {
+        if (input[1] >= 0) {
+            close(input[1]);
+        }
+        close(output[0]);
+        close(output[1]);
+    }
+
+    void Write(uint64_t timestampNs, std::vector<EvdevWireEvent> events) {
+        events.push_back(EvdevWireEvent{});
+        for (EvdevWireEvent& event : events) {
+            event.time.tv_sec = static_cast<time_t>(timestampNs / 1000000000ULL);
+            event.time.tv_usec = static_cast<suseconds_t>(timestampNs % 1000000000ULL / 1000);
+        }
+        write(input[1], events.data(), events.size() * sizeof(EvdevWireEvent));
+    }
+
+    std::vector<EvdevWireEvent> Read() {
+        std::vector<EvdevWireEvent> events(256);
+        ssize_t bytes = read(output[0], events.data(), events.size() * sizeof(EvdevWireEvent));
+        events.resize(bytes > 0 ? static_cast<size_t>(bytes) / sizeof(EvdevWireEvent) : 0);
+        return events;
+    }
+};
+
+EvdevWireEvent Key(uint16_t code, int32_t value) {
+    return EvdevWireEvent{{0, 0}, Evdev::kEventKey, code, value};
+}
+
+EvdevWireEvent Rel(uint16_t code, int32_t value) {
+    return EvdevWireEvent{{0, 0}, Evdev::kEventRelative, code, value};
+}
+
+bool Contains(const std::vector<EvdevWireEvent>& events, uint16_t type, uint16_t code, int32_t value) {
+    for (const EvdevWireEvent& event : events) {
+        if (event.type == type && event.code == code && event.value == value) {
+            return true;
+        }
+    }
+    return false;
+}
+
+} // namespace
+
+TP_TEST(testEvdevLoopMiddleDragScrollsThroughUinput) {
+    FakeDevices fake;
+    UinputWriter writer(fake.output[1]);
+    ScrollSettings settings;
+    settings.acceleration = 0.0;
+    settings.frameRate = 0.0;
+    InputPipeline pipeline(writer, settings);
+    EvdevInputLoop loop(pipeline, writer, &FakeClock);
+    g_now = 0;
+    TP_ASSERT_TRUE(loop.Initialize());
+    TP_ASSERT_TRUE(loop.AddDevice(fake.input[0]));
+
+    fake.Write(100 * kMillisecond, {Key(Evdev::kButtonMiddle, 1)});
+    for (int i = 1; i <= 20; ++i) {
+        fake.Write((100 + i) * kMillisecond, {Rel(Evdev::kRelativeY, -4)});
+    }
+    g_now = 121 * kMillisecond;
+    TP_ASSERT_TRUE(loop.RunOnce(0));
+
+    // Every report arrived in one read and left in one write
+    TP_ASSERT_EQ(loop.GetStatistics().reads, 1u);
+    TP_ASSERT_EQ(loop.GetStatistics().samples, 21u);
+    TP_ASSERT_EQ(writer.GetStatistics().writes, 1u);
+    std::vector<EvdevWireEvent> output = fake.Read();
+    TP_ASSERT_TRUE(Contains(output, Evdev::kEventKey, Evdev::kButtonMiddle, 1));
+    bool scrolled = false;
+    for (const EvdevWireEvent& event : output) {
+        scrolled = scrolled || (event.type == Evdev::kEventRelative && event.code == Evdev::kRelativeWheelHiRes);
+        TP_ASSERT_FALSE(event.type == Evdev::kEventRelative && event.code == Evdev::kRelativeY);
+    }
+    TP_ASSERT_TRUE(scrolled);
+
+    fake.Write(800 * kMillisecond, {Key(Evdev::kButtonMiddle, 0)});
+    g_now = 800 * kMillisecond;
+    loop.RunOnce(0);
+    TP_ASSERT_TRUE(Contains(fake.Read(), Evdev::kEventKey, Evdev::kButtonMiddle, 0));
+}
+
+TP_TEST(testEvdevLoopReleasesHeldClickWhenChordWindowCloses) {
+    FakeDevices fake;
+    UinputWriter writer(fake.output[1]);
+    InputPipeline pipeline(writer, ScrollSettings(), 20 * kMillisecond);
+    pipeline.SetClickPolicy(ChordClickPolicy::Hold);
+    EvdevInputLoop loop(pipeline, writer, &FakeClock);
+    g_now = 0;
+    loop.Initialize();
+    loop.AddDevice(fake.input[0]);
+
+    fake.Write(10 * kMillisecond, {Key(Evdev::kButtonLeft, 1)});
+    g_now = 10 * kMillisecond;
+    loop.RunOnce(0);
+    TP_ASSERT_TRUE(fake.Read().empty());
+
+    // No new input: the wakeup comes from the pipeline deadline alone
+    g_now = 30 * kMillisecond;
+    loop.RunOnce(0);
+    TP_ASSERT_TRUE(Contains(fake.Read(), Evdev::kEventKey, Evdev::kButtonLeft, 1));
+
+    fake.Write(40 * kMillisecond, {Rel(Evdev::kRelativeX, 5)});
+    g_now = 40 * kMillisecond;
+    loop.RunOnce(0);
+    TP_ASSERT_TRUE(Contains(fake.Read(), Evdev::kEventRelative, Evdev::kRelativeX, 5));
+}
+
+TP_TEST(testEvdevLoopRemovesClosedDevice) {
+    FakeDevices fake;
+    UinputWriter writer(fake.output[1]);
+    InputPipeline pipeline(writer);
+    EvdevInputLoop loop(pipeline, writer, &FakeClock);
+    loop.Initialize();
+    loop.AddDevice(fake.input[0]);
+    TP_ASSERT_EQ(loop.GetDeviceCount(), 1u);
+
+    close(fake.input[1]);
+    fake.input[1] = -1;
+    loop.RunOnce(0);
+    TP_ASSERT_EQ(loop.GetDeviceCount(), 0u);
+    TP_ASSERT_EQ(loop.GetStatistics().devicesRemoved, 1u);
+}
+
+// A device node appearing in the watched directory is reported once per wakeup
+TP_TEST(testEvdevLoopReportsNodesAddedToWatchedDirectory) {
+    FakeDevices fake;
+    UinputWriter writer(fake.output[1]);
+    InputPipeline pipeline(writer);
+    EvdevInputLoop loop(pipeline, writer, &FakeClock);
+    loop.Initialize();
+    char directory[] = "/tmp/tpmiddle-input-XXXXXX";
+    TP_ASSERT_TRUE(mkdtemp(directory) != nullptr);
+    TP_ASSERT_TRUE(loop.WatchDirectory(directory));
+
+    std::string node = std::string(directory) + "/event7";
+    std::string other = std::string(directory) + "/mouse0";
+    close(open(node.c_str(), O_CREAT | O_WRONLY, 0600));
+    close(open(other.c_str(), O_CREAT | O_WRONLY, 0600));
+    chmod(node.c_str(), 0660);
+    loop.RunOnce(0);
+    std::vector<std::string> added = loop.TakeAddedNodes();
+    TP_ASSERT_EQ(added.size(), 1u);
+    TP_ASSERT_EQ(added[0], node);
+    TP_ASSERT_TRUE(loop.TakeAddedNodes().empty());
+
+    TP_ASSERT_FALSE(loop.HasDevice(node));
+    loop.AddDevice(fake.input[0], node);
+    TP_ASSERT_TRUE(loop.HasDevice(node));
+
+    unlink(node.c_str());
+    unlink(other.c_str());
+    rmdir(directory);
+}
+
+TP_TEST(testEvdevLoopRecordsLiveCountersPerWakeup) {
+    FakeDevices fake;
+    UinputWriter writer(fake.output[1]);
+    ScrollSettings settings;
+    settings.frameRate = 0.0;
+    InputPipeline pipeline(writer, settings);
+    EvdevInputLoop loop(pipeline, writer, &FakeClock);
+    LiveCounters counters;
+    loop.SetCounters(&counters);
+    g_now = 0;
+    loop.Initialize();
+    loop.AddDevice(fake.input[0]);
+
+    fake.Write(100 * kMillisecond, {Key(Evdev::kButtonMiddle, 1)});
+    for (int i = 1; i <= 5; ++i) {
+        fake.Write((100 + i) * kMillisecond, {Rel(Evdev::kRelativeY, -4)});
+    }
+    g_now = 105 * kMillisecond;
+    TP_ASSERT_TRUE(loop.RunOnce(0));
+
+    TP_ASSERT_EQ(counters.Get(LiveCounter::EventsProcessed), 6u);
+    TP_ASSERT_EQ(counters.Get(LiveCounter::MiddleButtonEvents), 1u);
+    TP_ASSERT_EQ(counters.Get(LiveCounter::ChordDetections), 0u);
+    TP_ASSERT_TRUE(counters.Get(LiveCounter::ScrollEvents) > 0);
+}
+
+#endif // __linux__
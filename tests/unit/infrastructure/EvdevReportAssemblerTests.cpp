@@ -0,0 +1,89 @@
+#include "../../support/TestHarness.h"
+#include "../../../src/infrastructure/evdev/EvdevReportAssembler.h"
+#include "../../../src/domain/models/HIDUsage.h"
+#include <vector>
+
+using namespace TPMiddle::Infrastructure;
+using namespace TPMiddle::Domain;
+
+namespace {
+
+EvdevWireEvent Wire(uint64_t timestampUs, uint16_t type, uint16_t code, int32_t value) {
+    EvdevWireEvent event = {};
+    event.time.tv_sec = static_cast<time_t>(timestampUs / 1000000);
+    event.time.tv_usec = static_cast<suseconds_t>(timestampUs % 1000000);
+    event.type = type;
+    event.code = code;
+    event.value = value;
+    return event;
+}
+
+EvdevWireEvent Sync(uint64_t timestampUs, uint16_t code = Evdev::kSyncReport) {
+    return Wire(timestampUs, Evdev::kEventSync, code, 0);
+}
+
+} // namespace
+
+TP_TEST(testAssemblerMakesOneSamplePerReport) {
+    EvdevReportAssembler assembler(7);
+    std::vector<EvdevWireEvent> events = {
+        Wire(1000, Evdev::kEventKey, Evdev::kButtonMiddle, 1),
+        Wire(1000, Evdev::kEventRelative, Evdev::kRelativeX, 3),
+        Wire(1000, Evdev::kEventRelative, Evdev::kRelativeY, -2),
+        Sync(1000),
+        Wire(2000, Evdev::kEventRelative, Evdev::kRelativeY, -4),
+        Wire(2000, Evdev::kEventRelative, Evdev::kRelativeWheelHiRes, 120),
+        Wire(2000, Evdev::kEventRelative, Evdev::kRelativeWheel, 1),
+        Sync(2000),
+        Sync(3000),     // Nothing changed, no sample
+    };
+    InputEvent samples[9];
+    TP_ASSERT_EQ(assembler.Assemble(events.data(), events.size(), samples), 2u);
+
+    TP_ASSERT_TRUE(samples[0].type == InputEventType::Pointer);
+    TP_ASSERT_EQ(samples[0].device, 7u);
+    TP_ASSERT_EQ(samples[0].timestamp, 1000000ULL);
+    TP_ASSERT_EQ(samples[0].pointer.buttons, kButtonMaskMiddle);
+    TP_ASSERT_EQ(samples[0].pointer.deltaX, 3);
+    TP_ASSERT_EQ(samples[0].pointer.deltaY, -2);
+
+    // High-resolution wheel units are not double counted
+    TP_ASSERT_EQ(samples[1].pointer.deltaY, -4);
+    TP_ASSERT_EQ(samples[1].pointer.wheel, 1);
+    TP_ASSERT_EQ(samples[1].pointer.buttons, kButtonMaskMiddle);
+}
+
+TP_TEST(testAssemblerKeepsFramesSplitAcrossReads) {
+    EvdevReportAssembler assembler;
+    EvdevWireEvent first[] = {Wire(500, Evdev::kEventRelative, Evdev::kRelativeX, 40000)};
+    EvdevWireEvent second[] = {Wire(500, Evdev::kEventRelative, Evdev::kRelativeX, 1), Sync(500)};
+    InputEvent samples[2];
+
+    TP_ASSERT_EQ(assembler.Assemble(first, 1, samples), 0u);
+    TP_ASSERT_EQ(assembler.Assemble(second, 2, samples), 1u);
+    TP_ASSERT_EQ(samples[0].pointer.deltaX, 32767);
+}
+
+TP_TEST(testAssemblerDiscardsFrameAfterSynDropped) {
+    EvdevReportAssembler assembler;
+    std::vector<EvdevWireEvent> events = {
+        Wire(100, Evdev::kEventKey, Evdev::kButtonLeft, 1),
+        Sync(100, Evdev::kSyncDropped),
+        Wire(200, Evdev::kEventRelative, Evdev::kRelativeX, 5),
+        Sync(200),
+        Wire(300, Evdev::kEventRelative, Evdev::kRelativeX, 6),
+        Sync(300),
+    };
+    InputEvent samples[6];
+    TP_ASSERT_EQ(assembler.Assemble(events.data(), events.size(), samples), 1u);
+    TP_ASSERT_EQ(samples[0].pointer.deltaX, 6);
+    TP_ASSERT_EQ(samples[0].pointer.buttons, 0);
+    TP_ASSERT_EQ(assembler.GetStatistics().droppedFrames, 1u);
+
+    // A resynchronized button state is reported with the next frame
+    assembler.SetButtons(kButtonMaskLeft);
+    EvdevWireEvent release[] = {Wire(400, Evdev::kEventKey, Evdev::kButtonLeft, 0), Sync(400)};
+    TP_ASSERT_EQ(assembler.Assemble(release, 2, samples), 1u);
+    TP_ASSERT_EQ(samples[0].pointer.buttons, 0);
+    TP_ASSERT_EQ(assembler.GetButtons(), 0);
+}
@@ -0,0 +1,65 @@
+#include "../../support/TestHarness.h"
+#include "../../../src/domain/models/HIDUsage.h"
+#include "../../../src/infrastructure/hid/HIDMatching.h"
+
+using namespace TPMiddle::Domain;
+using namespace TPMiddle::Infrastructure;
+
+namespace {
+
+const uint32_t kLenovo = 0x17EF;
+
+HIDDeviceProperties Device(uint32_t vendor, uint16_t usagePage, uint16_t usage) {
+    HIDDeviceProperties device;
+    device.vendorID = vendor;
+    device.productID = 0x6047;
+    device.usages.push_back({usagePage, usage});
+    return device;
+}
+
+} // namespace
+
+TP_TEST(testMatcherAccumulatesCriteriaSets) {
+    HIDDeviceMatcher matcher;
+    TP_ASSERT_FALSE(matcher.Matches(Device(kLenovo, HIDUsage::kPageGenericDesktop, HIDUsage::kMouse)));
+
+    matcher.Add(HIDMatchCriteria::Usage(HIDUsage::kPageGenericDesktop, HIDUsage::kMouse).Vendor(kLenovo));
+    matcher.Add(HIDMatchCriteria::Usage(HIDUsage::kPageGenericDesktop, HIDUsage::kPointer).Vendor(kLenovo));
+    matcher.Add(HIDMatchCriteria::Usage(HIDUsage::kPageGenericDesktop, HIDUsage::kMouse).Vendor(kLenovo));
+    TP_ASSERT_EQ(matcher.GetCriteria().size(), 2u);
+
+    // Either set matches, and the later one did not replace the earlier
+    TP_ASSERT_TRUE(matcher.Matches(Device(kLenovo, HIDUsage::kPageGenericDesktop, HIDUsage::kMouse)));
+    TP_ASSERT_TRUE(matcher.Matches(Device(kLenovo, HIDUsage::kPageGenericDesktop, HIDUsage::kPointer)));
+}
+
+TP_TEST(testMatcherRejectsKeyboardInterfacesOfMatchingVendor) {
+    HIDDeviceMatcher matcher;
+    matcher.Add(HIDMatchCriteria::Usage(HIDUsage::kPageGenericDesktop, HIDUsage::kMouse).Vendor(kLenovo));
+
+    const uint16_t kKeyboard = 0x06;
+    TP_ASSERT_FALSE(matcher.Matches(Device(kLenovo, HIDUsage::kPageGenericDesktop, kKeyboard)));
+    TP_ASSERT_FALSE(matcher.Matches(Device(kLenovo, HIDUsage::kPageConsumer, 0x01)));
+    TP_ASSERT_FALSE(matcher.Matches(Device(0x046D, HIDUsage::kPageGenericDesktop, HIDUsage::kMouse)));
+
+    // A composite device matches through any of its usage pairs
+    HIDDeviceProperties composite = Device(kLenovo, HIDUsage::kPageGenericDesktop, kKeyboard);
+    composite.usages.push_back({HIDUsage::kPageGenericDesktop, HIDUsage::kMouse});
+    TP_ASSERT_TRUE(matcher.Matches(composite));
+}
+
+TP_TEST(testPointerElementFilterPassesOnlyConsumedElements) {
+    HIDElementFilter filter = HIDElementFilter::Pointer();
+
+    TP_ASSERT_TRUE(filter.Accepts(HIDUsage::kPageButton, HIDUsage::kButtonLeft));
+    TP_ASSERT_TRUE(filter.Accepts(HIDUsage::kPageButton, HIDUsage::kButtonMiddle));
+    TP_ASSERT_TRUE(filter.Accepts(HIDUsage::kPageGenericDesktop, HIDUsage::kX));
+    TP_ASSERT_TRUE(filter.Accepts(HIDUsage::kPageGenericDesktop, HIDUsage::kY));
+    TP_ASSERT_TRUE(filter.Accepts(HIDUsage::kPageGenericDesktop, HIDUsage::kWheel));
+
+    const uint16_t kPageKeyboard = 0x07;
+    TP_ASSERT_FALSE(filter.Accepts(kPageKeyboard, 0x04));
+    TP_ASSERT_FALSE(filter.Accepts(HIDUsage::kPageConsumer, 0xE9));
+    TP_ASSERT_FALSE(filter.Accepts(HIDUsage::kPageButton, 4));
+    TP_ASSERT_FALSE(filter.Accepts(HIDUsage::kPageGenericDesktop, 0x32));
+}
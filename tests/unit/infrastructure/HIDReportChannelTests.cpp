@@ -0,0 +1,207 @@
+#include "../../support/TestHarness.h"
+#include "../../../src/infrastructure/hid/HIDReportChannel.h"
+#include <cstring>
+#include <thread>
+#include <vector>
+
+using namespace TPMiddle::Infrastructure;
+
+namespace {
+
+// Records submitted requests so the test can complete them like a run loop would
+class FakeReportBackend : public IHIDReportBackend {
+public:
+    bool accept = true;
+    std::vector<ReportRequest*> pending;
+
+    bool SubmitReport(ReportRequest& request) override {
+        if (!accept) {
+            return false;
+        }
+        pending.push_back(&request);
+        return true;
+    }
+};
+
+struct CompletionRecord {
+    int calls = 0;
+    bool success = false;
+    std::vector<uint8_t> bytes;
+    PooledReport kept;
+};
+
+void RecordCompletion(void* context, bool success, PooledReport& report) {
+    CompletionRecord* record = static_cast<CompletionRecord*>(context);
+    ++record->calls;
+    record->success = success;
+    ReportView view = report.View();
+    record->bytes.assign(view.data, view.data + view.size);
+}
+
+void KeepCompletion(void* context, bool success, PooledReport& report) {
+    RecordCompletion(context, success, report);
+    static_cast<CompletionRecord*>(context)->kept = std::move(report);
+}
+
+} // namespace
+
+TP_TEST(testPoolExhaustsAndReusesBuffers) {
+    ReportBufferPool pool(3, 20);
+    TP_ASSERT_EQ(pool.GetAvailableCount(), 3u);
+
+    PooledReport a = pool.Acquire();
+    PooledReport b = pool.Acquire();
+    PooledReport c = pool.Acquire();
+    TP_ASSERT_TRUE(a.IsValid() && b.IsValid() && c.IsValid());
+    TP_ASSERT_TRUE(a.GetCapacity() >= 20u);
+    TP_ASSERT_TRUE(pool.Owns(b.MutableData()));
+    // Buffers never share a cache line
+    TP_ASSERT_TRUE(b.MutableData() - a.MutableData() >= static_cast<long>(ReportBufferPool::kCacheLine));
+
+    PooledReport none = pool.Acquire();
+    TP_ASSERT_FALSE(none.IsValid());
+    TP_ASSERT_EQ(pool.GetExhaustedCount(), 1u);
+
+    uint32_t index = b.GetIndex();
+    b.Release();
+    TP_ASSERT_EQ(pool.GetAvailableCount(), 1u);
+    PooledReport again = pool.Acquire();
+    TP_ASSERT_EQ(again.GetIndex(), index);
+
+    PooledReport moved = std::move(again);
+    TP_ASSERT_FALSE(again.IsValid());
+    TP_ASSERT_TRUE(moved.IsValid());
+}
+
+TP_TEST(testChannelQueuesInputReportsInPlace) {
+    FakeReportBackend backend;
+    HIDReportChannel channel(backend, 2, 8);
+    const uint8_t first[] = {1, 2, 3};
+    const uint8_t second[] = {4, 5};
+
+    TP_ASSERT_TRUE(channel.DeliverInputReport(7, first, sizeof(first), 1000));
+    TP_ASSERT_TRUE(channel.DeliverInputReport(7, second, sizeof(second), 2000));
+    // Both buffers are queued, so a third report is dropped rather than allocating
+    TP_ASSERT_FALSE(channel.DeliverInputReport(7, first, sizeof(first), 3000));
+    TP_ASSERT_EQ(channel.GetStatistics().droppedInputReports, 1u);
+
+    PooledReport report;
+    TP_ASSERT_TRUE(channel.Receive(report));
+    ReportView view = report.View();
+    TP_ASSERT_EQ(view.size, 3u);
+    TP_ASSERT_EQ(view.reportId, 7);
+    TP_ASSERT_EQ(view.timestamp, 1000u);
+    TP_ASSERT_TRUE(view.type == HIDReportType::Input);
+    TP_ASSERT_TRUE(std::memcmp(view.data, first, sizeof(first)) == 0);
+    TP_ASSERT_TRUE(channel.GetPool().Owns(view.data));
+
+    // Reassigning releases the first buffer back to the pool
+    TP_ASSERT_TRUE(channel.Receive(report));
+    TP_ASSERT_EQ(report.View().timestamp, 2000u);
+    TP_ASSERT_EQ(channel.GetPool().GetAvailableCount(), 1u);
+    const uint8_t oversized[16] = {};
+    TP_ASSERT_FALSE(channel.DeliverInputReport(7, oversized, sizeof(oversized), 4000));
+    report.Release();
+    TP_ASSERT_FALSE(channel.Receive(report));
+    TP_ASSERT_EQ(channel.GetPool().GetAvailableCount(), 2u);
+    TP_ASSERT_EQ(channel.GetStatistics().inputReports, 2u);
+}
+
+TP_TEST(testChannelSendReleasesBufferOnCompletion) {
+    FakeReportBackend backend;
+    HIDReportChannel channel(backend, 2, 8);
+
+    PooledReport report = channel.Acquire();
+    report.MutableData()[0] = 0x42;
+    report.MutableData()[1] = 0x01;
+    report.SetContents(2, HIDReportType::Output, 3);
+    CompletionRecord record;
+    TP_ASSERT_TRUE(channel.Send(HIDReportType::Output, 3, std::move(report), RecordCompletion, &record));
+    TP_ASSERT_EQ(channel.GetPool().GetAvailableCount(), 1u);
+
+    TP_ASSERT_EQ(backend.pending.size(), 1u);
+    ReportRequest& request = *backend.pending[0];
+    TP_ASSERT_TRUE(request.direction == ReportRequest::Direction::Set);
+    TP_ASSERT_TRUE(request.type == HIDReportType::Output);
+    TP_ASSERT_EQ(request.reportId, 3);
+    TP_ASSERT_EQ(request.length, 2u);
+    TP_ASSERT_EQ(request.buffer[0], 0x42);
+
+    request.Complete(true, 2);
+    TP_ASSERT_EQ(record.calls, 1);
+    TP_ASSERT_TRUE(record.success);
+    TP_ASSERT_EQ(channel.GetPool().GetAvailableCount(), 2u);
+
+    // A refused submission hands the buffer straight back
+    backend.accept = false;
+    TP_ASSERT_FALSE(channel.Send(HIDReportType::Feature, 1, channel.Acquire()));
+    TP_ASSERT_EQ(channel.GetPool().GetAvailableCount(), 2u);
+    TP_ASSERT_EQ(channel.GetStatistics().transfersFailed, 1u);
+}
+
+TP_TEST(testChannelRequestFillsPooledBuffer) {
+    FakeReportBackend backend;
+    HIDReportChannel channel(backend, 1, 8);
+
+    CompletionRecord record;
+    TP_ASSERT_TRUE(channel.Request(HIDReportType::Feature, 5, KeepCompletion, &record));
+    // The only buffer is in flight
+    TP_ASSERT_FALSE(channel.Request(HIDReportType::Feature, 5, KeepCompletion, &record));
+
+    ReportRequest& request = *backend.pending[0];
+    TP_ASSERT_TRUE(request.direction == ReportRequest::Direction::Get);
+    TP_ASSERT_TRUE(request.length >= 8u);
+    request.buffer[0] = 0xAA;
+    request.buffer[1] = 0xBB;
+    request.buffer[2] = 0xCC;
+    request.Complete(true, 3);
+
+    TP_ASSERT_EQ(record.calls, 1);
+    TP_ASSERT_EQ(record.bytes.size(), 3u);
+    TP_ASSERT_EQ(record.bytes[2], 0xCC);
+    // The callback kept the buffer, so it is still out of the pool
+    TP_ASSERT_TRUE(record.kept.IsValid());
+    TP_ASSERT_EQ(record.kept.View().reportId, 5);
+    TP_ASSERT_TRUE(record.kept.View().type == HIDReportType::Feature);
+    TP_ASSERT_EQ(channel.GetPool().GetAvailableCount(), 0u);
+    record.kept.Release();
+    TP_ASSERT_EQ(channel.GetPool().GetAvailableCount(), 1u);
+}
+
+TP_TEST(testChannelStreamsReportsAcrossThreads) {
+    FakeReportBackend backend;
+    HIDReportChannel channel(backend, 8, 16);
+    const uint32_t kReports = 20000;
+
+    std::thread producer([&channel, kReports]() {
+        for (uint32_t sequence = 0; sequence < kReports; ) {
+            uint8_t bytes[4];
+            std::memcpy(bytes, &sequence, sizeof(sequence));
+            if (channel.DeliverInputReport(1, bytes, sizeof(bytes), sequence)) {
+                ++sequence;
+            } else {
+                std::this_thread::yield();
+            }
+        }
+    });
+
+    uint32_t expected = 0;
+    bool ordered = true;
+    PooledReport report;
+    while (expected < kReports) {
+        if (!channel.Receive(report)) {
+            std::this_thread::yield();
+            continue;
+        }
+        uint32_t sequence;
+        std::memcpy(&sequence, report.View().data, sizeof(sequence));
+        ordered = ordered && sequence == expected && report.View().timestamp == expected;
+        report.Release();
+        ++expected;
+    }
+    producer.join();
+
+    TP_ASSERT_TRUE(ordered);
+    TP_ASSERT_EQ(channel.GetStatistics().inputReports, kReports);
+    TP_ASSERT_EQ(channel.GetPool().GetAvailableCount(), 8u);
+}
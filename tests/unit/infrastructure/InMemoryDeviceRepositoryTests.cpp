@@ -0,0 +1,144 @@
+#include "../../support/TestHarness.h"
+#include "../../../src/infrastructure/persistence/InMemoryDeviceRepository.h"
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace TPMiddle::Domain;
+using namespace TPMiddle::Infrastructure;
+
+namespace {
+
+class FakeDevice : public IDevice {
+public:
+    FakeDevice(const std::string& id, const std::string& type, bool connected = true)
+        : m_id(id), m_type(type), m_connected(connected) {}
+
+    std::string GetId() const override { return m_id; }
+    std::string GetName() const override { return "Device " + m_id; }
+    bool IsConnected() const override { return m_connected; }
+    std::string GetDeviceType() const override { return m_type; }
+    std::string GetLastError() const override { return std::string(); }
+    bool Reset() override { return true; }
+
+private:
+    std::string m_id;
+    std::string m_type;
+    bool m_connected;
+};
+
+std::shared_ptr<IDevice> MakeDevice(const std::string& id, const std::string& type, bool connected = true) {
+    return std::make_shared<FakeDevice>(id, type, connected);
+}
+
+// Every index of a snapshot must agree with its entries
+bool IsConsistent(const DeviceSnapshot& snapshot) {
+    for (size_t i = 0; i < snapshot.GetCount(); ++i) {
+        const DeviceEntry& entry = snapshot.At(i);
+        if (snapshot.FindById(entry.GetId()) != &entry || snapshot.FindByKey(entry.GetKey()) != &entry) {
+            return false;
+        }
+        if (entry.GetName() != "Device " + std::string(entry.GetId())) {
+            return false;
+        }
+    }
+    return true;
+}
+
+} // namespace
+
+TP_TEST(testRepositoryIndexesByIdKeyAndType) {
+    InMemoryDeviceRepository repository;
+    TP_ASSERT_TRUE(repository.Add(MakeDevice("built-in", "TrackPoint")));
+    TP_ASSERT_TRUE(repository.Add(MakeDevice("external", "TrackPoint", false)));
+    TP_ASSERT_TRUE(repository.Add(MakeDevice("mouse", "Mouse")));
+    TP_ASSERT_FALSE(repository.Add(MakeDevice("mouse", "Mouse")));
+
+    TP_ASSERT_TRUE(repository.FindById("external").has_value());
+    TP_ASSERT_FALSE(repository.FindById("missing").has_value());
+    TP_ASSERT_EQ(repository.GetDevicesByType("TrackPoint").size(), 2u);
+    TP_ASSERT_EQ(repository.GetConnectedDevices().size(), 2u);
+
+    InMemoryDeviceRepository::Reader reader(repository);
+    TP_ASSERT_TRUE(reader.IsLockFree());
+    const DeviceSnapshot& snapshot = reader.Snapshot();
+    uint32_t key = repository.GetKey("external");
+    TP_ASSERT_TRUE(snapshot.FindByKey(key) != nullptr);
+    TP_ASSERT_TRUE(snapshot.FindByKey(key)->GetName() == "Device external");
+    int trackPoints = 0;
+    snapshot.ForEachOfType("TrackPoint", [&trackPoints](const DeviceEntry&) { ++trackPoints; });
+    TP_ASSERT_EQ(trackPoints, 2);
+
+    // Update refreshes the cached fields and keeps the key
+    TP_ASSERT_TRUE(repository.Update(MakeDevice("external", "TrackPoint", true)));
+    TP_ASSERT_EQ(repository.GetKey("external"), key);
+    TP_ASSERT_EQ(repository.GetConnectedDevices().size(), 3u);
+
+    // Removed keys are reused
+    TP_ASSERT_TRUE(repository.Remove("external"));
+    TP_ASSERT_FALSE(repository.Remove("external"));
+    TP_ASSERT_TRUE(repository.Add(MakeDevice("replacement", "TrackPoint")));
+    TP_ASSERT_EQ(repository.GetKey("replacement"), key);
+}
+
+TP_TEST(testRepositorySnapshotOutlivesWrites) {
+    InMemoryDeviceRepository repository;
+    repository.Add(MakeDevice("a", "TrackPoint"));
+
+    InMemoryDeviceRepository::Reader reader(repository);
+    const DeviceSnapshot& held = reader.Snapshot();
+    uint64_t heldVersion = held.GetVersion();
+
+    // The held snapshot is retired, not freed, and still reads the old state
+    repository.Remove("a");
+    repository.Add(MakeDevice("b", "Mouse"));
+    TP_ASSERT_EQ(held.GetCount(), 1u);
+    TP_ASSERT_TRUE(held.FindById("a") != nullptr);
+    TP_ASSERT_EQ(repository.GetRetiredCount(), 1u);
+
+    const DeviceSnapshot& current = reader.Snapshot();
+    TP_ASSERT_TRUE(current.GetVersion() > heldVersion);
+    TP_ASSERT_TRUE(current.FindById("b") != nullptr);
+    TP_ASSERT_EQ(repository.GetRetiredCount(), 0u);
+}
+
+TP_TEST(testRepositoryConcurrentReadersDuringHotplug) {
+    InMemoryDeviceRepository repository;
+    std::atomic<bool> stop(false);
+    std::atomic<int> inconsistent(0);
+    std::atomic<uint64_t> reads(0);
+
+    std::vector<std::thread> readers;
+    for (int r = 0; r < 4; ++r) {
+        readers.emplace_back([&]() {
+            InMemoryDeviceRepository::Reader reader(repository);
+            uint64_t lastVersion = 0;
+            while (!stop.load(std::memory_order_relaxed)) {
+                const DeviceSnapshot& snapshot = reader.Snapshot();
+                if (snapshot.GetVersion() < lastVersion || !IsConsistent(snapshot)) {
+                    inconsistent.fetch_add(1);
+                }
+                lastVersion = snapshot.GetVersion();
+                reads.fetch_add(1, std::memory_order_relaxed);
+            }
+        });
+    }
+
+    // Hotplug churn: a rolling window of devices
+    for (int i = 0; i < 2000; ++i) {
+        repository.Add(MakeDevice("dev-" + std::to_string(i), i % 3 == 0 ? "Mouse" : "TrackPoint"));
+        if (i >= 8) {
+            repository.Remove("dev-" + std::to_string(i - 8));
+        }
+    }
+    stop.store(true);
+    for (std::thread& reader : readers) {
+        reader.join();
+    }
+
+    TP_ASSERT_EQ(inconsistent.load(), 0);
+    TP_ASSERT_TRUE(reads.load() > 0);
+    TP_ASSERT_EQ(repository.GetDevicesByType("TrackPoint").size() + repository.GetDevicesByType("Mouse").size(), 8u);
+    TP_ASSERT_EQ(repository.GetRetiredCount(), 0u);
+}
@@ -0,0 +1,104 @@
+#include "../../support/TestHarness.h"
+#include "../../../src/infrastructure/persistence/InputTrace.h"
+#include <cstdio>
+#include <string>
+#include <unistd.h>
+
+using namespace TPMiddle::Domain;
+using namespace TPMiddle::Infrastructure;
+
+namespace {
+
+std::string TemporaryTracePath(const char* name) {
+    return std::string("/tmp/tpmiddle-") + name + "-" + std::to_string(getpid()) + ".tptrace";
+}
+
+InputEvent MakeEvent(uint64_t index) {
+    InputEvent event = {};
+    event.type = InputEventType::Value;
+    event.timestamp = 1000 + index * 125000;
+    event.device = 0xABCD;
+    event.element.usagePage = 0x01;
+    event.element.usage = static_cast<uint16_t>(0x30 + (index & 1));
+    event.element.value = static_cast<int32_t>(index % 7) - 3;
+    return event;
+}
+
+} // namespace
+
+TP_TEST(testInputTraceRoundTripThroughMapping) {
+    std::string path = TemporaryTracePath("roundtrip");
+    const uint64_t kCount = InputTraceWriter::kBufferedRecords * 2 + 17;
+
+    InputTraceWriter writer;
+    TP_ASSERT_TRUE(writer.Open(path));
+    for (uint64_t i = 0; i < kCount; ++i) {
+        TP_ASSERT_TRUE(writer.Append(MakeEvent(i)));
+    }
+    writer.Close();
+    TP_ASSERT_EQ(writer.GetRecordCount(), kCount);
+
+    InputTraceReader reader;
+    TP_ASSERT_TRUE(reader.Open(path));
+    TP_ASSERT_EQ(reader.GetEventCount(), kCount);
+    TP_ASSERT_EQ(reader.GetHeader().recordCount, kCount);
+    TP_ASSERT_EQ(reader.GetHeader().startTimestamp, MakeEvent(0).timestamp);
+
+    bool identical = true;
+    for (uint64_t i = 0; i < kCount && identical; ++i) {
+        InputEvent expected = MakeEvent(i);
+        const InputEvent& actual = reader.GetEvents()[i];
+        identical = actual.timestamp == expected.timestamp && actual.device == expected.device &&
+                    actual.element.usagePage == expected.element.usagePage && actual.element.usage == expected.element.usage &&
+                    actual.element.value == expected.element.value && actual.type == expected.type;
+    }
+    TP_ASSERT_TRUE(identical);
+    reader.Close();
+    unlink(path.c_str());
+}
+
+TP_TEST(testInputTraceRejectsForeignFiles) {
+    std::string path = TemporaryTracePath("foreign");
+    FILE* file = std::fopen(path.c_str(), "wb");
+    char garbage[128] = "definitely not a trace";
+    std::fwrite(garbage, sizeof(garbage), 1, file);
+    std::fclose(file);
+
+    InputTraceReader reader;
+    TP_ASSERT_FALSE(reader.Open(path));
+    TP_ASSERT_FALSE(reader.GetLastError().empty());
+    TP_ASSERT_FALSE(reader.Open("/nonexistent/trace.tptrace"));
+    unlink(path.c_str());
+}
+
+TP_TEST(testInputTraceRenumbersDevicesOfOldVersions) {
+    std::string path = TemporaryTracePath("renumber");
+    const uint64_t kDevices[] = {0x7F00AA00, 0x7F00BB00, 0x7F00AA00, 0x7F00CC00};
+
+    InputTraceWriter writer;
+    TP_ASSERT_TRUE(writer.Open(path));
+    for (uint64_t i = 0; i < 4; ++i) {
+        InputEvent event = MakeEvent(i);
+        event.device = kDevices[i];
+        writer.Append(event);
+    }
+    writer.Close();
+
+    // Rewrite the header as a version 2 capture, which stored platform references
+    FILE* file = std::fopen(path.c_str(), "r+b");
+    InputTraceHeader header;
+    TP_ASSERT_EQ(std::fread(&header, sizeof(header), 1, file), 1u);
+    header.version = 2;
+    std::fseek(file, 0, SEEK_SET);
+    std::fwrite(&header, sizeof(header), 1, file);
+    std::fclose(file);
+
+    InputTraceReader reader;
+    TP_ASSERT_TRUE(reader.Open(path));
+    TP_ASSERT_EQ(reader.GetEvents()[0].device, 0u);
+    TP_ASSERT_EQ(reader.GetEvents()[1].device, 1u);
+    TP_ASSERT_EQ(reader.GetEvents()[2].device, 0u);
+    TP_ASSERT_EQ(reader.GetEvents()[3].device, 2u);
+    reader.Close();
+    unlink(path.c_str());
+}
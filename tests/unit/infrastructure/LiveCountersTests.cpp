@@ -0,0 +1,125 @@
+#include "../../support/TestHarness.h"
+#include "../../../src/infrastructure/metrics/LiveCounters.h"
+#include <atomic>
+#include <string>
+#include <thread>
+#include <unistd.h>
+
+using namespace TPMiddle::Infrastructure;
+
+namespace {
+
+std::string SegmentName(const char* name) {
+    return std::string("/tpmiddle-test-") + name + "-" + std::to_string(getpid());
+}
+
+} // namespace
+
+TP_TEST(testLiveCountersRoundTripThroughSharedMemory) {
+    LiveCounters counters;
+    counters.Add(LiveCounter::EventsProcessed, 99);     // Private block, dropped on publish
+    std::string name = SegmentName("roundtrip");
+    TP_ASSERT_TRUE(counters.Publish(name, 1000));
+    TP_ASSERT_TRUE(counters.IsPublished());
+
+    counters.BeginUpdate();
+    counters.Add(LiveCounter::EventsProcessed, 3);
+    counters.Add(LiveCounter::EventsDropped);
+    counters.Set(LiveCounter::QueueDepth, 7);
+    counters.AddDeviceReports(2, 3);
+    counters.AddDeviceReports(LiveCountersBlock::kMaxDevices);     // Out of range, ignored
+    counters.EndUpdate(5000);
+
+    LiveCountersReader reader;
+    TP_ASSERT_TRUE(reader.Open(name));
+    TP_ASSERT_EQ(reader.GetCounterCount(), static_cast<uint32_t>(kLiveCounterCount));
+
+    LiveCountersSnapshot snapshot;
+    TP_ASSERT_TRUE(reader.Read(snapshot));
+    TP_ASSERT_EQ(snapshot.pid, static_cast<int32_t>(getpid()));
+    TP_ASSERT_EQ(snapshot.publishedNs, 1000u);
+    TP_ASSERT_EQ(snapshot.updatedNs, 5000u);
+    TP_ASSERT_EQ(snapshot.sequence, 2u);
+    TP_ASSERT_EQ(snapshot.Get(LiveCounter::EventsProcessed), 3u);
+    TP_ASSERT_EQ(snapshot.Get(LiveCounter::EventsDropped), 1u);
+    TP_ASSERT_EQ(snapshot.Get(LiveCounter::QueueDepth), 7u);
+    TP_ASSERT_EQ(snapshot.deviceReports[2], 3u);
+
+    reader.Close();
+    counters.Unpublish();
+    TP_ASSERT_FALSE(counters.IsPublished());
+    TP_ASSERT_FALSE(reader.Open(name));
+}
+
+// A segment left behind by a crashed run is replaced by a fresh one
+TP_TEST(testLiveCountersReplacesStaleSegment) {
+    std::string name = SegmentName("stale");
+    LiveCounters crashed;
+    TP_ASSERT_TRUE(crashed.Publish(name, 1000));
+    crashed.BeginUpdate();
+    crashed.Add(LiveCounter::EventsProcessed, 5);
+    crashed.EndUpdate(2000);
+
+    LiveCounters counters;
+    TP_ASSERT_TRUE(counters.Publish(name, 3000));
+
+    LiveCountersReader reader;
+    TP_ASSERT_TRUE(reader.Open(name));
+    LiveCountersSnapshot snapshot;
+    TP_ASSERT_TRUE(reader.Read(snapshot));
+    TP_ASSERT_EQ(snapshot.publishedNs, 3000u);
+    TP_ASSERT_EQ(snapshot.Get(LiveCounter::EventsProcessed), 0u);
+    reader.Close();
+    counters.Unpublish();
+}
+
+TP_TEST(testLiveCountersReaderRejectsMissingSegment) {
+    LiveCountersReader reader;
+    TP_ASSERT_FALSE(reader.Open(SegmentName("missing")));
+    TP_ASSERT_FALSE(reader.GetLastError().empty());
+
+    LiveCountersSnapshot snapshot;
+    TP_ASSERT_FALSE(reader.Read(snapshot));
+    TP_ASSERT_EQ(reader.GetCounterCount(), 0u);
+}
+
+// Two counters bumped together in each batch must never be seen apart
+TP_TEST(testLiveCountersSnapshotsAreConsistentUnderWrites) {
+    LiveCounters counters;
+    std::string name = SegmentName("seqlock");
+    TP_ASSERT_TRUE(counters.Publish(name, 0));
+
+    LiveCountersReader reader;
+    TP_ASSERT_TRUE(reader.Open(name));
+
+    std::atomic<bool> done(false);
+    std::thread writer([&counters, &done]() {
+        for (uint64_t batch = 1; batch <= 200000; ++batch) {
+            counters.BeginUpdate();
+            counters.Add(LiveCounter::EventsProcessed);
+            counters.Set(LiveCounter::ScrollEvents, batch);
+            counters.EndUpdate(batch);
+        }
+        done.store(true);
+    });
+
+    int torn = 0;
+    int consistent = 0;
+    LiveCountersSnapshot snapshot;
+    while (!done.load()) {
+        if (reader.Read(snapshot)) {
+            ++consistent;
+            if (snapshot.Get(LiveCounter::EventsProcessed) != snapshot.Get(LiveCounter::ScrollEvents) ||
+                snapshot.updatedNs != snapshot.Get(LiveCounter::ScrollEvents)) {
+                ++torn;
+            }
+        }
+    }
+    writer.join();
+
+    TP_ASSERT_EQ(torn, 0);
+    TP_ASSERT_TRUE(consistent > 0);
+    TP_ASSERT_TRUE(reader.Read(snapshot));
+    TP_ASSERT_EQ(snapshot.Get(LiveCounter::EventsProcessed), 200000u);
+    counters.Unpublish();
+}
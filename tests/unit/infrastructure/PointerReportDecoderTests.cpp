@@ -0,0 +1,102 @@
+#include "../../support/TestHarness.h"
+#include "../../../src/infrastructure/hid/PointerReportDecoder.h"
+
+using namespace TPMiddle::Domain;
+using namespace TPMiddle::Infrastructure;
+
+namespace {
+
+// Boot-protocol style mouse: 3 buttons, 5 bits padding, 8-bit X, Y, wheel
+const uint8_t kBootMouseDescriptor[] = {
+    0x05, 0x01, 0x09, 0x02, 0xA1, 0x01, 0x09, 0x01, 0xA1, 0x00,
+    0x05, 0x09, 0x19, 0x01, 0x29, 0x03, 0x15, 0x00, 0x25, 0x01,
+    0x95, 0x03, 0x75, 0x01, 0x81, 0x02, 0x95, 0x01, 0x75, 0x05,
+    0x81, 0x03, 0x05, 0x01, 0x09, 0x30, 0x09, 0x31, 0x09, 0x38,
+    0x15, 0x81, 0x25, 0x7F, 0x75, 0x08, 0x95, 0x03, 0x81, 0x06,
+    0xC0, 0xC0
+};
+
+// Report ID 2: 16 buttons, packed 12-bit X/Y, wheel and AC Pan
+const uint8_t kReportIdMouseDescriptor[] = {
+    0x05, 0x01, 0x09, 0x02, 0xA1, 0x01, 0x85, 0x02, 0x09, 0x01,
+    0xA1, 0x00, 0x05, 0x09, 0x19, 0x01, 0x29, 0x10, 0x15, 0x00,
+    0x25, 0x01, 0x95, 0x10, 0x75, 0x01, 0x81, 0x02, 0x05, 0x01,
+    0x16, 0x01, 0xF8, 0x26, 0xFF, 0x07, 0x75, 0x0C, 0x95, 0x02,
+    0x09, 0x30, 0x09, 0x31, 0x81, 0x06, 0x15, 0x81, 0x25, 0x7F,
+    0x75, 0x08, 0x95, 0x01, 0x09, 0x38, 0x81, 0x06, 0x05, 0x0C,
+    0x0A, 0x38, 0x02, 0x95, 0x01, 0x81, 0x06, 0xC0, 0xC0
+};
+
+} // namespace
+
+TP_TEST(testDescriptorParsesBootMouseLayout) {
+    HIDReportDescriptor descriptor;
+    TP_ASSERT_TRUE(descriptor.Parse(kBootMouseDescriptor, sizeof(kBootMouseDescriptor)));
+    TP_ASSERT_FALSE(descriptor.UsesReportIds());
+    TP_ASSERT_EQ(descriptor.GetInputReportBits(0), 32u);
+    TP_ASSERT_EQ(descriptor.GetInputFields().size(), 3u);
+
+    const HIDReportField& axes = descriptor.GetInputFields()[2];
+    TP_ASSERT_EQ(axes.bitOffset, 8u);
+    TP_ASSERT_EQ(axes.logicalMinimum, -127);
+    TP_ASSERT_TRUE(axes.IsRelative());
+    TP_ASSERT_EQ(axes.UsageAt(1), 0x00010031u);
+}
+
+TP_TEST(testDescriptorRejectsMalformedInput) {
+    HIDReportDescriptor descriptor;
+    TP_ASSERT_FALSE(descriptor.Parse(kBootMouseDescriptor, 15));   // Cut inside an item
+    TP_ASSERT_FALSE(descriptor.GetLastError().empty());
+
+    const uint8_t unbalanced[] = {0x05, 0x01, 0xC0};
+    TP_ASSERT_FALSE(descriptor.Parse(unbalanced, sizeof(unbalanced)));
+    const uint8_t popWithoutPush[] = {0xB4};
+    TP_ASSERT_FALSE(descriptor.Parse(popWithoutPush, sizeof(popWithoutPush)));
+
+    // 32 bits x 2^27 values wraps a 32-bit product to zero
+    const uint8_t wrappingCount[] = {0x75, 0x20, 0x97, 0x00, 0x00, 0x00, 0x08, 0x81, 0x02};
+    TP_ASSERT_FALSE(descriptor.Parse(wrappingCount, sizeof(wrappingCount)));
+    TP_ASSERT_TRUE(descriptor.GetLastError().find("too large") != std::string::npos);
+}
+
+TP_TEST(testDecoderReadsWholeBootReport) {
+    HIDReportDescriptor descriptor;
+    descriptor.Parse(kBootMouseDescriptor, sizeof(kBootMouseDescriptor));
+    PointerReportDecoder decoder;
+    TP_ASSERT_TRUE(decoder.Build(descriptor));
+
+    const uint8_t report[] = {0x05, 0x03, 0xFE, 0x01};   // Left + middle, X=3, Y=-2, wheel=1
+    PointerSample sample = {};
+    TP_ASSERT_TRUE(decoder.Decode(report, sizeof(report), sample));
+    TP_ASSERT_EQ(sample.buttons, 0x05);
+    TP_ASSERT_EQ(sample.deltaX, 3);
+    TP_ASSERT_EQ(sample.deltaY, -2);
+    TP_ASSERT_EQ(sample.wheel, 1);
+    TP_ASSERT_EQ(sample.pan, 0);
+
+    TP_ASSERT_FALSE(decoder.Decode(report, 2, sample));
+}
+
+TP_TEST(testDecoderHandlesReportIdsAndPackedAxes) {
+    HIDReportDescriptor descriptor;
+    TP_ASSERT_TRUE(descriptor.Parse(kReportIdMouseDescriptor, sizeof(kReportIdMouseDescriptor)));
+    TP_ASSERT_TRUE(descriptor.UsesReportIds());
+
+    PointerReportDecoder decoder;
+    TP_ASSERT_TRUE(decoder.Build(descriptor));
+    TP_ASSERT_EQ(decoder.GetPlans().size(), 1u);
+    TP_ASSERT_EQ(decoder.GetPlans()[0].buttons.size(), 1u);
+
+    // X = -5 and Y = 300 packed into 24 bits, wheel -1, pan 2
+    const uint8_t report[] = {0x02, 0x02, 0x80, 0xFB, 0xCF, 0x12, 0xFF, 0x02};
+    PointerSample sample = {};
+    TP_ASSERT_TRUE(decoder.Decode(report, sizeof(report), sample));
+    TP_ASSERT_EQ(sample.buttons, 0x8002);
+    TP_ASSERT_EQ(sample.deltaX, -5);
+    TP_ASSERT_EQ(sample.deltaY, 300);
+    TP_ASSERT_EQ(sample.wheel, -1);
+    TP_ASSERT_EQ(sample.pan, 2);
+
+    const uint8_t otherReport[] = {0x03, 0, 0, 0, 0, 0, 0, 0};
+    TP_ASSERT_FALSE(decoder.Decode(otherReport, sizeof(otherReport), sample));
+}
@@ -0,0 +1,71 @@
+#include "../../support/TestHarness.h"
+#include "../../../src/infrastructure/evdev/UinputWriter.h"
+#include "../../../src/domain/models/HIDUsage.h"
+#include <unistd.h>
+#include <vector>
+
+using namespace TPMiddle::Infrastructure;
+using namespace TPMiddle::Domain;
+
+namespace {
+
+std::vector<EvdevWireEvent> ReadAll(int fd) {
+    std::vector<EvdevWireEvent> events(64);
+    ssize_t bytes = ::read(fd, events.data(), events.size() * sizeof(EvdevWireEvent));
+    events.resize(bytes > 0 ? static_cast<size_t>(bytes) / sizeof(EvdevWireEvent) : 0);
+    return events;
+}
+
+} // namespace
+
+TP_TEST(testUinputWriterFlushesFramesInOneWrite) {
+    int fds[2];
+    TP_ASSERT_EQ(pipe(fds), 0);
+    UinputWriter writer(fds[1]);
+
+    writer.PostMiddleButton(0, true);
+    writer.PostMotion(0, 2, -3);
+    writer.PostButton(0, kButtonMaskRight, false);
+    TP_ASSERT_EQ(writer.GetPendingCount(), 7u);
+    TP_ASSERT_TRUE(writer.Flush());
+    TP_ASSERT_EQ(writer.GetStatistics().writes, 1u);
+    TP_ASSERT_EQ(writer.GetStatistics().frames, 3u);
+
+    std::vector<EvdevWireEvent> events = ReadAll(fds[0]);
+    TP_ASSERT_EQ(events.size(), 7u);
+    TP_ASSERT_EQ(events[0].code, Evdev::kButtonMiddle);
+    TP_ASSERT_EQ(events[0].value, 1);
+    TP_ASSERT_EQ(events[1].type, Evdev::kEventSync);
+    TP_ASSERT_EQ(events[3].code, Evdev::kRelativeY);
+    TP_ASSERT_EQ(events[3].value, -3);
+    TP_ASSERT_EQ(events[5].code, Evdev::kButtonRight);
+    TP_ASSERT_EQ(events[5].value, 0);
+
+    close(fds[0]);
+    close(fds[1]);
+}
+
+TP_TEST(testUinputWriterScrollsInHighResolutionUnits) {
+    int fds[2];
+    TP_ASSERT_EQ(pipe(fds), 0);
+    UinputWriter writer(fds[1], 15.0);
+
+    // 10 + 10 pixels is 80 + 80 units: the second crosses a whole detent
+    writer.PostScroll(0, 0.0, 10.0);
+    writer.PostScroll(0, 0.0, 10.0);
+    writer.PostScroll(0, 1.5, 0.0);
+    writer.Flush();
+
+    std::vector<EvdevWireEvent> events = ReadAll(fds[0]);
+    TP_ASSERT_EQ(events.size(), 7u);
+    TP_ASSERT_EQ(events[0].code, Evdev::kRelativeWheelHiRes);
+    TP_ASSERT_EQ(events[0].value, 80);
+    TP_ASSERT_EQ(events[2].code, Evdev::kRelativeWheelHiRes);
+    TP_ASSERT_EQ(events[3].code, Evdev::kRelativeWheel);
+    TP_ASSERT_EQ(events[3].value, 1);
+    TP_ASSERT_EQ(events[5].code, Evdev::kRelativeHWheelHiRes);
+    TP_ASSERT_EQ(events[5].value, -12);
+
+    close(fds[0]);
+    close(fds[1]);
+}
@@ -0,0 +1,60 @@
+#include "../../support/TestHarness.h"
+#include "../../../src/utils/LatencyHistogram.h"
+#include <thread>
+#include <vector>
+
+using namespace TPMiddle::Utils;
+
+TP_TEST(testLatencyBucketsStayWithinRelativeError) {
+    bool bounded = true;
+    for (uint64_t value = 1; value < (1ULL << 38); value = value * 3 + 1) {
+        size_t index = LatencyBuckets::IndexOf(value);
+        uint64_t lower = LatencyBuckets::LowerBound(index);
+        uint64_t upper = LatencyBuckets::UpperBound(index);
+        bounded = bounded && lower <= value && value <= upper;
+        bounded = bounded && (upper - lower) * LatencyBuckets::kSubBucketCount <= lower + LatencyBuckets::kSubBucketCount;
+    }
+    TP_ASSERT_TRUE(bounded);
+    TP_ASSERT_EQ(LatencyBuckets::IndexOf(~0ULL), LatencyBuckets::kBucketCount - 1);
+}
+
+TP_TEST(testLatencyHistogramPercentiles) {
+    LatencyHistogram histogram;
+    for (uint64_t i = 1; i <= 1000; ++i) {
+        histogram.Record(i * 1000);
+    }
+
+    LatencyHistogramSnapshot snapshot = histogram.Snapshot();
+    TP_ASSERT_EQ(snapshot.count, 1000u);
+    TP_ASSERT_EQ(snapshot.max, 1000000u);
+    TP_ASSERT_NEAR(snapshot.Mean(), 500500.0, 1e-6);
+    TP_ASSERT_NEAR(static_cast<double>(snapshot.Percentile(0.50)), 500000.0, 500000.0 / 16);
+    TP_ASSERT_NEAR(static_cast<double>(snapshot.Percentile(0.99)), 990000.0, 990000.0 / 16);
+    TP_ASSERT_EQ(snapshot.Percentile(1.0), 1000000u);
+
+    histogram.Reset();
+    TP_ASSERT_EQ(histogram.Snapshot().count, 0u);
+    TP_ASSERT_EQ(histogram.Snapshot().Percentile(0.5), 0u);
+}
+
+TP_TEST(testLatencyHistogramConcurrentRecording) {
+    LatencyHistogram histogram;
+    const int kThreads = 4;
+    const uint64_t kPerThread = 50000;
+
+    std::vector<std::thread> writers;
+    for (int t = 0; t < kThreads; ++t) {
+        writers.emplace_back([&histogram, t]() {
+            for (uint64_t i = 0; i < kPerThread; ++i) {
+                histogram.Record(i + static_cast<uint64_t>(t));
+            }
+        });
+    }
+    for (auto& writer : writers) {
+        writer.join();
+    }
+
+    LatencyHistogramSnapshot snapshot = histogram.Snapshot();
+    TP_ASSERT_EQ(snapshot.count, kThreads * kPerThread);
+    TP_ASSERT_EQ(snapshot.max, kPerThread - 1 + kThreads - 1);
+}
@@ -0,0 +1,64 @@
+#include "../../support/TestHarness.h"
+#include "../../../src/utils/MonotonicClock.h"
+#if defined(__linux__)
+#include <time.h>
+#endif
+
+using TPMiddle::Utils::MonotonicClock;
+
+namespace {
+
+uint64_t g_fakeNow = 0;
+
+uint64_t FakeNanoseconds() {
+    return g_fakeNow;
+}
+
+} // namespace
+
+TP_TEST(testMonotonicClockNeverGoesBackwards) {
+    MonotonicClock clock;
+    TP_ASSERT_TRUE(clock.GetSource() == &MonotonicClock::SystemNanoseconds);
+
+    bool ordered = true;
+    uint64_t previous = clock.Now();
+    for (int i = 0; i < 10000; ++i) {
+        uint64_t now = clock.Now();
+        ordered = ordered && now >= previous;
+        previous = now;
+    }
+    TP_ASSERT_TRUE(ordered);
+}
+
+TP_TEST(testMonotonicClockUsesInjectedSource) {
+    MonotonicClock clock(&FakeNanoseconds);
+    g_fakeNow = 42;
+    TP_ASSERT_EQ(clock.Now(), 42u);
+    g_fakeNow = 5000000000ULL;
+    TP_ASSERT_EQ(clock.Now(), 5000000000ULL);
+    TP_ASSERT_TRUE(clock.GetSource() == &FakeNanoseconds);
+}
+
+TP_TEST(testMonotonicClockConvertsDeviceTimestamps) {
+    TP_ASSERT_EQ(MonotonicClock::TimevalToNanoseconds(0, 0), 0u);
+    TP_ASSERT_EQ(MonotonicClock::TimevalToNanoseconds(3, 250), 3000250000ULL);
+    TP_ASSERT_EQ(MonotonicClock::TimevalToNanoseconds(86400, 999999), 86400999999000ULL);
+#if !defined(__APPLE__)
+    TP_ASSERT_EQ(MonotonicClock::HostTicksToNanoseconds(123456789), 123456789u);
+#endif
+}
+
+#if defined(__linux__)
+// evdev stamps input_event with CLOCK_MONOTONIC once EVIOCSCLOCKID selects it;
+// the clock must read on the same base for report-to-processing latency
+TP_TEST(testMonotonicClockSharesEvdevTimeBase) {
+    struct timespec before;
+    struct timespec after;
+    clock_gettime(CLOCK_MONOTONIC, &before);
+    uint64_t now = MonotonicClock::SystemNanoseconds();
+    clock_gettime(CLOCK_MONOTONIC, &after);
+
+    TP_ASSERT_TRUE(now >= MonotonicClock::TimevalToNanoseconds(before.tv_sec, before.tv_nsec / 1000));
+    TP_ASSERT_TRUE(now <= MonotonicClock::TimevalToNanoseconds(after.tv_sec, after.tv_nsec / 1000 + 1));
+}
+#endif
@@ -0,0 +1,70 @@
+#include "../../support/TestHarness.h"
+#include "../../../src/utils/SPSCRing.h"
+#include <thread>
+
+using TPMiddle::Utils::SPSCRing;
+
+TP_TEST(testSPSCRingPushPopWrapsAround) {
+    SPSCRing<int, 4> ring;
+    int value = 0;
+
+    for (int round = 0; round < 10; ++round) {
+        TP_ASSERT_TRUE(ring.TryPush(round * 2));
+        TP_ASSERT_TRUE(ring.TryPush(round * 2 + 1));
+        TP_ASSERT_EQ(ring.Size(), 2u);
+        TP_ASSERT_TRUE(ring.TryPop(value));
+        TP_ASSERT_EQ(value, round * 2);
+        TP_ASSERT_TRUE(ring.TryPop(value));
+        TP_ASSERT_EQ(value, round * 2 + 1);
+    }
+    TP_ASSERT_TRUE(ring.IsEmpty());
+    TP_ASSERT_FALSE(ring.TryPop(value));
+}
+
+TP_TEST(testSPSCRingCountsOverflow) {
+    SPSCRing<int, 4> ring;
+    for (int i = 0; i < 4; ++i) {
+        TP_ASSERT_TRUE(ring.TryPush(i));
+    }
+    TP_ASSERT_FALSE(ring.TryPush(4));
+    TP_ASSERT_FALSE(ring.TryPush(5));
+    TP_ASSERT_EQ(ring.GetOverflowCount(), 2u);
+
+    int batch[8];
+    TP_ASSERT_EQ(ring.PopBatch(batch, 8), 4u);
+    TP_ASSERT_EQ(batch[0], 0);
+    TP_ASSERT_EQ(batch[3], 3);
+    TP_ASSERT_TRUE(ring.TryPush(6));
+}
+
+TP_TEST(testSPSCRingSyntheticProducerPreservesOrder) {
+    static SPSCRing<uint64_t, 256> ring;
+    const uint64_t kCount = 200000;
+
+    std::thread producer([] {
+        for (uint64_t i = 0; i < kCount; ++i) {
+            while (!ring.TryPush(i)) {
+                std::this_thread::yield();
+            }
+        }
+    });
+
+    uint64_t expected = 0;
+    bool inOrder = true;
+    uint64_t batch[32];
+    while (expected < kCount) {
+        size_t count = ring.PopBatch(batch, 32);
+        for (size_t i = 0; i < count; ++i) {
+            inOrder = inOrder && batch[i] == expected;
+            ++expected;
+        }
+        if (count == 0) {
+            std::this_thread::yield();
+        }
+    }
+    producer.join();
+
+    TP_ASSERT_TRUE(inOrder);
+    TP_ASSERT_EQ(expected, kCount);
+    TP_ASSERT_TRUE(ring.IsEmpty());
+}
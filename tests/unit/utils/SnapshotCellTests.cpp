@@ -0,0 +1,112 @@
+#include "../../support/TestHarness.h"
+#include "../../../src/utils/SnapshotCell.h"
+#include <atomic>
+#include <thread>
+#include <vector>
+
+using TPMiddle::Utils::SnapshotCell;
+
+namespace {
+
+// Both fields are written together, so a torn or freed read shows up as a mismatch
+struct Pair {
+    uint64_t value = 0;
+    uint64_t check = ~0ULL;
+};
+
+Pair MakePair(uint64_t value) {
+    Pair pair;
+    pair.value = value;
+    pair.check = ~value;
+    return pair;
+}
+
+} // namespace
+
+TP_TEST(testSnapshotCellReaderSeesPublishedValues) {
+    SnapshotCell<Pair> cell(MakePair(1));
+    SnapshotCell<Pair>::Reader reader(cell);
+    TP_ASSERT_TRUE(reader.IsLockFree());
+    TP_ASSERT_EQ(reader.GetVersion(), 0u);
+
+    const Pair& first = reader.Get();
+    TP_ASSERT_EQ(first.value, 1u);
+    TP_ASSERT_EQ(reader.GetVersion(), 1u);
+    // Unchanged value: the same snapshot comes back
+    TP_ASSERT_TRUE(&reader.Get() == &first);
+
+    TP_ASSERT_EQ(cell.Publish(MakePair(2)), 2u);
+    TP_ASSERT_EQ(cell.Publish(MakePair(3)), 3u);
+    TP_ASSERT_EQ(reader.Get().value, 3u);
+    TP_ASSERT_EQ(reader.GetVersion(), 3u);
+    TP_ASSERT_EQ(cell.Copy().value, 3u);
+}
+
+TP_TEST(testSnapshotCellKeepsHeldValueUntilReaderMovesOn) {
+    SnapshotCell<Pair> cell(MakePair(1));
+    SnapshotCell<Pair>::Reader reader(cell);
+    const Pair& held = reader.Get();
+
+    cell.Publish(MakePair(2));
+    cell.Publish(MakePair(3));
+    // Version 1 is still protected by the reader; version 2 was never read
+    TP_ASSERT_EQ(cell.GetRetiredCount(), 1u);
+    TP_ASSERT_EQ(held.value, 1u);
+    TP_ASSERT_EQ(held.check, ~1ULL);
+
+    reader.Get();
+    cell.Publish(MakePair(4));
+    TP_ASSERT_EQ(cell.GetRetiredCount(), 1u);
+    TP_ASSERT_EQ(reader.Get().value, 4u);
+}
+
+TP_TEST(testSnapshotCellFallsBackWhenSlotsRunOut) {
+    SnapshotCell<Pair> cell(MakePair(7));
+    std::vector<std::unique_ptr<SnapshotCell<Pair>::Reader>> readers;
+    for (size_t i = 0; i < SnapshotCell<Pair>::kMaxReaders; ++i) {
+        readers.emplace_back(new SnapshotCell<Pair>::Reader(cell));
+    }
+    SnapshotCell<Pair>::Reader extra(cell);
+    TP_ASSERT_FALSE(extra.IsLockFree());
+    TP_ASSERT_EQ(extra.Get().value, 7u);
+    cell.Publish(MakePair(8));
+    TP_ASSERT_EQ(extra.Get().value, 8u);
+    TP_ASSERT_EQ(extra.GetVersion(), 2u);
+
+    readers.pop_back();
+    SnapshotCell<Pair>::Reader reused(cell);
+    TP_ASSERT_TRUE(reused.IsLockFree());
+}
+
+TP_TEST(testSnapshotCellConcurrentReadersDuringPublish) {
+    SnapshotCell<Pair> cell(MakePair(0));
+    std::atomic<bool> stop(false);
+    std::atomic<bool> consistent(true);
+    std::vector<std::thread> readers;
+
+    for (int i = 0; i < 3; ++i) {
+        readers.emplace_back([&cell, &stop, &consistent]() {
+            SnapshotCell<Pair>::Reader reader(cell);
+            uint64_t last = 0;
+            while (!stop.load(std::memory_order_relaxed)) {
+                const Pair& pair = reader.Get();
+                if (pair.check != ~pair.value || pair.value < last) {
+                    consistent.store(false);
+                }
+                last = pair.value;
+            }
+        });
+    }
+
+    for (uint64_t value = 1; value <= 20000; ++value) {
+        cell.Publish(MakePair(value));
+    }
+    stop.store(true);
+    for (std::thread& reader : readers) {
+        reader.join();
+    }
+
+    TP_ASSERT_TRUE(consistent.load());
+    // At most one retired value per reader can still be protected
+    TP_ASSERT_TRUE(cell.GetRetiredCount() <= 3u);
+}
@@ -0,0 +1,100 @@
+#include "../../support/TestHarness.h"
+#include "../../../src/utils/TimerWheel.h"
+#include <cstdint>
+#include <vector>
+
+using namespace TPMiddle::Utils;
+
+namespace {
+
+const uint64_t kMillisecond = 1000000ULL;
+
+struct FiredLog {
+    std::vector<int> ids;
+    std::vector<uint64_t> deadlines;
+};
+
+struct LoggingTimer {
+    FiredLog* log;
+    int id;
+    WheelTimer timer;
+
+    LoggingTimer(FiredLog& log, int id) : log(&log), id(id), timer(&LoggingTimer::OnFire, this) {}
+
+    static void OnFire(void* context, uint64_t deadlineNs) {
+        LoggingTimer* self = static_cast<LoggingTimer*>(context);
+        self->log->ids.push_back(self->id);
+        self->log->deadlines.push_back(deadlineNs);
+    }
+};
+
+} // namespace
+
+TP_TEST(testTimerWheelFiresInDeadlineOrderWithExactDeadlines) {
+    TimerWheel<16> wheel(kMillisecond);
+    FiredLog log;
+    LoggingTimer a(log, 1), b(log, 2), c(log, 3);
+
+    wheel.Schedule(c.timer, 7 * kMillisecond + 300);
+    wheel.Schedule(a.timer, 2 * kMillisecond + 500);
+    wheel.Schedule(b.timer, 2 * kMillisecond + 100);   // Same bucket as a, earlier
+    TP_ASSERT_EQ(wheel.GetNextDeadline(), 2 * kMillisecond + 100);
+
+    TP_ASSERT_EQ(wheel.Advance(2 * kMillisecond), 0u);
+    TP_ASSERT_EQ(wheel.Advance(10 * kMillisecond), 3u);
+    TP_ASSERT_EQ(log.ids.size(), 3u);
+    TP_ASSERT_EQ(log.ids[0], 2);
+    TP_ASSERT_EQ(log.ids[1], 1);
+    TP_ASSERT_EQ(log.ids[2], 3);
+    TP_ASSERT_EQ(log.deadlines[0], 2 * kMillisecond + 100);
+    TP_ASSERT_EQ(log.deadlines[2], 7 * kMillisecond + 300);
+    TP_ASSERT_EQ(wheel.GetNextDeadline(), TimerWheel<16>::kNever);
+    TP_ASSERT_FALSE(a.timer.IsArmed());
+}
+
+TP_TEST(testTimerWheelCancelAndReschedule) {
+    TimerWheel<16> wheel(kMillisecond);
+    FiredLog log;
+    LoggingTimer a(log, 1), b(log, 2);
+
+    wheel.Schedule(a.timer, 3 * kMillisecond);
+    wheel.Schedule(b.timer, 4 * kMillisecond);
+    wheel.Cancel(a.timer);
+    TP_ASSERT_EQ(wheel.GetArmedCount(), 1u);
+    TP_ASSERT_EQ(wheel.GetNextDeadline(), 4 * kMillisecond);
+
+    wheel.Schedule(b.timer, 9 * kMillisecond);
+    TP_ASSERT_EQ(wheel.GetArmedCount(), 1u);
+    wheel.Advance(5 * kMillisecond);
+    TP_ASSERT_TRUE(log.ids.empty());
+
+    wheel.Advance(9 * kMillisecond);
+    TP_ASSERT_EQ(log.ids.size(), 1u);
+    TP_ASSERT_EQ(log.deadlines[0], 9 * kMillisecond);
+}
+
+TP_TEST(testTimerWheelDeadlinesBeyondOneRotation) {
+    TimerWheel<8> wheel(kMillisecond);
+    FiredLog log;
+    LoggingTimer nearTimer(log, 1), farTimer(log, 2);
+
+    // 20 ms is more than two rotations of 8 ms and hashes into slot 4
+    wheel.Schedule(farTimer.timer, 20 * kMillisecond);
+    wheel.Schedule(nearTimer.timer, 4 * kMillisecond);
+    TP_ASSERT_EQ(wheel.Advance(12 * kMillisecond), 1u);
+    TP_ASSERT_EQ(log.ids[0], 1);
+    TP_ASSERT_EQ(wheel.GetNextDeadline(), 20 * kMillisecond);
+
+    TP_ASSERT_EQ(wheel.Advance(20 * kMillisecond), 1u);
+    TP_ASSERT_EQ(log.ids[1], 2);
+}
+
+TP_TEST(testTimerWheelPastDeadlineFiresOnNextAdvance) {
+    TimerWheel<16> wheel(kMillisecond, 50 * kMillisecond);
+    FiredLog log;
+    LoggingTimer late(log, 1);
+
+    wheel.Schedule(late.timer, 10 * kMillisecond);
+    TP_ASSERT_EQ(wheel.Advance(50 * kMillisecond), 1u);
+    TP_ASSERT_EQ(log.deadlines[0], 10 * kMillisecond);
+}